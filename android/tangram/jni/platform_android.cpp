@@ -317,7 +317,7 @@ void featurePickCallback(JNIEnv* jniEnv, jobject listener, const std::vector<Tan
     jobject hashmap = jniEnv->NewObject(hashmapClass, hashmapInitMID);
 
     for (const auto& item : properties->items()) {
-        jstring jkey = jniEnv->NewStringUTF(item.key.c_str());
+        jstring jkey = jniEnv->NewStringUTF(item.name().c_str());
         jstring jvalue = jniEnv->NewStringUTF(properties->asString(item.value).c_str());
         jniEnv->CallObjectMethod(hashmap, hashmapPutMID, jkey, jvalue);
     }
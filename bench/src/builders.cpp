@@ -2,7 +2,10 @@
 #include "gl.h"
 
 #include "util/builders.h"
+#include "util/simplify.h"
 #include "glm/glm.hpp"
+#include <cmath>
+#include <string>
 #include <vector>
 
 #include "benchmark/benchmark_api.h"
@@ -10,7 +13,7 @@
 
 using namespace Tangram;
 
-std::vector<glm::vec3> line = {
+Line line = {
     {0.0, 0.0, 0.0},
     {1.0, 0.0, 0.0},
     {1.0, 1.0, 0.0},
@@ -26,13 +29,29 @@ struct PosNormEnormColVertex {
     GLfloat layer;
 };
 
+// Vertex sinks for the builders. The builders are inlined with these, the
+// *TypeErased benchmarks pass them through std::function instead.
+struct LineVertices {
+    std::vector<PosNormEnormColVertex>& vertices;
+
+    void operator()(const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) const {
+        vertices.push_back({ coord, uv, normal, 0.5f, 0xffffff, 0.f });
+    }
+};
+
+struct PolygonVertices {
+    std::vector<glm::vec3>& vertices;
+
+    void operator()(const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv) const {
+        vertices.push_back(coord);
+    }
+};
+
 static void BM_Tangram_BuildButtMiterLine(benchmark::State& state) {
     while(state.KeepRunning()) {
         std::vector<PosNormEnormColVertex> vertices;
-        PolyLineBuilder builder {
-            [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
-                vertices.push_back({ coord, uv, normal, 0.5f, 0xffffff, 0.f });
-            },
+        PolyLineBuilder<LineVertices> builder {
+            LineVertices{ vertices },
             CapTypes::butt,
             JoinTypes::miter
         };
@@ -45,10 +64,8 @@ BENCHMARK(BM_Tangram_BuildButtMiterLine);
 static void BM_Tangram_BuildRoundRoundLine(benchmark::State& state) {
     while(state.KeepRunning()) {
         std::vector<PosNormEnormColVertex> vertices;
-        PolyLineBuilder builder {
-            [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
-                vertices.push_back({ coord, uv, normal, 0.5f, 0xffffff, 0.f });
-            },
+        PolyLineBuilder<LineVertices> builder {
+            LineVertices{ vertices },
             CapTypes::round,
             JoinTypes::round
         };
@@ -58,4 +75,110 @@ static void BM_Tangram_BuildRoundRoundLine(benchmark::State& state) {
 }
 BENCHMARK(BM_Tangram_BuildRoundRoundLine);
 
+// A detailed road across the tile: a gentle curve with sub-pixel wiggles,
+// as in data for a higher zoom level
+static Line denseLine() {
+    Line dense;
+    const int n = 4096;
+    for (int i = 0; i < n; i++) {
+        float x = float(i) / (n - 1);
+        dense.push_back({ x, 0.5f + 0.25f * std::sin(x * 6.f) + 0.0002f * std::sin(i * 1.7f), 0.f });
+    }
+    return dense;
+}
+
+// 1px on a 256px tile drawn at up to twice its size
+const static float TOLERANCE = 1.f / 512;
+
+template<class VertexFn>
+static void buildDenseLine(benchmark::State& state, float _tolerance, JoinTypes _join) {
+    Line dense = denseLine();
+    size_t numVertices = 0;
+
+    while(state.KeepRunning()) {
+        Line input = dense;
+        simplifyLine(input, _tolerance);
+
+        std::vector<PosNormEnormColVertex> vertices;
+        PolyLineBuilder<VertexFn> builder {
+            LineVertices{ vertices },
+            CapTypes::butt,
+            _join
+        };
+
+        Builders::buildPolyLine(input, builder);
+        numVertices = vertices.size();
+    }
+
+    state.SetLabel("vertices: " + std::to_string(numVertices));
+}
+
+static void BM_Tangram_BuildDenseLine(benchmark::State& state) {
+    buildDenseLine<LineVertices>(state, 0, JoinTypes::miter);
+}
+BENCHMARK(BM_Tangram_BuildDenseLine);
+
+static void BM_Tangram_BuildDenseLineTypeErased(benchmark::State& state) {
+    buildDenseLine<PolyLineVertexFn>(state, 0, JoinTypes::miter);
+}
+BENCHMARK(BM_Tangram_BuildDenseLineTypeErased);
+
+static void BM_Tangram_BuildDenseRoundLine(benchmark::State& state) {
+    buildDenseLine<LineVertices>(state, 0, JoinTypes::round);
+}
+BENCHMARK(BM_Tangram_BuildDenseRoundLine);
+
+static void BM_Tangram_BuildDenseRoundLineTypeErased(benchmark::State& state) {
+    buildDenseLine<PolyLineVertexFn>(state, 0, JoinTypes::round);
+}
+BENCHMARK(BM_Tangram_BuildDenseRoundLineTypeErased);
+
+static void BM_Tangram_BuildSimplifiedDenseLine(benchmark::State& state) {
+    buildDenseLine<LineVertices>(state, TOLERANCE, JoinTypes::miter);
+}
+BENCHMARK(BM_Tangram_BuildSimplifiedDenseLine);
+
+template<class VertexFn>
+static void buildDensePolygon(benchmark::State& state, float _tolerance) {
+    Line ring;
+    const int n = 4096;
+    for (int i = 0; i < n; i++) {
+        float a = float(i) / n * 6.2831853f;
+        float r = 0.4f + 0.05f * std::sin(a * 5.f) + 0.0002f * std::sin(i * 1.7f);
+        ring.push_back({ 0.5f + r * std::cos(a), 0.5f + r * std::sin(a), 0.f });
+    }
+    ring.push_back(ring.front());
+
+    Polygon dense = { ring };
+    size_t numVertices = 0;
+
+    while(state.KeepRunning()) {
+        Polygon input = dense;
+        simplifyPolygon(input, _tolerance);
+
+        std::vector<glm::vec3> vertices;
+        PolygonBuilder<VertexFn> builder { PolygonVertices{ vertices } };
+
+        Builders::buildPolygon(input, 0.f, builder);
+        numVertices = vertices.size();
+    }
+
+    state.SetLabel("vertices: " + std::to_string(numVertices));
+}
+
+static void BM_Tangram_BuildDensePolygon(benchmark::State& state) {
+    buildDensePolygon<PolygonVertices>(state, 0);
+}
+BENCHMARK(BM_Tangram_BuildDensePolygon);
+
+static void BM_Tangram_BuildDensePolygonTypeErased(benchmark::State& state) {
+    buildDensePolygon<PolygonVertexFn>(state, 0);
+}
+BENCHMARK(BM_Tangram_BuildDensePolygonTypeErased);
+
+static void BM_Tangram_BuildSimplifiedDensePolygon(benchmark::State& state) {
+    buildDensePolygon<PolygonVertices>(state, TOLERANCE);
+}
+BENCHMARK(BM_Tangram_BuildSimplifiedDensePolygon);
+
 BENCHMARK_MAIN();
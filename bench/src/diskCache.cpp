@@ -0,0 +1,129 @@
+#include "data/diskCache.h"
+#include "tile/tileID.h"
+#include "platform.h"
+
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// A local tile directory acts as tile server: tiles/{z}/{x}/{y}.mvt
+// Tiles are created from 'tile.mvt' (or random data) when missing.
+const static char* TILE_DIR = "tiles";
+const static char* CACHE_FILE = "bench.pack";
+const static char* URL_TEMPLATE = "tiles/{z}/{x}/{y}.mvt";
+const static int ZOOM = 10;
+const static int GRID = 8;
+const static size_t CACHE_SIZE = 64 * 1024 * 1024;
+
+static std::string tilePath(int _x, int _y) {
+    return std::string(TILE_DIR) + "/" + std::to_string(ZOOM) + "/" +
+        std::to_string(_x) + "/" + std::to_string(_y) + ".mvt";
+}
+
+static bool readFile(const std::string& _path, std::vector<char>& _data) {
+    std::ifstream file(_path, std::ifstream::ate | std::ifstream::binary);
+    if (!file.is_open()) { return false; }
+
+    _data.resize(file.tellg());
+    file.seekg(std::ifstream::beg);
+    file.read(_data.data(), _data.size());
+    return true;
+}
+
+static void createTileDirectory() {
+
+    std::vector<char> tile;
+    if (!readFile("tile.mvt", tile)) {
+        tile.resize(32 * 1024);
+        for (size_t i = 0; i < tile.size(); i++) { tile[i] = char(i * 7919); }
+    }
+
+    std::string dir = std::string(TILE_DIR) + "/" + std::to_string(ZOOM);
+    mkdir(TILE_DIR, 0755);
+    mkdir(dir.c_str(), 0755);
+
+    for (int x = 0; x < GRID; x++) {
+        mkdir((dir + "/" + std::to_string(x)).c_str(), 0755);
+
+        for (int y = 0; y < GRID; y++) {
+            std::string path = tilePath(x, y);
+            if (access(path.c_str(), R_OK) == 0) { continue; }
+
+            std::ofstream file(path, std::ofstream::binary);
+            file.write(tile.data(), tile.size());
+        }
+    }
+}
+
+static void fillCache() {
+    unlink(CACHE_FILE);
+    DiskCache cache(CACHE_FILE, CACHE_SIZE);
+
+    std::vector<char> data;
+    for (int x = 0; x < GRID; x++) {
+        for (int y = 0; y < GRID; y++) {
+            if (readFile(tilePath(x, y), data)) {
+                cache.put(URL_TEMPLATE, TileID(x, y, ZOOM), data);
+            }
+        }
+    }
+}
+
+// Cold pan: all tiles come from the 'server'
+static void BM_Tangram_TileDirectoryPan(benchmark::State& state) {
+    createTileDirectory();
+
+    std::vector<char> data;
+    while (state.KeepRunning()) {
+        for (int x = 0; x < GRID; x++) {
+            for (int y = 0; y < GRID; y++) {
+                readFile(tilePath(x, y), data);
+            }
+        }
+    }
+}
+BENCHMARK(BM_Tangram_TileDirectoryPan);
+
+// Startup: open the pack file and rebuild its index
+static void BM_Tangram_DiskCacheStartup(benchmark::State& state) {
+    createTileDirectory();
+    fillCache();
+
+    size_t entries = 0;
+    while (state.KeepRunning()) {
+        DiskCache cache(CACHE_FILE, CACHE_SIZE);
+        entries = cache.entries();
+    }
+    state.SetLabel("entries: " + std::to_string(entries));
+}
+BENCHMARK(BM_Tangram_DiskCacheStartup);
+
+// Warm pan: all tiles come from the disk cache
+static void BM_Tangram_DiskCacheWarmPan(benchmark::State& state) {
+    createTileDirectory();
+    fillCache();
+
+    DiskCache cache(CACHE_FILE, CACHE_SIZE);
+
+    std::vector<char> data;
+    size_t hits = 0;
+    while (state.KeepRunning()) {
+        hits = 0;
+        for (int x = 0; x < GRID; x++) {
+            for (int y = 0; y < GRID; y++) {
+                hits += cache.get(URL_TEMPLATE, TileID(x, y, ZOOM), data);
+            }
+        }
+    }
+    state.SetLabel("hits: " + std::to_string(hits));
+}
+BENCHMARK(BM_Tangram_DiskCacheWarmPan);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,206 @@
+#include "tangram.h"
+#include "platform.h"
+#include "log.h"
+#include "data/dataSource.h"
+#include "data/tileData.h"
+#include "scene/dataLayer.h"
+#include "scene/drawRule.h"
+#include "scene/filterProgram.h"
+#include "scene/sceneLoader.h"
+#include "scene/scene.h"
+#include "scene/styleContext.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <fstream>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// The bundled scenes with layers, import.yaml only imports scene.yaml
+static const std::vector<std::string> s_sceneFiles = {
+    "scene.yaml",
+    "raster-simple.yaml",
+    "raster-double.yaml",
+    "raster-terrain.yaml",
+};
+
+class FilterFixture : public benchmark::Fixture {
+public:
+    MercatorProjection projection;
+
+    struct BenchScene {
+        std::string file;
+        std::shared_ptr<Scene> scene;
+        std::unique_ptr<StyleContext> styleContext;
+    };
+
+    std::vector<BenchScene> scenes;
+    std::shared_ptr<TileData> tileData;
+
+    void SetUp() override {
+        for (auto& file : s_sceneFiles) {
+            auto scene = std::make_shared<Scene>(file);
+            try { scene->config() = YAML::Load(stringFromFile(file.c_str())); }
+            catch (YAML::ParserException e) {
+                LOGE("Parsing scene config '%s'", e.what());
+                continue;
+            }
+            SceneLoader::applyConfig(scene);
+
+            auto styleContext = std::make_unique<StyleContext>();
+            styleContext->initFunctions(*scene);
+            styleContext->setKeywordZoom(10);
+
+            scenes.push_back({ file, scene, std::move(styleContext) });
+        }
+        if (scenes.empty()) { return; }
+
+        std::ifstream resource("tile.mvt", std::ifstream::ate | std::ifstream::binary);
+        if (!resource.is_open()) {
+            LOGE("Failed to read tile.mvt");
+            return;
+        }
+        auto rawTileData = std::make_shared<std::vector<char>>(resource.tellg());
+        resource.seekg(std::ifstream::beg);
+        resource.read(rawTileData->data(), rawTileData->size());
+
+        // All scenes match their layers against the features of this tile
+        auto source = *scenes.front().scene->dataSources().begin();
+        auto task = source->createTask({0,0,10,10,0});
+        dynamic_cast<DownloadTileTask&>(*task).rawTileData = rawTileData;
+
+        tileData = source->parse(*task, projection);
+    }
+
+    void TearDown() override {
+        tileData.reset();
+        scenes.clear();
+    }
+
+    // Evaluate filters like DrawRuleMergeSet::match
+    template<typename Eval>
+    int matchLayer(const SceneLayer& _layer, const Feature& _feature, StyleContext& _ctx, Eval _eval) {
+        if (!_layer.visible() || !_eval(_layer, _feature, _ctx)) { return 0; }
+
+        int matches = 1;
+        for (auto& sublayer : _layer.sublayers()) {
+            matches += matchLayer(sublayer, _feature, _ctx, _eval);
+        }
+        return matches;
+    }
+
+    template<typename Eval>
+    int matchTile(const BenchScene& _scene, Eval _eval) {
+        auto& styleContext = *_scene.styleContext;
+        int matches = 0;
+        for (auto& datalayer : _scene.scene->layers()) {
+            for (auto& collection : tileData->layers) {
+                for (auto& feature : collection.features) {
+                    styleContext.setFeature(feature);
+                    matches += matchLayer(datalayer, feature, styleContext, _eval);
+                }
+            }
+        }
+        return matches;
+    }
+
+    template<typename Eval>
+    int matchTile(Eval _eval) {
+        int matches = 0;
+        for (auto& scene : scenes) { matches += matchTile(scene, _eval); }
+        return matches;
+    }
+
+    // Match draw rules of all layers like TileBuilder
+    void matchRules(benchmark::State& _state, bool _cache) {
+        if (!tileData) { return; }
+
+        std::vector<DrawRuleMergeSet> ruleSets(scenes.size());
+        for (auto& ruleSet : ruleSets) { ruleSet.setMatchCache(_cache); }
+
+        size_t rules = 0;
+        while (_state.KeepRunning()) {
+            rules = 0;
+            for (size_t i = 0; i < scenes.size(); i++) {
+                auto& styleContext = *scenes[i].styleContext;
+                for (auto& datalayer : scenes[i].scene->layers()) {
+                    for (auto& collection : tileData->layers) {
+                        for (auto& feature : collection.features) {
+                            if (ruleSets[i].match(feature, datalayer, styleContext)) {
+                                rules += ruleSets[i].matchedRules().size();
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        DrawRuleMergeSet::MatchCacheStats stats;
+        for (auto& ruleSet : ruleSets) {
+            stats.hits += ruleSet.matchCacheStats().hits;
+            stats.misses += ruleSet.matchCacheStats().misses;
+        }
+        _state.SetLabel("rules: " + std::to_string(rules) +
+                        ", cache hits: " + std::to_string(stats.hits) +
+                        ", misses: " + std::to_string(stats.misses));
+    }
+};
+
+BENCHMARK_DEFINE_F(FilterFixture, FilterTree)(benchmark::State& st) {
+    if (!tileData) { return; }
+
+    int matches = 0;
+    while (st.KeepRunning()) {
+        matches = matchTile([](const SceneLayer& _layer, const Feature& _feature, StyleContext& _ctx) {
+                return _layer.filter().eval(_feature, _ctx);
+            });
+    }
+    st.SetLabel("matches: " + std::to_string(matches));
+}
+BENCHMARK_REGISTER_F(FilterFixture, FilterTree);
+
+BENCHMARK_DEFINE_F(FilterFixture, FilterProgram)(benchmark::State& st) {
+    if (!tileData) { return; }
+
+    int matches = 0;
+    while (st.KeepRunning()) {
+        matches = matchTile([](const SceneLayer& _layer, const Feature& _feature, StyleContext& _ctx) {
+                return _layer.filterProgram().eval(_feature, _ctx);
+            });
+    }
+
+    // Count the layers of each scene rejected by their key signature alone
+    std::string label = "matches: " + std::to_string(matches);
+    for (auto& scene : scenes) {
+        int evaluated = 0;
+        int rejected = 0;
+        matchTile(scene, [&](const SceneLayer& _layer, const Feature& _feature, StyleContext& _ctx) {
+                evaluated++;
+                if (!_layer.filterProgram().mayMatch(_ctx.keySignature())) {
+                    rejected++;
+                    return false;
+                }
+                return _layer.filterProgram().eval(_feature, _ctx);
+            });
+        label += ", " + scene.file + " rejected by key signature: " +
+            std::to_string(rejected) + "/" + std::to_string(evaluated);
+    }
+    st.SetLabel(label);
+}
+BENCHMARK_REGISTER_F(FilterFixture, FilterProgram);
+
+BENCHMARK_DEFINE_F(FilterFixture, DrawRuleMatch)(benchmark::State& st) {
+    matchRules(st, false);
+}
+BENCHMARK_REGISTER_F(FilterFixture, DrawRuleMatch);
+
+BENCHMARK_DEFINE_F(FilterFixture, DrawRuleMatchCached)(benchmark::State& st) {
+    matchRules(st, true);
+}
+BENCHMARK_REGISTER_F(FilterFixture, DrawRuleMatchCached);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,260 @@
+#include "tangram.h"
+#include "platform.h"
+#include "log.h"
+#include "debug/frameInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Tangram;
+
+// Drives a Map through scripted camera paths, headless with the mock GL
+// context and with tiles read from disk, and reports per-frame timings
+// as JSON (to stdout, or to the file given as first argument).
+//
+// Tiles are read from 'tiles/{z}/{x}/{y}.mvt' when that directory exists,
+// otherwise 'tile.mvt' is used for every tile.
+
+const static char* SCENE_FILE = "scene.yaml";
+const static char* BENCH_SCENE_FILE = "bench-frames.yaml";
+const static char* SOURCE_NAME = "osm";
+const static char* TILE_DIR = "tiles";
+
+const static int WIDTH = 1024;
+const static int HEIGHT = 768;
+const static float FRAME_TIME = 1.f / 60.f;
+
+// Give up waiting for a path to settle after this many frames
+const static int MAX_SETTLE_FRAMES = 600;
+
+const static double START_LON = -74.00976;
+const static double START_LAT = 40.70532;
+const static float START_ZOOM = 15;
+
+using Clock = std::chrono::steady_clock;
+
+static double msSince(Clock::time_point _start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+}
+
+struct Frame {
+    double update;
+    double render;
+    double labels;
+    bool complete;
+};
+
+struct CameraPath {
+    const char* name;
+    int frames;
+    std::function<void(Map&, int)> step;
+};
+
+struct PathResult {
+    std::string name;
+    std::vector<Frame> frames;
+    // Tile-ready latency: time from the last camera movement until the
+    // view is complete, i.e. all visible tiles are loaded and built
+    double settleTime;
+    int settleFrames;
+    bool settled;
+};
+
+static std::string writeBenchScene() {
+
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd))) { cwd[0] = 0; }
+
+    struct stat st;
+    bool hasTileDir = stat(TILE_DIR, &st) == 0 && S_ISDIR(st.st_mode);
+
+    std::string url = std::string("file://") + cwd + "/" +
+        (hasTileDir ? std::string(TILE_DIR) + "/{z}/{x}/{y}.mvt" : "tile.mvt");
+
+    std::ofstream file(BENCH_SCENE_FILE);
+    file << "import: " << SCENE_FILE << "\n"
+         << "sources:\n"
+         << "    " << SOURCE_NAME << ":\n"
+         << "        url: " << url << "\n";
+
+    return url;
+}
+
+static Frame drawFrame(Map& _map) {
+    Frame frame;
+
+    auto start = Clock::now();
+    frame.complete = _map.update(FRAME_TIME);
+    frame.update = msSince(start);
+
+    start = Clock::now();
+    _map.render();
+    frame.render = msSince(start);
+
+    frame.labels = FrameInfo::lastLabelTime();
+
+    return frame;
+}
+
+// Keep a steady frame rate, so that tiles load while the camera moves
+static void waitForNextFrame(Clock::time_point _frameStart) {
+    auto next = _frameStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(FRAME_TIME));
+    std::this_thread::sleep_until(next);
+}
+
+static bool settle(Map& _map, std::vector<Frame>* _frames, int& _count) {
+    for (_count = 0; _count < MAX_SETTLE_FRAMES; _count++) {
+        auto frameStart = Clock::now();
+        Frame frame = drawFrame(_map);
+        if (_frames) { _frames->push_back(frame); }
+        if (frame.complete) { return true; }
+        waitForNextFrame(frameStart);
+    }
+    return false;
+}
+
+static PathResult runPath(Map& _map, const CameraPath& _path) {
+
+    PathResult result;
+    result.name = _path.name;
+
+    _map.setPosition(START_LON, START_LAT);
+    _map.setZoom(START_ZOOM);
+    _map.setTilt(0);
+    _map.setRotation(0);
+
+    int count = 0;
+    if (!settle(_map, nullptr, count)) {
+        LOGE("Start view of path '%s' did not settle", _path.name);
+    }
+
+    for (int i = 0; i < _path.frames; i++) {
+        auto frameStart = Clock::now();
+        _path.step(_map, i);
+        result.frames.push_back(drawFrame(_map));
+        waitForNextFrame(frameStart);
+    }
+
+    auto start = Clock::now();
+    result.settled = settle(_map, &result.frames, result.settleFrames);
+    result.settleTime = msSince(start);
+
+    return result;
+}
+
+static void writeStats(std::ostream& _out, std::vector<double> _values) {
+    if (_values.empty()) { _values.push_back(0); }
+
+    std::sort(_values.begin(), _values.end());
+
+    double sum = 0;
+    for (double v : _values) { sum += v; }
+
+    auto percentile = [&](double p) {
+        return _values[std::min(_values.size() - 1, size_t(p * _values.size()))];
+    };
+
+    _out << "{\"mean\": " << sum / _values.size()
+         << ", \"p50\": " << percentile(0.5)
+         << ", \"p95\": " << percentile(0.95)
+         << ", \"max\": " << _values.back() << "}";
+}
+
+static void writeJson(std::ostream& _out, const std::string& _url, const std::vector<PathResult>& _results) {
+
+    _out << "{\n"
+         << "  \"scene\": \"" << SCENE_FILE << "\",\n"
+         << "  \"tiles\": \"" << _url << "\",\n"
+         << "  \"width\": " << WIDTH << ",\n"
+         << "  \"height\": " << HEIGHT << ",\n"
+         << "  \"paths\": [";
+
+    for (size_t p = 0; p < _results.size(); p++) {
+        auto& result = _results[p];
+
+        std::vector<double> update, render, labels;
+        for (auto& frame : result.frames) {
+            update.push_back(frame.update);
+            render.push_back(frame.render);
+            labels.push_back(frame.labels);
+        }
+
+        _out << (p ? "," : "") << "\n    {\n"
+             << "      \"name\": \"" << result.name << "\",\n"
+             << "      \"settled\": " << (result.settled ? "true" : "false") << ",\n"
+             << "      \"tile_ready_ms\": " << result.settleTime << ",\n"
+             << "      \"tile_ready_frames\": " << result.settleFrames << ",\n"
+             << "      \"update_ms\": ";
+        writeStats(_out, update);
+        _out << ",\n      \"render_ms\": ";
+        writeStats(_out, render);
+        _out << ",\n      \"labels_ms\": ";
+        writeStats(_out, labels);
+        _out << ",\n      \"frames\": [";
+
+        for (size_t i = 0; i < result.frames.size(); i++) {
+            auto& frame = result.frames[i];
+            _out << (i ? "," : "") << "\n        {\"update_ms\": " << frame.update
+                 << ", \"render_ms\": " << frame.render
+                 << ", \"labels_ms\": " << frame.labels
+                 << ", \"complete\": " << (frame.complete ? "true" : "false") << "}";
+        }
+        _out << "\n      ]\n    }";
+    }
+    _out << "\n  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+
+    std::string url = writeBenchScene();
+
+    Map map;
+    map.loadScene(BENCH_SCENE_FILE);
+    map.setupGL();
+    map.resize(WIDTH, HEIGHT);
+    map.setPixelScale(1);
+
+    const double panStep = 0.0005;
+
+    std::vector<CameraPath> paths = {
+        { "pan", 180, [&](Map& m, int i) {
+                m.setPosition(START_LON + i * panStep, START_LAT + i * panStep * 0.5);
+            }},
+        { "zoom", 180, [&](Map& m, int i) {
+                m.setZoom(START_ZOOM - 4 + 5.f * i / 180);
+            }},
+        { "fling", 120, [&](Map& m, int i) {
+                if (i == 0) { m.handleFlingGesture(WIDTH / 2, HEIGHT / 2, 2000, 800); }
+            }},
+        { "tilt", 120, [&](Map& m, int i) {
+                m.setTilt(1.f * i / 120);
+            }},
+    };
+
+    std::vector<PathResult> results;
+    for (auto& path : paths) {
+        LOG("Running camera path '%s'", path.name);
+        results.push_back(runPath(map, path));
+    }
+
+    if (argc > 1) {
+        std::ofstream out(argv[1]);
+        writeJson(out, url, results);
+    } else {
+        writeJson(std::cout, url, results);
+    }
+
+    unlink(BENCH_SCENE_FILE);
+
+    return 0;
+}
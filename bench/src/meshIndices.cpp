@@ -0,0 +1,100 @@
+#include "tangram.h"
+#include "gl.h"
+
+#include "gl/hardware.h"
+#include "gl/mesh.h"
+#include "util/builders.h"
+#include "glm/glm.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+struct BuildingVertex {
+    glm::vec3 pos;
+    glm::vec3 normal;
+};
+
+auto layout = std::make_shared<VertexLayout>(std::vector<VertexLayout::VertexAttrib>({
+    {"a_position", 3, GL_FLOAT, false, 0},
+    {"a_normal", 3, GL_FLOAT, false, 0},
+}));
+
+struct BuildingVertices {
+    MeshData<BuildingVertex>& mesh;
+
+    void operator()(const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv) const {
+        mesh.vertices.push_back({ coord, normal });
+    }
+};
+
+// Exposes the draw batches of the compiled mesh
+struct BuildingMesh : public Mesh<BuildingVertex> {
+    using Mesh<BuildingVertex>::Mesh;
+
+    size_t drawCalls() const { return m_vertexOffsets.size(); }
+};
+
+// Extruded octagonal buildings on a 56x56 grid, about 110k vertices: the
+// building layer of a dense city tile at high zoom
+static MeshData<BuildingVertex> denseBuildings() {
+    MeshData<BuildingVertex> meshData;
+    PolygonBuilder<BuildingVertices> builder(BuildingVertices{ meshData }, false);
+
+    const int n = 56;
+    for (int i = 0; i < n * n; i++) {
+        glm::vec2 center((i % n + 0.5f) / n, (i / n + 0.5f) / n);
+        Polygon polygon(1);
+        for (int c = 0; c < 8; c++) {
+            float a = c * float(M_PI) / 4;
+            polygon[0].push_back({ center.x + 0.3f / n * std::cos(a), center.y + 0.3f / n * std::sin(a), 0.f });
+        }
+
+        Builders::buildPolygonExtrusion(polygon, 0.f, 0.01f, builder);
+        Builders::buildPolygon(polygon, 0.01f, builder);
+
+        meshData.indices.insert(meshData.indices.end(), builder.indices.begin(), builder.indices.end());
+        meshData.offsets.emplace_back(builder.indices.size(), builder.numVertices);
+        builder.clear();
+    }
+    return meshData;
+}
+
+// Without a GL context only the compile step is timed, the label reports the
+// draw calls needed for the mesh and the size of its index buffer
+static void compileBuildings(benchmark::State& state, bool _elementIndexUint) {
+    Hardware::supportsElementIndexUint = _elementIndexUint;
+    MeshData<BuildingVertex> meshData = denseBuildings();
+    size_t drawCalls = 0;
+    size_t indexBytes = 0;
+
+    while(state.KeepRunning()) {
+        BuildingMesh mesh(layout, GL_TRIANGLES);
+        mesh.compile(meshData);
+
+        drawCalls = mesh.drawCalls();
+        indexBytes = mesh.bufferSize() - meshData.vertices.size() * sizeof(BuildingVertex);
+    }
+
+    state.SetLabel("vertices: " + std::to_string(meshData.vertices.size()) +
+                   " draw calls: " + std::to_string(drawCalls) +
+                   " index bytes: " + std::to_string(indexBytes));
+
+    Hardware::supportsElementIndexUint = false;
+}
+
+static void BM_Tangram_CompileBuildings16BitIndices(benchmark::State& state) {
+    compileBuildings(state, false);
+}
+BENCHMARK(BM_Tangram_CompileBuildings16BitIndices);
+
+static void BM_Tangram_CompileBuildings32BitIndices(benchmark::State& state) {
+    compileBuildings(state, true);
+}
+BENCHMARK(BM_Tangram_CompileBuildings32BitIndices);
+
+BENCHMARK_MAIN();
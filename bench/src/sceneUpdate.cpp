@@ -0,0 +1,89 @@
+#include "tangram.h"
+#include "platform.h"
+#include "log.h"
+#include "scene/sceneLoader.h"
+#include "scene/scene.h"
+#include "scene/styleContext.h"
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Like the TileWorker of Map::Impl
+static const int NUM_WORKERS = 2;
+
+class SceneUpdateFixture : public benchmark::Fixture {
+public:
+    const char* sceneFile = "scene.yaml";
+
+    std::shared_ptr<Scene> scene;
+
+    void SetUp() override {
+        scene = std::make_shared<Scene>(sceneFile);
+        try { scene->config() = YAML::Load(stringFromFile(sceneFile)); }
+        catch (YAML::ParserException e) {
+            LOGE("Parsing scene config '%s'", e.what());
+            scene.reset();
+            return;
+        }
+        SceneLoader::applyConfig(scene);
+    }
+
+    void TearDown() override {
+        scene.reset();
+    }
+
+    // Like Map::applySceneUpdates: a copy of the scene with new id
+    std::shared_ptr<Scene> nextScene() {
+        auto next = std::make_shared<Scene>(*scene);
+        next->functions() = scene->functions();
+        return next;
+    }
+
+    std::string label() {
+        return "workers: " + std::to_string(NUM_WORKERS) +
+            ", functions: " + std::to_string(scene->functions().size());
+    }
+};
+
+BENCHMARK_DEFINE_F(SceneUpdateFixture, NewStyleContexts)(benchmark::State& st) {
+    if (!scene) { return; }
+
+    // Each worker creates a Duktape heap and compiles all functions
+    while (st.KeepRunning()) {
+        auto next = nextScene();
+        for (int i = 0; i < NUM_WORKERS; i++) {
+            StyleContext styleContext;
+            styleContext.setSceneGlobals(next->config()["global"]);
+            styleContext.setFunctions(next->functions());
+        }
+    }
+    st.SetLabel(label());
+}
+BENCHMARK_REGISTER_F(SceneUpdateFixture, NewStyleContexts);
+
+BENCHMARK_DEFINE_F(SceneUpdateFixture, PooledStyleContexts)(benchmark::State& st) {
+    if (!scene) { return; }
+
+    // Workers keep their Duktape heap, the first compiles the functions and
+    // the others load the bytecode
+    std::vector<std::unique_ptr<StyleContext>> styleContexts;
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        styleContexts.push_back(std::make_unique<StyleContext>());
+    }
+
+    while (st.KeepRunning()) {
+        auto next = nextScene();
+        for (auto& styleContext : styleContexts) {
+            styleContext->initFunctions(*next);
+        }
+    }
+    st.SetLabel(label());
+}
+BENCHMARK_REGISTER_F(SceneUpdateFixture, PooledStyleContexts);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,105 @@
+#include "tangram.h"
+#include "platform.h"
+#include "log.h"
+#include "data/dataSource.h"
+#include "data/tileData.h"
+#include "scene/nativeFunction.h"
+#include "scene/sceneLoader.h"
+#include "scene/scene.h"
+#include "scene/styleContext.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <fstream>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+class StyleFunctionFixture : public benchmark::Fixture {
+public:
+    MercatorProjection projection;
+    const char* sceneFile = "scene.yaml";
+
+    std::shared_ptr<Scene> scene;
+    std::shared_ptr<TileData> tileData;
+
+    void SetUp() override {
+        scene = std::make_shared<Scene>(sceneFile);
+        try { scene->config() = YAML::Load(stringFromFile(sceneFile)); }
+        catch (YAML::ParserException e) {
+            LOGE("Parsing scene config '%s'", e.what());
+            return;
+        }
+        SceneLoader::applyConfig(scene);
+
+        std::ifstream resource("tile.mvt", std::ifstream::ate | std::ifstream::binary);
+        if (!resource.is_open()) {
+            LOGE("Failed to read tile.mvt");
+            return;
+        }
+        auto rawTileData = std::make_shared<std::vector<char>>(resource.tellg());
+        resource.seekg(std::ifstream::beg);
+        resource.read(rawTileData->data(), rawTileData->size());
+
+        auto source = *scene->dataSources().begin();
+        auto task = source->createTask({0,0,10,10,0});
+        dynamic_cast<DownloadTileTask&>(*task).rawTileData = rawTileData;
+
+        tileData = source->parse(*task, projection);
+    }
+
+    void TearDown() override {
+        tileData.reset();
+        scene.reset();
+    }
+
+    // Evaluates every function of the scene for every feature of the tile
+    void evalFunctions(benchmark::State& _state, bool _native) {
+        if (!tileData) { return; }
+
+        StyleContext styleContext;
+        styleContext.initFunctions(*scene);
+        styleContext.setKeywordZoom(16);
+        styleContext.setNativeFunctions(_native);
+
+        auto& functions = scene->functions();
+        size_t compiled = 0;
+        for (auto& function : functions) {
+            NativeFunction native;
+            compiled += native.compile(function);
+        }
+
+        while (_state.KeepRunning()) {
+            for (auto& collection : tileData->layers) {
+                for (auto& feature : collection.features) {
+                    styleContext.setFeature(feature);
+                    for (size_t id = 0; id < functions.size(); id++) {
+                        styleContext.evalFilter(id);
+                    }
+                }
+            }
+        }
+
+        auto& stats = styleContext.functionCacheStats();
+        _state.SetLabel("native functions: " + std::to_string(compiled) + "/" +
+                        std::to_string(functions.size()) +
+                        ", native evaluations: " + std::to_string(stats.native) +
+                        ", duktape: " + std::to_string(stats.misses) +
+                        ", memoised: " + std::to_string(stats.hits));
+    }
+};
+
+BENCHMARK_DEFINE_F(StyleFunctionFixture, Duktape)(benchmark::State& st) {
+    evalFunctions(st, false);
+}
+BENCHMARK_REGISTER_F(StyleFunctionFixture, Duktape);
+
+BENCHMARK_DEFINE_F(StyleFunctionFixture, Native)(benchmark::State& st) {
+    evalFunctions(st, true);
+}
+BENCHMARK_REGISTER_F(StyleFunctionFixture, Native);
+
+BENCHMARK_MAIN();
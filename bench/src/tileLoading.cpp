@@ -11,7 +11,9 @@
 #include "tile/tile.h"
 #include "tile/tileBuilder.h"
 #include "tile/tileTask.h"
+#include "tile/tileWorker.h"
 #include "text/fontContext.h"
+#include "util/arena.h"
 
 #include <vector>
 #include <iostream>
@@ -114,10 +116,95 @@ BENCHMARK_DEFINE_F(TileLoadingFixture, BuildTest)(benchmark::State& st) {
 
         LOG("ok %d / bytes - %d", bool(result), result->getMemoryUsage());
     }
+
+    auto& stats = ctx.tileBuilder->styleContext().functionCacheStats();
+    st.SetLabel("style function cache hits: " + std::to_string(stats.hits) +
+                ", evaluated: " + std::to_string(stats.misses) +
+                ", hit rate: " + std::to_string(stats.hitRate()));
 }
 
 BENCHMARK_REGISTER_F(TileLoadingFixture, BuildTest);
 
+BENCHMARK_DEFINE_F(TileLoadingFixture, BuildArenaTest)(benchmark::State& st) {
+
+    // Like TileWorker: parse and build with TileData in an Arena
+    auto arena = std::make_shared<Arena>();
+    size_t allocations = 0;
+    size_t capacity = 0;
+
+    while (st.KeepRunning()) {
+        {
+            Arena::Scope scope(arena);
+            ctx.parseTile();
+            result = ctx.tileBuilder->build({0,0,10,10,0}, *ctx.tileData, *ctx.source);
+            ctx.tileData.reset();
+        }
+        allocations = arena->allocations();
+        capacity = arena->capacity();
+        arena->reset();
+    }
+
+    st.SetLabel("heap allocations moved to arena: " + std::to_string(allocations) +
+                ", arena bytes: " + std::to_string(capacity));
+}
+
+BENCHMARK_REGISTER_F(TileLoadingFixture, BuildArenaTest);
+
+BENCHMARK_DEFINE_F(TileLoadingFixture, BuildSelectedTest)(benchmark::State& st) {
+
+    // Like TileTask::process: skip layers and features the scene does not use
+    TileID tileId(0,0,10,10,0);
+    size_t skipped = 0;
+    size_t decoded = 0;
+
+    while (st.KeepRunning()) {
+        auto task = ctx.source->createTask(tileId);
+        auto& t = dynamic_cast<DownloadTileTask&>(*task);
+        t.rawTileData = std::make_shared<std::vector<char>>(ctx.rawTileData);
+
+        auto selection = ctx.tileBuilder->selection(*ctx.source);
+        ctx.tileData = ctx.source->parseSelected(*task, ctx.s_projection, selection);
+        result = ctx.tileBuilder->build(tileId, *ctx.tileData, *ctx.source);
+
+        skipped = selection.bytesSkipped;
+        decoded = selection.bytesDecoded;
+    }
+
+    st.SetLabel("bytes skipped: " + std::to_string(skipped) +
+                ", geometry bytes decoded: " + std::to_string(decoded));
+}
+
+BENCHMARK_REGISTER_F(TileLoadingFixture, BuildSelectedTest);
+
+BENCHMARK_DEFINE_F(TileLoadingFixture, BuildSplitTest)(benchmark::State& st) {
+
+    // Like TileWorker with a split threshold: idle workers build parts of the tile
+    TileID tileId(0,0,10,10,0);
+    auto serial = ctx.tileBuilder->build(tileId, *ctx.tileData, *ctx.source);
+
+    TileWorker worker(2);
+    worker.setScene(ctx.scene);
+    worker.setSplitThreshold(1);
+    ctx.tileBuilder->setExecutor(&worker);
+
+    while (st.KeepRunning()) {
+        result = ctx.tileBuilder->build(tileId, *ctx.tileData, *ctx.source);
+    }
+
+    ctx.tileBuilder->setExecutor(nullptr);
+    worker.stop();
+
+    bool equal = true;
+    for (auto& style : ctx.scene->styles()) {
+        auto& a = serial->getMesh(*style);
+        auto& b = result->getMesh(*style);
+        if (bool(a) != bool(b) || (a && a->bufferSize() != b->bufferSize())) { equal = false; }
+    }
+    st.SetLabel(std::string("meshes equal to serial build: ") + (equal ? "yes" : "no"));
+}
+
+BENCHMARK_REGISTER_F(TileLoadingFixture, BuildSplitTest);
+
 
 
 BENCHMARK_MAIN();
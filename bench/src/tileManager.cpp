@@ -0,0 +1,131 @@
+#include "data/dataSource.h"
+#include "tile/tile.h"
+#include "tile/tileManager.h"
+#include "tile/tileTask.h"
+#include "tile/tileWorker.h"
+#include "tile/visibleTiles.h"
+#include "util/mapProjection.h"
+#include "view/view.h"
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// 32 x 20 tiles: a pitched view on a large screen
+const static int GRID_X = 32;
+const static int GRID_Y = 20;
+const static int ZOOM = 12;
+
+static MercatorProjection s_projection;
+
+struct BenchSource : DataSource {
+    BenchSource() : DataSource("", "") { m_generateGeometry = true; }
+
+    std::shared_ptr<TileData> parse(const TileTask& _task,
+                                    const MapProjection& _projection) const override {
+        return nullptr;
+    }
+
+    // Data is always available: tasks go directly to the workers
+    std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override {
+        return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+    }
+};
+
+// Builds empty tiles immediately, unless on hold
+struct BenchWorker : TileTaskQueue {
+    bool hold = false;
+    std::vector<std::shared_ptr<TileTask>> pending;
+
+    void enqueue(std::shared_ptr<TileTask>&& _task) override {
+        if (hold) {
+            pending.push_back(std::move(_task));
+            return;
+        }
+        _task->tile() = std::make_shared<Tile>(_task->tileId(), s_projection, &_task->source());
+    }
+};
+
+struct BenchContext {
+    BenchWorker worker;
+    TileManager tileManager{worker};
+    ViewState viewState{ &s_projection, true, glm::dvec2(0), float(ZOOM), 0, 0 };
+
+    // Visible tiles, panned by _offset tiles to the right
+    std::vector<TileID> visible(int _offset) {
+        std::vector<TileID> tiles;
+        for (int x = 0; x < GRID_X; x++) {
+            for (int y = 0; y < GRID_Y; y++) {
+                tiles.emplace_back(1000 + x + _offset, 1000 + y, ZOOM);
+            }
+        }
+        return tiles;
+    }
+
+    BenchContext() {
+        tileManager.setDataSources({ std::make_shared<BenchSource>() });
+    }
+
+    void load(const VisibleTiles& _visible) {
+        // Create tasks, then collect the built tiles
+        tileManager.updateTileSets(viewState, _visible);
+        tileManager.updateTileSets(viewState, _visible);
+    }
+};
+
+// Panning across tile boundaries: one column is added and one removed, the
+// new tiles come from the tile cache
+static void BM_Tangram_UpdateTileSets_Pan(benchmark::State& state) {
+    BenchContext ctx;
+
+    VisibleTiles frames[] = { VisibleTiles(ctx.visible(0)), VisibleTiles(ctx.visible(1)) };
+    ctx.load(frames[0]);
+    ctx.load(frames[1]);
+
+    size_t frame = 0;
+    while (state.KeepRunning()) {
+        ctx.tileManager.updateTileSets(ctx.viewState, frames[frame++ % 2]);
+    }
+    state.SetItemsProcessed(state.iterations() * GRID_X * GRID_Y);
+}
+BENCHMARK(BM_Tangram_UpdateTileSets_Pan);
+
+// The visible tiles are unchanged, but one of them is still loading
+static void BM_Tangram_UpdateTileSets_Loading(benchmark::State& state) {
+    BenchContext ctx;
+
+    VisibleTiles ready(ctx.visible(0));
+    ctx.load(ready);
+
+    auto tiles = ctx.visible(0);
+    tiles.emplace_back(0, 0, ZOOM);
+    VisibleTiles loading(tiles);
+
+    ctx.worker.hold = true;
+
+    while (state.KeepRunning()) {
+        ctx.tileManager.updateTileSets(ctx.viewState, loading);
+    }
+    state.SetItemsProcessed(state.iterations() * GRID_X * GRID_Y);
+}
+BENCHMARK(BM_Tangram_UpdateTileSets_Loading);
+
+// The view moved within the visible tiles
+static void BM_Tangram_UpdateTileSets_Unchanged(benchmark::State& state) {
+    BenchContext ctx;
+
+    VisibleTiles visible(ctx.visible(0));
+    ctx.load(visible);
+
+    while (state.KeepRunning()) {
+        ctx.tileManager.updateTileSets(ctx.viewState, visible);
+    }
+    state.SetItemsProcessed(state.iterations() * GRID_X * GRID_Y);
+}
+BENCHMARK(BM_Tangram_UpdateTileSets_Unchanged);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,271 @@
+#include "tangram.h"
+#include "platform.h"
+#include "log.h"
+#include "data/dataSource.h"
+#include "data/tileData.h"
+#include "scene/sceneLoader.h"
+#include "scene/scene.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Protobuf encoding of the Mapbox Vector Tile messages
+struct PbfWriter {
+    std::string data;
+
+    void varint(uint64_t _value) {
+        while (_value >= 0x80) {
+            data += char((_value & 0x7f) | 0x80);
+            _value >>= 7;
+        }
+        data += char(_value);
+    }
+    void key(uint32_t _tag, uint32_t _type) { varint((_tag << 3) | _type); }
+    void uint(uint32_t _tag, uint64_t _value) { key(_tag, 0); varint(_value); }
+    void bytes(uint32_t _tag, const std::string& _value) {
+        key(_tag, 2);
+        varint(_value.size());
+        data += _value;
+    }
+    void number(uint32_t _tag, double _value) {
+        key(_tag, 1);
+        char buffer[sizeof(double)];
+        std::memcpy(buffer, &_value, sizeof(double));
+        data.append(buffer, sizeof(double));
+    }
+    void packed(uint32_t _tag, const std::vector<uint32_t>& _values) {
+        PbfWriter values;
+        for (auto value : _values) { values.varint(value); }
+        bytes(_tag, values.data);
+    }
+};
+
+struct LayerWriter {
+    enum GeomType : uint32_t { point = 1, line = 2, polygon = 3 };
+
+    std::string name;
+    std::vector<std::string> keys;
+    // Encoded Value messages
+    std::vector<std::string> values;
+    std::vector<std::string> features;
+
+    static uint32_t index(std::vector<std::string>& _items, const std::string& _item) {
+        auto it = std::find(_items.begin(), _items.end(), _item);
+        if (it != _items.end()) { return it - _items.begin(); }
+        _items.push_back(_item);
+        return _items.size() - 1;
+    }
+
+    void add(GeomType _type, const std::vector<std::pair<std::string, Value>>& _props,
+             const std::vector<uint32_t>& _geometry) {
+
+        std::vector<uint32_t> tags;
+        for (auto& prop : _props) {
+            PbfWriter value;
+            if (prop.second.is<std::string>()) {
+                value.bytes(1, prop.second.get<std::string>());
+            } else {
+                value.number(3, prop.second.get<double>());
+            }
+            tags.push_back(index(keys, prop.first));
+            tags.push_back(index(values, value.data));
+        }
+
+        PbfWriter feature;
+        feature.packed(2, tags);
+        feature.uint(3, _type);
+        feature.packed(4, _geometry);
+        features.push_back(feature.data);
+    }
+
+    std::string encode() const {
+        PbfWriter layer;
+        layer.uint(15, 2);
+        layer.bytes(1, name);
+        for (auto& feature : features) { layer.bytes(2, feature); }
+        for (auto& key : keys) { layer.bytes(3, key); }
+        for (auto& value : values) { layer.bytes(4, value); }
+        layer.uint(5, 4096);
+        return layer.data;
+    }
+};
+
+static uint32_t command(uint32_t _id, uint32_t _count) { return (_id & 0x7) | (_count << 3); }
+static uint32_t zigzag(int32_t _value) { return (uint32_t(_value) << 1) ^ uint32_t(_value >> 31); }
+
+// Geometry commands of a line through _points, or of a ring when _close is set
+static std::vector<uint32_t> geometry(const std::vector<std::pair<int, int>>& _points, bool _close) {
+    std::vector<uint32_t> commands;
+    int x = 0, y = 0;
+    for (size_t i = 0; i < _points.size(); i++) {
+        if (i == 0) { commands.push_back(command(1, 1)); }
+        if (i == 1) { commands.push_back(command(2, _points.size() - 1)); }
+        commands.push_back(zigzag(_points[i].first - x));
+        commands.push_back(zigzag(_points[i].second - y));
+        x = _points[i].first;
+        y = _points[i].second;
+    }
+    if (_close) { commands.push_back(command(7, 1)); }
+    return commands;
+}
+
+static std::vector<std::pair<int, int>> randomPoints(std::mt19937& _random, size_t _count, bool _ring) {
+    std::uniform_int_distribution<int> position(0, 4095);
+    std::uniform_int_distribution<int> step(-64, 64);
+
+    std::vector<std::pair<int, int>> points;
+    int cx = position(_random), cy = position(_random);
+    for (size_t i = 0; i < _count; i++) {
+        if (_ring) {
+            float angle = 6.2832f * i / _count;
+            int radius = 40 + step(_random) / 4;
+            points.emplace_back(cx + int(radius * std::cos(angle)), cy + int(radius * std::sin(angle)));
+        } else {
+            cx += step(_random);
+            cy += step(_random);
+            points.emplace_back(cx, cy);
+        }
+    }
+    return points;
+}
+
+// A tile with the layers of the bundled scene.yaml: some of the features miss
+// the keys required by the layer filters and one layer is not used at all
+static std::vector<char> bundledTile() {
+    std::mt19937 random(0);
+
+    LayerWriter earth{ "earth" };
+    earth.add(LayerWriter::polygon, { { "kind", Value(std::string("earth")) } },
+              geometry({ {0, 0}, {4096, 0}, {4096, 4096}, {0, 4096} }, true));
+
+    // landuse requires 'name'
+    LayerWriter landuse{ "landuse" };
+    const char* landuseKinds[] = { "park", "industrial", "university", "parking", "farm" };
+    for (int i = 0; i < 400; i++) {
+        std::vector<std::pair<std::string, Value>> props = {
+            { "kind", Value(std::string(landuseKinds[i % 5])) },
+            { "area", Value(double(1000 * i)) },
+        };
+        if (i % 2 == 0) { props.push_back({ "name", Value("Landuse " + std::to_string(i)) }); }
+        landuse.add(LayerWriter::polygon, props, geometry(randomPoints(random, 24, true), true));
+    }
+
+    // water requires 'area'
+    LayerWriter water{ "water" };
+    for (int i = 0; i < 300; i++) {
+        std::vector<std::pair<std::string, Value>> props = { { "kind", Value(std::string("water")) } };
+        if (i % 3 != 0) { props.push_back({ "area", Value(double(100000 * i)) }); }
+        water.add(LayerWriter::polygon, props, geometry(randomPoints(random, 32, true), true));
+    }
+
+    LayerWriter roads{ "roads" };
+    const char* roadKinds[] = { "highway", "major_road", "minor_road", "path", "rail" };
+    for (int i = 0; i < 600; i++) {
+        roads.add(LayerWriter::line, {
+                { "kind", Value(std::string(roadKinds[i % 5])) },
+                { "sort_key", Value(double(i % 7)) },
+            }, geometry(randomPoints(random, 16, false), false));
+    }
+
+    // Not used by the scene
+    LayerWriter transit{ "transit" };
+    for (int i = 0; i < 300; i++) {
+        transit.add(LayerWriter::line, { { "kind", Value(std::string("bus")) } },
+                    geometry(randomPoints(random, 16, false), false));
+    }
+
+    PbfWriter tile;
+    for (auto* layer : { &earth, &landuse, &water, &roads, &transit }) {
+        tile.bytes(3, layer->encode());
+    }
+    return std::vector<char>(tile.data.begin(), tile.data.end());
+}
+
+class TileSelectionFixture : public benchmark::Fixture {
+public:
+    MercatorProjection projection;
+    TileID tileId = { 0, 0, 10, 10, 0 };
+
+    std::shared_ptr<Scene> scene;
+    std::shared_ptr<DataSource> source;
+    std::unique_ptr<TileBuilder> tileBuilder;
+    std::shared_ptr<std::vector<char>> rawTileData;
+
+    void SetUp() override {
+        scene = std::make_shared<Scene>("scene.yaml");
+        try { scene->config() = YAML::Load(stringFromFile("scene.yaml")); }
+        catch (YAML::ParserException e) {
+            LOGE("Parsing scene config '%s'", e.what());
+            return;
+        }
+        SceneLoader::applyConfig(scene);
+
+        source = scene->getDataSource("osm");
+        tileBuilder = std::make_unique<TileBuilder>(scene);
+        rawTileData = std::make_shared<std::vector<char>>(bundledTile());
+    }
+
+    void TearDown() override {
+        tileBuilder.reset();
+        source.reset();
+        scene.reset();
+    }
+
+    std::shared_ptr<TileTask> createTask() {
+        auto task = source->createTask(tileId);
+        dynamic_cast<DownloadTileTask&>(*task).rawTileData = rawTileData;
+        return task;
+    }
+};
+
+BENCHMARK_DEFINE_F(TileSelectionFixture, ParseAll)(benchmark::State& st) {
+    if (!source) { return; }
+
+    size_t features = 0;
+    while (st.KeepRunning()) {
+        auto tileData = source->parse(*createTask(), projection);
+
+        features = 0;
+        for (auto& layer : tileData->layers) { features += layer.features.size(); }
+    }
+    st.SetLabel("tile bytes: " + std::to_string(rawTileData->size()) +
+                ", features: " + std::to_string(features));
+}
+BENCHMARK_REGISTER_F(TileSelectionFixture, ParseAll);
+
+BENCHMARK_DEFINE_F(TileSelectionFixture, ParseSelected)(benchmark::State& st) {
+    if (!source) { return; }
+
+    // Like TileTask::process: skip layers and features the scene does not use
+    size_t features = 0;
+    size_t skipped = 0;
+    size_t decoded = 0;
+    while (st.KeepRunning()) {
+        auto selection = tileBuilder->selection(*source);
+        auto tileData = source->parseSelected(*createTask(), projection, selection);
+
+        features = 0;
+        for (auto& layer : tileData->layers) { features += layer.features.size(); }
+        skipped = selection.bytesSkipped;
+        decoded = selection.bytesDecoded;
+    }
+    st.SetLabel("tile bytes: " + std::to_string(rawTileData->size()) +
+                ", features: " + std::to_string(features) +
+                ", bytes skipped: " + std::to_string(skipped) +
+                ", geometry bytes decoded: " + std::to_string(decoded));
+}
+BENCHMARK_REGISTER_F(TileSelectionFixture, ParseSelected);
+
+BENCHMARK_MAIN();
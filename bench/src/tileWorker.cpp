@@ -0,0 +1,158 @@
+#include "tangram.h"
+#include "platform.h"
+#include "data/dataSource.h"
+#include "scene/scene.h"
+#include "tile/tileBuilder.h"
+#include "tile/tileTask.h"
+#include "tile/tileWorker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+const static int NUM_WORKERS = 4;
+const static int NUM_TASKS = 512;
+
+static std::atomic<int> s_processed;
+
+struct BenchDataSource : DataSource {
+    BenchDataSource() : DataSource("", "") {}
+
+    std::shared_ptr<TileData> parse(const TileTask& _task,
+                                    const MapProjection& _projection) const override {
+        return nullptr;
+    }
+};
+
+// Only measures scheduling: processing a task does no work
+struct BenchTask : TileTask {
+    BenchTask(TileID& _tileId, std::shared_ptr<DataSource> _source)
+        : TileTask(_tileId, _source, -1) {}
+
+    void process(TileBuilder& _tileBuilder) override { s_processed++; }
+};
+
+// The previous TileWorker queue: One mutex, scan for canceled
+// tasks and the highest priority task on each dequeue.
+class MutexTileQueue : public TileTaskQueue {
+public:
+    MutexTileQueue(int _numWorker, std::shared_ptr<Scene> _scene) {
+        for (int i = 0; i < _numWorker; i++) {
+            m_builders.push_back(std::make_unique<TileBuilder>(_scene));
+        }
+        for (auto& builder : m_builders) {
+            m_threads.emplace_back(&MutexTileQueue::run, this, builder.get());
+        }
+    }
+
+    ~MutexTileQueue() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads) { thread.join(); }
+    }
+
+    void enqueue(std::shared_ptr<TileTask>&& task) override {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(task));
+        }
+        m_condition.notify_one();
+    }
+
+private:
+    void run(TileBuilder* _builder) {
+        while (true) {
+            std::shared_ptr<TileTask> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [&, this]{ return !m_running || !m_queue.empty(); });
+                if (!m_running) { break; }
+
+                auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
+                                              [](const auto& a) { return a->isCanceled(); });
+                m_queue.erase(removes, m_queue.end());
+
+                if (m_queue.empty()) { continue; }
+
+                auto it = std::min_element(m_queue.begin(), m_queue.end(),
+                    [](const auto& a, const auto& b) {
+                        if (a->isProxy() != b->isProxy()) {
+                            return !a->isProxy();
+                        }
+                        return a->getPriority() < b->getPriority();
+                    });
+
+                task = std::move(*it);
+                m_queue.erase(it);
+            }
+            task->process(*_builder);
+        }
+    }
+
+    bool m_running = true;
+    std::vector<std::unique_ptr<TileBuilder>> m_builders;
+    std::vector<std::thread> m_threads;
+    std::condition_variable m_condition;
+    std::mutex m_mutex;
+    std::vector<std::shared_ptr<TileTask>> m_queue;
+};
+
+static void runTasks(TileTaskQueue& _queue, std::shared_ptr<DataSource> _source) {
+
+    s_processed = 0;
+
+    for (int i = 0; i < NUM_TASKS; i++) {
+        TileID tileId(i % 64, i / 64, 10);
+        auto task = std::make_shared<BenchTask>(tileId, _source);
+        task->setPriority(float((i * 7919) % NUM_TASKS));
+        task->setProxyState(i % 5 == 0);
+
+        // Cancel some tasks like TileManager does on fast view changes
+        if (i % 3 == 0) {
+            task->cancel();
+            s_processed++;
+        }
+        _queue.enqueue(std::move(task));
+    }
+
+    while (s_processed < NUM_TASKS) {
+        std::this_thread::yield();
+    }
+}
+
+static void BM_Tangram_MutexTileQueue(benchmark::State& state) {
+    auto scene = std::make_shared<Scene>();
+    auto source = std::make_shared<BenchDataSource>();
+    MutexTileQueue queue(NUM_WORKERS, scene);
+
+    while (state.KeepRunning()) {
+        runTasks(queue, source);
+    }
+}
+BENCHMARK(BM_Tangram_MutexTileQueue);
+
+static void BM_Tangram_TileWorker(benchmark::State& state) {
+    auto scene = std::make_shared<Scene>();
+    auto source = std::make_shared<BenchDataSource>();
+    TileWorker worker(NUM_WORKERS);
+    worker.setScene(scene);
+
+    while (state.KeepRunning()) {
+        runTasks(worker, source);
+    }
+    worker.stop();
+}
+BENCHMARK(BM_Tangram_TileWorker);
+
+BENCHMARK_MAIN();
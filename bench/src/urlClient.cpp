@@ -0,0 +1,137 @@
+#include "platform.h"
+#include "urlClient.h"
+#include "httpServer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+const static int NUM_WORKERS = 3;
+const static int NUM_REQUESTS = 128;
+// Response size and server latency of a vector tile
+const static char* TILE_QUERY = "?size=16384&delay=2";
+
+static std::atomic<int> s_finished;
+
+static size_t writeData(char* _data, size_t _size, size_t _count, void* _stream) {
+    auto& content = *static_cast<std::vector<char>*>(_stream);
+    content.insert(content.end(), _data, _data + _size * _count);
+    return _size * _count;
+}
+
+// The previous linux UrlWorkers: a fixed number of threads with one easy
+// handle each, taking the next request when they are idle.
+class UrlWorkers {
+public:
+    UrlWorkers(int _numWorker) {
+        for (int i = 0; i < _numWorker; i++) {
+            m_threads.emplace_back(&UrlWorkers::run, this);
+        }
+    }
+
+    ~UrlWorkers() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads) { thread.join(); }
+    }
+
+    void enqueue(std::string _url) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queue.push_back(std::move(_url));
+        }
+        m_condition.notify_one();
+    }
+
+private:
+    void run() {
+        CURL* handle = curl_easy_init();
+        std::vector<char> content;
+
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeData);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, &content);
+        curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip");
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+
+        while (true) {
+            std::string url;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [&]{ return !m_running || !m_queue.empty(); });
+                if (!m_running) { break; }
+
+                url = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+
+            content.clear();
+            curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+            curl_easy_perform(handle);
+
+            s_finished++;
+        }
+        curl_easy_cleanup(handle);
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::string> m_queue;
+    bool m_running = true;
+    std::vector<std::thread> m_threads;
+};
+
+static std::string tileUrl(const HttpServer& _server, int _request) {
+    return _server.url() + "/" + std::to_string(_request) + TILE_QUERY;
+}
+
+static void waitForRequests() {
+    while (s_finished < NUM_REQUESTS) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+static void BM_Tangram_UrlWorkers(benchmark::State& state) {
+    HttpServer server;
+    UrlWorkers workers(NUM_WORKERS);
+
+    while (state.KeepRunning()) {
+        s_finished = 0;
+        for (int i = 0; i < NUM_REQUESTS; i++) {
+            workers.enqueue(tileUrl(server, i));
+        }
+        waitForRequests();
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_REQUESTS);
+}
+BENCHMARK(BM_Tangram_UrlWorkers);
+
+static void BM_Tangram_UrlClient(benchmark::State& state) {
+    HttpServer server;
+    UrlClient client;
+
+    while (state.KeepRunning()) {
+        s_finished = 0;
+        for (int i = 0; i < NUM_REQUESTS; i++) {
+            client.addRequest(tileUrl(server, i), [](std::vector<char>&&) { s_finished++; });
+        }
+        waitForRequests();
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_REQUESTS);
+}
+BENCHMARK(BM_Tangram_UrlClient);
+
+BENCHMARK_MAIN();
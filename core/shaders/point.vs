@@ -27,12 +27,12 @@ uniform LOWP int u_pass;
 attribute vec2 a_uv;
 attribute LOWP float a_alpha;
 attribute LOWP vec4 a_color;
-#ifdef TANGRAM_TEXT
 attribute vec2 a_position;
+#ifdef TANGRAM_TEXT
 attribute LOWP vec4 a_stroke;
 attribute float a_scale;
 #else
-attribute vec3 a_position;
+attribute float a_depth;
 #endif
 
 varying vec4 v_color;
@@ -94,7 +94,8 @@ void main() {
 #else
     v_texcoords = a_uv;
 
-    gl_Position = vec4(a_position, 1.0);
+    gl_Position = u_ortho * vec4(UNPACK_POSITION(a_position), 0.0, 1.0);
+    gl_Position.z = a_depth;
 
 #endif
 
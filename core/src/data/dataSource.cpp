@@ -1,4 +1,5 @@
 #include "dataSource.h"
+#include "diskCache.h"
 #include "util/geoJson.h"
 #include "platform.h"
 #include "tileData.h"
@@ -8,84 +9,181 @@
 #include "tile/tileManager.h"
 #include "tile/tileTask.h"
 #include "gl/texture.h"
+#include "util/asyncWorker.h"
 #include "log.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <mutex>
-#include <list>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 namespace Tangram {
 
 struct RawCache {
 
-    // Used to ensure safe access from async loading threads
-    std::mutex m_mutex;
-
-    // LRU in-memory cache for raw tile data
-    using CacheEntry = std::pair<TileID, std::shared_ptr<std::vector<char>>>;
-    using CacheList = std::list<CacheEntry>;
-    using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
-
-    CacheMap m_cacheMap;
-    CacheList m_cacheList;
-    int m_usage = 0;
-    int m_maxUsage = 0;
+    // Entries are distributed over shards by TileID hash, so that
+    // concurrent access from download and worker threads rarely contends.
+    // The budget is shared: a shard may hold more than its share of
+    // maxUsage while the other shards hold less.
+    static constexpr size_t NUM_SHARDS = 8;
+
+    struct Entry {
+        TileID id;
+        std::shared_ptr<std::vector<char>> data;
+        // Set on access, cleared when passed by the CLOCK hand
+        bool referenced;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        std::unordered_map<TileID, size_t> index;
+        size_t hand = 0;
+        int64_t usage = 0;
+    };
+
+    std::array<Shard, NUM_SHARDS> m_shards;
+
+    std::atomic<int64_t> m_maxUsage{0};
+    std::atomic<int64_t> m_usage{0};
+
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_evictions{0};
+
+    Shard& shard(const TileID& _id) {
+        return m_shards[std::hash<TileID>()(_id) % NUM_SHARDS];
+    }
 
     bool get(DownloadTileTask& _task) {
 
         if (m_maxUsage <= 0) { return false; }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
         TileID id(_task.tileId().x, _task.tileId().y, _task.tileId().z);
+        auto& s = shard(id);
 
-        auto it = m_cacheMap.find(id);
-        if (it != m_cacheMap.end()) {
-            // Move cached entry to start of list
-            m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
-            _task.rawTileData = m_cacheList.front().second;
+        std::lock_guard<std::mutex> lock(s.mutex);
 
-            return true;
+        auto it = s.index.find(id);
+        if (it == s.index.end()) {
+            m_misses++;
+            return false;
         }
 
-        return false;
+        auto& entry = s.entries[it->second];
+        entry.referenced = true;
+        _task.rawTileData = entry.data;
+
+        m_hits++;
+        return true;
     }
+
     void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef) {
 
-        if (m_maxUsage <= 0) { return; }
+        int64_t maxUsage = m_maxUsage;
+        int64_t size = rawDataRef->size();
+
+        // Tiles that do not fit would flush the whole cache
+        if (maxUsage <= 0 || size > maxUsage) { return; }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
         TileID id(tileID.x, tileID.y, tileID.z);
+        auto& s = shard(id);
+        int64_t shareUsage = maxUsage / NUM_SHARDS;
+
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+
+            auto it = s.index.find(id);
+            if (it != s.index.end()) {
+                auto& entry = s.entries[it->second];
+                s.usage -= entry.data->size();
+                m_usage -= entry.data->size();
+                entry.data = rawDataRef;
+                entry.referenced = true;
+            } else {
+                s.index[id] = s.entries.size();
+                s.entries.push_back({ id, rawDataRef, false });
+            }
+
+            s.usage += size;
+            m_usage += size;
+
+            evict(s, shareUsage, maxUsage, &id);
+        }
+
+        // Over budget: first take from the shards that hold more than their
+        // share, then from any shard
+        for (int64_t limit : { shareUsage, int64_t(0) }) {
+            for (auto& other : m_shards) {
+                if (m_usage <= maxUsage) { return; }
+                if (&other == &s) { continue; }
+
+                std::lock_guard<std::mutex> lock(other.mutex);
+                evict(other, limit, maxUsage, nullptr);
+            }
+        }
+    }
+
+    // CLOCK eviction: Skip (and unmark) recently used entries. Evicts from
+    // @_s while the cache is over @_maxUsage and @_s over @_shardLimit.
+    // Expects the shard mutex to be locked.
+    void evict(Shard& _s, int64_t _shardLimit, int64_t _maxUsage, const TileID* _keep) {
 
-        m_cacheList.push_front({id, rawDataRef});
-        m_cacheMap[id] = m_cacheList.begin();
+        // Skipping _keep, _s must have other entries left
+        size_t minEntries = _keep ? 1 : 0;
 
-        m_usage += rawDataRef->size();
+        while (m_usage > _maxUsage && _s.usage > _shardLimit &&
+               _s.entries.size() > minEntries) {
 
-        while (m_usage > m_maxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Error: invalid cache state!");
-                m_usage = 0;
-                break;
+            if (_s.hand >= _s.entries.size()) { _s.hand = 0; }
+
+            auto& entry = _s.entries[_s.hand];
+            if (entry.referenced || (_keep && entry.id == *_keep)) {
+                entry.referenced = false;
+                _s.hand++;
+                continue;
             }
 
-            // LOGE("Limit raw cache tiles:%d, %fMB ", m_cacheList.size(),
-            //        double(m_cacheUsage) / (1024*1024));
+            _s.usage -= entry.data->size();
+            m_usage -= entry.data->size();
+            _s.index.erase(entry.id);
 
-            auto& entry = m_cacheList.back();
-            m_usage -= entry.second->size();
+            // Move last entry into the free slot
+            if (_s.hand != _s.entries.size() - 1) {
+                entry = std::move(_s.entries.back());
+                _s.index[entry.id] = _s.hand;
+            }
+            _s.entries.pop_back();
 
-            m_cacheMap.erase(entry.first);
-            m_cacheList.pop_back();
+            m_evictions++;
         }
     }
 
     void clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_usage = 0;
+        for (auto& s : m_shards) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.entries.clear();
+            s.index.clear();
+            s.hand = 0;
+            m_usage -= s.usage;
+            s.usage = 0;
+        }
+    }
+
+    void stats(DataSource::CacheStats& _stats) {
+        _stats.hits = m_hits;
+        _stats.misses = m_misses;
+        _stats.evictions = m_evictions;
+        _stats.maxUsage = std::max(int64_t(0), m_maxUsage.load());
+
+        for (auto& s : m_shards) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            _stats.entries += s.entries.size();
+            _stats.usage += s.usage;
+        }
     }
 };
 
@@ -102,6 +200,9 @@ DataSource::DataSource(const std::string& _name, const std::string& _urlTemplate
 }
 
 DataSource::~DataSource() {
+    // The tiles of this source stay in the disk cache for the next session
+    m_diskCache.reset();
+
     clearData();
 }
 
@@ -117,17 +218,64 @@ void DataSource::setCacheSize(size_t _cacheSize) {
     m_cache->m_maxUsage = _cacheSize;
 }
 
+void DataSource::setDiskCache(std::shared_ptr<DiskCache> _diskCache) {
+    m_diskCache = _diskCache;
+}
+
+DataSource::CacheStats DataSource::cacheStats() const {
+    CacheStats stats;
+    m_cache->stats(stats);
+    stats.diskHits = m_diskHits;
+    return stats;
+}
+
+// Tasks are created and downloads started on the GL thread, which must not
+// wait for disk reads. Downloads finish on the network thread, which must
+// not wait for disk writes and cache compaction.
+static AsyncWorker& diskCacheWorker() {
+    static AsyncWorker worker;
+    return worker;
+}
+
+// Compaction rewrites the whole pack file, lookups must not wait for it
+static AsyncWorker& diskCompactionWorker() {
+    static AsyncWorker worker;
+    return worker;
+}
+
 bool DataSource::cacheGet(DownloadTileTask& _task) {
     return m_cache->get(_task);
 }
 
-void DataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef) {
-    m_cache->put(_tileID, _rawDataRef);
+void DataSource::cachePut(const TileTask& _task, std::shared_ptr<std::vector<char>> _rawDataRef) {
+    m_cache->put(_task.tileId(), _rawDataRef);
+
+    if (m_diskCache) {
+        // Drop data that was requested before the source was cleared. Removals
+        // run on the same worker, so data that is written before a later
+        // clearData() is removed again.
+        diskCacheWorker().enqueue([source = shared_from_this(), tileID = _task.tileId(),
+                                   generation = _task.sourceGeneration(), _rawDataRef]() {
+            if (generation != source->generation()) { return; }
+
+            auto& diskCache = source->m_diskCache;
+            if (!diskCache->put(source->m_urlTemplate, tileID, *_rawDataRef)) {
+                // Full: records are dropped until the compaction is done
+                diskCompactionWorker().enqueue([diskCache]() { diskCache->compact(); });
+            }
+        });
+    }
 }
 
 void DataSource::clearData() {
     m_cache->clear();
     m_generation++;
+
+    if (m_diskCache) {
+        diskCacheWorker().enqueue([diskCache = m_diskCache, urlTemplate = m_urlTemplate]() {
+            diskCache->remove(urlTemplate);
+        });
+    }
 }
 
 void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const {
@@ -161,9 +309,11 @@ bool DataSource::equals(const DataSource& other) const {
 void DataSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
                               TileTaskCb _cb) {
 
-    if (_task->isCanceled()) { return; }
-
-    TileID tileID = _task->tileId();
+    // Let the callback release the download
+    if (_task->isCanceled()) {
+        _cb.func(std::move(_task));
+        return;
+    }
 
     if (!_rawData.empty()) {
 
@@ -173,28 +323,81 @@ void DataSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<Tile
         auto& task = static_cast<DownloadTileTask&>(*_task);
         task.rawTileData = rawDataRef;
 
-        _cb.func(std::move(_task));
+        cachePut(task, rawDataRef);
 
-        cachePut(tileID, rawDataRef);
+        _cb.func(std::move(_task));
+    } else {
+        // Let the callback know that the download finished without data
+        _cb.func(std::move(_task));
     }
 }
 
 bool DataSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
 
+    if (m_diskCache) {
+        loadFromDiskCache(std::move(_task), _cb);
+        return true;
+    }
+    return startDownload(std::move(_task), _cb);
+}
+
+void DataSource::loadFromDiskCache(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
+
+    // The task holds a reference to this source
+    diskCacheWorker().enqueue([this, _cb, task = std::move(_task)]() mutable {
+
+        // Let the callback release the download
+        if (task->isCanceled()) {
+            _cb.func(std::move(task));
+            return;
+        }
+
+        auto rawDataRef = std::make_shared<std::vector<char>>();
+
+        if (m_diskCache->get(m_urlTemplate, task->tileId(), *rawDataRef)) {
+            static_cast<DownloadTileTask&>(*task).rawTileData = rawDataRef;
+            m_cache->put(task->tileId(), rawDataRef);
+            m_diskHits++;
+
+            _cb.func(std::move(task));
+            return;
+        }
+
+        auto copyTask = task;
+        if (!startDownload(std::move(task), _cb)) {
+            // Tasks without data are canceled by the callback
+            _cb.func(std::move(copyTask));
+        }
+    });
+}
+
+bool DataSource::startDownload(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
+
     std::string url(constructURL(_task->tileId()));
 
+    auto copyTask = _task;
+
     // lambda captured parameters are const by default, we want "task" (moved) to be non-const,
     // hence "mutable"
     // Refer: http://en.cppreference.com/w/cpp/language/lambda
-    return startUrlRequest(url,
+    bool status = startUrlRequest(url,
             [this, _cb, task = std::move(_task)](std::vector<char>&& rawData) mutable {
                 this->onTileLoaded(std::move(rawData), std::move(task), _cb);
             });
 
+    // The task may have been canceled while the request was started,
+    // after DownloadScheduler stopped its download
+    if (status && copyTask->isCanceled()) { cancelUrlRequest(url); }
+
+    return status;
 }
 
-void DataSource::cancelLoadingTile(const TileID& _tileID) {
+void DataSource::cancelDownload(const TileID& _tileID) {
     cancelUrlRequest(constructURL(_tileID));
+}
+
+void DataSource::cancelLoadingTile(const TileID& _tileID) {
+    cancelDownload(_tileID);
     for (auto& raster : m_rasterSources) {
         TileID rasterID = _tileID.withMaxSourceZoom(raster->maxZoom());
         raster->cancelLoadingTile(rasterID);
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <vector>
@@ -11,11 +12,13 @@ namespace Tangram {
 
 class MapProjection;
 struct TileData;
+struct TileDataSelection;
 struct TileID;
 struct Raster;
 class Tile;
 class TileManager;
 struct RawCache;
+class DiskCache;
 class Texture;
 
 class DataSource : public std::enable_shared_from_this<DataSource> {
@@ -44,9 +47,20 @@ public:
     /* Stops any running I/O tasks pertaining to @_tile */
     virtual void cancelLoadingTile(const TileID& _tile);
 
+    /* Stops the url request for @_tile, but not those of its rasters. The
+     * callback passed to loadTileData() is not called after this. */
+    void cancelDownload(const TileID& _tile);
+
     /* Parse a <TileTask> with data into a <TileData>, returning an empty TileData on failure */
     virtual std::shared_ptr<TileData> parse(const TileTask& _task, const MapProjection& _projection) const = 0;
 
+    /* Like parse(), but sources may skip the layers and features which are not
+     * selected by @_selection */
+    virtual std::shared_ptr<TileData> parseSelected(const TileTask& _task, const MapProjection& _projection,
+                                                    TileDataSelection& _selection) const {
+        return parse(_task, _projection);
+    }
+
     /* Clears all data associated with this DataSource */
     virtual void clearData();
 
@@ -64,6 +78,33 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        // Misses of the in-memory cache that were found in the disk cache
+        uint64_t diskHits = 0;
+        uint64_t entries = 0;
+        // Bytes of raw tile data held in memory
+        uint64_t usage = 0;
+        uint64_t maxUsage = 0;
+    };
+
+    /* Counters of the in-memory tile data cache, e.g. for monitoring */
+    CacheStats cacheStats() const;
+
+    /* @_diskCache: Persistent cache for tile data which is used when the
+     * in-memory cache has no entry for a tile. May be shared by multiple sources.
+     * Lookups run on a separate thread before the download of a tile.
+     */
+    void setDiskCache(std::shared_ptr<DiskCache> _diskCache);
+
+    /* @_maxDownloads: Maximum number of tile downloads of this source that
+     * run at the same time, 0 for no limit other than the global one.
+     */
+    void setMaxDownloads(size_t _maxDownloads) { m_maxDownloads = _maxDownloads; }
+    size_t maxDownloads() const { return m_maxDownloads; }
+
     /* ID of this DataSource instance */
     int32_t id() const { return m_id; }
 
@@ -103,9 +144,19 @@ protected:
         return url;
     }
 
+    /* Starts the url request for the tile data of @_task */
+    virtual bool startDownload(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb);
+
+    /* Looks up the tile data of @_task in the disk cache on the disk cache
+     * thread and starts the download from there when it is not found */
+    void loadFromDiskCache(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb);
+
+    /* Looks up the in-memory cache */
     bool cacheGet(DownloadTileTask& _task);
 
-    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef);
+    /* Adds the data of _task to the in-memory cache and queues the write
+     * to the disk cache */
+    void cachePut(const TileTask& _task, std::shared_ptr<std::vector<char>> _rawDataRef);
 
     // This datasource is used to generate actual tile geometry
     bool m_generateGeometry = false;
@@ -122,17 +173,23 @@ protected:
     // Maximum zoom for which tiles will be requested
     int32_t m_maxZoom;
 
+    // Maximum number of concurrent downloads, 0 for no limit
+    size_t m_maxDownloads = 0;
+
     // Unique id for DataSource
     int32_t m_id;
 
     // Generation of dynamic DataSource state (incremented for each update)
-    int64_t m_generation = 1;
+    std::atomic<int64_t> m_generation{1};
 
     // URL template for requesting tiles from a network or filesystem
     std::string m_urlTemplate;
 
     std::unique_ptr<RawCache> m_cache;
 
+    std::shared_ptr<DiskCache> m_diskCache;
+    std::atomic<uint64_t> m_diskHits{0};
+
     /* vector of raster sources (as raster samplers) referenced by this datasource */
     std::vector<std::shared_ptr<DataSource>> m_rasterSources;
 };
@@ -0,0 +1,526 @@
+#include "diskCache.h"
+
+#include "tile/tileID.h"
+#include "util/hash.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tangram {
+
+static const char FILE_MAGIC[8] = { 'T', 'G', 'C', 'A', 'C', 'H', 'E', '2' };
+static const uint32_t RECORD_MAGIC = 0x54524543; // 'TREC'
+
+// Record flags: drop all previous records of the source
+static const uint32_t RECORD_REMOVE = 1;
+
+struct RecordHeader {
+    uint32_t magic;
+    // Checksum of source URL template and data
+    uint32_t checksum;
+    int32_t x, y, z;
+    uint32_t sourceSize;
+    uint32_t dataSize;
+    uint32_t flags;
+};
+
+static_assert(sizeof(RecordHeader) == 32, "Unexpected RecordHeader padding");
+
+// FNV-1a
+static uint32_t checksum(uint32_t _hash, const char* _data, size_t _size) {
+    for (size_t i = 0; i < _size; i++) {
+        _hash ^= uint8_t(_data[i]);
+        _hash *= 16777619u;
+    }
+    return _hash;
+}
+
+static uint32_t checksum(const std::string& _source, const char* _data, size_t _size) {
+    return checksum(checksum(2166136261u, _source.data(), _source.size()), _data, _size);
+}
+
+static bool writeAll(int _fd, size_t _offset, const char* _data, size_t _size) {
+    while (_size > 0) {
+        ssize_t n = pwrite(_fd, _data, _size, _offset);
+        if (n <= 0) { return false; }
+        _data += n;
+        _offset += n;
+        _size -= n;
+    }
+    return true;
+}
+
+// Makes a rename in the directory of _path durable
+static bool syncDirectory(const std::string& _path) {
+    size_t slash = _path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : _path.substr(0, slash + 1);
+
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) { return false; }
+
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+size_t DiskCache::KeyHash::operator()(const Key& _key) const {
+    size_t seed = std::hash<std::string>()(_key.source);
+    hash_combine(seed, _key.x);
+    hash_combine(seed, _key.y);
+    hash_combine(seed, _key.z);
+    return seed;
+}
+
+DiskCache::Mapping::~Mapping() {
+    munmap(const_cast<char*>(data), size);
+}
+
+DiskCache::DiskCache(const std::string& _path, size_t _maxSize)
+    : m_path(_path), m_maxSize(_maxSize) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!openFile()) {
+            LOGE("Cannot open tile cache '%s'", m_path.c_str());
+            closeFile();
+            return;
+        }
+        if (m_fileSize <= m_maxSize) { return; }
+    }
+    compact();
+}
+
+DiskCache::~DiskCache() {
+    closeFile();
+}
+
+bool DiskCache::openFile() {
+
+    m_fd = open(m_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0) { return false; }
+
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) { return false; }
+
+    m_fileSize = st.st_size;
+
+    char magic[sizeof(FILE_MAGIC)];
+    if (m_fileSize < sizeof(FILE_MAGIC) ||
+        pread(m_fd, magic, sizeof(magic), 0) != sizeof(magic) ||
+        std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0) {
+
+        if (m_fileSize > 0) {
+            LOGW("Resetting incompatible tile cache '%s'", m_path.c_str());
+        }
+        if (ftruncate(m_fd, 0) != 0 || !writeAll(m_fd, 0, FILE_MAGIC, sizeof(FILE_MAGIC))) {
+            return false;
+        }
+        m_fileSize = sizeof(FILE_MAGIC);
+    }
+
+    if (!map(m_fileSize)) { return false; }
+
+    scan();
+
+    return true;
+}
+
+void DiskCache::closeFile() {
+    m_map.reset();
+
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_entries.clear();
+    m_index.clear();
+    m_fileSize = 0;
+}
+
+bool DiskCache::map(size_t _size) {
+
+    if (m_map && _size <= m_map->size) { return true; }
+
+    // Appended records become visible through the shared mapping, reserve
+    // room for them. The file only grows beyond the budget by removal
+    // records, or when it was opened with a smaller budget. Pages beyond
+    // the end of the file are never read. Readers of the previous mapping
+    // keep it until they are done.
+    size_t size = std::max(m_fileSize, m_maxSize) + m_maxSize / 4;
+
+    void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (ptr == MAP_FAILED) {
+        LOGE("Cannot map tile cache '%s'", m_path.c_str());
+        m_map.reset();
+        return false;
+    }
+
+    m_map = std::make_shared<Mapping>(static_cast<const char*>(ptr), size);
+
+    return _size <= m_map->size;
+}
+
+void DiskCache::scan() {
+
+    const char* data = m_map->data;
+    size_t offset = sizeof(FILE_MAGIC);
+
+    // Offsets of the records with complete headers
+    std::vector<size_t> records;
+
+    while (offset + sizeof(RecordHeader) <= m_fileSize) {
+
+        RecordHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+
+        if (header.magic != RECORD_MAGIC) { break; }
+
+        size_t size = sizeof(header) + header.sourceSize + header.dataSize;
+        if (offset + size > m_fileSize) { break; }
+
+        records.push_back(offset);
+        offset += size;
+    }
+
+    // Appends are not synced: the last records may have been written only
+    // partially, which their headers do not tell.
+    while (!records.empty()) {
+        RecordHeader header;
+        std::memcpy(&header, data + records.back(), sizeof(header));
+
+        const char* source = data + records.back() + sizeof(header);
+        uint32_t sum = checksum(checksum(2166136261u, source, header.sourceSize),
+                                source + header.sourceSize, header.dataSize);
+
+        if (sum == header.checksum) { break; }
+
+        offset = records.back();
+        records.pop_back();
+    }
+
+    for (size_t recordOffset : records) {
+
+        RecordHeader header;
+        std::memcpy(&header, data + recordOffset, sizeof(header));
+
+        size_t size = sizeof(header) + header.sourceSize + header.dataSize;
+
+        Key key{ std::string(data + recordOffset + sizeof(header), header.sourceSize),
+                 header.x, header.y, header.z };
+
+        if (header.flags & RECORD_REMOVE) {
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                if (it->key.source == key.source) {
+                    m_index.erase(it->key);
+                    it = m_entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            continue;
+        }
+
+        // Later records replace earlier ones and are more recently used
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_entries.erase(it->second);
+        }
+        m_entries.push_front({ key, recordOffset, size });
+        m_index[key] = m_entries.begin();
+    }
+
+    if (offset < m_fileSize) {
+        // Incomplete record from an interrupted write
+        LOGW("Truncating tile cache '%s' from %d to %d bytes", m_path.c_str(),
+             int(m_fileSize), int(offset));
+
+        if (ftruncate(m_fd, offset) == 0) {
+            m_fileSize = offset;
+        }
+    }
+}
+
+bool DiskCache::get(const std::string& _source, const TileID& _tileID, std::vector<char>& _data) {
+
+    Key key{ _source, _tileID.x, _tileID.y, _tileID.z };
+
+    std::shared_ptr<const Mapping> mapping;
+    size_t offset;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_fd < 0) { return false; }
+
+        auto it = m_index.find(key);
+        if (it == m_index.end()) { return false; }
+
+        auto entry = it->second;
+
+        if (!map(entry->offset + entry->size)) { return false; }
+
+        mapping = m_map;
+        offset = entry->offset;
+
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+    }
+
+    // Page in and copy the record without blocking other lookups
+    const char* record = mapping->data + offset;
+
+    RecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+
+    const char* data = record + sizeof(header) + header.sourceSize;
+
+    if (header.checksum != checksum(_source, data, header.dataSize)) {
+        LOGW("Dropping corrupt tile cache record %d/%d/%d", key.z, key.x, key.y);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Unless the record was replaced or the file compacted meanwhile
+        auto it = m_index.find(key);
+        if (it != m_index.end() && it->second->offset == offset && m_map == mapping) {
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+        return false;
+    }
+
+    // Copied rather than handed out as a view, see get() in diskCache.h
+    _data.assign(data, data + header.dataSize);
+
+    return true;
+}
+
+bool DiskCache::append(int _fd, size_t _offset, const Key& _key, const char* _data, size_t _size,
+                       uint32_t _checksum, uint32_t _flags) {
+
+    RecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.checksum = _checksum;
+    header.x = _key.x;
+    header.y = _key.y;
+    header.z = _key.z;
+    header.sourceSize = _key.source.size();
+    header.dataSize = _size;
+    header.flags = _flags;
+
+    size_t offset = _offset;
+
+    if (!writeAll(_fd, offset, reinterpret_cast<const char*>(&header), sizeof(header))) { return false; }
+    offset += sizeof(header);
+
+    if (!writeAll(_fd, offset, _key.source.data(), _key.source.size())) { return false; }
+    offset += _key.source.size();
+
+    return writeAll(_fd, offset, _data, _size);
+}
+
+bool DiskCache::put(const std::string& _source, const TileID& _tileID, const std::vector<char>& _data) {
+
+    size_t size = sizeof(RecordHeader) + _source.size() + _data.size();
+
+    // Do not let a single tile flush the whole cache
+    if (size > m_maxSize / 4) { return true; }
+
+    Key key{ _source, _tileID.x, _tileID.y, _tileID.z };
+    uint32_t sum = checksum(_source, _data.data(), _data.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd < 0) { return true; }
+
+    if (m_compacting || m_fileSize + size > m_maxSize) { return false; }
+
+    if (!append(m_fd, m_fileSize, key, _data.data(), _data.size(), sum, 0)) {
+        LOGE("Cannot write to tile cache '%s'", m_path.c_str());
+        // Drop partially written record
+        if (ftruncate(m_fd, m_fileSize) != 0) { closeFile(); }
+        return true;
+    }
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_entries.erase(it->second);
+    }
+    m_entries.push_front({ key, m_fileSize, size });
+    m_index[key] = m_entries.begin();
+
+    m_fileSize += size;
+
+    return true;
+}
+
+void DiskCache::remove(const std::string& _source) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd < 0) { return; }
+
+    bool found = false;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->key.source == _source) {
+            m_index.erase(it->key);
+            it = m_entries.erase(it);
+            found = true;
+        } else {
+            ++it;
+        }
+    }
+    if (!found) { return; }
+
+    // The records of a running compaction may include the removed ones.
+    // Its result is discarded, so the removal record can be appended to
+    // the current pack file.
+    m_resets++;
+
+    Key key{ _source, 0, 0, 0 };
+    uint32_t sum = checksum(_source, nullptr, 0);
+    size_t size = sizeof(RecordHeader) + _source.size();
+
+    if (!append(m_fd, m_fileSize, key, nullptr, 0, sum, RECORD_REMOVE)) {
+        LOGE("Cannot write to tile cache '%s'", m_path.c_str());
+        // Without the removal record the entries would be restored
+        reset();
+        return;
+    }
+    m_fileSize += size;
+}
+
+void DiskCache::compact() {
+
+    // Snapshot of the records to keep. Nothing is appended to the pack file
+    // while m_compacting is set, so their offsets stay valid.
+    std::vector<Entry> keep;
+    std::shared_ptr<const Mapping> mapping;
+    uint32_t resets;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Nothing to gain, e.g. a compaction that was requested again
+        // while the previous one ran
+        if (m_fd < 0 || m_compacting || m_fileSize <= m_maxSize / 4 * 3) { return; }
+
+        if (!map(m_fileSize)) { return; }
+
+        m_compacting = true;
+        mapping = m_map;
+        resets = m_resets;
+
+        // Keep most recently used records within 3/4 of the budget
+        size_t budget = m_maxSize / 4 * 3;
+        size_t size = sizeof(FILE_MAGIC);
+
+        for (auto& entry : m_entries) {
+            if (size + entry.size > budget) { break; }
+            size += entry.size;
+            keep.push_back(entry);
+        }
+    }
+
+    std::string tmpPath = m_path + ".tmp";
+
+    int fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    bool ok = fd >= 0 && writeAll(fd, 0, FILE_MAGIC, sizeof(FILE_MAGIC));
+
+    // Write oldest first, so that scan() restores the LRU order
+    size_t offset = sizeof(FILE_MAGIC);
+    for (auto it = keep.rbegin(); ok && it != keep.rend(); ++it) {
+        ok = writeAll(fd, offset, mapping->data + it->offset, it->size);
+        it->offset = offset;
+        offset += it->size;
+    }
+
+    ok = ok && fsync(fd) == 0;
+    mapping.reset();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_compacting = false;
+
+    if (ok && (resets != m_resets || m_fd < 0)) {
+        // Cleared or closed meanwhile
+        close(fd);
+        unlink(tmpPath.c_str());
+        return;
+    }
+
+    ok = ok && rename(tmpPath.c_str(), m_path.c_str()) == 0;
+
+    if (!ok) {
+        LOGE("Cannot compact tile cache '%s'", m_path.c_str());
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmpPath.c_str());
+        }
+        reset();
+        return;
+    }
+
+    m_map.reset();
+    close(m_fd);
+
+    m_fd = fd;
+    m_fileSize = offset;
+
+    m_entries.assign(keep.begin(), keep.end());
+    m_index.clear();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        m_index[it->key] = it;
+    }
+
+    lock.unlock();
+
+    if (!syncDirectory(m_path)) {
+        LOGW("Cannot sync directory of tile cache '%s'", m_path.c_str());
+    }
+}
+
+void DiskCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    reset();
+}
+
+void DiskCache::reset() {
+
+    if (m_fd < 0) { return; }
+
+    m_resets++;
+
+    m_entries.clear();
+    m_index.clear();
+    m_map.reset();
+
+    // Replace the file instead of truncating it, lookups may still read
+    // from a mapping of the old one
+    close(m_fd);
+    unlink(m_path.c_str());
+
+    m_fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (m_fd < 0 || !writeAll(m_fd, 0, FILE_MAGIC, sizeof(FILE_MAGIC))) {
+        LOGE("Cannot reset tile cache '%s'", m_path.c_str());
+        closeFile();
+        return;
+    }
+    m_fileSize = sizeof(FILE_MAGIC);
+}
+
+size_t DiskCache::entries() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t DiskCache::fileSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fileSize;
+}
+
+}
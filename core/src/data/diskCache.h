@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+struct TileID;
+
+/* DiskCache
+ *
+ * Persistent cache for raw tile data, shared by all DataSources.
+ *
+ * Records are keyed by the URL template of their source and the tile
+ * coordinates, so that they stay valid across restarts and sources of
+ * the same name in different scenes do not share tiles.
+ *
+ * Records are appended to a single pack file and read back through a
+ * read-only memory mapping. The index is rebuilt on open from the record
+ * headers. Appends are not synced, so records at the end of the file may
+ * be torn after a crash: they are cut off when their header is incomplete
+ * or when their checksum does not match. Record data is also verified on
+ * each hit.
+ *
+ * The mapping reserves address space for the whole size budget, so that
+ * appends do not require a new mapping.
+ *
+ * When the file reaches its size budget put() drops new records until
+ * compact() was run: it writes the most recently used records to a new
+ * file which then atomically replaces the pack file. Compaction is slow,
+ * callers run it apart from lookups. Lookups continue on the old file
+ * meanwhile. Record data is read and copied without holding the lock.
+ */
+class DiskCache {
+
+public:
+
+    /* Opens or creates the pack file at @_path. The file will not grow
+     * larger than @_maxSize bytes */
+    DiskCache(const std::string& _path, size_t _maxSize);
+
+    ~DiskCache();
+
+    DiskCache(const DiskCache& _other) = delete;
+    DiskCache& operator=(const DiskCache& _other) = delete;
+
+    bool isOpen() const { return m_fd >= 0; }
+
+    /* Copies the data cached for tile @_tileID of the source with URL template
+     * @_source into @_data. Returns false when no valid record exists. Reads
+     * from disk, do not call on the GL thread.
+     *
+     * The data is copied instead of being handed out as a view of the
+     * mapping: tile data is owned as a std::vector by the RawCache and the
+     * parsers, and a view would keep the mapping of a compacted pack file
+     * and its disk space alive for as long as the tile is cached. The
+     * checksum check reads the whole record anyway, so the copy is from
+     * memory that was just paged in. */
+    bool get(const std::string& _source, const TileID& _tileID, std::vector<char>& _data);
+
+    /* Appends a record for @_data. Returns false when the record was dropped
+     * because the pack file is full or being compacted, see compact() */
+    bool put(const std::string& _source, const TileID& _tileID, const std::vector<char>& _data);
+
+    /* Write the most recently used records to a new pack file which replaces
+     * the current one. Does nothing while another compaction is running or
+     * when the file is within 3/4 of its budget, which compaction leaves.
+     * Reads and writes the whole file, run it apart from lookups */
+    void compact();
+
+    /* Drop all records of the source with URL template @_source. A removal
+     * record is appended, so that they are not restored on the next open */
+    void remove(const std::string& _source);
+
+    /* Drop all records */
+    void clear();
+
+    /* Number of records in the index */
+    size_t entries() const;
+
+    /* Bytes used by the pack file, including superseded records */
+    size_t fileSize() const;
+
+private:
+
+    struct Key {
+        // URL template of the source
+        std::string source;
+        int32_t x, y, z;
+
+        bool operator==(const Key& _other) const {
+            return x == _other.x && y == _other.y && z == _other.z &&
+                source == _other.source;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& _key) const;
+    };
+
+    struct Entry {
+        Key key;
+        // Offset and size of the whole record in the pack file
+        size_t offset;
+        size_t size;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    // Read-only mapping of the pack file, released when the last reader is done
+    struct Mapping {
+        const char* data;
+        size_t size;
+
+        Mapping(const char* _data, size_t _size) : data(_data), size(_size) {}
+        ~Mapping();
+    };
+
+    bool openFile();
+    void closeFile();
+
+    /* Rebuild index from the records in the pack file */
+    void scan();
+
+    /* Make sure the mapping covers @_size bytes of the pack file. A new
+     * mapping reserves the size budget beyond the end of the file */
+    bool map(size_t _size);
+
+    /* Drop all records, expects m_mutex to be locked */
+    void reset();
+
+    bool append(int _fd, size_t _offset, const Key& _key, const char* _data, size_t _size,
+                uint32_t _checksum, uint32_t _flags);
+
+    std::string m_path;
+    size_t m_maxSize;
+
+    int m_fd = -1;
+    size_t m_fileSize = 0;
+
+    std::shared_ptr<const Mapping> m_map;
+
+    // Set while compact() writes the new pack file
+    bool m_compacting = false;
+    // Incremented by reset() and remove(), compact() discards its result
+    // when it changed
+    uint32_t m_resets = 0;
+
+    // Most recently used entries at the front
+    EntryList m_entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> m_index;
+
+    mutable std::mutex m_mutex;
+};
+
+}
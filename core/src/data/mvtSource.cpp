@@ -16,6 +16,15 @@ MVTSource::MVTSource(const std::string& _name, const std::string& _urlTemplate,
 }
 
 std::shared_ptr<TileData> MVTSource::parse(const TileTask& _task, const MapProjection& _projection) const {
+    return parseLayers(_task, nullptr);
+}
+
+std::shared_ptr<TileData> MVTSource::parseSelected(const TileTask& _task, const MapProjection& _projection,
+                                                   TileDataSelection& _selection) const {
+    return parseLayers(_task, &_selection);
+}
+
+std::shared_ptr<TileData> MVTSource::parseLayers(const TileTask& _task, TileDataSelection* _selection) const {
 
     auto tileData = std::make_shared<TileData>();
 
@@ -23,10 +32,18 @@ std::shared_ptr<TileData> MVTSource::parse(const TileTask& _task, const MapProje
 
     protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
     PbfParser::ParserContext ctx(m_id);
+    ctx.selection = _selection;
 
     while(item.next()) {
         if(item.tag == 3) {
-            tileData->layers.push_back(PbfParser::getLayer(ctx, item.getMessage()));
+            auto layerMsg = item.getMessage();
+
+            // Skip layers that are not used by any DataLayer of the scene
+            if (_selection && !_selection->selectLayer(PbfParser::getLayerName(layerMsg))) {
+                _selection->bytesSkipped += layerMsg.getEnd() - layerMsg.getData();
+                continue;
+            }
+            tileData->layers.push_back(PbfParser::getLayer(ctx, layerMsg));
         } else {
             item.skip();
         }
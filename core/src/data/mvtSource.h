@@ -11,6 +11,11 @@ protected:
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
+    virtual std::shared_ptr<TileData> parseSelected(const TileTask& _task, const MapProjection& _projection,
+                                                    TileDataSelection& _selection) const override;
+
+    std::shared_ptr<TileData> parseLayers(const TileTask& _task, TileDataSelection* _selection) const;
+
 public:
 
     MVTSource(const std::string& _name, const std::string& _urlTemplate,
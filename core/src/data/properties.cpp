@@ -1,45 +1,267 @@
 #include "propertyItem.h"
 #include "properties.h"
+
+#include "log.h"
+
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace Tangram {
 
+namespace {
+
+// Key names are stored in chunks which are never moved or freed,
+// so that keyName() can read them without locking. Chunk n holds
+// KEY_CHUNK_SIZE << n keys, so that the table can grow to all 32 bit ids.
+const size_t KEY_CHUNK_SIZE = 1024;
+const size_t MAX_KEY_CHUNKS = 23;
+
+// Slot value of an empty IdIndex slot, slots hold key id + 1 otherwise
+const uint32_t EMPTY_SLOT = 0;
+
+// Returns the chunk of @_id and sets @_index to its position in the chunk
+size_t keyChunk(uint32_t _id, size_t& _index) {
+    uint64_t n = uint64_t(_id) / KEY_CHUNK_SIZE + 1;
+    size_t chunk = 0;
+    while (n >>= 1) { chunk++; }
+
+    _index = _id - KEY_CHUNK_SIZE * ((uint64_t(1) << chunk) - 1);
+    return chunk;
+}
+
+// Open addressing hash index from key names to ids. Readers probe it
+// without locking: a slot is only set once, after the name of its id
+// was stored, and a full index is replaced by a larger copy instead of
+// being rehashed in place.
+struct IdIndex {
+    explicit IdIndex(size_t _capacity) : mask(_capacity - 1), slots(new std::atomic<uint32_t>[_capacity]) {
+        for (size_t i = 0; i < _capacity; i++) { slots[i] = EMPTY_SLOT; }
+    }
+
+    size_t mask;
+    std::unique_ptr<std::atomic<uint32_t>[]> slots;
+};
+
+struct KeyTable {
+    // Guards inserts, lookups do not lock
+    std::mutex mutex;
+    uint64_t count = 0;
+    std::atomic<IdIndex*> index;
+    // Replaced indices are kept since readers may still probe them
+    std::vector<std::unique_ptr<IdIndex>> indices;
+    std::atomic<std::string*> chunks[MAX_KEY_CHUNKS];
+
+    KeyTable() {
+        for (auto& chunk : chunks) { chunk = nullptr; }
+
+        indices.emplace_back(new IdIndex(KEY_CHUNK_SIZE * 2));
+        index = indices.back().get();
+
+        // Reserve id 0 for the empty key
+        chunks[0] = new std::string[KEY_CHUNK_SIZE];
+        insert(0, std::hash<std::string>()(""));
+        count = 1;
+    }
+
+    const std::string& name(uint32_t _id) const {
+        size_t i;
+        size_t chunk = keyChunk(_id, i);
+        return chunks[chunk].load(std::memory_order_acquire)[i];
+    }
+
+    bool find(const std::string& _key, size_t _hash, uint32_t& _id) const {
+        const IdIndex* idx = index.load(std::memory_order_acquire);
+
+        for (size_t i = _hash & idx->mask;; i = (i + 1) & idx->mask) {
+            uint32_t slot = idx->slots[i].load(std::memory_order_acquire);
+            if (slot == EMPTY_SLOT) { return false; }
+            if (name(slot - 1) == _key) {
+                _id = slot - 1;
+                return true;
+            }
+        }
+    }
+
+    // Must be called with the mutex held, after the name of @_id was stored
+    void insert(uint32_t _id, size_t _hash) {
+        IdIndex* idx = index.load(std::memory_order_relaxed);
+
+        // Keep the load factor at most 1/2
+        if ((count + 1) * 2 > idx->mask + 1) {
+            auto grown = std::make_unique<IdIndex>((idx->mask + 1) * 2);
+            std::hash<std::string> hash;
+            for (size_t i = 0; i <= idx->mask; i++) {
+                uint32_t slot = idx->slots[i].load(std::memory_order_relaxed);
+                if (slot != EMPTY_SLOT) { place(*grown, slot, hash(name(slot - 1))); }
+            }
+            idx = grown.get();
+            indices.push_back(std::move(grown));
+            index.store(idx, std::memory_order_release);
+        }
+
+        place(*idx, _id + 1, _hash);
+    }
+
+    static void place(IdIndex& _idx, uint32_t _slot, size_t _hash) {
+        size_t i = _hash & _idx.mask;
+        while (_idx.slots[i].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+            i = (i + 1) & _idx.mask;
+        }
+        _idx.slots[i].store(_slot, std::memory_order_release);
+    }
+};
+
+KeyTable& keyTable() {
+    static KeyTable s_table;
+    return s_table;
+}
+
+}
+
+namespace {
+
+// Returns the id of @_key, interning it unless @_maxKeys keys are interned
+uint32_t internKey(const std::string& _key, uint64_t _maxKeys) {
+
+    auto& table = keyTable();
+    size_t hash = std::hash<std::string>()(_key);
+
+    uint32_t id;
+    if (table.find(_key, hash, id)) { return id; }
+
+    std::lock_guard<std::mutex> lock(table.mutex);
+
+    // Another thread may have added the key meanwhile
+    if (table.find(_key, hash, id)) { return id; }
+
+    if (table.count >= _maxKeys) { return Properties::NO_KEY_ID; }
+
+    // Ids must not alias, filters and style function caches compare them.
+    // Slots store id + 1, so UINT32_MAX cannot be used.
+    if (table.count >= UINT32_MAX) {
+        LOGE("Too many property keys");
+        std::abort();
+    }
+
+    id = table.count;
+    size_t index;
+    size_t chunk = keyChunk(id, index);
+
+    if (!table.chunks[chunk]) {
+        table.chunks[chunk].store(new std::string[KEY_CHUNK_SIZE << chunk], std::memory_order_release);
+    }
+    table.chunks[chunk].load(std::memory_order_relaxed)[index] = _key;
+
+    table.insert(id, hash);
+    table.count++;
+
+    return id;
+}
+
+}
+
+constexpr uint32_t Properties::NO_KEY_ID;
+constexpr uint32_t Properties::MAX_DATA_KEYS;
+
+uint32_t Properties::keyId(const std::string& _key) {
+    return internKey(_key, UINT32_MAX);
+}
+
+uint32_t Properties::dataKeyId(const std::string& _key) {
+    return internKey(_key, MAX_DATA_KEYS);
+}
+
+bool Properties::findKeyId(const std::string& _key, uint32_t& _keyId) {
+
+    auto& table = keyTable();
+
+    return table.find(_key, std::hash<std::string>()(_key), _keyId);
+}
+
+const std::string& Properties::keyName(uint32_t _keyId) {
+    return keyTable().name(_keyId);
+}
+
+uint32_t Properties::KeyCache::keyId(const std::string& _key) {
+    auto it = ids.find(_key);
+    if (it != ids.end()) { return it->second; }
+
+    uint32_t id = Properties::dataKeyId(_key);
+    ids.emplace(_key, id);
+    return id;
+}
+
 Properties::Properties() : sourceId(0) {}
 
 Properties::~Properties() {}
 
 Properties& Properties::operator=(Properties&& _other) {
     props = std::move(_other.props);
+    m_unindexed = std::move(_other.m_unindexed);
+    m_unindexedKeys = std::move(_other.m_unindexedKeys);
     sourceId = _other.sourceId;
     return *this;
 }
 
 void Properties::setSorted(std::vector<Item>&& _items) {
     props = std::move(_items);
+    m_unindexed.clear();
+    m_unindexedKeys.clear();
 }
 
 const Value& Properties::get(const std::string& key) const {
 
-    const auto it = std::find_if(props.begin(), props.end(),
-                                 [&](const auto& item) {
-                                     return item.key == key;
-                                 });
-    if (it == props.end()) {
-        return NOT_A_VALUE;
+    // Keys that were never interned can only be found by name
+    uint32_t id;
+    if (!findKeyId(key, id)) {
+        return getUnindexed(key);
+    }
+
+    return get(id);
+}
+
+const Value& Properties::getUnindexed(const std::string& _key) const {
+    for (size_t i = 0; i < m_unindexedKeys.size(); i++) {
+        if (m_unindexedKeys[i] == _key) { return m_unindexed[i].value; }
     }
+    return NOT_A_VALUE;
+}
 
-    // auto it = std::lower_bound(props.begin(), props.end(), key,
-    //                            [](auto& item, auto& key) {
-    //                                return keyComparator(item.key, key);
-    //                            });
-    // if (it == props.end() || it->key != key) {
-    //     return NOT_FOUND;
-    // }
+uint64_t Properties::keySignature() const {
+    if (!m_unindexed.empty()) { return ~uint64_t(0); }
+
+    uint64_t signature = 0;
+    for (auto& item : props) { signature |= keyBit(item.key); }
+    return signature;
+}
+
+const Value& Properties::get(uint32_t keyId) const {
+
+    const auto it = std::lower_bound(props.begin(), props.end(), keyId,
+                                     [](const auto& item, uint32_t id) {
+                                         return item.key < id;
+                                     });
+
+    if (it == props.end() || it->key != keyId) {
+        // The key may have been interned after the item was added
+        if (!m_unindexed.empty()) { return getUnindexed(keyName(keyId)); }
+        return NOT_A_VALUE;
+    }
 
     return it->value;
 }
 
-void Properties::clear() { props.clear(); }
+void Properties::clear() {
+    props.clear();
+    m_unindexed.clear();
+    m_unindexedKeys.clear();
+}
 
 bool Properties::contains(const std::string& key) const {
     return !get(key).is<none_type>();
@@ -115,30 +337,38 @@ void Properties::sort() {
 }
 
 void Properties::set(std::string key, std::string value) {
-
-    auto it = std::lower_bound(props.begin(), props.end(), key,
-                               [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
-                               });
-
-    if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), std::move(value));
-    } else {
-        it->value = std::move(value);
-    }
+    setValue(std::move(key), Value(std::move(value)));
 }
 
 void Properties::set(std::string key, double value) {
+    setValue(std::move(key), Value(value));
+}
+
+void Properties::setValue(std::string key, Value value) {
+
+    uint32_t id = dataKeyId(key);
 
-    auto it = std::lower_bound(props.begin(), props.end(), key,
-                               [](auto& item, auto& key) {
-                                   return keyComparator(item.key, key);
+    if (id == NO_KEY_ID) {
+        for (size_t i = 0; i < m_unindexedKeys.size(); i++) {
+            if (m_unindexedKeys[i] == key) {
+                m_unindexed[i].value = std::move(value);
+                return;
+            }
+        }
+        m_unindexed.emplace_back(NO_KEY_ID, std::move(value));
+        m_unindexedKeys.push_back(std::move(key));
+        return;
+    }
+
+    auto it = std::lower_bound(props.begin(), props.end(), id,
+                               [](auto& item, uint32_t id) {
+                                   return item.key < id;
                                });
 
-    if (it == props.end() || it->key != key) {
-        props.emplace(it, std::move(key), value);
+    if (it == props.end() || it->key != id) {
+        props.emplace(it, id, std::move(value));
     } else {
-        it->value = value;
+        it->value = std::move(value);
     }
 }
 
@@ -146,9 +376,15 @@ std::string Properties::toJson() const {
 
     std::string json = "{ ";
 
-    for (const auto& item : props) {
-        bool last = (&item == &props.back());
-        json += "\"" + item.key + "\": \"" + asString(item.value) + (last ? "\"" : "\",");
+    auto append = [&](const std::string& _key, const Value& _value) {
+        if (json.size() > 2) { json += ","; }
+        json += "\"" + _key + "\": \"" + asString(_value) + "\"";
+    };
+
+    for (const auto& item : props) { append(item.name(), item.value); }
+
+    for (size_t i = 0; i < m_unindexed.size(); i++) {
+        append(m_unindexedKeys[i], m_unindexed[i].value);
     }
 
     json += " }";
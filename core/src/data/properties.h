@@ -1,7 +1,9 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace Tangram {
 
@@ -22,6 +24,9 @@ struct Properties {
 
     const Value& get(const std::string& key) const;
 
+    /* Lookup by interned key, see keyId() */
+    const Value& get(uint32_t keyId) const;
+
     void sort();
 
     void clear();
@@ -47,6 +52,10 @@ struct Properties {
     void set(std::string key, std::string value);
     void set(std::string key, double value);
 
+    /* Sets the value of @key like set(), for values of any type */
+    void setValue(std::string key, Value value);
+
+    /* @_items must be ordered by key id */
     void setSorted(std::vector<Item>&& _items);
 
     // template <typename... Args> void set(std::string key, Args&&... args) {
@@ -54,19 +63,62 @@ struct Properties {
     //     sort();
     // }
 
+    /* Returns the items with an interned key. Items of data keys that
+     * dataKeyId() did not intern are not included. */
     const std::vector<Item>& items() const { return props; }
 
+    /* Returns the union of keyBit() of all keys, all bits are set when
+     * a key is not interned */
+    uint64_t keySignature() const;
+
+    /* Returns the bit of @_keyId in a key signature. Key ids are assigned in
+     * order of first use, so the first 64 keys map to distinct bits. */
+    static uint64_t keyBit(uint32_t _keyId) { return uint64_t(1) << (_keyId % 64); }
+
     int32_t sourceId;
 
-    static bool keyComparator(const std::string& a, const std::string& b) {
-        if (a.size() == b.size()) {
-            return a < b;
-        } else {
-            return a.size() < b.size();
-        }
-    }
+    /* Key id of properties whose key is not interned */
+    static constexpr uint32_t NO_KEY_ID = UINT32_MAX;
+
+    /* Number of keys after which dataKeyId() stops interning new keys */
+    static constexpr uint32_t MAX_DATA_KEYS = 1 << 16;
+
+    /* Returns a process-wide unique id for @_key. Items store only this id
+     * instead of the key string. Keys that are already interned are looked
+     * up without locking. Interned keys are never released, use this for
+     * keys of the scene and dataKeyId() for keys read from tile data. */
+    static uint32_t keyId(const std::string& _key);
+
+    /* Like keyId(), but returns NO_KEY_ID instead of interning @_key once
+     * MAX_DATA_KEYS keys are interned. Properties keep the key strings of
+     * such items, so that arbitrary data does not grow the key table
+     * without bound. */
+    static uint32_t dataKeyId(const std::string& _key);
+
+    /* Sets @_keyId to the id of @_key and returns true when @_key was
+     * interned by keyId(), without adding it otherwise. Does not lock. */
+    static bool findKeyId(const std::string& _key, uint32_t& _keyId);
+
+    /* Returns the key for an id returned by keyId() */
+    static const std::string& keyName(uint32_t _keyId);
+
+    /* Local cache of dataKeyId() lookups, e.g. for the features of one layer,
+     * so that each distinct key is hashed and compared in the global key
+     * table only once */
+    struct KeyCache {
+        uint32_t keyId(const std::string& _key);
+
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
 private:
+    const Value& getUnindexed(const std::string& _key) const;
+
     std::vector<Item> props;
+
+    // Items of keys without id and their keys, in order of insertion
+    std::vector<Item> m_unindexed;
+    std::vector<std::string> m_unindexedKeys;
 };
 
 }
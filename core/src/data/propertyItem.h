@@ -1,19 +1,25 @@
 #pragma once
 
+#include "data/properties.h"
 #include "util/variant.h"
 
 namespace Tangram {
 
 struct PropertyItem {
-    PropertyItem(std::string _key, Value _value) :
-        key(std::move(_key)), value(std::move(_value)) {}
+    PropertyItem(uint32_t _key, Value _value) :
+        key(_key), value(std::move(_value)) {}
 
-    std::string key;
+    PropertyItem(const std::string& _key, Value _value) :
+        key(Properties::keyId(_key)), value(std::move(_value)) {}
+
+    // Interned key, see Properties::keyId()
+    uint32_t key;
     Value value;
+
+    const std::string& name() const { return Properties::keyName(key); }
+
     bool operator<(const PropertyItem& _rhs) const {
-        return key.size() == _rhs.key.size()
-            ? key < _rhs.key
-            : key.size() < _rhs.key.size();
+        return key < _rhs.key;
     }
 };
 
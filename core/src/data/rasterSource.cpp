@@ -134,9 +134,11 @@ std::shared_ptr<TileTask> RasterSource::createTask(TileID _tileId, int _subTask)
 void RasterSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
                                 TileTaskCb _cb) {
 
-    if (_task->isCanceled()) { return; }
-
-    TileID tileID = _task->tileId();
+    // Let the callback release the download
+    if (_task->isCanceled()) {
+        _cb.func(std::move(_task));
+        return;
+    }
 
     auto rawDataRef = std::make_shared<std::vector<char>>();
     std::swap(*rawDataRef, _rawData);
@@ -144,12 +146,12 @@ void RasterSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<Ti
     auto& task = static_cast<DownloadTileTask&>(*_task);
     task.rawTileData = rawDataRef;
 
-    _cb.func(std::move(_task));
+    cachePut(task, rawDataRef);
 
-    cachePut(tileID, rawDataRef);
+    _cb.func(std::move(_task));
 }
 
-bool RasterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
+bool RasterSource::startDownload(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
 
     std::string url(constructURL(_task->tileId()));
 
@@ -168,6 +170,9 @@ bool RasterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _c
     if (!status) {
         auto& task = static_cast<RasterTileTask&>(*copyTask);
         task.m_texture = m_emptyTexture;
+    } else if (copyTask->isCanceled()) {
+        // Canceled while the request was started, see DataSource::startDownload()
+        cancelUrlRequest(url);
     }
 
     return status;
@@ -30,6 +30,8 @@ protected:
     virtual void onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
                               TileTaskCb _cb) override;
 
+    virtual bool startDownload(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
+
 public:
 
     RasterSource(const std::string& _name, const std::string& _urlTemplate,
@@ -38,8 +40,6 @@ public:
 
     virtual std::shared_ptr<TileTask> createTask(TileID _tile, int _subTask) override;
 
-    virtual bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
-
     virtual void clearRasters() override;
     virtual void clearRaster(const TileID& id) override;
     virtual bool isRaster() const override { return true; }
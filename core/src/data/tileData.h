@@ -2,6 +2,7 @@
 
 #include "glm/vec3.hpp"
 #include "data/properties.h"
+#include "util/arena.h"
 
 #include <vector>
 #include <string>
@@ -53,6 +54,15 @@ Data heirarchy:
   A <Point> is 3 32-bit floating point coordinates representing x, y, and z
   (in that order).
 
+Memory:
+
+  Geometry and feature containers use an <ArenaAllocator>. TileWorkers parse
+  and build each tile with an <Arena> set as current, so that the many small
+  per-feature vectors are bump-allocated into a few contiguous chunks. The
+  TileData shares ownership of that Arena, its memory is released together
+  with the TileData. Containers created without a current Arena (e.g. for
+  Markers) use the heap.
+
 */
 namespace Tangram {
 
@@ -65,9 +75,9 @@ enum GeometryType {
 
 typedef glm::vec3 Point;
 
-typedef std::vector<Point> Line;
+typedef std::vector<Point, ArenaAllocator<Point>> Line;
 
-typedef std::vector<Line> Polygon;
+typedef std::vector<Line, ArenaAllocator<Line>> Polygon;
 
 struct Feature {
     Feature() {}
@@ -75,9 +85,9 @@ struct Feature {
 
     GeometryType geometryType = GeometryType::polygons;
 
-    std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+    std::vector<Point, ArenaAllocator<Point>> points;
+    std::vector<Line, ArenaAllocator<Line>> lines;
+    std::vector<Polygon, ArenaAllocator<Polygon>> polygons;
 
     Properties props;
 };
@@ -88,14 +98,36 @@ struct Layer {
 
     std::string name;
 
-    std::vector<Feature> features;
+    std::vector<Feature, ArenaAllocator<Feature>> features;
 
 };
 
 struct TileData {
 
+    // Memory of the layers, declared first to be released last
+    std::shared_ptr<Arena> arena = Arena::currentOwner();
+
     std::vector<Layer> layers;
 
 };
 
+/* Lets a <DataSource> skip the layers and features of a tile which are not
+ * used by the current scene, see <TileBuilder::DataLayerSelection>
+ */
+struct TileDataSelection {
+
+    virtual ~TileDataSelection() {}
+
+    /* Returns whether features of the layer @_name may be used */
+    virtual bool selectLayer(const std::string& _name) const = 0;
+
+    /* Returns whether @_feature of layer @_layer may be used. Only properties
+     * and geometryType of the feature are set at this point */
+    virtual bool selectFeature(const std::string& _layer, const Feature& _feature) = 0;
+
+    // Bytes of encoded tile data that were skipped and decoded
+    size_t bytesSkipped = 0;
+    size_t bytesDecoded = 0;
+};
+
 }
@@ -6,10 +6,12 @@
 #include "tile/tile.h"
 #include "tile/tileCache.h"
 #include "gl/primitives.h"
+#include "gl/renderState.h"
 #include "view/view.h"
 #include "gl.h"
 #include "gl/error.h"
 
+#include <chrono>
 #include <deque>
 #include <ctime>
 
@@ -20,6 +22,9 @@
 namespace Tangram {
 
 static float s_lastUpdateTime = 0.0;
+static float s_lastLabelTime = 0.0;
+
+static std::chrono::steady_clock::time_point s_startLabelTime;
 
 static clock_t s_startFrameTime = 0,
     s_endFrameTime = 0,
@@ -43,6 +48,19 @@ void FrameInfo::endUpdate() {
 
 }
 
+void FrameInfo::beginLabels() {
+    s_startLabelTime = std::chrono::steady_clock::now();
+}
+
+void FrameInfo::endLabels() {
+    std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - s_startLabelTime;
+    s_lastLabelTime = duration.count();
+}
+
+float FrameInfo::lastLabelTime() {
+    return s_lastLabelTime;
+}
+
 void FrameInfo::beginFrame() {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
@@ -113,6 +131,14 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
             debuginfos.push_back("tile cache size:"
                                  + std::to_string(_tileManager.getTileCache()->getMemoryUsage() / 1024) + "kb");
             debuginfos.push_back("tile size:" + std::to_string(memused / 1024) + "kb");
+            auto prefetch = _tileManager.prefetchStats();
+            debuginfos.push_back("tile prefetch:" + std::to_string(prefetch.requested) + ", hit rate:"
+                                 + to_string_with_precision(prefetch.hitRate(), 2));
+            auto pool = rs.bufferPoolStats();
+            debuginfos.push_back("gl buffer pool:" + std::to_string(pool.used / 1024) + "/"
+                                 + std::to_string(pool.capacity / 1024) + "kb, fragmentation:"
+                                 + to_string_with_precision(pool.fragmentation(), 2));
+            debuginfos.push_back("staging pool:" + std::to_string(StagingPool::stats().pooled / 1024) + "kb");
             debuginfos.push_back("avg frame cpu time:" + to_string_with_precision(avgTimeCpu, 2) + "ms");
             debuginfos.push_back("avg frame render time:" + to_string_with_precision(avgTimeRender, 2) + "ms");
             debuginfos.push_back("avg frame update time:" + to_string_with_precision(avgTimeUpdate, 2) + "ms");
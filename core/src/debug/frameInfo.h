@@ -13,6 +13,12 @@ struct FrameInfo {
 
     static void endUpdate();
 
+    static void beginLabels();
+    static void endLabels();
+
+    /* Duration of the last label update in ms, always recorded */
+    static float lastLabelTime();
+
     static void draw(RenderState& rs, const View& _view, TileManager& _tileManager);
 };
 
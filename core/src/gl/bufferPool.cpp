@@ -0,0 +1,295 @@
+#include "bufferPool.h"
+
+#include "gl/renderState.h"
+#include "log.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+namespace Tangram {
+
+BufferPool::Stats& BufferPool::Stats::operator+=(const Stats& _other) {
+    pages += _other.pages;
+    allocations += _other.allocations;
+    capacity += _other.capacity;
+    used += _other.used;
+    freeBlocks += _other.freeBlocks;
+    largestFreeBlock = std::max(largestFreeBlock, _other.largestFreeBlock);
+    return *this;
+}
+
+BufferPool::BufferPool(GLenum _target, size_t _pageSize, size_t _alignment)
+    : m_target(_target),
+      m_pageSize(_pageSize),
+      m_alignment(_alignment) {}
+
+void BufferPool::bind(RenderState& rs, GLuint _buffer) {
+    if (m_target == GL_ELEMENT_ARRAY_BUFFER) {
+        rs.indexBuffer(_buffer);
+    } else {
+        rs.vertexBuffer(_buffer);
+    }
+}
+
+void BufferPool::unbind(RenderState& rs, GLuint _buffer) {
+    if (m_target == GL_ELEMENT_ARRAY_BUFFER) {
+        rs.indexBufferUnset(_buffer);
+    } else {
+        rs.vertexBufferUnset(_buffer);
+    }
+}
+
+bool BufferPool::allocate(Page& _page, size_t _size, Allocation& _allocation) {
+
+    for (auto it = _page.freeBlocks.begin(); it != _page.freeBlocks.end(); ++it) {
+        if (it->size < _size) { continue; }
+
+        _allocation.buffer = _page.buffer;
+        _allocation.offset = it->offset;
+        _allocation.size = _size;
+
+        it->offset += _size;
+        it->size -= _size;
+        if (it->size == 0) { _page.freeBlocks.erase(it); }
+
+        _page.used += _size;
+        _page.allocations++;
+        return true;
+    }
+    return false;
+}
+
+BufferPool::Allocation BufferPool::allocate(RenderState& rs, size_t _size) {
+
+    Allocation allocation;
+    if (_size == 0) { return allocation; }
+
+    size_t size = (_size + m_alignment - 1) / m_alignment * m_alignment;
+
+    for (auto& page : m_pages) {
+        if (page.size - page.used >= size && allocate(page, size, allocation)) {
+            return allocation;
+        }
+    }
+
+    // Meshes larger than a page get a page of their own
+    Page page;
+    page.size = std::max(size, m_pageSize);
+    page.used = 0;
+    page.allocations = 0;
+    page.freeBlocks.push_back({ 0, page.size });
+
+    GL::genBuffers(1, &page.buffer);
+    bind(rs, page.buffer);
+    GL::bufferData(m_target, page.size, nullptr, GL_STATIC_DRAW);
+
+    m_pages.push_back(std::move(page));
+    allocate(m_pages.back(), size, allocation);
+
+    return allocation;
+}
+
+void BufferPool::free(RenderState& rs, const Allocation& _allocation) {
+
+    if (!_allocation) { return; }
+
+    auto pageIt = std::find_if(m_pages.begin(), m_pages.end(),
+                               [&](const Page& p) { return p.buffer == _allocation.buffer; });
+
+    if (pageIt == m_pages.end()) {
+        LOGW("Freeing range of unknown buffer %d", _allocation.buffer);
+        return;
+    }
+
+    auto& page = *pageIt;
+    auto& blocks = page.freeBlocks;
+    size_t offset = _allocation.offset;
+    size_t size = _allocation.size;
+
+    auto it = std::lower_bound(blocks.begin(), blocks.end(), offset,
+                               [](const Block& b, size_t o) { return b.offset < o; });
+
+    // Merge with following block
+    if (it != blocks.end() && offset + size == it->offset) {
+        it->offset = offset;
+        it->size += size;
+    } else {
+        it = blocks.insert(it, { offset, size });
+    }
+    // Merge with preceding block
+    if (it != blocks.begin()) {
+        auto prev = it - 1;
+        if (prev->offset + prev->size == it->offset) {
+            prev->size += it->size;
+            blocks.erase(it);
+        }
+    }
+
+    page.used -= size;
+    page.allocations--;
+
+    if (page.allocations == 0) {
+        // Keep one empty page of the default size around for reuse
+        bool keep = page.size == m_pageSize;
+        for (auto& p : m_pages) {
+            if (&p != &page && p.allocations == 0) { keep = false; }
+        }
+        if (!keep) { deletePage(rs, pageIt - m_pages.begin()); }
+    }
+}
+
+void BufferPool::upload(RenderState& rs, const Allocation& _allocation, const void* _data) {
+
+    if (!_allocation) { return; }
+
+    bind(rs, _allocation.buffer);
+    GL::bufferSubData(m_target, _allocation.offset, _allocation.size, _data);
+}
+
+void BufferPool::deletePage(RenderState& rs, size_t _index) {
+
+    GLuint buffer = m_pages[_index].buffer;
+    unbind(rs, buffer);
+    GL::deleteBuffers(1, &buffer);
+
+    m_pages.erase(m_pages.begin() + _index);
+}
+
+void BufferPool::dispose(RenderState& rs) {
+    while (!m_pages.empty()) {
+        deletePage(rs, m_pages.size() - 1);
+    }
+}
+
+void BufferPool::invalidate() {
+    m_pages.clear();
+}
+
+BufferPool::Stats BufferPool::stats() const {
+
+    Stats stats;
+    stats.pages = m_pages.size();
+
+    for (auto& page : m_pages) {
+        stats.allocations += page.allocations;
+        stats.capacity += page.size;
+        stats.used += page.used;
+        stats.freeBlocks += page.freeBlocks.size();
+
+        for (auto& block : page.freeBlocks) {
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, block.size);
+        }
+    }
+    return stats;
+}
+
+constexpr size_t StagingPool::MIN_BLOCK_SIZE;
+constexpr size_t StagingPool::MAX_BLOCK_SIZE;
+constexpr size_t StagingPool::MAX_POOLED_SIZE;
+
+namespace {
+
+constexpr size_t NUM_SIZE_CLASSES = 11;
+
+static_assert((StagingPool::MIN_BLOCK_SIZE << (NUM_SIZE_CLASSES - 1)) == StagingPool::MAX_BLOCK_SIZE,
+              "Size classes must cover MIN_BLOCK_SIZE to MAX_BLOCK_SIZE");
+
+struct StagingStorage {
+    std::mutex mutex;
+    std::array<std::vector<GLbyte*>, NUM_SIZE_CLASSES> blocks;
+    StagingPool::Stats stats;
+};
+
+// Never destroyed, meshes may be released during static destruction
+StagingStorage& storage() {
+    static auto* s = new StagingStorage();
+    return *s;
+}
+
+size_t sizeClass(size_t _size) {
+    size_t c = 0;
+    while ((StagingPool::MIN_BLOCK_SIZE << c) < _size) { c++; }
+    return c;
+}
+
+}
+
+GLbyte* StagingPool::acquire(size_t _size) {
+
+    auto& s = storage();
+
+    if (_size > MAX_BLOCK_SIZE) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stats.live += _size;
+        s.stats.misses++;
+        return new GLbyte[_size];
+    }
+
+    size_t c = sizeClass(_size);
+    size_t blockSize = MIN_BLOCK_SIZE << c;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stats.live += blockSize;
+
+        auto& blocks = s.blocks[c];
+        if (!blocks.empty()) {
+            GLbyte* data = blocks.back();
+            blocks.pop_back();
+            s.stats.pooled -= blockSize;
+            s.stats.hits++;
+            return data;
+        }
+        s.stats.misses++;
+    }
+    return new GLbyte[blockSize];
+}
+
+void StagingPool::release(GLbyte* _data, size_t _size) {
+
+    if (!_data) { return; }
+
+    auto& s = storage();
+
+    if (_size > MAX_BLOCK_SIZE) {
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.stats.live -= _size;
+        }
+        delete[] _data;
+        return;
+    }
+
+    size_t c = sizeClass(_size);
+    size_t blockSize = MIN_BLOCK_SIZE << c;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.stats.live -= blockSize;
+
+        if (s.stats.pooled + blockSize <= MAX_POOLED_SIZE) {
+            s.blocks[c].push_back(_data);
+            s.stats.pooled += blockSize;
+            return;
+        }
+    }
+    delete[] _data;
+}
+
+StagingPool::Stats StagingPool::stats() {
+    auto& s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.stats;
+}
+
+void StagingPool::clear() {
+    auto& s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    for (auto& blocks : s.blocks) {
+        for (auto* data : blocks) { delete[] data; }
+        blocks.clear();
+    }
+    s.stats.pooled = 0;
+}
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "gl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+class RenderState;
+
+/* BufferPool
+ *
+ * Suballocates ranges of large, shared GL buffer objects ('pages'), so that
+ * static meshes do not need to create one vertex and index buffer each.
+ * Ranges are handed out first-fit from a sorted list of free blocks per page;
+ * freed ranges are merged with their neighbours.
+ *
+ * A BufferPool must only be used on the GL thread.
+ */
+class BufferPool {
+
+public:
+
+    struct Allocation {
+        GLuint buffer = 0;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+
+        explicit operator bool() const { return buffer != 0; }
+    };
+
+    struct Stats {
+        size_t pages = 0;
+        size_t allocations = 0;
+        // Bytes of GL buffer storage
+        size_t capacity = 0;
+        // Bytes handed out to allocations
+        size_t used = 0;
+        size_t freeBlocks = 0;
+        size_t largestFreeBlock = 0;
+
+        // 0 when all free space is contiguous, towards 1 when it is
+        // scattered over many small blocks
+        float fragmentation() const {
+            size_t free = capacity - used;
+            return free == 0 ? 0.f : 1.f - float(largestFreeBlock) / free;
+        }
+
+        Stats& operator+=(const Stats& _other);
+    };
+
+    // _target is GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+    BufferPool(GLenum _target, size_t _pageSize, size_t _alignment = 4);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Returns an empty Allocation when _size is 0
+    Allocation allocate(RenderState& rs, size_t _size);
+
+    void free(RenderState& rs, const Allocation& _allocation);
+
+    // Upload _allocation.size bytes from _data into the allocated range
+    void upload(RenderState& rs, const Allocation& _allocation, const void* _data);
+
+    // Delete all pages
+    void dispose(RenderState& rs);
+
+    // Forget all pages without deleting them, for when the GL context was lost
+    void invalidate();
+
+    Stats stats() const;
+
+private:
+
+    struct Block {
+        size_t offset;
+        size_t size;
+    };
+
+    struct Page {
+        GLuint buffer;
+        size_t size;
+        size_t used;
+        size_t allocations;
+        // Sorted by offset
+        std::vector<Block> freeBlocks;
+    };
+
+    bool allocate(Page& _page, size_t _size, Allocation& _allocation);
+    void bind(RenderState& rs, GLuint _buffer);
+    void unbind(RenderState& rs, GLuint _buffer);
+    void deletePage(RenderState& rs, size_t _index);
+
+    GLenum m_target;
+    size_t m_pageSize;
+    size_t m_alignment;
+
+    std::vector<Page> m_pages;
+};
+
+/* StagingPool
+ *
+ * Recycles the CPU-side memory that meshes compile their vertices and indices
+ * into before they are uploaded. Blocks are kept in power-of-two size classes
+ * up to MAX_BLOCK_SIZE, larger requests go straight to the heap. Thread-safe:
+ * meshes are compiled on worker threads and uploaded on the GL thread.
+ */
+class StagingPool {
+
+public:
+
+    static constexpr size_t MIN_BLOCK_SIZE = 1 << 12;
+    static constexpr size_t MAX_BLOCK_SIZE = 1 << 22;
+    // Upper limit for memory held by the pool while not in use
+    static constexpr size_t MAX_POOLED_SIZE = 16 << 20;
+
+    struct Stats {
+        // Bytes currently handed out
+        size_t live = 0;
+        // Bytes held for reuse
+        size_t pooled = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    // Get a block of at least _size bytes
+    static GLbyte* acquire(size_t _size);
+
+    // Return a block obtained from acquire(_size)
+    static void release(GLbyte* _data, size_t _size);
+
+    static Stats stats();
+
+    // Free all pooled blocks
+    static void clear();
+};
+
+}
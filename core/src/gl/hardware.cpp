@@ -15,6 +15,7 @@ namespace Hardware {
 bool supportsMapBuffer = false;
 bool supportsVAOs = false;
 bool supportsTextureNPOT = false;
+bool supportsElementIndexUint = false;
 
 uint32_t maxTextureSize = 0;
 uint32_t maxCombinedTextureUnits = 0;
@@ -55,8 +56,14 @@ void loadExtensions() {
     supportsVAOs = isAvailable("vertex_array_object");
     supportsTextureNPOT = isAvailable("texture_non_power_of_two");
 
+    // 32 bit indices are core in desktop GL and GLES 3
+    auto version = (const char*) GL::getString(GL_VERSION);
+    bool isGLES2 = version && strstr(version, "OpenGL ES 2") != nullptr;
+    supportsElementIndexUint = !isGLES2 || isAvailable("element_index_uint");
+
     LOG("Driver supports map buffer: %d", supportsMapBuffer);
     LOG("Driver supports vaos: %d", supportsVAOs);
+    LOG("Driver supports 32 bit indices: %d", supportsElementIndexUint);
 
     // find extension symbols if needed
     initGLExtensions();
@@ -8,6 +8,7 @@ namespace Hardware {
 extern bool supportsMapBuffer;
 extern bool supportsVAOs;
 extern bool supportsTextureNPOT;
+extern bool supportsElementIndexUint;
 extern uint32_t maxTextureSize;
 extern uint32_t maxCombinedTextureUnits;
 
@@ -41,32 +41,33 @@ MeshBase::~MeshBase() {
     auto generation = m_generation;
     auto glVertexBuffer = m_glVertexBuffer;
     auto glIndexBuffer = m_glIndexBuffer;
+    auto vertexPool = m_vertexPool;
+    auto vertexAllocation = m_vertexAllocation;
+    auto indexAllocation = m_indexAllocation;
 
     m_disposer([=](RenderState& rs) mutable {
         // Deleting a index/array buffer being used ends up setting up the current vertex/index buffer to 0
         // after the driver finishes using it, force the render state to be 0 for vertex/index buffer
         if (rs.isValidGeneration(generation)) {
-            if (glVertexBuffer) {
-                rs.vertexBufferUnset(glVertexBuffer);
-                GL::deleteBuffers(1, &glVertexBuffer);
-            }
-            if (glIndexBuffer) {
-                rs.indexBufferUnset(glIndexBuffer);
-                GL::deleteBuffers(1, &glIndexBuffer);
+            if (vertexPool) {
+                // Return the ranges of the shared buffers
+                vertexPool->free(rs, vertexAllocation);
+                rs.indexBufferPool().free(rs, indexAllocation);
+            } else {
+                if (glVertexBuffer) {
+                    rs.vertexBufferUnset(glVertexBuffer);
+                    GL::deleteBuffers(1, &glVertexBuffer);
+                }
+                if (glIndexBuffer) {
+                    rs.indexBufferUnset(glIndexBuffer);
+                    GL::deleteBuffers(1, &glIndexBuffer);
+                }
             }
             vaos.dispose();
         }
     });
 
-
-    if (m_glVertexData) {
-        delete[] m_glVertexData;
-    }
-
-    if (m_glIndexData) {
-        delete[] m_glIndexData;
-    }
-
+    releaseStagingData();
 }
 
 void MeshBase::setVertexLayout(std::shared_ptr<VertexLayout> _vertexLayout) {
@@ -127,35 +128,46 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
 
 void MeshBase::upload(RenderState& rs) {
 
-    // Generate vertex buffer, if needed
-    if (m_glVertexBuffer == 0) {
-        GL::genBuffers(1, &m_glVertexBuffer);
-    }
-
-    // Buffer vertex data
     int vertexBytes = m_nVertices * m_vertexLayout->getStride();
 
-    rs.vertexBuffer(m_glVertexBuffer);
-    GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
-
-    delete[] m_glVertexData;
-    m_glVertexData = nullptr;
+    if (m_hint == GL_STATIC_DRAW) {
+        // Suballocate from the shared buffers, the data is never updated
+        m_vertexPool = &rs.vertexBufferPool(*m_vertexLayout);
+        m_vertexAllocation = m_vertexPool->allocate(rs, vertexBytes);
+        m_vertexPool->upload(rs, m_vertexAllocation, m_glVertexData);
+        m_glVertexBuffer = m_vertexAllocation.buffer;
+
+        if (m_glIndexData) {
+            auto& indexPool = rs.indexBufferPool();
+            m_indexAllocation = indexPool.allocate(rs, m_nIndices * indexSize());
+            indexPool.upload(rs, m_indexAllocation, m_glIndexData);
+            m_glIndexBuffer = m_indexAllocation.buffer;
+        }
+    } else {
+        // Generate vertex buffer, if needed
+        if (m_glVertexBuffer == 0) {
+            GL::genBuffers(1, &m_glVertexBuffer);
+        }
 
-    if (m_glIndexData) {
+        // Buffer vertex data
+        rs.vertexBuffer(m_glVertexBuffer);
+        GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
 
-        if (m_glIndexBuffer == 0) {
-            GL::genBuffers(1, &m_glIndexBuffer);
-        }
+        if (m_glIndexData) {
 
-        // Buffer element index data
-        rs.indexBuffer(m_glIndexBuffer);
+            if (m_glIndexBuffer == 0) {
+                GL::genBuffers(1, &m_glIndexBuffer);
+            }
 
-        GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, m_hint);
+            // Buffer element index data
+            rs.indexBuffer(m_glIndexBuffer);
 
-        delete[] m_glIndexData;
-        m_glIndexData = nullptr;
+            GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * indexSize(), m_glIndexData, m_hint);
+        }
     }
 
+    releaseStagingData();
+
     m_generation = rs.generation();
     m_disposer = Disposer(rs);
 
@@ -184,7 +196,8 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
     if (Hardware::supportsVAOs) {
         if (!m_vaos.isInitialized()) {
             // Capture vao state
-            m_vaos.initialize(rs, _shader, m_vertexOffsets, *m_vertexLayout, m_glVertexBuffer, m_glIndexBuffer);
+            m_vaos.initialize(rs, _shader, m_vertexOffsets, *m_vertexLayout, m_glVertexBuffer, m_glIndexBuffer,
+                              m_vertexAllocation.offset);
         }
     } else {
         // Bind buffers for drawing
@@ -205,7 +218,7 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
 
         if (!Hardware::supportsVAOs) {
             // Enable vertex attribs via vertex layout object
-            size_t byteOffset = vertexOffset * m_vertexLayout->getStride();
+            size_t byteOffset = m_vertexAllocation.offset + vertexOffset * m_vertexLayout->getStride();
             m_vertexLayout->enable(rs,  _shader, byteOffset);
         } else {
             // Bind the corresponding vao relative to the current offset
@@ -214,8 +227,8 @@ bool MeshBase::draw(RenderState& rs, ShaderProgram& _shader) {
 
         // Draw as elements or arrays
         if (nIndices > 0) {
-            GL::drawElements(m_drawMode, nIndices, GL_UNSIGNED_SHORT,
-                             (void*)(indiceOffset * sizeof(GLushort)));
+            GL::drawElements(m_drawMode, nIndices, m_indexType,
+                             (void*)(m_indexAllocation.offset + indiceOffset * indexSize()));
         } else if (nVertices > 0) {
             GL::drawArrays(m_drawMode, 0, nVertices);
         }
@@ -236,6 +249,9 @@ bool MeshBase::checkValidity(RenderState& rs) {
         m_isUploaded = false;
         m_glVertexBuffer = 0;
         m_glIndexBuffer = 0;
+        m_vertexPool = nullptr;
+        m_vertexAllocation = {};
+        m_indexAllocation = {};
         m_vaos = {};
 
         m_generation = rs.generation();
@@ -247,46 +263,58 @@ bool MeshBase::checkValidity(RenderState& rs) {
 }
 
 size_t MeshBase::bufferSize() const {
-    return m_nVertices * m_vertexLayout->getStride() + m_nIndices * sizeof(GLushort);
+    return m_nVertices * m_vertexLayout->getStride() + m_nIndices * indexSize();
 }
 
 // Add indices by collecting them into batches to draw as much as
 // possible in one draw call.  The indices must be shifted by the
 // number of vertices that are present in the current batch.
-size_t MeshBase::compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
-                                const std::vector<uint16_t>& _indices, size_t _offset) {
-
+template<class I>
+static size_t copyIndices(I* _dst, const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
+                          const std::vector<uint16_t>& _indices, size_t _maxVertices,
+                          std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets) {
 
-    GLushort* dst = m_glIndexData + _offset;
     size_t curVertices = 0;
     size_t src = 0;
 
-    if (m_vertexOffsets.empty()) {
-        m_vertexOffsets.emplace_back(0, 0);
+    if (_vertexOffsets.empty()) {
+        _vertexOffsets.emplace_back(0, 0);
     } else {
-        curVertices = m_vertexOffsets.back().second;
+        curVertices = _vertexOffsets.back().second;
     }
 
     for (auto& p : _offsets) {
         size_t nIndices = p.first;
         size_t nVertices = p.second;
 
-        if (curVertices + nVertices > MAX_INDEX_VALUE) {
-            m_vertexOffsets.emplace_back(0, 0);
+        if (curVertices + nVertices > _maxVertices) {
+            _vertexOffsets.emplace_back(0, 0);
             curVertices = 0;
         }
-        for (size_t i = 0; i < nIndices; i++, dst++) {
-            *dst = _indices[src++] + curVertices;
+        for (size_t i = 0; i < nIndices; i++, _dst++) {
+            *_dst = _indices[src++] + curVertices;
         }
 
-        auto& offset = m_vertexOffsets.back();
+        auto& offset = _vertexOffsets.back();
         offset.first += nIndices;
         offset.second += nVertices;
 
         curVertices += nVertices;
     }
 
-    return _offset + src;
+    return src;
+}
+
+size_t MeshBase::compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
+                                const std::vector<uint16_t>& _indices, size_t _offset) {
+
+    if (m_indexType == GL_UNSIGNED_INT) {
+        auto* dst = reinterpret_cast<GLuint*>(m_glIndexData) + _offset;
+        return _offset + copyIndices(dst, _offsets, _indices, UINT32_MAX, m_vertexOffsets);
+    }
+
+    auto* dst = reinterpret_cast<GLushort*>(m_glIndexData) + _offset;
+    return _offset + copyIndices(dst, _offsets, _indices, MAX_INDEX_VALUE, m_vertexOffsets);
 }
 
 void MeshBase::setDirty(GLintptr _byteOffset, GLsizei _byteSize) {
@@ -305,4 +333,29 @@ void MeshBase::setDirty(GLintptr _byteOffset, GLsizei _byteSize) {
     }
 }
 
+void MeshBase::allocateStagingData() {
+
+    m_glVertexData = StagingPool::acquire(m_nVertices * m_vertexLayout->getStride());
+
+    m_indexType = (m_nVertices > MAX_INDEX_VALUE && Hardware::supportsElementIndexUint)
+        ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+
+    if (m_nIndices > 0) {
+        m_glIndexData = StagingPool::acquire(m_nIndices * indexSize());
+    }
+}
+
+void MeshBase::releaseStagingData() {
+
+    if (m_glVertexData) {
+        StagingPool::release(m_glVertexData, m_nVertices * m_vertexLayout->getStride());
+        m_glVertexData = nullptr;
+    }
+
+    if (m_glIndexData) {
+        StagingPool::release(m_glIndexData, m_nIndices * indexSize());
+        m_glIndexData = nullptr;
+    }
+}
+
 }
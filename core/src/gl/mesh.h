@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gl.h"
+#include "gl/bufferPool.h"
 #include "gl/disposer.h"
 #include "vertexLayout.h"
 #include "vao.h"
@@ -95,7 +96,22 @@ protected:
     size_t m_nIndices;
     GLuint m_glIndexBuffer;
     // Compiled  indices for upload
-    GLushort* m_glIndexData = nullptr;
+    GLbyte* m_glIndexData = nullptr;
+
+    // GL_UNSIGNED_INT when the mesh has more vertices than GLushort can
+    // index and the driver supports it, the mesh is then drawn without
+    // splitting it at MAX_INDEX_VALUE vertices
+    GLenum m_indexType = GL_UNSIGNED_SHORT;
+
+    size_t indexSize() const {
+        return m_indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
+    }
+
+    // Static meshes are suballocated from the shared buffers of the RenderState,
+    // m_glVertexBuffer and m_glIndexBuffer then refer to the pool pages
+    BufferPool* m_vertexPool = nullptr;
+    BufferPool::Allocation m_vertexAllocation;
+    BufferPool::Allocation m_indexAllocation;
 
     GLenum m_drawMode;
     GLenum m_hint;
@@ -115,6 +131,12 @@ protected:
                           const std::vector<uint16_t>& _indices, size_t _offset);
 
     void setDirty(GLintptr _byteOffset, GLsizei _byteSize);
+
+    // Get compile buffers from the StagingPool and choose the index type
+    void allocateStagingData();
+
+    // Return compile buffers to the StagingPool
+    void releaseStagingData();
 };
 
 template<class T>
@@ -189,7 +211,7 @@ void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
     }
 
     int stride = m_vertexLayout->getStride();
-    m_glVertexData = new GLbyte[m_nVertices * stride];
+    allocateStagingData();
 
     size_t offset = 0;
     for (auto& m : _meshes) {
@@ -204,8 +226,6 @@ void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
     assert(offset == m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
-
         size_t offset = 0;
         for (auto& m : _meshes) {
             offset = compileIndices(m.offsets, m.indices, offset);
@@ -223,14 +243,13 @@ void Mesh<T>::compile(const MeshData<T>& _mesh) {
     m_nIndices = _mesh.indices.size();
 
     int stride = m_vertexLayout->getStride();
-    m_glVertexData = new GLbyte[m_nVertices * stride];
+    allocateStagingData();
 
     std::memcpy(m_glVertexData,
                 (const GLbyte*)_mesh.vertices.data(),
                 m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
         compileIndices(_mesh.offsets, _mesh.indices, 0);
     }
 
@@ -14,7 +14,8 @@
 
 namespace Tangram {
 
-RenderState::RenderState() {
+RenderState::RenderState()
+    : m_indexBufferPool(GL_ELEMENT_ARRAY_BUFFER, INDEX_POOL_PAGE_SIZE) {
 
     m_blending = { 0, false };
     m_culling = { 0, false };
@@ -45,6 +46,11 @@ RenderState::~RenderState() {
     deleteQuadIndexBuffer();
     deleteDefaultPointTexture();
 
+    for (auto& pool : m_vertexBufferPools) {
+        pool.second->dispose(*this);
+    }
+    m_indexBufferPool.dispose(*this);
+
 }
 
 void RenderState::invalidate() {
@@ -75,10 +81,36 @@ void RenderState::invalidate() {
 }
 
 void RenderState::increaseGeneration() {
+    // Buffers of the previous context are gone
+    for (auto& pool : m_vertexBufferPools) {
+        pool.second->invalidate();
+    }
+    m_indexBufferPool.invalidate();
+
     generateQuadIndexBuffer();
     m_validGeneration++;
 }
 
+BufferPool& RenderState::vertexBufferPool(const VertexLayout& _layout) {
+    auto& pool = m_vertexBufferPools[_layout.getStride()];
+    if (!pool) {
+        pool.reset(new BufferPool(GL_ARRAY_BUFFER, VERTEX_POOL_PAGE_SIZE));
+    }
+    return *pool;
+}
+
+BufferPool& RenderState::indexBufferPool() {
+    return m_indexBufferPool;
+}
+
+BufferPool::Stats RenderState::bufferPoolStats() const {
+    BufferPool::Stats stats = m_indexBufferPool.stats();
+    for (auto& pool : m_vertexBufferPools) {
+        stats += pool.second->stats();
+    }
+    return stats;
+}
+
 bool RenderState::isValidGeneration(int _generation) {
     return _generation == m_validGeneration;
 }
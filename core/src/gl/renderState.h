@@ -1,14 +1,18 @@
 #pragma once
 
 #include "gl.h"
+#include "gl/bufferPool.h"
 #include "gl/disposer.h"
 #include "util/jobQueue.h"
 #include <array>
+#include <memory>
+#include <unordered_map>
 
 namespace Tangram {
 
 class Disposer;
 class Texture;
+class VertexLayout;
 
 class RenderState {
 
@@ -18,6 +22,10 @@ public:
 
     static constexpr size_t MAX_QUAD_VERTICES = 16384;
 
+    static constexpr size_t VERTEX_POOL_PAGE_SIZE = 1 << 21;
+
+    static constexpr size_t INDEX_POOL_PAGE_SIZE = 1 << 19;
+
     RenderState();
     ~RenderState();
 
@@ -98,6 +106,15 @@ public:
 
     Texture* getDefaultPointTexture();
 
+    // Shared GL buffers for static meshes, one vertex pool per vertex stride.
+    // Pools are not tied to VertexLayout instances, which are recreated with
+    // each scene.
+    BufferPool& vertexBufferPool(const VertexLayout& _layout);
+
+    BufferPool& indexBufferPool();
+
+    BufferPool::Stats bufferPoolStats() const;
+
     std::array<GLuint, MAX_ATTRIBUTES> attributeBindings = { { 0 } };
 
     JobQueue jobQueue;
@@ -115,6 +132,9 @@ private:
     void deleteDefaultPointTexture();
     void generateDefaultPointTexture();
 
+    std::unordered_map<GLint, std::unique_ptr<BufferPool>> m_vertexBufferPools;
+    BufferPool m_indexBufferPool;
+
     struct {
         GLboolean enabled;
         bool set;
@@ -8,7 +8,8 @@
 namespace Tangram {
 
 void Vao::initialize(RenderState& rs, ShaderProgram& _program, const std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
-               VertexLayout& _layout, GLuint _vertexBuffer, GLuint _indexBuffer) {
+               VertexLayout& _layout, GLuint _vertexBuffer, GLuint _indexBuffer,
+               size_t _vertexByteOffset) {
 
     m_glVAOs.resize(_vertexOffsets.size());
 
@@ -37,7 +38,7 @@ void Vao::initialize(RenderState& rs, ShaderProgram& _program, const std::vector
         }
 
         // Enable vertex layout on the specified locations
-        _layout.enable(locations, vertexOffset * _layout.getStride());
+        _layout.enable(locations, _vertexByteOffset + vertexOffset * _layout.getStride());
 
         vertexOffset += nVerts;
     }
@@ -15,7 +15,8 @@ class Vao {
 public:
 
     void initialize(RenderState& rs, ShaderProgram& _program, const std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
-                    VertexLayout& _layout, GLuint _vertexBuffer, GLuint _indexBuffer);
+                    VertexLayout& _layout, GLuint _vertexBuffer, GLuint _indexBuffer,
+                    size_t _vertexByteOffset = 0);
     bool isInitialized();
     void bind(unsigned int _index);
     void unbind();
@@ -10,8 +10,16 @@ namespace Tangram {
 
 using namespace LabelProperty;
 
+const float SpriteVertex::position_scale = 4.0f;
 const float SpriteVertex::alpha_scale = 65535.0f;
 const float SpriteVertex::texture_scale = 65535.0f;
+const float SpriteVertex::depth_scale = 32767.0f;
+
+glm::i16vec2 SpriteVertex::packPosition(glm::vec2 _position, glm::i16vec2 _offset) {
+    glm::vec2 pos = _position * position_scale + glm::vec2(_offset);
+
+    return glm::i16vec2(glm::clamp(pos, float(SHRT_MIN), float(SHRT_MAX)));
+}
 
 SpriteLabel::SpriteLabel(Label::WorldTransform _transform, glm::vec2 _size, Label::Options _options,
                          float _extrudeScale, Texture* _texture, SpriteLabels& _labels, size_t _labelsPos)
@@ -70,12 +78,13 @@ bool SpriteLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState&
                     glm::vec4 projected = worldToClipSpace(_mvp, glm::vec4(positions[i], 0.f, 1.f));
                     if (projected.w <= 0.0f) { return false; }
 
-                        m_projected[i] = glm::vec3(projected) / projected.w;
+                        glm::vec3 ndc = glm::vec3(projected) / projected.w;
+                        m_depth[i] = ndc.z;
 
                         // from normalized device coordinates to screen space coordinate system
                         // top-left screen axis, y pointing down
-                        positions[i].x = 1 + m_projected[i].x;
-                        positions[i].y = 1 - m_projected[i].y;
+                        positions[i].x = 1 + ndc.x;
+                        positions[i].y = 1 - ndc.y;
                         positions[i] *= halfScreen;
                 }
 
@@ -83,16 +92,13 @@ bool SpriteLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState&
                 glm::vec4 projected = worldToClipSpace(_mvp, glm::vec4(p0, 0.f, 1.f));
                 if (projected.w <= 0.0f) { return false; }
 
-                m_projected[0] = glm::vec3(projected) / projected.w;
+                glm::vec2 ndc = glm::vec2(projected) / projected.w;
 
                 auto& position = m_screenTransform.position;
-                position.x = 1 + m_projected[0].x;
-                position.y = 1 - m_projected[0].y;
+                position.x = 1 + ndc.x;
+                position.y = 1 - ndc.y;
                 position *= halfScreen;
                 position += m_options.offset;
-
-                m_projected[1].x = _viewState.viewportSize.x;
-                m_projected[1].y = _viewState.viewportSize.y;
             }
 
             break;
@@ -150,11 +156,7 @@ void SpriteLabel::addVerticesToMesh() {
 
     auto& quad = m_labels.quads[m_labelsPos];
 
-    SpriteVertex::State state {
-        quad.color,
-        uint16_t(m_screenTransform.alpha * SpriteVertex::alpha_scale),
-        0,
-    };
+    uint16_t alpha = uint16_t(m_screenTransform.alpha * SpriteVertex::alpha_scale);
 
     auto& style = m_labels.m_style;
 
@@ -174,30 +176,23 @@ void SpriteLabel::addVerticesToMesh() {
         for (int i = 0; i < 4; i++) {
             SpriteVertex& vertex = quadVertices[i];
 
-            vertex.pos = m_projected[i];
+            vertex.pos = SpriteVertex::packPosition(m_screenTransform.positions[i]);
             vertex.uv = quad.quad[i].uv;
-            vertex.state = state;
+            vertex.color = quad.color;
+            vertex.alpha = alpha;
+            vertex.depth = int16_t(glm::clamp(m_depth[i], -1.f, 1.f) * SpriteVertex::depth_scale);
         }
 
     } else {
 
-        glm::vec2 pos = glm::vec2(m_projected[0]);
-        glm::vec2 scale = 2.0f / glm::vec2(m_projected[1]);
-        scale.y *= -1;
-
-        pos += m_options.offset * scale;
-
         for (int i = 0; i < 4; i++) {
             SpriteVertex& vertex = quadVertices[i];
 
-            glm::vec2 coord = pos + quad.quad[i].pos * scale;
-
-            vertex.pos.x = coord.x;
-            vertex.pos.y = coord.y;
-            vertex.pos.z = 0;
-
+            vertex.pos = SpriteVertex::packPosition(m_screenTransform.position, quad.quad[i].pos);
             vertex.uv = quad.quad[i].uv;
-            vertex.state = state;
+            vertex.color = quad.color;
+            vertex.alpha = alpha;
+            vertex.depth = 0;
         }
     }
 }
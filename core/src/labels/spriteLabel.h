@@ -12,16 +12,20 @@ class PointStyle;
 class Texture;
 
 struct SpriteVertex {
-    glm::vec3 pos;
+    glm::i16vec2 pos; // screen position, see position_scale
     glm::u16vec2 uv;
-    struct State {
-        uint32_t color;
-        uint16_t alpha;
-        uint16_t scale;
-    } state;
+    uint32_t color;
+    uint16_t alpha;
+    int16_t depth; // normalized device depth of flat sprites
 
+    static const float position_scale;
     static const float alpha_scale;
     static const float texture_scale;
+    static const float depth_scale;
+
+    /* Packs a screen position plus an offset in packed units. Positions far
+     * outside of the screen are clamped to the range of pos. */
+    static glm::i16vec2 packPosition(glm::vec2 _position, glm::i16vec2 _offset = {0, 0});
 };
 
 class SpriteLabel : public Label {
@@ -50,12 +54,13 @@ private:
 
     float m_extrudeScale;
 
-    std::array<glm::vec3, 4> m_projected;
+    // Depth of the quad corners of flat sprites
+    std::array<float, 4> m_depth;
 };
 
 struct SpriteQuad {
     struct {
-        glm::vec2 pos;
+        glm::i16vec2 pos; // offset from the label position, see SpriteVertex::position_scale
         glm::u16vec2 uv;
     } quad[4];
     // TODO color and stroke must not be stored per quad
@@ -70,6 +75,11 @@ public:
         quads = std::move(_quads);
     }
 
+    // Memory of the labels and their quads, see Tile::getMemoryUsage()
+    size_t bufferSize() const override {
+        return quads.size() * sizeof(SpriteQuad) + m_labels.size() * sizeof(SpriteLabel);
+    }
+
     // TODO: hide within class if needed
     const PointStyle& m_style;
     std::vector<SpriteQuad> quads;
@@ -19,6 +19,11 @@ public:
 
     void setQuads(std::vector<GlyphQuad>&& _quads, std::bitset<FontContext::max_textures> _atlasRefs);
 
+    // Memory of the labels and their quads, see Tile::getMemoryUsage()
+    size_t bufferSize() const override {
+        return quads.size() * sizeof(GlyphQuad) + m_labels.size() * sizeof(TextLabel);
+    }
+
     std::vector<GlyphQuad> quads;
     const TextStyle& style;
 
@@ -2,9 +2,11 @@
 
 namespace Tangram {
 
-DataLayer::DataLayer(SceneLayer _layer, const std::string& _source, const std::vector<std::string>& _collections) :
+DataLayer::DataLayer(SceneLayer _layer, const std::string& _source, const std::vector<std::string>& _collections,
+                     float _simplify) :
     SceneLayer(std::move(_layer)),
     m_source(_source),
-    m_collections(_collections) {}
+    m_collections(_collections),
+    m_simplify(_simplify) {}
 
 }
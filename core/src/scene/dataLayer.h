@@ -12,12 +12,17 @@ class DataLayer : public SceneLayer {
     std::string m_source;
     std::vector<std::string> m_collections;
 
+    // Tolerance in pixels for simplifying line and polygon geometry, 0 to disable
+    float m_simplify;
+
 public:
 
-    DataLayer(SceneLayer _layer, const std::string& _source, const std::vector<std::string>& _collections);
+    DataLayer(SceneLayer _layer, const std::string& _source, const std::vector<std::string>& _collections,
+              float _simplify = 0);
 
     const auto& source() const { return m_source; }
     const auto& collections() const { return m_collections; }
+    float simplify() const { return m_simplify; }
 
 };
 
@@ -9,6 +9,9 @@
 #include "platform.h"
 #include "drawRuleWarnings.h"
 #include "util/hash.h"
+#include "util/memoCache.h"
+#include "data/properties.h"
+#include "data/tileData.h"
 #include "log.h"
 
 #include <algorithm>
@@ -113,10 +116,156 @@ void DrawRule::logGetError(StyleParamKey _expectedKey, const StyleParam& _param)
     LOGE("wrong type '%d'for StyleParam '%d'", _param.value.which(), _expectedKey);
 }
 
+// Clear the cache when it holds more results
+static const size_t MAX_MATCH_RESULTS = 512;
+
+static void collectFilterKeys(const Filter& _filter, std::vector<std::pair<uint32_t, bool>>& _keys,
+                              bool& _cacheable) {
+
+    auto addKey = [&](const std::string& _key, bool _exists) {
+        _keys.emplace_back(Properties::keyId(_key), _exists);
+    };
+
+    auto& data = _filter.data;
+    switch (data.which()) {
+    case Filter::Data::type<Filter::OperatorAll>::value:
+    case Filter::Data::type<Filter::OperatorAny>::value:
+    case Filter::Data::type<Filter::OperatorNone>::value:
+        for (auto& operand : _filter.operands()) {
+            collectFilterKeys(operand, _keys, _cacheable);
+        }
+        break;
+    case Filter::Data::type<Filter::EqualitySet>::value: {
+        auto& f = data.get<Filter::EqualitySet>();
+        if (f.keyword == FilterKeyword::undefined) { addKey(f.key, false); }
+        break;
+    }
+    case Filter::Data::type<Filter::Equality>::value: {
+        auto& f = data.get<Filter::Equality>();
+        if (f.keyword == FilterKeyword::undefined) { addKey(f.key, false); }
+        break;
+    }
+    case Filter::Data::type<Filter::Range>::value: {
+        auto& f = data.get<Filter::Range>();
+        if (f.keyword == FilterKeyword::undefined) { addKey(f.key, false); }
+        break;
+    }
+    case Filter::Data::type<Filter::Existence>::value:
+        addKey(data.get<Filter::Existence>().key, true);
+        break;
+    case Filter::Data::type<Filter::Function>::value:
+        // JS functions may read any property
+        _cacheable = false;
+        break;
+    default:
+        break;
+    }
+}
+
+DrawRuleMergeSet::LayerKeys& DrawRuleMergeSet::layerKeys(const SceneLayer& _layer) {
+
+    auto it = m_layerKeys.find(&_layer);
+    if (it != m_layerKeys.end()) { return it->second; }
+
+    auto& layerKeys = m_layerKeys[&_layer];
+
+    std::vector<std::pair<uint32_t, bool>> keys;
+    std::vector<const SceneLayer*> layers = { &_layer };
+
+    while (!layers.empty()) {
+        auto* layer = layers.back();
+        layers.pop_back();
+
+        collectFilterKeys(layer->filter(), keys, layerKeys.cacheable);
+
+        for (auto& sublayer : layer->sublayers()) { layers.push_back(&sublayer); }
+    }
+
+    // A key that is tested for its value is not only tested for existence
+    std::sort(keys.begin(), keys.end());
+    for (auto& key : keys) {
+        if (!layerKeys.keys.empty() && layerKeys.keys.back().id == key.first) {
+            layerKeys.keys.back().exists &= key.second;
+        } else {
+            layerKeys.keys.push_back({ key.first, key.second });
+        }
+    }
+
+    return layerKeys;
+}
+
+void DrawRuleMergeSet::matchArgs(const LayerKeys& _keys, StyleContext& _ctx) {
+
+    m_matchArgs.clear();
+    m_matchArgs.push_back(_ctx.getKeyword(FilterKeyword::zoom));
+    m_matchArgs.push_back(_ctx.getKeyword(FilterKeyword::geometry));
+
+    for (auto& key : _keys.keys) {
+        auto& value = _ctx.getProperty(key.id);
+        if (key.exists) {
+            m_matchArgs.push_back(value.is<none_type>() ? Value() : Value(1.0));
+        } else {
+            m_matchArgs.push_back(value);
+        }
+    }
+}
+
 bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
 
     _ctx.setFeature(_feature);
+
+    // Reject features without any of the properties the layer filter
+    // requires before looking up the cache
+    if (!_layer.filterProgram().mayMatch(_ctx.keySignature())) {
+        m_matchedRules.clear();
+        m_matchedLayers.clear();
+        return false;
+    }
+
+    if (!m_matchCacheEnabled) { return matchLayers(_feature, _layer, _ctx); }
+
+    auto& keys = layerKeys(_layer);
+    if (!keys.cacheable) { return matchLayers(_feature, _layer, _ctx); }
+
+    // Give up on layers whose features rarely share filter properties
+    if (!keys.window.lookup()) {
+        keys.cacheable = false;
+        return matchLayers(_feature, _layer, _ctx);
+    }
+
+    matchArgs(keys, _ctx);
+
+    size_t hash = 0;
+    hash_combine(hash, &_layer);
+    for (auto& arg : m_matchArgs) { hashValue(hash, arg); }
+
+    auto it = m_matchCache.find(hash);
+    if (it != m_matchCache.end() &&
+        it->second.layer == &_layer &&
+        it->second.args == m_matchArgs) {
+
+        keys.window.hit();
+        m_matchCacheStats.hits++;
+
+        m_matchedRules = it->second.rules;
+        m_matchedLayers = it->second.layers;
+        return it->second.matched;
+    }
+
+    m_matchCacheStats.misses++;
+
+    bool matched = matchLayers(_feature, _layer, _ctx);
+
+    limitMemoResults(m_matchCache, MAX_MATCH_RESULTS);
+    m_matchCache[hash] = { &_layer, m_matchArgs, matched, m_matchedRules, m_matchedLayers };
+
+    return matched;
+}
+
+bool DrawRuleMergeSet::matchLayers(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
+
     m_matchedRules.clear();
+    m_matchedLayers.clear();
     m_queuedLayers.clear();
 
     // If uber layer is marked not visible return immediately
@@ -125,7 +274,7 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
     }
 
     // If the first filter doesn't match, return immediately
-    if (!_layer.filter().eval(_feature, _ctx)) { return false; }
+    if (!_layer.filterProgram().eval(_feature, _ctx)) { return false; }
 
     m_queuedLayers.push_back(&_layer);
 
@@ -138,6 +287,7 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
 
         // Merge rules from layer into accumulated set
         mergeRules(layer);
+        m_matchedLayers.push_back(&layer);
 
         // Push each of the layer's matching sublayers onto the stack
         for (const auto& sublayer : layer.sublayers()) {
@@ -146,7 +296,7 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
                 continue;
             }
 
-            if (sublayer.filter().eval(_feature, _ctx)) {
+            if (sublayer.filterProgram().eval(_feature, _ctx)) {
                 m_queuedLayers.push_back(&sublayer);
             }
         }
@@ -161,6 +311,24 @@ void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
     // If no rules matched the feature, return immediately
     if (!match(_feature, _layer, _ctx)) { return; }
 
+    buildRules(_feature, _ctx, _builder);
+}
+
+void DrawRuleMergeSet::apply(const Feature& _feature, const std::vector<const SceneLayer*>& _layers,
+                             StyleContext& _ctx, TileBuilder& _builder) {
+
+    _ctx.setFeature(_feature);
+
+    m_matchedRules.clear();
+    for (auto* layer : _layers) {
+        mergeRules(*layer);
+    }
+
+    buildRules(_feature, _ctx, _builder);
+}
+
+void DrawRuleMergeSet::buildRules(const Feature& _feature, StyleContext& _ctx, TileBuilder& _builder) {
+
     // For each matched rule, find the style to be used and
     // build the feature with the rule's parameters
     for (auto& rule : m_matchedRules) {
@@ -183,7 +351,7 @@ void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
                 auto* outlineStyle = _builder.getStyleBuilder(styleName);
                 if (!outlineStyle) {
                     LOGN("Invalid style %s", styleName.c_str());
-                } else {
+                } else if (_builder.isSelected(*outlineStyle)) {
                     rule.isOutlineOnly = true;
                     outlineStyle->addFeature(_feature, rule);
                     rule.isOutlineOnly = false;
@@ -191,7 +359,9 @@ void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
             }
 
             // build feature with style
-            style->addFeature(_feature, rule);
+            if (_builder.isSelected(*style)) {
+                style->addFeature(_feature, rule);
+            }
         }
     }
 }
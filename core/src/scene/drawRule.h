@@ -1,10 +1,12 @@
 #pragma once
 
 #include "scene/styleParam.h"
+#include "util/memoCache.h"
 
 #include <vector>
 #include <set>
 #include <bitset>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -122,6 +124,11 @@ public:
     void apply(const Feature& _feature, const SceneLayer& _sceneLayer,
                StyleContext& _ctx, TileBuilder& _builder);
 
+    /* Apply the rules of _layers, the matchedLayers() of a previous match of
+     * @_feature, without evaluating the filters again */
+    void apply(const Feature& _feature, const std::vector<const SceneLayer*>& _layers,
+               StyleContext& _ctx, TileBuilder& _builder);
+
     bool evaluateRuleForContext(DrawRule& rule, StyleContext& ctx);
 
     // internal
@@ -132,11 +139,64 @@ public:
 
     auto& matchedRules() { return m_matchedRules; }
 
+    /* Layers merged into matchedRules(), in merge order */
+    const auto& matchedLayers() const { return m_matchedLayers; }
+
+    struct MatchCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    /* Matched rules are cached by the layer, the zoom, the geometry type and
+     * the values of the properties the layer filters test. The SceneLayers
+     * must outlive the DrawRuleMergeSet. */
+    const MatchCacheStats& matchCacheStats() const { return m_matchCacheStats; }
+
+    void setMatchCache(bool _enable) { m_matchCacheEnabled = _enable; }
+
 private:
-    // Reusable containers 'matchedRules' and 'queuedLayers'
+    bool matchLayers(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx);
+
+    /* Add _feature to the StyleBuilders of the matched rules */
+    void buildRules(const Feature& _feature, StyleContext& _ctx, TileBuilder& _builder);
+
+    // Properties tested by the filters of a layer and its sublayers
+    struct LayerKeys {
+        struct Key {
+            // See Properties::keyId
+            uint32_t id;
+            // Only tested for existence
+            bool exists;
+        };
+        std::vector<Key> keys;
+        // Layers with JS function filters are not cached
+        bool cacheable = true;
+        MemoWindow window;
+    };
+
+    struct MatchResult {
+        const SceneLayer* layer;
+        // Zoom, geometry type and the values of LayerKeys::keys
+        std::vector<Value> args;
+        bool matched;
+        std::vector<DrawRule> rules;
+        std::vector<const SceneLayer*> layers;
+    };
+
+    LayerKeys& layerKeys(const SceneLayer& _layer);
+    void matchArgs(const LayerKeys& _keys, StyleContext& _ctx);
+
+    // Reusable containers 'matchedRules', 'matchedLayers' and 'queuedLayers'
     std::vector<DrawRule> m_matchedRules;
+    std::vector<const SceneLayer*> m_matchedLayers;
     std::vector<const SceneLayer*> m_queuedLayers;
 
+    bool m_matchCacheEnabled = true;
+    std::unordered_map<const SceneLayer*, LayerKeys> m_layerKeys;
+    std::unordered_map<size_t, MatchResult> m_matchCache;
+    std::vector<Value> m_matchArgs;
+    MatchCacheStats m_matchCacheStats;
+
     // Container for dynamically-evaluated parameters
     StyleParam m_evaluated[StyleParamKeySize];
 
@@ -0,0 +1,303 @@
+#include "filterProgram.h"
+
+#include "data/tileData.h"
+#include "scene/styleContext.h"
+
+#include <bitset>
+#include <cmath>
+#include <limits>
+
+namespace Tangram {
+
+// Returns false when @_filter can pass for a feature without properties.
+// Otherwise @_signature is set to the keys of which a passing feature has
+// at least one.
+static bool requiredKeys(const Filter& _filter, uint64_t& _signature) {
+
+    auto& data = _filter.data;
+
+    switch (data.which()) {
+
+    case Filter::Data::type<Filter::OperatorAll>::value: {
+        // Any operand will do, take the one requiring the fewest keys
+        bool required = false;
+        for (auto& operand : data.get<Filter::OperatorAll>().operands) {
+            uint64_t signature = 0;
+            if (!requiredKeys(operand, signature)) { continue; }
+
+            if (!required || std::bitset<64>(signature).count() <
+                             std::bitset<64>(_signature).count()) {
+                _signature = signature;
+                required = true;
+            }
+        }
+        return required;
+    }
+    case Filter::Data::type<Filter::OperatorAny>::value: {
+        // Every operand must require some of the keys
+        auto& operands = data.get<Filter::OperatorAny>().operands;
+        if (operands.empty()) { return false; }
+
+        uint64_t signature = 0;
+        for (auto& operand : operands) {
+            uint64_t operandSignature = 0;
+            if (!requiredKeys(operand, operandSignature)) { return false; }
+            signature |= operandSignature;
+        }
+        _signature = signature;
+        return true;
+    }
+    case Filter::Data::type<Filter::EqualitySet>::value: {
+        auto& f = data.get<Filter::EqualitySet>();
+        if (f.keyword != FilterKeyword::undefined) { return false; }
+        _signature = Properties::keyBit(Properties::keyId(f.key));
+        return true;
+    }
+    case Filter::Data::type<Filter::Equality>::value: {
+        auto& f = data.get<Filter::Equality>();
+        if (f.keyword != FilterKeyword::undefined) { return false; }
+        _signature = Properties::keyBit(Properties::keyId(f.key));
+        return true;
+    }
+    case Filter::Data::type<Filter::Range>::value: {
+        auto& f = data.get<Filter::Range>();
+        if (f.keyword != FilterKeyword::undefined) { return false; }
+        _signature = Properties::keyBit(Properties::keyId(f.key));
+        return true;
+    }
+    case Filter::Data::type<Filter::Existence>::value: {
+        auto& f = data.get<Filter::Existence>();
+        if (!f.exists) { return false; }
+        _signature = Properties::keyBit(Properties::keyId(f.key));
+        return true;
+    }
+    default:
+        // 'none', functions and none_type
+        return false;
+    }
+}
+
+FilterProgram::FilterProgram(const Filter& _filter) {
+    compile(_filter);
+
+    if (!requiredKeys(_filter, m_keySignature)) {
+        m_keySignature = 0;
+    }
+}
+
+size_t FilterProgram::emit(Opcode _op, uint32_t _arg, FilterKeyword _keyword, uint32_t _key) {
+    m_code.push_back({ _op, _keyword, _key, _arg, PropertySlots::NONE });
+    return m_code.size() - 1;
+}
+
+void FilterProgram::linkProperties(PropertySlots& _slots) {
+    for (auto& in : m_code) {
+        switch (in.op) {
+        case Opcode::exists:
+        case Opcode::equal_number:
+        case Opcode::equal_string:
+        case Opcode::range:
+            if (in.keyword == FilterKeyword::undefined) { in.slot = _slots.slot(in.key); }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void FilterProgram::compileOperator(const std::vector<Filter>& _operands, Opcode _shortCircuit,
+                                    bool _empty) {
+
+    if (_operands.empty()) {
+        emit(Opcode::load, _empty);
+        return;
+    }
+
+    // Filters created by Filter::MatchAll etc. are already sorted
+    auto operands = _operands;
+    Filter::sort(operands);
+
+    std::vector<size_t> jumps;
+
+    for (size_t i = 0; i < operands.size(); i++) {
+        compile(operands[i]);
+
+        if (i + 1 < operands.size()) {
+            jumps.push_back(emit(_shortCircuit));
+        }
+    }
+
+    for (auto jump : jumps) {
+        m_code[jump].arg = m_code.size();
+    }
+}
+
+void FilterProgram::compileEquality(const std::string& _key, FilterKeyword _keyword, const Value& _value) {
+
+    uint32_t keyId = _keyword == FilterKeyword::undefined ? Properties::keyId(_key) : 0;
+
+    if (_value.is<double>()) {
+        m_numbers.push_back(_value.get<double>());
+        emit(Opcode::equal_number, m_numbers.size() - 1, _keyword, keyId);
+
+    } else if (_value.is<std::string>()) {
+        m_strings.push_back(_value.get<std::string>());
+        emit(Opcode::equal_string, m_strings.size() - 1, _keyword, keyId);
+
+    } else {
+        // Nothing is equal to an unset value
+        emit(Opcode::load, false);
+    }
+}
+
+void FilterProgram::compile(const Filter& _filter) {
+
+    auto& data = _filter.data;
+
+    switch (data.which()) {
+
+    case Filter::Data::type<Filter::OperatorAll>::value:
+        compileOperator(data.get<Filter::OperatorAll>().operands, Opcode::jump_if_false, true);
+        break;
+
+    case Filter::Data::type<Filter::OperatorAny>::value:
+        compileOperator(data.get<Filter::OperatorAny>().operands, Opcode::jump_if_true, false);
+        break;
+
+    case Filter::Data::type<Filter::OperatorNone>::value:
+        // none(a, b) == !any(a, b)
+        compileOperator(data.get<Filter::OperatorNone>().operands, Opcode::jump_if_true, false);
+        emit(Opcode::negate);
+        break;
+
+    case Filter::Data::type<Filter::EqualitySet>::value: {
+        auto& f = data.get<Filter::EqualitySet>();
+        std::vector<size_t> jumps;
+
+        if (f.values.empty()) {
+            emit(Opcode::load, false);
+            break;
+        }
+        for (size_t i = 0; i < f.values.size(); i++) {
+            compileEquality(f.key, f.keyword, f.values[i]);
+
+            if (i + 1 < f.values.size()) {
+                jumps.push_back(emit(Opcode::jump_if_true));
+            }
+        }
+        for (auto jump : jumps) {
+            m_code[jump].arg = m_code.size();
+        }
+        break;
+    }
+    case Filter::Data::type<Filter::Equality>::value: {
+        auto& f = data.get<Filter::Equality>();
+        compileEquality(f.key, f.keyword, f.value);
+        break;
+    }
+    case Filter::Data::type<Filter::Range>::value: {
+        auto& f = data.get<Filter::Range>();
+        uint32_t keyId = f.keyword == FilterKeyword::undefined ? Properties::keyId(f.key) : 0;
+
+        m_ranges.emplace_back(f.min, f.max);
+        emit(Opcode::range, m_ranges.size() - 1, f.keyword, keyId);
+        break;
+    }
+    case Filter::Data::type<Filter::Existence>::value: {
+        auto& f = data.get<Filter::Existence>();
+        emit(Opcode::exists, f.exists, FilterKeyword::undefined, Properties::keyId(f.key));
+        break;
+    }
+    case Filter::Data::type<Filter::Function>::value:
+        emit(Opcode::function, data.get<Filter::Function>().id);
+        break;
+
+    default:
+        // none_type: match everything
+        emit(Opcode::load, true);
+        break;
+    }
+}
+
+bool FilterProgram::eval(const Feature& _feature, StyleContext& _ctx) const {
+
+    // Use cached lookups only when the StyleContext was set up for this feature
+    bool cached = _ctx.feature() == &_feature;
+
+    if (m_keySignature != 0 &&
+        !mayMatch(cached ? _ctx.keySignature() : _feature.props.keySignature())) {
+        return false;
+    }
+
+    auto value = [&](const Instruction& _in) -> const Value& {
+        if (_in.keyword != FilterKeyword::undefined) {
+            return _ctx.getKeyword(_in.keyword);
+        }
+        return cached ? _ctx.getProperty(_in.slot, _in.key) : _feature.props.get(_in.key);
+    };
+
+    bool result = true;
+    size_t pc = 0;
+    const size_t end = m_code.size();
+
+    while (pc < end) {
+        const auto& in = m_code[pc++];
+
+        switch (in.op) {
+        case Opcode::load:
+            result = in.arg != 0;
+            break;
+
+        case Opcode::jump_if_true:
+            if (result) { pc = in.arg; }
+            break;
+
+        case Opcode::jump_if_false:
+            if (!result) { pc = in.arg; }
+            break;
+
+        case Opcode::negate:
+            result = !result;
+            break;
+
+        case Opcode::exists:
+            result = (!value(in).is<none_type>()) == (in.arg != 0);
+            break;
+
+        case Opcode::equal_number: {
+            auto& v = value(in);
+            if (v.is<double>()) {
+                double a = v.get<double>();
+                double b = m_numbers[in.arg];
+                result = a == b || std::fabs(a - b) <= std::numeric_limits<double>::epsilon();
+            } else {
+                result = false;
+            }
+            break;
+        }
+        case Opcode::equal_string: {
+            auto& v = value(in);
+            result = v.is<std::string>() && v.get<std::string>() == m_strings[in.arg];
+            break;
+        }
+        case Opcode::range: {
+            auto& v = value(in);
+            if (v.is<double>()) {
+                double num = v.get<double>();
+                auto& range = m_ranges[in.arg];
+                result = num >= range.first && num < range.second;
+            } else {
+                result = false;
+            }
+            break;
+        }
+        case Opcode::function:
+            result = _ctx.evalFilter(in.arg);
+            break;
+        }
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "scene/filters.h"
+#include "scene/propertySlots.h"
+
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+class StyleContext;
+struct Feature;
+
+/* FilterProgram
+ *
+ * A <Filter> tree compiled to a flat instruction stream. Operands of
+ * 'all', 'any' and 'none' are ordered by Filter::filterCost, so that
+ * cheap tests run first, and are evaluated with short-circuit jumps.
+ *
+ * Property keys are interned at compile time. Once the program is linked
+ * to the PropertySlots of its Scene, lookups of properties of the current
+ * Feature of the StyleContext go through the StyleContext cache and are
+ * shared by all filters and functions of the scene.
+ *
+ * Most filters can only pass for features that have at least one of a few
+ * properties, e.g. 'kind' for { kind: [road, path] }. The key signature
+ * holds the Properties::keyBit() of these keys, so that eval() can reject
+ * features without any of them - and thus the layer and its sublayers -
+ * with a single test.
+ */
+class FilterProgram {
+
+public:
+
+    // Matches all features
+    FilterProgram() {}
+
+    explicit FilterProgram(const Filter& _filter);
+
+    bool eval(const Feature& _feature, StyleContext& _ctx) const;
+
+    /* Assigns the slots of the property keys in @_slots */
+    void linkProperties(PropertySlots& _slots);
+
+    /* Returns false when a feature with @_keySignature (see
+     * Properties::keySignature) cannot pass the filter */
+    bool mayMatch(uint64_t _keySignature) const {
+        return m_keySignature == 0 || (m_keySignature & _keySignature) != 0;
+    }
+
+    /* Keys of which a passing feature has at least one, 0 when the filter
+     * can pass without properties - public for testing */
+    uint64_t keySignature() const { return m_keySignature; }
+
+    /* Number of instructions - public for testing */
+    size_t size() const { return m_code.size(); }
+
+private:
+
+    enum class Opcode : uint8_t {
+        load,           // result = arg
+        jump_if_true,   // if result: pc = arg
+        jump_if_false,  // if !result: pc = arg
+        negate,         // result = !result
+        exists,         // result = (value(key) is set) == arg
+        equal_number,   // result = value(key) == m_numbers[arg]
+        equal_string,   // result = value(key) == m_strings[arg]
+        range,          // result = value(key) in m_ranges[arg]
+        function,       // result = evalFilter(arg)
+    };
+
+    struct Instruction {
+        Opcode op;
+        FilterKeyword keyword;
+        // Property key id, see Properties::keyId
+        uint32_t key;
+        uint32_t arg;
+        uint32_t slot;
+    };
+
+    void compile(const Filter& _filter);
+    void compileOperator(const std::vector<Filter>& _operands, Opcode _shortCircuit, bool _empty);
+    void compileEquality(const std::string& _key, FilterKeyword _keyword, const Value& _value);
+
+    size_t emit(Opcode _op, uint32_t _arg = 0, FilterKeyword _keyword = FilterKeyword::undefined,
+                uint32_t _key = 0);
+
+    std::vector<Instruction> m_code;
+
+    uint64_t m_keySignature = 0;
+
+    std::vector<double> m_numbers;
+    std::vector<std::string> m_strings;
+    std::vector<std::pair<float, float>> m_ranges;
+};
+
+}
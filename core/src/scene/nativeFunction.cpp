@@ -0,0 +1,776 @@
+#include "nativeFunction.h"
+
+#include "data/properties.h"
+#include "data/tileData.h"
+#include "scene/filters.h"
+#include "scene/styleContext.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace Tangram {
+
+using JsValue = NativeFunction::JsValue;
+using Type = JsValue::Type;
+
+struct Token {
+    enum class Kind { end, number, string, identifier, punctuator };
+
+    Kind kind = Kind::end;
+    // Identifier, punctuator or the value of a string literal
+    std::string text;
+    double number = 0;
+    bool newlineBefore = false;
+};
+
+static const char* const s_punctuators[] = {
+    "===", "!==",
+    "==", "!=", "<=", ">=", "&&", "||",
+    "<", ">", "+", "-", "*", "/", "%", "!", "?", ":", "(", ")", "{", "}", "[", "]", ".", ";",
+};
+
+static bool isIdentifierStart(char _c) {
+    return (_c >= 'a' && _c <= 'z') || (_c >= 'A' && _c <= 'Z') || _c == '_' || _c == '$';
+}
+
+static bool isIdentifierPart(char _c) {
+    return isIdentifierStart(_c) || (_c >= '0' && _c <= '9');
+}
+
+static bool isSpace(char _c) {
+    return _c == ' ' || _c == '\t' || _c == '\r' || _c == '\n';
+}
+
+static bool isDigit(char _c) {
+    return _c >= '0' && _c <= '9';
+}
+
+static bool isHexDigit(char _c) {
+    return isDigit(_c) || (_c >= 'a' && _c <= 'f') || (_c >= 'A' && _c <= 'F');
+}
+
+static bool tokenizeNumber(const std::string& _source, size_t& _pos, Token& _token) {
+    size_t start = _pos;
+    const char* s = _source.c_str();
+
+    if (s[_pos] == '0' && (s[_pos + 1] == 'x' || s[_pos + 1] == 'X')) {
+        _pos += 2;
+        if (!isHexDigit(s[_pos])) { return false; }
+        while (isHexDigit(s[_pos])) { _pos++; }
+        _token.number = std::strtoull(s + start + 2, nullptr, 16);
+    } else {
+        // Legacy octal literals
+        if (s[_pos] == '0' && isDigit(s[_pos + 1])) { return false; }
+
+        while (isDigit(s[_pos])) { _pos++; }
+        if (s[_pos] == '.') {
+            _pos++;
+            while (isDigit(s[_pos])) { _pos++; }
+        }
+        if (s[_pos] == 'e' || s[_pos] == 'E') {
+            _pos++;
+            if (s[_pos] == '+' || s[_pos] == '-') { _pos++; }
+            if (!isDigit(s[_pos])) { return false; }
+            while (isDigit(s[_pos])) { _pos++; }
+        }
+        _token.number = std::strtod(_source.substr(start, _pos - start).c_str(), nullptr);
+    }
+
+    _token.kind = Token::Kind::number;
+
+    // e.g. '3in'
+    return !isIdentifierPart(s[_pos]);
+}
+
+static bool tokenizeString(const std::string& _source, size_t& _pos, Token& _token) {
+    char quote = _source[_pos++];
+
+    while (_pos < _source.size()) {
+        char c = _source[_pos++];
+
+        if (c == quote) {
+            _token.kind = Token::Kind::string;
+            return true;
+        }
+        if (c == '\n' || c == '\r') { return false; }
+
+        if (c == '\\') {
+            if (_pos >= _source.size()) { return false; }
+            char e = _source[_pos++];
+            switch (e) {
+            case '\\': case '\'': case '"': c = e; break;
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'v': c = '\v'; break;
+            // Hex, unicode and octal escapes and line continuations
+            default: return false;
+            }
+        }
+        _token.text += c;
+    }
+    return false;
+}
+
+// With @_lenient, comments and the characters and literals outside of the
+// subset are skipped instead of failing, for checks on any function source
+static bool tokenize(const std::string& _source, std::vector<Token>& _tokens, bool _lenient = false) {
+    size_t pos = 0;
+    bool newline = false;
+
+    while (true) {
+        while (pos < _source.size() && isSpace(_source[pos])) {
+            if (_source[pos] == '\n' || _source[pos] == '\r') { newline = true; }
+            pos++;
+        }
+
+        Token token;
+        token.newlineBefore = newline;
+        newline = false;
+
+        if (pos >= _source.size()) {
+            _tokens.push_back(token);
+            return true;
+        }
+
+        char c = _source[pos];
+
+        if (isIdentifierStart(c)) {
+            size_t start = pos;
+            while (isIdentifierPart(_source[pos])) { pos++; }
+            token.kind = Token::Kind::identifier;
+            token.text = _source.substr(start, pos - start);
+
+        } else if (isDigit(c) || (c == '.' && isDigit(_source[pos + 1]))) {
+            if (!tokenizeNumber(_source, pos, token)) {
+                if (!_lenient) { return false; }
+                while (isIdentifierPart(_source[pos]) || _source[pos] == '.') { pos++; }
+            }
+
+        } else if (c == '\'' || c == '"') {
+            size_t start = pos;
+            if (!tokenizeString(_source, pos, token)) {
+                if (!_lenient) { return false; }
+                // Skip to the closing quote, the value is not used
+                pos = start + 1;
+                while (pos < _source.size() && _source[pos] != c && _source[pos] != '\n') {
+                    if (_source[pos] == '\\') { pos++; }
+                    pos++;
+                }
+                pos++;
+                token.kind = Token::Kind::string;
+                token.text.clear();
+            }
+
+        } else {
+            // Comments and regular expressions
+            if (c == '/' && (_source[pos + 1] == '/' || _source[pos + 1] == '*')) {
+                if (!_lenient) { return false; }
+                if (_source[pos + 1] == '/') {
+                    pos = _source.find_first_of("\r\n", pos);
+                } else {
+                    pos = _source.find("*/", pos + 2);
+                    if (pos != std::string::npos) { pos += 2; }
+                }
+                if (pos == std::string::npos) { pos = _source.size(); }
+                newline = true;
+                continue;
+            }
+
+            for (const char* punctuator : s_punctuators) {
+                size_t length = std::strlen(punctuator);
+                if (_source.compare(pos, length, punctuator) == 0) {
+                    token.kind = Token::Kind::punctuator;
+                    token.text = punctuator;
+                    pos += length;
+                    break;
+                }
+            }
+            // Any other character, e.g. non-ASCII identifiers
+            if (token.kind == Token::Kind::end) {
+                if (!_lenient) { return false; }
+                pos++;
+                continue;
+            }
+        }
+        _tokens.push_back(std::move(token));
+    }
+}
+
+class NativeFunctionParser {
+
+public:
+
+    NativeFunctionParser(NativeFunction& _function, const std::vector<Token>& _tokens,
+                         PropertySlots* _slots)
+        : m_function(_function), m_tokens(_tokens), m_slots(_slots) {}
+
+    // function [name]() { return <expression>[;] }
+    bool parseFunction() {
+        if (!acceptIdentifier("function")) { return false; }
+        if (peek().kind == Token::Kind::identifier) { m_pos++; }
+
+        if (!accept("(") || !accept(")") || !accept("{")) { return false; }
+
+        if (!acceptIdentifier("return")) { return false; }
+        // 'return' followed by a line break returns undefined
+        if (peek().newlineBefore) { return false; }
+
+        if (!parseConditional()) { return false; }
+
+        accept(";");
+
+        return accept("}") && peek().kind == Token::Kind::end;
+    }
+
+private:
+
+    using Opcode = NativeFunction::Opcode;
+
+    static const int MAX_DEPTH = 32;
+
+    const Token& peek() const { return m_tokens[m_pos]; }
+
+    bool isPunctuator(const char* _text) const {
+        return peek().kind == Token::Kind::punctuator && peek().text == _text;
+    }
+
+    bool accept(const char* _punctuator) {
+        if (!isPunctuator(_punctuator)) { return false; }
+        m_pos++;
+        return true;
+    }
+
+    bool acceptIdentifier(const char* _name) {
+        if (peek().kind != Token::Kind::identifier || peek().text != _name) { return false; }
+        m_pos++;
+        return true;
+    }
+
+    size_t emit(Opcode _op, uint32_t _arg = 0) { return m_function.emit(_op, _arg); }
+
+    void patch(size_t _jump) { m_function.m_code[_jump].arg = m_function.m_code.size(); }
+
+    // a ? b : c
+    bool parseConditional() {
+        if (++m_depth > MAX_DEPTH) { return false; }
+
+        if (!parseLogical(Opcode::jump_if_true)) { return false; }
+
+        if (accept("?")) {
+            size_t toElse = emit(Opcode::pop_jump_if_false);
+            if (!parseConditional() || !accept(":")) { return false; }
+
+            size_t toEnd = emit(Opcode::jump);
+            patch(toElse);
+            if (!parseConditional()) { return false; }
+            patch(toEnd);
+        }
+
+        m_depth--;
+        return true;
+    }
+
+    // a || b, a && b: the result is one of the operands
+    bool parseLogical(Opcode _op) {
+        bool isOr = _op == Opcode::jump_if_true;
+        const char* punctuator = isOr ? "||" : "&&";
+
+        if (!(isOr ? parseLogical(Opcode::jump_if_false) : parseEquality())) { return false; }
+
+        std::vector<size_t> jumps;
+        while (accept(punctuator)) {
+            jumps.push_back(emit(_op));
+            if (!(isOr ? parseLogical(Opcode::jump_if_false) : parseEquality())) { return false; }
+        }
+        for (auto jump : jumps) { patch(jump); }
+
+        return true;
+    }
+
+    bool parseEquality() {
+        if (!parseRelational()) { return false; }
+
+        while (true) {
+            Opcode op;
+            if (accept("===")) { op = Opcode::strict_equal; }
+            else if (accept("!==")) { op = Opcode::strict_not_equal; }
+            else if (accept("==")) { op = Opcode::equal; }
+            else if (accept("!=")) { op = Opcode::not_equal; }
+            else { return true; }
+
+            if (!parseRelational()) { return false; }
+            emit(op);
+        }
+    }
+
+    bool parseRelational() {
+        if (!parseAdditive()) { return false; }
+
+        while (true) {
+            Opcode op;
+            if (accept("<=")) { op = Opcode::less_equal; }
+            else if (accept(">=")) { op = Opcode::greater_equal; }
+            else if (accept("<")) { op = Opcode::less; }
+            else if (accept(">")) { op = Opcode::greater; }
+            else { return true; }
+
+            if (!parseAdditive()) { return false; }
+            emit(op);
+        }
+    }
+
+    bool parseAdditive() {
+        if (!parseMultiplicative()) { return false; }
+
+        while (true) {
+            Opcode op;
+            if (accept("+")) { op = Opcode::add; }
+            else if (accept("-")) { op = Opcode::subtract; }
+            else { return true; }
+
+            if (!parseMultiplicative()) { return false; }
+            emit(op);
+        }
+    }
+
+    bool parseMultiplicative() {
+        if (!parseUnary()) { return false; }
+
+        while (true) {
+            Opcode op;
+            if (accept("*")) { op = Opcode::multiply; }
+            else if (accept("/")) { op = Opcode::divide; }
+            else if (accept("%")) { op = Opcode::modulo; }
+            else { return true; }
+
+            if (!parseUnary()) { return false; }
+            emit(op);
+        }
+    }
+
+    bool parseUnary() {
+        Opcode op;
+        if (accept("!")) { op = Opcode::logical_not; }
+        else if (accept("-")) { op = Opcode::negate; }
+        else if (accept("+")) { op = Opcode::to_number; }
+        else { return parsePrimary(); }
+
+        if (++m_depth > MAX_DEPTH || !parseUnary()) { return false; }
+        m_depth--;
+
+        emit(op);
+        return true;
+    }
+
+    bool parsePrimary() {
+        const Token& token = peek();
+
+        switch (token.kind) {
+        case Token::Kind::number:
+            m_function.m_numbers.push_back(token.number);
+            emit(Opcode::push_number, m_function.m_numbers.size() - 1);
+            m_pos++;
+            break;
+
+        case Token::Kind::string:
+            m_function.m_strings.push_back(token.text);
+            emit(Opcode::push_string, m_function.m_strings.size() - 1);
+            m_pos++;
+            break;
+
+        case Token::Kind::punctuator:
+            if (!accept("(") || !parseConditional() || !accept(")")) { return false; }
+            break;
+
+        case Token::Kind::identifier:
+            if (!parseIdentifier()) { return false; }
+            break;
+
+        default:
+            return false;
+        }
+
+        // Member access and calls on values, e.g. feature.name.length
+        return !isPunctuator(".") && !isPunctuator("[") && !isPunctuator("(");
+    }
+
+    bool parseIdentifier() {
+        const std::string& name = m_tokens[m_pos++].text;
+
+        if (name == "true" || name == "false") {
+            emit(Opcode::push_boolean, name == "true");
+
+        } else if (name == "null") {
+            emit(Opcode::push_null);
+
+        } else if (name == "undefined") {
+            emit(Opcode::push_undefined);
+
+        } else if (name == "$zoom") {
+            emit(Opcode::push_keyword, static_cast<uint32_t>(FilterKeyword::zoom));
+
+        } else if (name == "$geometry") {
+            emit(Opcode::push_keyword, static_cast<uint32_t>(FilterKeyword::geometry));
+
+        } else if (name == "point" || name == "line" || name == "polygon") {
+            // Global geometry constants, see StyleContext()
+            m_function.m_numbers.push_back(name == "point" ? GeometryType::points :
+                                           name == "line" ? GeometryType::lines :
+                                           GeometryType::polygons);
+            emit(Opcode::push_number, m_function.m_numbers.size() - 1);
+
+        } else if (name == "feature") {
+            std::string key;
+            if (accept(".")) {
+                if (peek().kind != Token::Kind::identifier) { return false; }
+                key = m_tokens[m_pos++].text;
+            } else if (accept("[")) {
+                if (peek().kind != Token::Kind::string) { return false; }
+                key = m_tokens[m_pos++].text;
+                if (!accept("]")) { return false; }
+            } else {
+                return false;
+            }
+            PropertyKey property{ Properties::keyId(key) };
+            if (m_slots) { property.slot = m_slots->slot(property.id); }
+
+            m_function.m_properties.push_back(property);
+            emit(Opcode::push_property, m_function.m_properties.size() - 1);
+
+        } else {
+            // Scene globals, Math, etc.
+            return false;
+        }
+        return true;
+    }
+
+    NativeFunction& m_function;
+    const std::vector<Token>& m_tokens;
+    PropertySlots* m_slots;
+    size_t m_pos = 0;
+    int m_depth = 0;
+};
+
+bool NativeFunction::compile(const std::string& _source, PropertySlots* _slots) {
+
+    m_code.clear();
+    m_numbers.clear();
+    m_strings.clear();
+    m_properties.clear();
+
+    std::vector<Token> tokens;
+    if (!tokenize(_source, tokens)) { return false; }
+
+    NativeFunctionParser parser(*this, tokens, _slots);
+    if (!parser.parseFunction()) {
+        m_code.clear();
+        return false;
+    }
+    return true;
+}
+
+bool NativeFunction::isDeterministic(const std::string& _source) {
+
+    std::vector<Token> tokens;
+    tokenize(_source, tokens, true);
+
+    auto is = [&](size_t _i, Token::Kind _kind, const char* _text) {
+        return _i < tokens.size() && tokens[_i].kind == _kind && tokens[_i].text == _text;
+    };
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        // Members like 'feature.Date' are not the globals
+        if (i > 0 && is(i - 1, Token::Kind::punctuator, ".")) { continue; }
+
+        if (is(i, Token::Kind::identifier, "Date")) { return false; }
+
+        if (is(i, Token::Kind::identifier, "Math")) {
+            if (is(i + 1, Token::Kind::punctuator, ".") &&
+                is(i + 2, Token::Kind::identifier, "random")) { return false; }
+            if (is(i + 1, Token::Kind::punctuator, "[") &&
+                is(i + 2, Token::Kind::string, "random")) { return false; }
+        }
+    }
+    return true;
+}
+
+size_t NativeFunction::emit(Opcode _op, uint32_t _arg) {
+    m_code.push_back({ _op, _arg });
+    return m_code.size() - 1;
+}
+
+bool JsValue::toBoolean() const {
+    switch (type) {
+    case Type::boolean: return number != 0;
+    case Type::number: return number != 0 && !std::isnan(number);
+    case Type::string: return !string->empty();
+    default: return false;
+    }
+}
+
+static JsValue jsNumber(double _number) {
+    JsValue value;
+    value.type = Type::number;
+    value.number = _number;
+    return value;
+}
+
+static JsValue jsBoolean(bool _value) {
+    JsValue value;
+    value.type = Type::boolean;
+    value.number = _value;
+    return value;
+}
+
+static JsValue jsValue(const Value& _value) {
+    JsValue value;
+    if (_value.is<double>()) {
+        value.type = Type::number;
+        value.number = _value.get<double>();
+    } else if (_value.is<std::string>()) {
+        value.type = Type::string;
+        value.string = &_value.get<std::string>();
+    }
+    return value;
+}
+
+// ToNumber, except for strings
+static bool toNumber(const JsValue& _value, double& _number) {
+    switch (_value.type) {
+    case Type::undefined: _number = std::numeric_limits<double>::quiet_NaN(); return true;
+    case Type::null: _number = 0; return true;
+    case Type::string: return false;
+    default: _number = _value.number; return true;
+    }
+}
+
+static bool isAscii(const std::string& _string) {
+    for (char c : _string) {
+        if (static_cast<unsigned char>(c) > 0x7f) { return false; }
+    }
+    return true;
+}
+
+static bool strictEquals(const JsValue& _a, const JsValue& _b) {
+    if (_a.type != _b.type) { return false; }
+
+    switch (_a.type) {
+    case Type::undefined:
+    case Type::null: return true;
+    case Type::string: return *_a.string == *_b.string;
+    default: return _a.number == _b.number;
+    }
+}
+
+static bool looseEquals(JsValue _a, JsValue _b, bool& _result) {
+    if (_a.type == _b.type) {
+        _result = strictEquals(_a, _b);
+        return true;
+    }
+
+    bool aNull = _a.type == Type::undefined || _a.type == Type::null;
+    bool bNull = _b.type == Type::undefined || _b.type == Type::null;
+    if (aNull || bNull) {
+        _result = aNull && bNull;
+        return true;
+    }
+
+    // Booleans compare as numbers
+    if (_a.type == Type::boolean) { _a.type = Type::number; }
+    if (_b.type == Type::boolean) { _b.type = Type::number; }
+
+    if (_a.type == Type::number && _b.type == Type::number) {
+        _result = _a.number == _b.number;
+        return true;
+    }
+    return false;
+}
+
+// Abstract relational comparison: -1 for a < b, 1 for a > b, 0 for equal and
+// 2 for undefined (NaN)
+static bool compare(const JsValue& _a, const JsValue& _b, int& _result) {
+    if (_a.type == Type::string && _b.type == Type::string) {
+        // JS compares UTF-16 code units, which only matches the byte order
+        // of UTF-8 strings for code points below U+E000
+        if (!isAscii(*_a.string) || !isAscii(*_b.string)) { return false; }
+        int c = _a.string->compare(*_b.string);
+        _result = c < 0 ? -1 : (c > 0 ? 1 : 0);
+        return true;
+    }
+
+    double a, b;
+    if (!toNumber(_a, a) || !toNumber(_b, b)) { return false; }
+
+    if (std::isnan(a) || std::isnan(b)) { _result = 2; }
+    else { _result = a < b ? -1 : (a > b ? 1 : 0); }
+    return true;
+}
+
+bool NativeFunction::eval(StyleContext& _ctx, JsValue& _result) const {
+
+    auto& stack = m_stack;
+    stack.clear();
+    m_concatenated.clear();
+
+    for (size_t pc = 0; pc < m_code.size(); pc++) {
+        const auto& in = m_code[pc];
+
+        switch (in.op) {
+        case Opcode::push_undefined:
+            stack.push_back(JsValue());
+            break;
+
+        case Opcode::push_null: {
+            JsValue value;
+            value.type = Type::null;
+            stack.push_back(value);
+            break;
+        }
+        case Opcode::push_boolean:
+            stack.push_back(jsBoolean(in.arg));
+            break;
+
+        case Opcode::push_number:
+            stack.push_back(jsNumber(m_numbers[in.arg]));
+            break;
+
+        case Opcode::push_string: {
+            JsValue value;
+            value.type = Type::string;
+            value.string = &m_strings[in.arg];
+            stack.push_back(value);
+            break;
+        }
+        case Opcode::push_property: {
+            if (!_ctx.feature()) { return false; }
+            auto& property = m_properties[in.arg];
+            stack.push_back(jsValue(_ctx.getProperty(property.slot, property.id)));
+            break;
+        }
+
+        case Opcode::push_keyword: {
+            auto& keyword = _ctx.getKeyword(static_cast<FilterKeyword>(in.arg));
+            // Not defined in the JS context
+            if (keyword.is<none_type>()) { return false; }
+            stack.push_back(jsValue(keyword));
+            break;
+        }
+        case Opcode::logical_not:
+            stack.back() = jsBoolean(!stack.back().toBoolean());
+            break;
+
+        case Opcode::negate:
+        case Opcode::to_number: {
+            double n;
+            if (!toNumber(stack.back(), n)) { return false; }
+            stack.back() = jsNumber(in.op == Opcode::negate ? -n : n);
+            break;
+        }
+        case Opcode::add: {
+            JsValue b = stack.back();
+            stack.pop_back();
+            JsValue& a = stack.back();
+
+            if (a.type == Type::string || b.type == Type::string) {
+                // Concatenation with numbers needs JS number formatting
+                if (a.type != b.type) { return false; }
+                m_concatenated.push_back(*a.string + *b.string);
+                a.string = &m_concatenated.back();
+                break;
+            }
+            double x, y;
+            toNumber(a, x);
+            toNumber(b, y);
+            a = jsNumber(x + y);
+            break;
+        }
+        case Opcode::subtract:
+        case Opcode::multiply:
+        case Opcode::divide:
+        case Opcode::modulo: {
+            JsValue b = stack.back();
+            stack.pop_back();
+            JsValue& a = stack.back();
+
+            double x, y;
+            if (!toNumber(a, x) || !toNumber(b, y)) { return false; }
+
+            switch (in.op) {
+            case Opcode::subtract: a = jsNumber(x - y); break;
+            case Opcode::multiply: a = jsNumber(x * y); break;
+            case Opcode::divide: a = jsNumber(x / y); break;
+            default: a = jsNumber(std::fmod(x, y)); break;
+            }
+            break;
+        }
+        case Opcode::less:
+        case Opcode::less_equal:
+        case Opcode::greater:
+        case Opcode::greater_equal: {
+            JsValue b = stack.back();
+            stack.pop_back();
+            JsValue& a = stack.back();
+
+            int c;
+            if (!compare(a, b, c)) { return false; }
+
+            switch (in.op) {
+            case Opcode::less: a = jsBoolean(c == -1); break;
+            case Opcode::less_equal: a = jsBoolean(c == -1 || c == 0); break;
+            case Opcode::greater: a = jsBoolean(c == 1); break;
+            default: a = jsBoolean(c == 1 || c == 0); break;
+            }
+            break;
+        }
+        case Opcode::equal:
+        case Opcode::not_equal: {
+            JsValue b = stack.back();
+            stack.pop_back();
+            JsValue& a = stack.back();
+
+            bool equal;
+            if (!looseEquals(a, b, equal)) { return false; }
+            a = jsBoolean(equal == (in.op == Opcode::equal));
+            break;
+        }
+        case Opcode::strict_equal:
+        case Opcode::strict_not_equal: {
+            JsValue b = stack.back();
+            stack.pop_back();
+            JsValue& a = stack.back();
+
+            a = jsBoolean(strictEquals(a, b) == (in.op == Opcode::strict_equal));
+            break;
+        }
+        case Opcode::jump:
+            pc = in.arg - 1;
+            break;
+
+        case Opcode::jump_if_true:
+        case Opcode::jump_if_false:
+            if (stack.back().toBoolean() == (in.op == Opcode::jump_if_true)) {
+                pc = in.arg - 1;
+            } else {
+                stack.pop_back();
+            }
+            break;
+
+        case Opcode::pop_jump_if_false: {
+            bool condition = stack.back().toBoolean();
+            stack.pop_back();
+            if (!condition) { pc = in.arg - 1; }
+            break;
+        }
+        }
+    }
+
+    _result = stack.back();
+    return true;
+}
+
+}
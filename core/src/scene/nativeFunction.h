@@ -0,0 +1,117 @@
+#pragma once
+
+#include "scene/propertySlots.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+class StyleContext;
+
+/* NativeFunction
+ *
+ * A scene JS function compiled to a small stack machine, for the subset of
+ * JS most style functions are written in: a single return statement with
+ * literals, feature properties, $zoom and $geometry, arithmetic, comparisons,
+ * the logical operators and the conditional operator, e.g.
+ *
+ *   function() { return feature.sort_key + 1 || 0; }
+ *   function() { return (feature.scalerank * .75) <= ($zoom - 4); }
+ *
+ * Property keys are interned at compile time and read through the property
+ * cache of the StyleContext, when compiled with the PropertySlots of the
+ * scene.
+ *
+ * compile() fails for functions outside of the subset. eval() fails when a
+ * value would need a conversion the subset does not implement, like string
+ * to number or number to string. In both cases StyleContext evaluates the
+ * function with Duktape instead.
+ */
+class NativeFunction {
+
+public:
+
+    struct JsValue {
+        enum class Type : uint8_t { undefined, null, boolean, number, string };
+
+        Type type = Type::undefined;
+        // Value of booleans and numbers
+        double number = 0;
+        const std::string* string = nullptr;
+
+        bool toBoolean() const;
+    };
+
+    /* Returns false when _source is not in the supported subset of JS.
+     * Property keys get a slot in @_slots when given. */
+    bool compile(const std::string& _source, PropertySlots* _slots = nullptr);
+
+    bool valid() const { return !m_code.empty(); }
+
+    /* Returns false when any JS function _source reads the current time or
+     * random numbers, i.e. refers to Date or Math.random outside of strings
+     * and comments. Global functions it calls are not checked. */
+    static bool isDeterministic(const std::string& _source);
+
+    /* Evaluates the function for the current Feature and keywords of _ctx,
+     * the result is valid until the next call to eval() */
+    bool eval(StyleContext& _ctx, JsValue& _result) const;
+
+    /* Number of instructions - public for testing */
+    size_t size() const { return m_code.size(); }
+
+private:
+
+    enum class Opcode : uint8_t {
+        push_undefined,
+        push_null,
+        push_boolean,       // push arg
+        push_number,        // push m_numbers[arg]
+        push_string,        // push m_strings[arg]
+        push_property,      // push value(m_properties[arg])
+        push_keyword,       // push keyword arg, see FilterKeyword
+        logical_not,
+        negate,
+        to_number,
+        add,
+        subtract,
+        multiply,
+        divide,
+        modulo,
+        less,
+        less_equal,
+        greater,
+        greater_equal,
+        equal,
+        not_equal,
+        strict_equal,
+        strict_not_equal,
+        jump,               // pc = arg
+        jump_if_true,       // if top: pc = arg, else pop
+        jump_if_false,      // if !top: pc = arg, else pop
+        pop_jump_if_false,  // if !pop: pc = arg
+    };
+
+    struct Instruction {
+        Opcode op;
+        uint32_t arg;
+    };
+
+    friend class NativeFunctionParser;
+
+    size_t emit(Opcode _op, uint32_t _arg = 0);
+
+    std::vector<Instruction> m_code;
+
+    std::vector<double> m_numbers;
+    std::vector<std::string> m_strings;
+    std::vector<PropertyKey> m_properties;
+
+    // Evaluation stack and results of string concatenations
+    mutable std::vector<JsValue> m_stack;
+    mutable std::deque<std::string> m_concatenated;
+};
+
+}
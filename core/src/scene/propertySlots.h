@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace Tangram {
+
+/* PropertySlots
+ *
+ * Dense ids for the property keys read by the filters and functions of one
+ * Scene. StyleContext caches the property lookups of the current Feature in
+ * an array indexed by slot, which stays as small as the set of keys the scene
+ * reads - key ids (see Properties::keyId) are process-wide and grow with the
+ * keys of all tile data and scenes.
+ *
+ * Slots are assigned while filters and functions are compiled, possibly by
+ * several StyleContexts at once.
+ */
+class PropertySlots {
+
+public:
+
+    // Slot of keys that are read without the StyleContext cache
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /* Returns the slot of @_keyId, adding one for a new key */
+    uint32_t slot(uint32_t _keyId) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_slots.emplace(_keyId, uint32_t(m_slots.size())).first->second;
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::unordered_map<uint32_t, uint32_t> m_slots;
+};
+
+/* A property key id with its slot in a PropertySlots */
+struct PropertyKey {
+    uint32_t id;
+    uint32_t slot = PropertySlots::NONE;
+
+    bool operator<(const PropertyKey& _rhs) const { return id < _rhs.id; }
+};
+
+}
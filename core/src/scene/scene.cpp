@@ -26,6 +26,8 @@ static std::atomic<int32_t> s_serial;
 Scene::Scene(const std::string& _path)
     : id(s_serial++),
       m_path(_path),
+      m_functionBytecode(std::make_unique<FunctionBytecode>()),
+      m_propertySlots(std::make_unique<PropertySlots>()),
       m_fontContext(std::make_shared<FontContext>()) {
 
     std::regex r("^(http|https):/");
@@ -56,7 +58,9 @@ Scene::Scene(const std::string& _path)
 }
 
 Scene::Scene(const Scene& _other)
-    : id(s_serial++) {
+    : id(s_serial++),
+      m_functionBytecode(std::make_unique<FunctionBytecode>()),
+      m_propertySlots(std::make_unique<PropertySlots>()) {
 
     m_config = _other.m_config;
     m_fontContext = _other.m_fontContext;
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "scene/propertySlots.h"
 #include "util/color.h"
 #include "view/view.h"
 
 #include <atomic>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <tuple>
@@ -101,6 +103,19 @@ public:
 
     int addJsFunction(const std::string& _function);
 
+    /* The scene functions compiled to Duktape bytecode by the first
+     * StyleContext that initializes them, see StyleContext::initFunctions() */
+    struct FunctionBytecode {
+        std::mutex mutex;
+        bool compiled = false;
+        std::vector<std::string> functions;
+    };
+
+    FunctionBytecode& functionBytecode() const { return *m_functionBytecode; }
+
+    /* Slots of the property keys read by the layer filters and functions */
+    PropertySlots& propertySlots() const { return *m_propertySlots; }
+
     const int32_t id;
 
     bool useScenePosition = true;
@@ -149,6 +164,8 @@ private:
     std::vector<std::string> m_names;
 
     std::vector<std::string> m_jsFunctions;
+    std::unique_ptr<FunctionBytecode> m_functionBytecode;
+    std::unique_ptr<PropertySlots> m_propertySlots;
     std::list<Stops> m_stops;
 
     Color m_background;
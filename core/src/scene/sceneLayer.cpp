@@ -9,6 +9,7 @@ SceneLayer::SceneLayer(std::string _name, Filter _filter,
                        std::vector<SceneLayer> _sublayers,
                        bool _visible) :
     m_filter(std::move(_filter)),
+    m_filterProgram(m_filter),
     m_name(_name),
     m_rules(_rules),
     m_sublayers(std::move(_sublayers)),
@@ -28,4 +29,14 @@ void SceneLayer::setDepth(size_t _d) {
 
 }
 
+void SceneLayer::linkProperties(PropertySlots& _slots) {
+
+    m_filterProgram.linkProperties(_slots);
+
+    for (auto& layer : m_sublayers) {
+        layer.linkProperties(_slots);
+    }
+
+}
+
 }
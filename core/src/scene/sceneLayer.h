@@ -2,6 +2,7 @@
 
 #include "scene/drawRule.h"
 #include "scene/filters.h"
+#include "scene/filterProgram.h"
 #include "scene/styleParam.h"
 
 #include <string>
@@ -14,6 +15,7 @@ struct Feature;
 class SceneLayer {
 
     Filter m_filter;
+    FilterProgram m_filterProgram;
     std::string m_name;
     std::vector<DrawRuleData> m_rules;
     std::vector<SceneLayer> m_sublayers;
@@ -29,12 +31,16 @@ public:
 
     const auto& name() const { return m_name; }
     const auto& filter() const { return m_filter; }
+    const auto& filterProgram() const { return m_filterProgram; }
     const auto& rules() const { return m_rules; }
     const auto& sublayers() const { return m_sublayers; }
     const auto& depth() const { return m_depth; }
     const auto& visible() const { return m_visible; }
 
     void setDepth(size_t _d);
+
+    /* Links the filter programs of this layer and its sublayers to @_slots */
+    void linkProperties(PropertySlots& _slots);
 };
 
 }
@@ -962,6 +962,10 @@ void SceneLoader::loadSource(const std::string& name, const Node& source, const
 
     if (sourcePtr) {
         sourcePtr->setCacheSize(CACHE_SIZE);
+
+        if (auto maxDownloadsNode = source["max_downloads"]) {
+            sourcePtr->setMaxDownloads(maxDownloadsNode.as<size_t>(0));
+        }
         _scene->dataSources().push_back(sourcePtr);
     }
 
@@ -1608,6 +1612,7 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
 
     std::string source;
     std::vector<std::string> collections;
+    double simplify = 0;
 
     if (Node data = layer.second["data"]) {
         if (Node data_source = data["source"]) {
@@ -1629,6 +1634,11 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
                 collections = data_layer.as<std::vector<std::string>>();
             }
         }
+
+        // Tolerance in pixels for simplifying the layer's geometry
+        if (Node data_simplify = data["simplify"]) {
+            getDouble(data_simplify, simplify, "simplify");
+        }
     }
 
     if (collections.empty()) {
@@ -1637,7 +1647,8 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
 
     auto sublayer = loadSublayer(layer.second, name, scene);
 
-    scene->layers().push_back({ std::move(sublayer), source, collections });
+    scene->layers().push_back({ std::move(sublayer), source, collections, float(simplify) });
+    scene->layers().back().linkProperties(scene->propertySlots());
 }
 
 void SceneLoader::loadBackground(Node background, const std::shared_ptr<Scene>& scene) {
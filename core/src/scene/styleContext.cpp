@@ -6,10 +6,15 @@
 #include "scene/filters.h"
 #include "scene/scene.h"
 #include "util/builders.h"
+#include "util/hash.h"
 #include "log.h"
 
 #include "duktape.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #define DUMP(...) // do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 #define DBG(...) do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 
@@ -22,6 +27,14 @@ const static char FUNC_ID[] = "\xff""\xff""fns";
 static const std::string key_geom("$geometry");
 static const std::string key_zoom("$zoom");
 
+// Result kind of evalFilter() in the function cache, evalStyle() results
+// use their StyleParamKey
+static const int FILTER_RESULT = -1;
+
+// Memoised results per function, the cache of a function is cleared when
+// it grows beyond this
+static const size_t MAX_CACHED_RESULTS = 1024;
+
 static const std::vector<std::string> s_geometryStrings = {
     "", // unknown
     "point",
@@ -149,7 +162,16 @@ void StyleContext::parseSceneGlobals(const YAML::Node& node) {
 
 void StyleContext::setSceneGlobals(const YAML::Node& sceneGlobals) {
 
-    if (!sceneGlobals) { return; }
+    // Functions may read globals
+    for (auto& cache : m_functionCache) { cache.results.clear(); }
+
+    if (!sceneGlobals) {
+        // Remove the globals of a previous scene
+        duk_push_global_object(m_ctx);
+        duk_del_prop_string(m_ctx, -1, "global");
+        duk_pop(m_ctx);
+        return;
+    }
 
     //[ "ctx" ]
     // globalObject
@@ -167,8 +189,98 @@ void StyleContext::initFunctions(const Scene& _scene) {
     }
     m_sceneId = _scene.id;
 
+    // Slots are assigned per scene
+    m_propertySlots = &_scene.propertySlots();
+    m_propertyCache.clear();
+
     setSceneGlobals(_scene.config()["global"]);
-    setFunctions(_scene.functions());
+
+    // The first StyleContext of a scene compiles its functions, the
+    // others load the bytecode
+    auto& bytecode = _scene.functionBytecode();
+    {
+        std::lock_guard<std::mutex> lock(bytecode.mutex);
+        if (!bytecode.compiled) {
+            setFunctions(_scene.functions());
+            dumpFunctions(bytecode.functions);
+            bytecode.compiled = true;
+            return;
+        }
+    }
+    loadFunctions(_scene.functions(), bytecode.functions);
+}
+
+void StyleContext::dumpFunctions(std::vector<std::string>& _bytecode) {
+
+    _bytecode.assign(m_functionCount, std::string());
+
+    if (!duk_get_global_string(m_ctx, FUNC_ID)) {
+        duk_pop(m_ctx);
+        return;
+    }
+
+    for (int id = 0; id < m_functionCount; id++) {
+        // Functions that failed to compile stay empty
+        if (duk_get_prop_index(m_ctx, -1, id)) {
+            // [fns, function] -> [fns, buffer]
+            duk_dump_function(m_ctx);
+            duk_size_t size = 0;
+            auto* data = static_cast<const char*>(duk_get_buffer(m_ctx, -1, &size));
+            _bytecode[id].assign(data, size);
+        }
+        duk_pop(m_ctx);
+    }
+
+    // pop fns array
+    duk_pop(m_ctx);
+}
+
+void StyleContext::loadFunctions(const std::vector<std::string>& _functions,
+                                 const std::vector<std::string>& _bytecode) {
+
+    auto arr_idx = duk_push_array(m_ctx);
+
+    for (size_t id = 0; id < _bytecode.size(); id++) {
+        auto& code = _bytecode[id];
+        if (code.empty()) { continue; }
+
+        // [fns, buffer] -> [fns, function]
+        void* buffer = duk_push_fixed_buffer(m_ctx, code.size());
+        std::memcpy(buffer, code.data(), code.size());
+        duk_load_function(m_ctx);
+
+        duk_put_prop_index(m_ctx, arr_idx, id);
+    }
+
+    if (!duk_put_global_string(m_ctx, FUNC_ID)) {
+        LOGE("'fns' object not set");
+    }
+
+    m_functionCount = _bytecode.size();
+
+    initFunctionState(_functions, _bytecode.size());
+
+    DUMP("loadFunctions\n");
+}
+
+// Results of functions that use random numbers or the current time can
+// not be reused
+static bool isCacheable(const std::string& _function) {
+    return NativeFunction::isDeterministic(_function);
+}
+
+void StyleContext::initFunctionState(const std::vector<std::string>& _functions, size_t _count) {
+
+    m_functionCache.clear();
+    m_functionCache.resize(_count);
+
+    m_nativeFunctions.clear();
+    m_nativeFunctions.resize(_count);
+
+    for (size_t id = 0; id < _count; id++) {
+        m_functionCache[id].enabled = isCacheable(_functions[id]);
+        m_nativeFunctions[id].compile(_functions[id], m_propertySlots);
+    }
 }
 
 bool StyleContext::setFunctions(const std::vector<std::string>& _functions) {
@@ -178,6 +290,8 @@ bool StyleContext::setFunctions(const std::vector<std::string>& _functions) {
 
     bool ok = true;
 
+    initFunctionState(_functions, _functions.size());
+
     for (auto& function : _functions) {
         duk_push_string(m_ctx, function.c_str());
         duk_push_string(m_ctx, "");
@@ -231,6 +345,15 @@ bool StyleContext::addFunction(const std::string& _function) {
     // Pop the functions array off the stack
     duk_pop(m_ctx);
 
+    m_functionCount = id + 1;
+
+    m_functionCache.resize(m_functionCount);
+    m_functionCache[id] = FunctionCache();
+    m_functionCache[id].enabled = isCacheable(_function);
+
+    m_nativeFunctions.resize(m_functionCount);
+    m_nativeFunctions[id].compile(_function, m_propertySlots);
+
     return ok;
 }
 
@@ -238,12 +361,47 @@ void StyleContext::setFeature(const Feature& _feature) {
 
     m_feature = &_feature;
 
+    if (++m_featureEpoch == 0) {
+        // Wrapped around: invalidate all cached lookups
+        m_propertyCache.assign(m_propertyCache.size(), CachedProperty());
+        m_keySignatureEpoch = 0;
+        m_featureEpoch = 1;
+    }
+
     if (m_keywordGeom != m_feature->geometryType) {
         setKeyword(key_geom, s_geometryStrings[m_feature->geometryType]);
         m_keywordGeom = m_feature->geometryType;
     }
 }
 
+const Value& StyleContext::getProperty(uint32_t _slot, uint32_t _keyId) {
+
+    if (_slot == PropertySlots::NONE) {
+        return m_feature->props.get(_keyId);
+    }
+
+    if (_slot >= m_propertyCache.size()) {
+        m_propertyCache.resize(_slot + 1);
+    }
+
+    auto& entry = m_propertyCache[_slot];
+
+    if (entry.epoch != m_featureEpoch) {
+        entry.value = &m_feature->props.get(_keyId);
+        entry.epoch = m_featureEpoch;
+    }
+    return *entry.value;
+}
+
+uint64_t StyleContext::keySignature() {
+
+    if (m_keySignatureEpoch != m_featureEpoch) {
+        m_keySignature = m_feature->props.keySignature();
+        m_keySignatureEpoch = m_featureEpoch;
+    }
+    return m_keySignature;
+}
+
 void StyleContext::setKeywordZoom(int _zoom) {
     if (m_keywordZoom != _zoom) {
         setKeyword(key_zoom, _zoom);
@@ -305,7 +463,10 @@ bool StyleContext::evalFunction(FunctionID id) {
     duk_remove(m_ctx, -2);
 
     // call popped function (sitting at stack top), evaluated value is put on stack top
-    if (duk_pcall(m_ctx, 0) != 0) {
+    int status = duk_pcall(m_ctx, 0);
+    m_recordKeys = false;
+
+    if (status != 0) {
         LOGE("EvalFilterFn: %s", duk_safe_to_string(m_ctx, -1));
         duk_pop(m_ctx);
         return false;
@@ -314,8 +475,118 @@ bool StyleContext::evalFunction(FunctionID id) {
     return true;
 }
 
+size_t StyleContext::cacheKey(const FunctionCache& _cache, int _kind) {
+    size_t seed = 0;
+    hash_combine(seed, _kind);
+
+    for (auto& keyword : m_keywords) { hashValue(seed, keyword); }
+    for (auto& key : _cache.keys) { hashValue(seed, getProperty(key.slot, key.id)); }
+
+    return seed;
+}
+
+bool StyleContext::cacheMatch(const FunctionCache& _cache, const FunctionCache::Result& _result) {
+    size_t arg = 0;
+    for (auto& keyword : m_keywords) {
+        if (!(_result.args[arg++] == keyword)) { return false; }
+    }
+    for (auto& key : _cache.keys) {
+        if (!(_result.args[arg++] == getProperty(key.slot, key.id))) { return false; }
+    }
+    return true;
+}
+
+StyleContext::FunctionCache* StyleContext::cacheLookup(FunctionID _id, int _kind, size_t& _hash,
+                                                      const FunctionCache::Result*& _result) {
+    _result = nullptr;
+    m_recordKeys = false;
+
+    if (!m_feature || _id >= m_functionCache.size()) { return nullptr; }
+
+    auto& cache = m_functionCache[_id];
+    if (!cache.enabled) { return nullptr; }
+
+    if (!cache.window.lookup()) {
+        // Features rarely share the values this function reads
+        cache.enabled = false;
+        cache.results.clear();
+        return nullptr;
+    }
+
+    _hash = cacheKey(cache, _kind);
+
+    auto it = cache.results.find(_hash);
+    if (it != cache.results.end() && it->second.kind == _kind && cacheMatch(cache, it->second)) {
+        cache.window.hit();
+        m_functionCacheStats.hits++;
+        _result = &it->second;
+        return &cache;
+    }
+
+    // Record the properties read by the following evaluation
+    m_readKeys.clear();
+    m_recordKeys = true;
+
+    return &cache;
+}
+
+void StyleContext::cacheStore(FunctionCache& _cache, int _kind, size_t _hash,
+                              bool _ok, const StyleParam::Value& _value) {
+
+    // Add keys that were first read in this evaluation, e.g. in a branch
+    // not taken before. Results for the previous set of keys can not be
+    // matched anymore.
+    bool addedKeys = false;
+    for (auto& key : m_readKeys) {
+        PropertyKey property{ Properties::keyId(key) };
+        auto it = std::lower_bound(_cache.keys.begin(), _cache.keys.end(), property);
+        if (it == _cache.keys.end() || it->id != property.id) {
+            if (m_propertySlots) { property.slot = m_propertySlots->slot(property.id); }
+            _cache.keys.insert(it, property);
+            addedKeys = true;
+        }
+    }
+    if (addedKeys) {
+        _cache.results.clear();
+        _hash = cacheKey(_cache, _kind);
+    }
+
+    limitMemoResults(_cache.results, MAX_CACHED_RESULTS);
+
+    auto& result = _cache.results[_hash];
+    result.args.assign(m_keywords.begin(), m_keywords.end());
+    for (auto& key : _cache.keys) {
+        result.args.push_back(getProperty(key.slot, key.id));
+    }
+    result.kind = _kind;
+    result.ok = _ok;
+    result.value = _value;
+}
+
+bool StyleContext::evalNative(FunctionID _id, NativeFunction::JsValue& _result) {
+
+    if (!m_nativeFunctionsEnabled || _id >= m_nativeFunctions.size()) { return false; }
+
+    auto& function = m_nativeFunctions[_id];
+    if (!function.valid() || !function.eval(*this, _result)) { return false; }
+
+    m_functionCacheStats.native++;
+    return true;
+}
+
 bool StyleContext::evalFilter(FunctionID _id) {
 
+    NativeFunction::JsValue native;
+    if (evalNative(_id, native)) { return native.toBoolean(); }
+
+    size_t hash = 0;
+    const FunctionCache::Result* cached = nullptr;
+    auto* cache = cacheLookup(_id, FILTER_RESULT, hash, cached);
+
+    if (cached) { return cached->ok; }
+
+    m_functionCacheStats.misses++;
+
     if (!evalFunction(_id)) { return false; };
 
     // Evaluate the "truthiness" of the function result at the top of the stack.
@@ -324,11 +595,30 @@ bool StyleContext::evalFilter(FunctionID _id) {
     // pop result
     duk_pop(m_ctx);
 
+    if (cache) { cacheStore(*cache, FILTER_RESULT, hash, result, none_type{}); }
+
     return result;
 }
 
 bool StyleContext::evalStyle(FunctionID _id, StyleParamKey _key, StyleParam::Value& _val) {
 
+    NativeFunction::JsValue native;
+    if (evalNative(_id, native)) {
+        parseNativeResult(_key, native, _val);
+        return !_val.is<none_type>();
+    }
+
+    size_t hash = 0;
+    const FunctionCache::Result* cached = nullptr;
+    auto* cache = cacheLookup(_id, static_cast<int>(_key), hash, cached);
+
+    if (cached) {
+        _val = cached->value;
+        return cached->ok;
+    }
+
+    m_functionCacheStats.misses++;
+
     if (!evalFunction(_id)) { return false; }
 
     // parse evaluated result at stack top
@@ -337,7 +627,85 @@ bool StyleContext::evalStyle(FunctionID _id, StyleParamKey _key, StyleParam::Val
     // pop result, empty stack
     duk_pop(m_ctx);
 
-    return !_val.is<none_type>();
+    bool ok = !_val.is<none_type>();
+
+    if (cache) { cacheStore(*cache, static_cast<int>(_key), hash, ok, _val); }
+
+    return ok;
+}
+
+static void parseBooleanResult(StyleParamKey _key, bool _value, StyleParam::Value& _val) {
+    switch (_key) {
+        case StyleParamKey::interactive:
+        case StyleParamKey::text_interactive:
+        case StyleParamKey::visible:
+            _val = _value;
+            break;
+        case StyleParamKey::extrude:
+            _val = _value ? glm::vec2(NAN, NAN) : glm::vec2(0.0f, 0.0f);
+            break;
+        default:
+            break;
+    }
+}
+
+// Like duk_get_uint(): NaN is 0, values out of range are clamped
+static uint32_t toUint(double _value) {
+    if (std::isnan(_value) || _value < 0) { return 0; }
+    if (_value > UINT32_MAX) { return UINT32_MAX; }
+    return static_cast<uint32_t>(_value);
+}
+
+static void parseNumberResult(StyleParamKey _key, double _value, StyleParam::Value& _val) {
+    switch (_key) {
+        case StyleParamKey::extrude:
+            _val = glm::vec2(0.f, static_cast<float>(_value));
+            break;
+        case StyleParamKey::width:
+        case StyleParamKey::outline_width: {
+            // TODO more efficient way to return pixels.
+            // atm this only works by return value as string
+            _val = StyleParam::Width{static_cast<float>(_value)};
+            break;
+        }
+        case StyleParamKey::text_font_stroke_width: {
+            _val = static_cast<float>(_value);
+            break;
+        }
+        case StyleParamKey::order:
+        case StyleParamKey::outline_order:
+        case StyleParamKey::priority:
+        case StyleParamKey::color:
+        case StyleParamKey::outline_color:
+        case StyleParamKey::text_font_fill:
+        case StyleParamKey::text_font_stroke_color: {
+            _val = toUint(_value);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void StyleContext::parseNativeResult(StyleParamKey _key, const NativeFunction::JsValue& _result,
+                                     StyleParam::Value& _val) const {
+    using Type = NativeFunction::JsValue::Type;
+
+    _val = none_type{};
+
+    switch (_result.type) {
+    case Type::string:
+        _val = StyleParam::parseString(_key, *_result.string);
+        break;
+    case Type::boolean:
+        parseBooleanResult(_key, _result.number != 0, _val);
+        break;
+    case Type::number:
+        if (!std::isnan(_result.number)) { parseNumberResult(_key, _result.number, _val); }
+        break;
+    default:
+        break;
+    }
 }
 
 void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val) const {
@@ -348,20 +716,7 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
         _val = StyleParam::parseString(_key, value);
 
     } else if (duk_is_boolean(m_ctx, -1)) {
-        bool value = duk_get_boolean(m_ctx, -1);
-
-        switch (_key) {
-            case StyleParamKey::interactive:
-            case StyleParamKey::text_interactive:
-            case StyleParamKey::visible:
-                _val = value;
-                break;
-            case StyleParamKey::extrude:
-                _val = value ? glm::vec2(NAN, NAN) : glm::vec2(0.0f, 0.0f);
-                break;
-            default:
-                break;
-        }
+        parseBooleanResult(_key, duk_get_boolean(m_ctx, -1), _val);
 
     } else if (duk_is_array(m_ctx, -1)) {
         duk_get_prop_string(m_ctx, -1, "length");
@@ -427,36 +782,8 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
         // Ignore setting value
         LOGD("duk evaluates JS method to NAN.\n");
     } else if (duk_is_number(m_ctx, -1)) {
+        parseNumberResult(_key, duk_get_number(m_ctx, -1), _val);
 
-        switch (_key) {
-            case StyleParamKey::extrude:
-                _val = glm::vec2(0.f, static_cast<float>(duk_get_number(m_ctx, -1)));
-                break;
-            case StyleParamKey::width:
-            case StyleParamKey::outline_width: {
-                // TODO more efficient way to return pixels.
-                // atm this only works by return value as string
-                double v = duk_get_number(m_ctx, -1);
-                _val = StyleParam::Width{static_cast<float>(v)};
-                break;
-            }
-            case StyleParamKey::text_font_stroke_width: {
-                _val = static_cast<float>(duk_get_number(m_ctx, -1));
-                break;
-            }
-            case StyleParamKey::order:
-            case StyleParamKey::outline_order:
-            case StyleParamKey::priority:
-            case StyleParamKey::color:
-            case StyleParamKey::outline_color:
-            case StyleParamKey::text_font_fill:
-            case StyleParamKey::text_font_stroke_color: {
-                _val = static_cast<uint32_t>(duk_get_uint(m_ctx, -1));
-                break;
-            }
-            default:
-                break;
-        }
     } else if (duk_is_null_or_undefined(m_ctx, -1)) {
         // Ignore setting value
         LOGD("duk evaluates JS method to null or undefined.");
@@ -471,7 +798,7 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
 duk_ret_t StyleContext::jsHasProperty(duk_context *_ctx) {
 
     duk_get_prop_string(_ctx, 0, INSTANCE_ID);
-    auto* attr = static_cast<const StyleContext*> (duk_to_pointer(_ctx, -1));
+    auto* attr = static_cast<StyleContext*> (duk_to_pointer(_ctx, -1));
     if (!attr || !attr->m_feature) {
         LOGE("Error: no context set %p %p", attr, attr ? attr->m_feature : nullptr);
         duk_pop(_ctx);
@@ -479,6 +806,8 @@ duk_ret_t StyleContext::jsHasProperty(duk_context *_ctx) {
     }
 
     const char* key = duk_require_string(_ctx, 1);
+    if (attr->m_recordKeys) { attr->m_readKeys.emplace_back(key); }
+
     duk_push_boolean(_ctx, attr->m_feature->props.contains(key));
 
     return 1;
@@ -489,7 +818,7 @@ duk_ret_t StyleContext::jsGetProperty(duk_context *_ctx) {
 
     // Get the StyleContext instance from JS Feature object (first parameter).
     duk_get_prop_string(_ctx, 0, INSTANCE_ID);
-    auto* attr = static_cast<const StyleContext*> (duk_to_pointer(_ctx, -1));
+    auto* attr = static_cast<StyleContext*> (duk_to_pointer(_ctx, -1));
     if (!attr || !attr->m_feature) {
         LOGE("Error: no context set %p %p",  attr, attr ? attr->m_feature : nullptr);
         duk_pop(_ctx);
@@ -498,6 +827,7 @@ duk_ret_t StyleContext::jsGetProperty(duk_context *_ctx) {
 
     // Get the property name (second parameter)
     const char* key = duk_require_string(_ctx, 1);
+    if (attr->m_recordKeys) { attr->m_readKeys.emplace_back(key); }
 
     auto it = attr->m_feature->props.get(key);
     if (it.is<std::string>()) {
@@ -1,13 +1,16 @@
 #pragma once
 
+#include "scene/nativeFunction.h"
 #include "scene/styleParam.h"
 #include "util/fastmap.h"
+#include "util/memoCache.h"
 
 #include <string>
 #include <functional>
 #include <memory>
 #include <array>
 #include <unordered_map>
+#include <vector>
 
 struct duk_hthread;
 typedef struct duk_hthread duk_context;
@@ -55,11 +58,25 @@ public:
     /* Called from Filter::eval */
     bool evalFilter(FunctionID id);
 
+    /* Called from FilterProgram::eval: Returns property @_keyId (see
+     * Properties::keyId) of the current Feature. Lookups of keys with a
+     * slot of the scene PropertySlots are cached until the next call to
+     * setFeature() */
+    const Value& getProperty(uint32_t _slot, uint32_t _keyId);
+
+    /* Returns Properties::keySignature() of the current Feature, computed
+     * once per call to setFeature() */
+    uint64_t keySignature();
+
+    const Feature* feature() const { return m_feature; }
+
     /* Called from DrawRule::eval */
     bool evalStyle(FunctionID id, StyleParamKey _key, StyleParam::Value& _val);
 
     /*
-     * Setup filter and style functions from @_scene
+     * Setup filter and style functions from @_scene. The Duktape heap is
+     * kept when switching scenes and functions compiled by another
+     * StyleContext for the same scene are loaded from their bytecode
      */
     void initFunctions(const Scene& _scene);
 
@@ -75,12 +92,63 @@ public:
     void setKeyword(const std::string& _key, Value _value);
     const Value& getKeyword(const std::string& _key) const;
 
+    struct FunctionCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // Evaluated by a NativeFunction, without cache lookup
+        uint64_t native = 0;
+
+        float hitRate() const {
+            return hits + misses > 0 ? float(hits) / (hits + misses) : 0.f;
+        }
+    };
+
+    /* Results of evalFilter() and evalStyle() are memoised per function,
+     * keyed by the keywords and the feature properties the function read */
+    const FunctionCacheStats& functionCacheStats() const { return m_functionCacheStats; }
+
+    /* Functions in the subset of JS that NativeFunction compiles are evaluated
+     * without Duktape, unless disabled here (e.g. to compare in benchmarks) */
+    void setNativeFunctions(bool _enable) { m_nativeFunctionsEnabled = _enable; }
+
 private:
     static int jsGetProperty(duk_context *_ctx);
     static int jsHasProperty(duk_context *_ctx);
 
+    // Memoised results of one function. 'keys' are the property keys the
+    // function read in any evaluation so far, ordered by key id: two
+    // features with the same values for these and the same keywords give
+    // the same result.
+    struct FunctionCache {
+        struct Result {
+            std::vector<Value> args;
+            int kind;
+            bool ok;
+            StyleParam::Value value;
+        };
+        std::vector<PropertyKey> keys;
+        std::unordered_map<size_t, Result> results;
+        MemoWindow window;
+        // Not set for functions that are not deterministic or that rarely
+        // repeat a result
+        bool enabled = true;
+    };
+
+    FunctionCache* cacheLookup(FunctionID _id, int _kind, size_t& _hash, const FunctionCache::Result*& _result);
+    void cacheStore(FunctionCache& _cache, int _kind, size_t _hash, bool _ok, const StyleParam::Value& _value);
+    size_t cacheKey(const FunctionCache& _cache, int _kind);
+    bool cacheMatch(const FunctionCache& _cache, const FunctionCache::Result& _result);
+
+    void initFunctionState(const std::vector<std::string>& _functions, size_t _count);
+    void dumpFunctions(std::vector<std::string>& _bytecode);
+    void loadFunctions(const std::vector<std::string>& _functions,
+                       const std::vector<std::string>& _bytecode);
+
     bool evalFunction(FunctionID id);
+    bool evalNative(FunctionID _id, NativeFunction::JsValue& _result);
     void parseStyleResult(StyleParamKey _key, StyleParam::Value& _val) const;
+    void parseNativeResult(StyleParamKey _key, const NativeFunction::JsValue& _result,
+                           StyleParam::Value& _val) const;
     void parseSceneGlobals(const YAML::Node& node);
 
     std::array<Value, 4> m_keywords;
@@ -93,6 +161,31 @@ private:
 
     const Feature* m_feature = nullptr;
 
+    // Slots of the current scene, see initFunctions()
+    PropertySlots* m_propertySlots = nullptr;
+
+    // Property lookups of the current Feature by slot, valid when 'epoch'
+    // matches m_featureEpoch
+    struct CachedProperty {
+        uint32_t epoch = 0;
+        const Value* value = nullptr;
+    };
+    std::vector<CachedProperty> m_propertyCache;
+    uint32_t m_featureEpoch = 1;
+
+    uint64_t m_keySignature = 0;
+    uint32_t m_keySignatureEpoch = 0;
+
+    std::vector<NativeFunction> m_nativeFunctions;
+    bool m_nativeFunctionsEnabled = true;
+
+    std::vector<FunctionCache> m_functionCache;
+    FunctionCacheStats m_functionCacheStats;
+
+    // Property keys read by the function being evaluated for the cache
+    std::vector<std::string> m_readKeys;
+    bool m_recordKeys = false;
+
     mutable duk_context *m_ctx;
 };
 
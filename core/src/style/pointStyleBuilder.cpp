@@ -198,11 +198,13 @@ void PointStyleBuilder::addLabel(const Point& _point, const glm::vec4& _quad,
         v3 = rotateBy(v3, rotation);
     }
 
+    float scale = SpriteVertex::position_scale;
+
     m_quads.push_back({{
-        {v0, {uvBL.x, uvTR.y}},
-        {v1, {uvTR.x, uvTR.y}},
-        {v2, {uvBL.x, uvBL.y}},
-        {v3, {uvTR.x, uvBL.y}}},
+        {glm::i16vec2(v0 * scale), {uvBL.x, uvTR.y}},
+        {glm::i16vec2(v1 * scale), {uvTR.x, uvTR.y}},
+        {glm::i16vec2(v2 * scale), {uvBL.x, uvBL.y}},
+        {glm::i16vec2(v3 * scale), {uvTR.x, uvBL.y}}},
         _params.color});
 }
 
@@ -47,6 +47,8 @@ struct PointStyleBuilder : public StyleBuilder {
 
     void addLayoutItems(LabelCollider& _layout) override;
 
+    bool hasLayoutItems() const override { return true; }
+
     void addFeature(const Feature& _feat, const DrawRule& _rule) override;
 
 private:
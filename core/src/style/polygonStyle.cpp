@@ -84,7 +84,7 @@ struct PolygonStyleBuilder : public StyleBuilder {
 
 public:
 
-    struct {
+    struct Parameters {
         uint32_t order = 0;
         uint32_t color = 0xffffffff;
         glm::vec2 extrude;
@@ -110,17 +110,28 @@ public:
 
     std::unique_ptr<StyledMesh> build() override;
 
-    PolygonStyleBuilder(const PolygonStyle& _style) : StyleBuilder(_style), m_style(_style) {}
+    PolygonStyleBuilder(const PolygonStyle& _style)
+        : StyleBuilder(_style), m_style(_style) {}
 
     void parseRule(const DrawRule& _rule, const Properties& _props);
 
-    PolygonBuilder& polygonBuilder() { return m_builder; }
+    // Adds the vertices of m_builder to the mesh with the current parameters
+    struct VertexFn {
+        MeshData<V>* mesh = nullptr;
+        const Parameters* params = nullptr;
+
+        void operator()(const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv) {
+            mesh->vertices.push_back({ coord, params->order, normal, uv, params->color });
+        }
+    };
+
+    PolygonBuilder<VertexFn>& polygonBuilder() { return m_builder; }
 
 private:
 
     const PolygonStyle& m_style;
 
-    PolygonBuilder m_builder;
+    PolygonBuilder<VertexFn> m_builder;
 
     MeshData<V> m_meshData;
 
@@ -162,11 +173,7 @@ void PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Propertie
 
     parseRule(_rule, _props);
 
-    m_builder.addVertex = [this](const glm::vec3& coord,
-                                 const glm::vec3& normal,
-                                 const glm::vec2& uv) {
-        m_meshData.vertices.push_back({ coord, m_params.order, normal, uv, m_params.color });
-    };
+    m_builder.addVertex = { &m_meshData, &m_params };
 
     if (m_params.minHeight != m_params.height) {
         Builders::buildPolygonExtrusion(_polygon, m_params.minHeight,
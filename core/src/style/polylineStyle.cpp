@@ -45,6 +45,21 @@ struct PolylineVertexNoUVs {
     glm::i16vec4 pos;
     glm::i16vec4 extrude;
     GLuint abgr;
+
+    // The quantized attributes, see Builders::packPolyLineVertices()
+    PolyLinePackFormat packFormat() const {
+        PolyLinePackFormat format;
+        format.positionScale = position_scale;
+        format.extrusionScale = extrusion_scale;
+        format.texcoordScale = texture_scale;
+        format.position = offset(&pos);
+        format.extrusion = offset(&extrude);
+        return format;
+    }
+
+    size_t offset(const void* _attribute) const {
+        return static_cast<const char*>(_attribute) - reinterpret_cast<const char*>(this);
+    }
 };
 
 struct PolylineVertex : PolylineVertexNoUVs {
@@ -58,6 +73,13 @@ struct PolylineVertex : PolylineVertexNoUVs {
           texcoord(v.texcoord) {}
 
     glm::u16vec2 texcoord;
+
+    PolyLinePackFormat packFormat() const {
+        PolyLinePackFormat format = PolylineVertexNoUVs::packFormat();
+        format.hasTexcoord = true;
+        format.texcoord = offset(&texcoord);
+        return format;
+    }
 };
 
 PolylineStyle::PolylineStyle(std::string _name, Blending _blendMode, GLenum _drawMode)
@@ -183,12 +205,24 @@ public:
 
     bool evalWidth(const StyleParam& _styleParam, float& width, float& slope);
 
-    PolyLineBuilder& polylineBuilder() { return m_builder; }
+    // Stages the vertices of m_builder, buildLine() packs them into the
+    // mesh that is currently built
+    struct VertexFn {
+        std::vector<PolyLineVertexData>* vertices = nullptr;
+        float zoom = 1;
+
+        void operator()(const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
+            vertices->push_back({ { coord.x, coord.y }, normal, { uv.x, uv.y * zoom } });
+        }
+    };
+
+    PolyLineBuilder<VertexFn>& polylineBuilder() { return m_builder; }
 
 private:
 
     const PolylineStyle& m_style;
-    PolyLineBuilder m_builder;
+    PolyLineBuilder<VertexFn> m_builder;
+    std::vector<PolyLineVertexData> m_vertexData;
 
     std::vector<MeshData<V>> m_meshData;
 
@@ -409,14 +443,23 @@ template <class V>
 void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parameters::Attributes& _att,
                         MeshData<V>& _mesh) {
 
-    float zoom = m_overzoom2;
-    m_builder.addVertex = [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
-        _mesh.vertices.push_back({{ coord.x,coord.y }, normal, { uv.x, uv.y * zoom },
-                                  _att.width, _att.height, _att.color});
-    };
+    m_builder.addVertex = { &m_vertexData, m_overzoom2 };
 
     Builders::buildPolyLine(_line, m_builder);
 
+    // Attributes of the whole line, the packed ones are overwritten
+    V prototype({ 0.f, 0.f }, { 0.f, 0.f }, { 0.f, 0.f }, _att.width, _att.height, _att.color);
+
+    size_t first = _mesh.vertices.size();
+    _mesh.vertices.resize(first + m_vertexData.size(), prototype);
+
+    auto format = prototype.packFormat();
+    format.stride = sizeof(V);
+
+    Builders::packPolyLineVertices(m_vertexData.data(), m_vertexData.size(), format,
+                                   reinterpret_cast<char*>(_mesh.vertices.data() + first));
+    m_vertexData.clear();
+
     _mesh.indices.insert(_mesh.indices.end(),
                          m_builder.indices.begin(),
                          m_builder.indices.end());
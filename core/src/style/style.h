@@ -86,6 +86,9 @@ public:
 
     virtual void addLayoutItems(LabelCollider& _layout) {}
 
+    /* Whether the builder creates labels that are passed to addLayoutItems() */
+    virtual bool hasLayoutItems() const { return false; }
+
     virtual const Style& style() const = 0;
 
 protected:
@@ -51,6 +51,8 @@ public:
 
     void addLayoutItems(LabelCollider& _layout) override;
 
+    bool hasLayoutItems() const override { return true; }
+
 protected:
 
     const TextStyle& m_style;
@@ -21,6 +21,7 @@
 #include "util/fastmap.h"
 #include "view/view.h"
 #include "data/clientGeoJsonSource.h"
+#include "data/diskCache.h"
 #include "gl.h"
 #include "gl/hardware.h"
 #include "util/ease.h"
@@ -28,6 +29,7 @@
 #include "debug/textDisplay.h"
 #include "debug/frameInfo.h"
 
+#include <atomic>
 #include <cmath>
 #include <bitset>
 
@@ -53,6 +55,9 @@ public:
 
     void setPixelScale(float _pixelsPerPoint);
 
+    // Update prefetchTiles for the destination of the current eases or fling
+    void updatePrefetchTiles();
+
     std::mutex tilesMutex;
     std::mutex sceneMutex;
 
@@ -66,9 +71,32 @@ public:
     std::vector<SceneUpdate> sceneUpdates;
     std::array<Ease, 4> eases;
 
+    // Destinations of the position and zoom eases, set from any thread
+    std::mutex easeMutex;
+    glm::dvec2 easePosition;
+    float easeZoom = 0;
+
+    // View at the predicted destination and the tiles visible from there
+    View prefetchView;
+    VisibleTiles prefetchTiles;
+    std::vector<TileID> prefetchScratch;
+
+    // Destination of the last prefetchView update, zoom -1 when not moving
+    glm::dvec2 prefetchPosition;
+    int prefetchZoom = -1;
+    // Size, pitch, roll and pixel scale of the view copied to prefetchView
+    std::array<float, 5> prefetchCamera;
+
+    // Seconds of fling movement to load tiles ahead for, set from any thread
+    std::atomic<float> prefetchHorizon{0.5f};
+    // Tiles loading ahead at a time, 0 when prefetching is disabled
+    std::atomic<size_t> prefetchBudget{TileManager::DEFAULT_PREFETCH_BUDGET};
+
     std::shared_ptr<Scene> scene = std::make_shared<Scene>();
     std::shared_ptr<Scene> nextScene = nullptr;
 
+    std::shared_ptr<DiskCache> diskCache;
+
     // NB: Destruction of (managed and loading) tiles must happen
     // before implicit destruction of 'scene' above!
     // In particular any references of Labels and Markers to FontContext
@@ -89,6 +117,79 @@ void Map::Impl::clearEase(EaseField _f) {
     eases[static_cast<size_t>(_f)] = none;
 }
 
+void Map::Impl::updatePrefetchTiles() {
+
+    if (prefetchBudget == 0) {
+        prefetchTiles.clear();
+        prefetchZoom = -1;
+        return;
+    }
+
+    glm::dvec2 position(view.getPosition().x, view.getPosition().y);
+    float zoom = view.getZoom();
+    bool moving = false;
+
+    {
+        std::lock_guard<std::mutex> lock(easeMutex);
+        if (!eases[static_cast<size_t>(EaseField::position)].finished()) {
+            position = easePosition;
+            moving = true;
+        }
+        if (!eases[static_cast<size_t>(EaseField::zoom)].finished()) {
+            zoom = easeZoom;
+            moving = true;
+        }
+    }
+
+    glm::vec2 flingTranslation;
+    float flingZoom;
+    float horizon = prefetchHorizon;
+    if (!moving && horizon > 0 &&
+        inputHandler.predictFling(horizon, flingTranslation, flingZoom)) {
+        position += glm::dvec2(flingTranslation);
+        zoom += flingZoom;
+        moving = true;
+    }
+
+    if (!moving) {
+        prefetchTiles.clear();
+        prefetchZoom = -1;
+        return;
+    }
+
+    std::array<float, 5> camera = {{ view.getWidth(), view.getHeight(), view.getPitch(),
+                                     view.getRoll(), view.pixelScale() }};
+
+    bool cameraChanged = prefetchZoom < 0 || camera != prefetchCamera;
+
+    if (!cameraChanged && int(zoom) == prefetchZoom) {
+        // The visible tiles change at tile boundaries: keep them while the
+        // destination stays within a tile of the last one
+        double tileSize = 2 * MapProjection::HALF_CIRCUMFERENCE / std::exp2(prefetchZoom);
+        if (std::abs(position.x - prefetchPosition.x) < tileSize &&
+            std::abs(position.y - prefetchPosition.y) < tileSize) {
+            return;
+        }
+    }
+
+    if (cameraChanged) {
+        // Same camera as the view, moved to the destination
+        prefetchView = view;
+        prefetchCamera = camera;
+    }
+
+    prefetchPosition = position;
+    prefetchZoom = int(zoom);
+
+    prefetchView.setPosition(position.x, position.y);
+    prefetchView.setZoom(zoom);
+    prefetchView.update();
+
+    // Keeps the version while the destination tiles stay the same
+    prefetchScratch = prefetchView.getVisibleTiles().tiles();
+    prefetchTiles.update(prefetchScratch);
+}
+
 static std::bitset<8> g_flags = 0;
 
 Map::Map() {
@@ -108,9 +209,11 @@ Map::~Map() {
 }
 
 void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
+    std::shared_ptr<DiskCache> sceneDiskCache;
     {
         std::lock_guard<std::mutex> lock(sceneMutex);
         scene = _scene;
+        sceneDiskCache = diskCache;
     }
 
     scene->setPixelScale(view.pixelScale());
@@ -147,6 +250,18 @@ void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
     }
 
     inputHandler.setView(view);
+
+    if (sceneDiskCache) {
+        // Sources are not loading yet, TileManager keeps its current
+        // sources when they are equal to the new ones.
+        for (auto& source : _scene->dataSources()) {
+            source->setDiskCache(sceneDiskCache);
+            for (auto& raster : source->rasterSources()) {
+                raster->setDiskCache(sceneDiskCache);
+            }
+        }
+    }
+
     tileManager.setDataSources(_scene->dataSources());
     tileWorker.setScene(_scene);
     markerManager.setScene(_scene);
@@ -317,6 +432,8 @@ bool Map::update(float _dt) {
 
     impl->view.update();
 
+    impl->updatePrefetchTiles();
+
     impl->markerManager.update(static_cast<int>(impl->view.getZoom()));
 
     for (const auto& style : impl->scene->styles()) {
@@ -326,7 +443,8 @@ bool Map::update(float _dt) {
     {
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
-        impl->tileManager.updateTileSets(impl->view.state(), impl->view.getVisibleTiles());
+        impl->tileManager.updateTileSets(impl->view.state(), impl->view.getVisibleTiles(),
+                                         impl->prefetchTiles);
 
         auto& tiles = impl->tileManager.getVisibleTiles();
         auto& markers = impl->markerManager.markers();
@@ -342,10 +460,14 @@ bool Map::update(float _dt) {
             for (const auto& tile : tiles) {
                 tile->update(_dt, impl->view);
             }
+            FrameInfo::beginLabels();
             impl->labels.updateLabelSet(impl->view.state(), _dt, impl->scene->styles(), tiles, markers,
                                         *impl->tileManager.getTileCache());
+            FrameInfo::endLabels();
         } else {
+            FrameInfo::beginLabels();
             impl->labels.updateLabels(impl->view.state(), _dt, impl->scene->styles(), tiles, markers);
+            FrameInfo::endLabels();
         }
     }
 
@@ -457,6 +579,10 @@ void Map::setPositionEased(double _lon, double _lat, float _duration, EaseType _
     auto cb = [=](float t) { impl->setPositionNow(ease(lon_start, _lon, t, _e), ease(lat_start, _lat, t, _e)); };
     impl->setEase(EaseField::position, { _duration, cb });
 
+    glm::dvec2 destination = impl->view.getMapProjection().LonLatToMeters({ _lon, _lat });
+    std::lock_guard<std::mutex> lock(impl->easeMutex);
+    impl->easePosition = destination;
+
 }
 
 void Map::getPosition(double& _lon, double& _lat) {
@@ -489,6 +615,9 @@ void Map::setZoomEased(float _z, float _duration, EaseType _e) {
     auto cb = [=](float t) { impl->setZoomNow(ease(z_start, _z, t, _e)); };
     impl->setEase(EaseField::zoom, { _duration, cb });
 
+    std::lock_guard<std::mutex> lock(impl->easeMutex);
+    impl->easeZoom = _z;
+
 }
 
 float Map::getZoom() {
@@ -635,6 +764,31 @@ void Map::clearDataSource(DataSource& _source, bool _data, bool _tiles) {
     requestRender();
 }
 
+void Map::setDiskCache(const char* _path, size_t _maxSize) {
+
+    std::shared_ptr<DiskCache> diskCache;
+
+    if (_path && *_path) {
+        diskCache = std::make_shared<DiskCache>(_path, _maxSize);
+        if (!diskCache->isOpen()) { diskCache.reset(); }
+    }
+
+    std::lock_guard<std::mutex> lock(impl->sceneMutex);
+    impl->diskCache = diskCache;
+}
+
+void Map::setTileSplitThreshold(size_t _features) {
+    impl->tileWorker.setSplitThreshold(_features);
+}
+
+void Map::setTilePrefetch(float _horizon, size_t _maxTiles) {
+    impl->prefetchHorizon = _horizon;
+    impl->prefetchBudget = _maxTiles;
+
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+    impl->tileManager.setPrefetchBudget(_maxTiles);
+}
+
 MarkerID Map::markerAdd() {
     return impl->markerManager.add();
 }
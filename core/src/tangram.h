@@ -150,6 +150,20 @@ public:
 
     void clearDataSource(DataSource& _source, bool _data, bool _tiles);
 
+    // Persist downloaded tile data in the file at _path, using at most _maxSize bytes;
+    // applies to the data sources of scenes loaded after this call. An empty path
+    // disables the disk cache.
+    void setDiskCache(const char* _path, size_t _maxSize);
+
+    // Build tiles with at least _features features in parts on all worker threads;
+    // the result is the same as when built on one thread. 0 (the default) disables it.
+    void setTileSplitThreshold(size_t _features);
+
+    // Load tiles ahead for the destination of position and zoom eases and of flings;
+    // flings are predicted _horizon seconds ahead and at most _maxTiles tiles load
+    // ahead at a time. _maxTiles = 0 disables it; defaults are 0.5 seconds and 8 tiles.
+    void setTilePrefetch(float _horizon, size_t _maxTiles);
+
     // Add a marker object to the map and return an ID for it; an ID of 0 indicates an invalid marker;
     // the marker will not be drawn until both styling and geometry are set using the functions below.
     MarkerID markerAdd();
@@ -0,0 +1,170 @@
+#include "downloadScheduler.h"
+
+#include "data/dataSource.h"
+#include "platform.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+constexpr size_t DownloadScheduler::DEFAULT_MAX_ACTIVE;
+
+// Set while this thread starts downloads. DataSources may deliver their data
+// from within loadTileData(), the running dispatch loop then continues with
+// the next request instead of recursing.
+static thread_local bool s_dispatching = false;
+
+DownloadScheduler::DownloadScheduler(size_t _maxActive) : m_maxActive(_maxActive) {}
+
+void DownloadScheduler::enqueue(std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Request request{ _task->isProxy(), _task->getPriority(), std::move(_task), std::move(_cb) };
+
+    auto it = std::lower_bound(m_queue.begin(), m_queue.end(), request);
+    m_queue.insert(it, std::move(request));
+}
+
+void DownloadScheduler::update() {
+
+    std::vector<std::shared_ptr<TileTask>> canceled;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Tiles that went out of view
+        m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(),
+                                     [](auto& r) { return r.task->isCanceled(); }),
+                      m_queue.end());
+
+        for (auto& request : m_queue) {
+            request.proxy = request.task->isProxy();
+            request.priority = request.task->getPriority();
+        }
+        std::sort(m_queue.begin(), m_queue.end());
+
+        for (auto& download : m_active) {
+            if (download.task->isCanceled()) { canceled.push_back(download.task); }
+        }
+    }
+
+    // A download keeps its slot until its callback is called, unless its
+    // url request is canceled here: the callback is not called after that.
+    for (auto& task : canceled) {
+        task->source().cancelDownload(task->tileId());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        release(*task);
+    }
+
+    dispatch();
+}
+
+void DownloadScheduler::setMaxActive(size_t _maxActive) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxActive = _maxActive;
+    }
+    dispatch();
+}
+
+size_t DownloadScheduler::pending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+size_t DownloadScheduler::active() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_active.size();
+}
+
+bool DownloadScheduler::next(Request& _request) {
+
+    if (m_active.size() >= m_maxActive) { return false; }
+
+    for (size_t i = m_queue.size(); i-- > 0; ) {
+        auto& task = m_queue[i].task;
+
+        if (task->isCanceled()) {
+            m_queue.erase(m_queue.begin() + i);
+            continue;
+        }
+
+        auto& source = task->source();
+        auto& count = m_sourceActive[source.id()];
+        if (source.maxDownloads() > 0 && count >= source.maxDownloads()) {
+            continue;
+        }
+
+        count++;
+        m_active.push_back({ task, source.id() });
+
+        _request = std::move(m_queue[i]);
+        m_queue.erase(m_queue.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+void DownloadScheduler::release(const TileTask& _task) {
+
+    auto it = std::find_if(m_active.begin(), m_active.end(),
+                           [&](auto& d) { return d.task.get() == &_task; });
+
+    // Already released, when the callback of a canceled download
+    // was running while its url request was canceled
+    if (it == m_active.end()) { return; }
+
+    m_sourceActive[it->sourceId]--;
+
+    *it = std::move(m_active.back());
+    m_active.pop_back();
+}
+
+void DownloadScheduler::finished(const TileTask& _task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        release(_task);
+    }
+
+    dispatch();
+}
+
+void DownloadScheduler::dispatch() {
+
+    if (s_dispatching) { return; }
+    s_dispatching = true;
+
+    Request request;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!next(request)) { break; }
+        }
+
+        auto task = request.task;
+
+        TileTaskCb cb{[this, cb = std::move(request.cb)](std::shared_ptr<TileTask>&& _task) {
+            finished(*_task);
+            cb.func(std::move(_task));
+        }};
+
+        if (!task->source().loadTileData(std::move(request.task), std::move(cb))) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                release(*task);
+            }
+
+            // Raster sub-tasks are set ready with an empty texture. Canceled
+            // tiles will not be loaded again until their source generation
+            // changes.
+            if (!task->isReady()) { task->cancel(); }
+            requestRender();
+        }
+    }
+
+    s_dispatching = false;
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "tile/tileTask.h"
+#include "util/fastmap.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+/* DownloadScheduler
+ *
+ * Central queue for the tile downloads of all DataSources, including the
+ * raster sub-tasks of tiles. Downloads are started in order of their task
+ * priority: tiles that are not only needed as proxies first, then by distance
+ * to the view center (see TileManager::updateTileSet()).
+ *
+ * At most 'maxActive' downloads run at the same time and at most
+ * DataSource::maxDownloads() per source. When a download finishes, the next
+ * queued one is started from the thread that delivered the data, so that the
+ * queue does not have to wait for the next frame.
+ *
+ * A running download holds its slot until the DataSource calls back, also
+ * for canceled tasks, or until update() canceled its url request.
+ */
+class DownloadScheduler {
+
+public:
+
+    static constexpr size_t DEFAULT_MAX_ACTIVE = 4;
+
+    DownloadScheduler(size_t _maxActive = DEFAULT_MAX_ACTIVE);
+
+    DownloadScheduler(const DownloadScheduler&) = delete;
+    DownloadScheduler& operator=(const DownloadScheduler&) = delete;
+
+    /* Queue the download of _task, _cb is passed on to DataSource::loadTileData() */
+    void enqueue(std::shared_ptr<TileTask> _task, TileTaskCb _cb);
+
+    /* Re-rank queued downloads by the current priorities of their tasks, drop
+     * canceled ones, stop the running downloads of canceled tasks and start
+     * downloads for free slots. Called once per frame by TileManager after
+     * updating the task priorities. */
+    void update();
+
+    void setMaxActive(size_t _maxActive);
+
+    /* Number of queued downloads */
+    size_t pending();
+
+    /* Number of running downloads */
+    size_t active();
+
+private:
+
+    struct Request {
+        // Snapshot of the task priority, so that queue order does not
+        // change while TileManager updates the task priorities.
+        bool proxy;
+        double priority;
+        std::shared_ptr<TileTask> task;
+        TileTaskCb cb;
+
+        // Queue order: the greatest request is started first
+        bool operator<(const Request& _other) const {
+            if (proxy != _other.proxy) { return proxy; }
+            return priority > _other.priority;
+        }
+    };
+
+    struct Download {
+        std::shared_ptr<TileTask> task;
+        int32_t sourceId;
+    };
+
+    void dispatch();
+    void finished(const TileTask& _task);
+
+    // Must be called with m_mutex held
+    bool next(Request& _request);
+    void release(const TileTask& _task);
+
+    std::mutex m_mutex;
+
+    size_t m_maxActive;
+
+    // Sorted, most urgent request last
+    std::vector<Request> m_queue;
+
+    std::vector<Download> m_active;
+
+    // Running downloads per source id
+    fastmap<int32_t, size_t> m_sourceActive;
+};
+
+}
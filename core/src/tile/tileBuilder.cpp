@@ -7,18 +7,46 @@
 #include "style/style.h"
 #include "tile/tile.h"
 #include "util/mapProjection.h"
+#include "util/simplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
 
 namespace Tangram {
 
-TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
-    : m_scene(_scene) {
+TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene, std::unique_ptr<StyleContext> _styleContext)
+    : m_scene(_scene),
+      m_styleContext(std::move(_styleContext)) {
 
-    m_styleContext.initFunctions(*_scene);
+    if (!m_styleContext) {
+        m_styleContext = std::make_unique<StyleContext>();
+    }
+    m_styleContext->initFunctions(*_scene);
 
     // Initialize StyleBuilders
     for (auto& style : _scene->styles()) {
         m_styleBuilder[style->getName()] = style->createBuilder();
     }
+
+    // Smallest 'simplify' tolerance of the DataLayers of each source and collection
+    for (const auto& datalayer : _scene->layers()) {
+        auto& tolerances = m_simplifyTolerances[datalayer.source()];
+        float tolerance = datalayer.simplify();
+
+        if (tolerances.unnamed < 0 || tolerance < tolerances.unnamed) {
+            tolerances.unnamed = tolerance;
+        }
+
+        for (const auto& name : datalayer.collections()) {
+            auto it = tolerances.collections.find(name);
+            if (it == tolerances.collections.end()) {
+                tolerances.collections[name] = tolerance;
+            } else if (tolerance < it->second) {
+                it->second = tolerance;
+            }
+        }
+    }
 }
 
 TileBuilder::~TileBuilder() {}
@@ -36,13 +64,133 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
 
     tile->initGeometry(m_scene->styles().size());
 
-    m_styleContext.setKeywordZoom(_tileID.s);
+    size_t parts = 1;
+    if (m_executor) {
+        size_t features = 0;
+        for (const auto& collection : _tileData.layers) {
+            features += collection.features.size();
+        }
+        parts = m_executor->splitCount(features);
+    }
+
+    if (parts <= 1) {
+        std::vector<bool> allStyles(m_scene->styles().size(), true);
+
+        for (auto& mesh : buildStyles(*tile, _tileData, _source, allStyles)) {
+            tile->setMesh(*mesh.first, std::move(mesh.second));
+        }
+        return tile;
+    }
+
+    // Split the tile by styles: the features are matched once, then each part
+    // applies the matched rules of all features but passes them only to the
+    // StyleBuilders of its own styles. Every mesh is thus built from the same
+    // features in the same order as in a serial build, independent of which
+    // worker builds it.
+    auto matches = matchFeatures(*tile, _tileData, _source);
+
+    auto styleSets = splitStyles(parts, usedStyles(matches));
+    std::vector<StyleMeshes> results(styleSets.size());
+
+    std::vector<TileBuildExecutor::Job> jobs;
+    for (size_t i = 0; i < styleSets.size(); i++) {
+        jobs.push_back([&, i](TileBuilder& _builder) {
+                results[i] = _builder.buildStyles(*tile, matches, styleSets[i]);
+            });
+    }
+
+    m_executor->execute(*this, jobs);
+
+    for (auto& meshes : results) {
+        for (auto& mesh : meshes) {
+            tile->setMesh(*mesh.first, std::move(mesh.second));
+        }
+    }
+
+    return tile;
+}
+
+size_t TileBuilder::simplify(TileID _tileID, TileData& _tileData, const DataSource& _source) {
+
+    // Pixel size of the tile when it is drawn largest: just before the next
+    // zoom level, magnified further when it is overzoomed
+    float tileSize = m_scene->mapProjection()->TileSize() * std::exp2(_tileID.s - _tileID.z + 1);
+
+    size_t removed = 0;
+
+    auto tolerances = m_simplifyTolerances.find(_source.name());
+    if (tolerances == m_simplifyTolerances.end()) { return removed; }
+
+    for (auto& collection : _tileData.layers) {
+
+        // Same rule as in build(): unnamed collections are used by all layers
+        float tolerance = tolerances->second.unnamed;
+
+        if (!collection.name.empty()) {
+            auto it = tolerances->second.collections.find(collection.name);
+            tolerance = (it != tolerances->second.collections.end()) ? it->second : -1;
+        }
+
+        if (tolerance <= 0) { continue; }
+
+        tolerance /= tileSize;
+
+        for (auto& feature : collection.features) {
+            if (feature.geometryType == GeometryType::lines) {
+                for (auto& line : feature.lines) {
+                    removed += simplifyLine(line, tolerance);
+                }
+            } else if (feature.geometryType == GeometryType::polygons) {
+                for (auto& polygon : feature.polygons) {
+                    removed += simplifyPolygon(polygon, tolerance);
+                }
+            }
+        }
+    }
+
+    return removed;
+}
+
+void TileBuilder::beginStyles(const Tile& _tile, const std::vector<bool>& _styles) {
+
+    m_selectedStyles = &_styles;
+
+    m_styleContext->setKeywordZoom(_tile.getID().s);
+
+    for (auto& builder : m_styleBuilder) {
+        if (builder.second && isSelected(*builder.second))
+            builder.second->setup(_tile);
+    }
+}
+
+TileBuilder::StyleMeshes TileBuilder::endStyles(const Tile& _tile) {
+    StyleMeshes meshes;
+
+    for (auto& builder : m_styleBuilder) {
+        if (isSelected(*builder.second))
+            builder.second->addLayoutItems(m_labelLayout);
+    }
+
+    float tileSize = m_scene->mapProjection()->TileSize() * m_scene->pixelScale();
+
+    m_labelLayout.process(_tile.getID(), _tile.getInverseScale(), tileSize);
 
     for (auto& builder : m_styleBuilder) {
-        if (builder.second)
-            builder.second->setup(*tile);
+        if (isSelected(*builder.second))
+            meshes.emplace_back(&builder.second->style(), builder.second->build());
     }
 
+    m_selectedStyles = nullptr;
+
+    return meshes;
+}
+
+TileBuilder::StyleMeshes TileBuilder::buildStyles(const Tile& _tile, const TileData& _tileData,
+                                                  const DataSource& _source,
+                                                  const std::vector<bool>& _styles) {
+
+    beginStyles(_tile, _styles);
+
     for (const auto& datalayer : m_scene->layers()) {
 
         if (datalayer.source() != _source.name()) { continue; }
@@ -58,25 +206,168 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
             }
 
             for (const auto& feat : collection.features) {
-                m_ruleSet.apply(feat, datalayer, m_styleContext, *this);
+                m_ruleSet.apply(feat, datalayer, *m_styleContext, *this);
             }
         }
     }
 
-    for (auto& builder : m_styleBuilder) {
+    return endStyles(_tile);
+}
+
+std::vector<TileBuilder::MatchedFeature> TileBuilder::matchFeatures(const Tile& _tile,
+                                                                    const TileData& _tileData,
+                                                                    const DataSource& _source) {
+    std::vector<MatchedFeature> matches;
 
-        builder.second->addLayoutItems(m_labelLayout);
+    m_styleContext->setKeywordZoom(_tile.getID().s);
+
+    for (const auto& datalayer : m_scene->layers()) {
+
+        if (datalayer.source() != _source.name()) { continue; }
+
+        for (const auto& collection : _tileData.layers) {
+
+            if (!collection.name.empty()) {
+                const auto& dlc = datalayer.collections();
+                bool layerContainsCollection =
+                    std::find(dlc.begin(), dlc.end(), collection.name) != dlc.end();
+
+                if (!layerContainsCollection) { continue; }
+            }
+
+            for (const auto& feat : collection.features) {
+                if (m_ruleSet.match(feat, datalayer, *m_styleContext)) {
+                    matches.push_back({ &feat, m_ruleSet.matchedLayers() });
+                }
+            }
+        }
     }
 
-    float tileSize = m_scene->mapProjection()->TileSize() * m_scene->pixelScale();
+    return matches;
+}
+
+TileBuilder::StyleMeshes TileBuilder::buildStyles(const Tile& _tile,
+                                                  const std::vector<MatchedFeature>& _features,
+                                                  const std::vector<bool>& _styles) {
+
+    beginStyles(_tile, _styles);
+
+    for (const auto& match : _features) {
+        m_ruleSet.apply(*match.feature, match.layers, *m_styleContext, *this);
+    }
+
+    return endStyles(_tile);
+}
+
+bool TileBuilder::isSelected(const StyleBuilder& _builder) const {
+    return !m_selectedStyles || (*m_selectedStyles)[_builder.style().getID()];
+}
+
+std::vector<bool> TileBuilder::usedStyles(const std::vector<MatchedFeature>& _features) const {
+
+    std::vector<bool> used(m_scene->styles().size(), false);
+
+    auto use = [&](const std::string& _name) {
+        auto it = m_styleBuilder.find(_name);
+        if (it != m_styleBuilder.end()) { used[it->second->style().getID()] = true; }
+    };
+
+    // Rules of the same name merge over the matched layers, so this may
+    // include a style that a merged rule replaces, but never misses one
+    std::unordered_set<const SceneLayer*> layers;
+    for (const auto& match : _features) {
+        for (auto* layer : match.layers) {
+            if (!layers.insert(layer).second) { continue; }
 
-    m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize);
+            for (const auto& rule : layer->rules()) {
+                use(rule.name);
+                for (const auto& param : rule.parameters) {
+                    if ((param.key == StyleParamKey::style || param.key == StyleParamKey::outline_style) &&
+                        param.value.is<std::string>()) {
+                        use(param.value.get<std::string>());
+                    }
+                }
+            }
+        }
+    }
+    return used;
+}
+
+std::vector<std::vector<bool>> TileBuilder::splitStyles(size_t _parts, const std::vector<bool>& _used) const {
+
+    size_t numStyles = m_scene->styles().size();
+
+    // The LabelCollider needs all labels of a tile at once: keep the label
+    // styles together in the first part, distribute the others round-robin.
+    // Only styles with features of this tile count, any more parts would
+    // build nothing.
+    bool usesLabels = false;
+    size_t usedStyles = 0;
+    for (auto& builder : m_styleBuilder) {
+        if (!_used[builder.second->style().getID()]) { continue; }
 
+        if (builder.second->hasLayoutItems()) {
+            usesLabels = true;
+        } else {
+            usedStyles++;
+        }
+    }
+    _parts = std::max<size_t>(1, std::min(_parts, usedStyles + (usesLabels ? 1 : 0)));
+
+    std::vector<std::vector<bool>> styleSets(_parts, std::vector<bool>(numStyles, false));
+
+    size_t next = usesLabels ? 1 : 0;
     for (auto& builder : m_styleBuilder) {
-        tile->setMesh(builder.second->style(), builder.second->build());
+        size_t id = builder.second->style().getID();
+
+        if (builder.second->hasLayoutItems() || !_used[id]) {
+            styleSets[0][id] = true;
+        } else {
+            styleSets[next++ % _parts][id] = true;
+        }
     }
+    return styleSets;
+}
 
-    return tile;
+TileBuilder::DataLayerSelection::DataLayerSelection(TileBuilder& _builder, const DataSource& _source) {
+
+    for (const auto& datalayer : _builder.m_scene->layers()) {
+        if (datalayer.source() == _source.name()) {
+            m_layers.push_back(&datalayer);
+        }
+    }
+}
+
+bool TileBuilder::DataLayerSelection::containsCollection(const DataLayer& _layer,
+                                                         const std::string& _name) const {
+    // Same rule as in build(): unnamed collections are used by all layers
+    if (_name.empty()) { return true; }
+
+    const auto& dlc = _layer.collections();
+    return std::find(dlc.begin(), dlc.end(), _name) != dlc.end();
+}
+
+bool TileBuilder::DataLayerSelection::selectLayer(const std::string& _name) const {
+
+    for (auto* layer : m_layers) {
+        if (containsCollection(*layer, _name)) { return true; }
+    }
+    return false;
+}
+
+bool TileBuilder::DataLayerSelection::selectFeature(const std::string& _layer, const Feature& _feature) {
+
+    // Only the keys of the feature are tested here: evaluating the filters,
+    // and their functions, is left to DrawRuleMergeSet::match() in build()
+    uint64_t keySignature = _feature.props.keySignature();
+
+    for (auto* layer : m_layers) {
+        if (!layer->visible() || !containsCollection(*layer, _layer)) { continue; }
+
+        // A feature without the keys of the top-level filter can not match any sublayer
+        if (layer->filterProgram().mayMatch(keySignature)) { return true; }
+    }
+    return false;
 }
 
 }
@@ -1,23 +1,52 @@
 #pragma once
 
 #include "data/dataSource.h"
+#include "data/tileData.h"
 #include "scene/styleContext.h"
 #include "scene/drawRule.h"
 #include "labels/labelCollider.h"
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace Tangram {
 
 class DataLayer;
 class DataSource;
+class Style;
+struct StyledMesh;
 class Tile;
 struct TileData;
 class StyleBuilder;
+class TileBuilder;
+
+/* TileBuildExecutor
+ *
+ * Runs the parts of a tile that is built on several threads, see
+ * TileBuilder::build(). The first job runs on the calling thread with
+ * the calling TileBuilder; the others may be taken by idle workers and
+ * run with their own TileBuilder for the same Scene.
+ */
+struct TileBuildExecutor {
+    using Job = std::function<void(TileBuilder&)>;
+
+    virtual ~TileBuildExecutor() {}
+
+    /* Number of parts to build a tile with _features features in, 1 to build it serially */
+    virtual size_t splitCount(size_t _features) const = 0;
+
+    /* Returns when all _jobs are done */
+    virtual void execute(TileBuilder& _builder, std::vector<Job>& _jobs) = 0;
+};
 
 class TileBuilder {
 
 public:
 
-    TileBuilder(std::shared_ptr<Scene> _scene);
+    /* Reuses the Duktape heap of _styleContext when given, see
+     * StyleContext::initFunctions() */
+    TileBuilder(std::shared_ptr<Scene> _scene, std::unique_ptr<StyleContext> _styleContext = nullptr);
 
     ~TileBuilder();
 
@@ -25,17 +54,100 @@ public:
 
     std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const DataSource& _source);
 
+    /* Simplify the lines and polygons of _data for the DataLayers that set a
+     * 'simplify' tolerance. Collections used by several DataLayers get the
+     * smallest tolerance of them. Returns the number of removed points. */
+    size_t simplify(TileID _tileID, TileData& _data, const DataSource& _source);
+
+    using StyleMeshes = std::vector<std::pair<const Style*, std::unique_ptr<StyledMesh>>>;
+
+    /* Build the meshes of the styles selected in _styles (indexed by Style id) only */
+    StyleMeshes buildStyles(const Tile& _tile, const TileData& _data, const DataSource& _source,
+                            const std::vector<bool>& _styles);
+
+    /* Whether features are added to _builder in the current build */
+    bool isSelected(const StyleBuilder& _builder) const;
+
+    /* Large tiles are split into parts when an executor is set */
+    void setExecutor(TileBuildExecutor* _executor) { m_executor = _executor; }
+
     const Scene& scene() const { return *m_scene; }
 
+    const StyleContext& styleContext() const { return *m_styleContext; }
+
+    /* Hands the StyleContext over to the TileBuilder of the next Scene */
+    std::unique_ptr<StyleContext> releaseStyleContext() { return std::move(m_styleContext); }
+
+    /* Selects the layers and features of a tile which can match the
+     * DataLayers of the scene that use the tile's source. Features are
+     * selected by their keys only, see FilterProgram::mayMatch() */
+    class DataLayerSelection : public TileDataSelection {
+    public:
+        DataLayerSelection(TileBuilder& _builder, const DataSource& _source);
+
+        bool selectLayer(const std::string& _name) const override;
+        bool selectFeature(const std::string& _layer, const Feature& _feature) override;
+
+    private:
+        bool containsCollection(const DataLayer& _layer, const std::string& _name) const;
+
+        std::vector<const DataLayer*> m_layers;
+    };
+
+    DataLayerSelection selection(const DataSource& _source) {
+        return DataLayerSelection(*this, _source);
+    }
+
 private:
+
+    // A feature and the layers it matched, see DrawRuleMergeSet::matchedLayers()
+    struct MatchedFeature {
+        const Feature* feature;
+        std::vector<const SceneLayer*> layers;
+    };
+
+    /* Styles, by id, that the draw rules of the layers in _features may use */
+    std::vector<bool> usedStyles(const std::vector<MatchedFeature>& _features) const;
+
+    /* Assign the styles to at most _parts sets, one per style in _used at
+     * most; labels and unused styles stay in the first part */
+    std::vector<std::vector<bool>> splitStyles(size_t _parts, const std::vector<bool>& _used) const;
+
+    /* Match the features of _data once for all parts of a split build, in
+     * the order of a serial build */
+    std::vector<MatchedFeature> matchFeatures(const Tile& _tile, const TileData& _data,
+                                              const DataSource& _source);
+
+    /* Build the meshes of the styles selected in _styles from matched features */
+    StyleMeshes buildStyles(const Tile& _tile, const std::vector<MatchedFeature>& _features,
+                            const std::vector<bool>& _styles);
+
+    void beginStyles(const Tile& _tile, const std::vector<bool>& _styles);
+    StyleMeshes endStyles(const Tile& _tile);
+
     std::shared_ptr<Scene> m_scene;
 
-    StyleContext m_styleContext;
+    std::unique_ptr<StyleContext> m_styleContext;
     DrawRuleMergeSet m_ruleSet;
 
     LabelCollider m_labelLayout;
 
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
+
+    TileBuildExecutor* m_executor = nullptr;
+
+    // Smallest 'simplify' tolerances of the DataLayers of a source, computed
+    // once for the Scene
+    struct SimplifyTolerances {
+        // Unnamed collections are used by all DataLayers of the source
+        float unnamed = -1;
+        fastmap<std::string, float> collections;
+    };
+
+    fastmap<std::string, SimplifyTolerances> m_simplifyTolerances;
+
+    // Styles of the current build, indexed by Style id
+    const std::vector<bool>* m_selectedStyles = nullptr;
 };
 
 }
@@ -15,6 +15,41 @@
 
 namespace Tangram {
 
+// Squared distance of the tile to the view center. Tiles with a higher
+// zoom than the view get a lower priority, parent tiles a higher one.
+static double loadPriority(const ViewState& _view, const TileID& _tileID) {
+    auto tileCenter = _view.mapProjection->TileCenter(_tileID);
+    double scaleDiv = exp2(_tileID.z - _view.zoom);
+    if (scaleDiv < 1) { scaleDiv = 0.1/scaleDiv; } // prefer parent tiles
+    return glm::length2(tileCenter - _view.center) * scaleDiv;
+}
+
+// Tiles that are loaded ahead are ranked as proxies, i.e. behind the visible
+// tiles, and behind the actual proxy tiles unless those are far off
+const static double PREFETCH_PRIORITY_SCALE = 1e4;
+
+// Map _tiles to the max zoom of a source, keeping only the tile with the
+// highest source zoom among those with the same coordinates
+static void mapToSourceZoom(const std::vector<TileID>& _tiles, int32_t _maxZoom,
+                            std::vector<TileID>& _mappedTiles) {
+    _mappedTiles.clear();
+
+    for (const auto& id : _tiles) {
+        _mappedTiles.push_back(id.withMaxSourceZoom(_maxZoom));
+    }
+
+    auto sameCoords = [](auto& a, auto& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.wrap == b.wrap;
+    };
+    std::sort(_mappedTiles.begin(), _mappedTiles.end(), [](auto& a, auto& b) {
+            return std::tie(a.x, a.y, a.z, a.wrap, b.s) < std::tie(b.x, b.y, b.z, b.wrap, a.s);
+        });
+    _mappedTiles.erase(std::unique(_mappedTiles.begin(), _mappedTiles.end(), sameCoords),
+                       _mappedTiles.end());
+
+    std::sort(_mappedTiles.begin(), _mappedTiles.end());
+}
+
 TileManager::TileManager(TileTaskQueue& _tileWorker) : m_workers(_tileWorker) {
 
     m_tileCache = std::unique_ptr<TileCache>(new TileCache(DEFAULT_CACHE_SIZE));
@@ -57,6 +92,7 @@ void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>&
             }
             // Clear cache
             tileSet.tiles.clear();
+            tileSet.invalidate();
             return false;
         });
 
@@ -101,6 +137,7 @@ bool TileManager::removeClientDataSource(DataSource& dataSource) {
 void TileManager::clearTileSets() {
     for (auto& tileSet : m_tileSets) {
         tileSet.tiles.clear();
+        tileSet.invalidate();
     }
 
     m_tileCache->clear();
@@ -110,28 +147,87 @@ void TileManager::clearTileSet(int32_t _sourceId) {
     for (auto& tileSet : m_tileSets) {
         if (tileSet.source->id() != _sourceId) { continue; }
         tileSet.tiles.clear();
+        tileSet.invalidate();
     }
 
     m_tileCache->clear();
     m_tileSetChanged = true;
 }
 
+bool TileManager::isUpToDate(const TileSet& _tileSet, const ViewState& _view,
+                             const VisibleTiles& _visibleTiles,
+                             const VisibleTiles& _prefetchTiles) const {
+
+    // New tile data only arrives for loading tiles
+    return !_tileSet.loading &&
+        _tileSet.visibleVersion == int64_t(_visibleTiles.version()) &&
+        _tileSet.prefetchVersion == int64_t(_prefetchTiles.version()) &&
+        _tileSet.sourceGeneration == _tileSet.source->generation() &&
+        _tileSet.maxZoom == int(_view.zoom) + 2;
+}
+
+bool TileManager::canApplyDeltas(const TileSet& _tileSet, const ViewState& _view,
+                                 const VisibleTiles& _visibleTiles,
+                                 const VisibleTiles& _prefetchTiles) const {
+
+    // Like isUpToDate(), but for the visible tiles before the last change.
+    // Overzoomed sources map the visible tiles and need the full update.
+    return !_tileSet.loading &&
+        _tileSet.visibleVersion == int64_t(_visibleTiles.previousVersion()) &&
+        _tileSet.prefetchVersion == int64_t(_prefetchTiles.version()) &&
+        _tileSet.sourceGeneration == _tileSet.source->generation() &&
+        _tileSet.maxZoom == int(_view.zoom) + 2 &&
+        _view.zoom <= _tileSet.source->maxZoom();
+}
+
 void TileManager::updateTileSets(const ViewState& _view,
-                                 const std::set<TileID>& _visibleTiles) {
+                                 const VisibleTiles& _visibleTiles,
+                                 const VisibleTiles& _prefetchTiles) {
     m_tiles.clear();
-    m_loadPending = 0;
     m_tilesInProgress = 0;
+    m_prefetchLoading = 0;
     m_tileSetChanged = false;
 
     for (auto& tileSet : m_tileSets) {
         // check if tile set is active for zoom (zoom might be below min_zoom)
-        if (tileSet.source->isActiveForZoom(_view.zoom)) {
-            updateTileSet(tileSet, _view, _visibleTiles);
+        if (!tileSet.source->isActiveForZoom(_view.zoom)) {
+            tileSet.invalidate();
+            continue;
         }
+
+        if (isUpToDate(tileSet, _view, _visibleTiles, _prefetchTiles)) {
+            // Nothing changed for this TileSet, e.g. while panning within
+            // the current tiles or when only the tiles of other sources load
+            m_tiles.insert(m_tiles.end(), tileSet.renderTiles.begin(), tileSet.renderTiles.end());
+            continue;
+        }
+
+        size_t first = m_tiles.size();
+
+        if (canApplyDeltas(tileSet, _view, _visibleTiles, _prefetchTiles)) {
+            // Only the tiles that came into or went out of view changed,
+            // e.g. when panning with all current tiles loaded
+            updateTileSetDeltas(tileSet, _view, _visibleTiles, _prefetchTiles);
+        } else {
+            updateTileSet(tileSet, _view, _visibleTiles, _prefetchTiles);
+        }
+
+        tileSet.renderTiles.assign(m_tiles.begin() + first, m_tiles.end());
+        tileSet.visibleVersion = _visibleTiles.version();
+        tileSet.prefetchVersion = _prefetchTiles.version();
     }
 
     loadTiles();
 
+    // Start queued downloads in the order of the updated priorities,
+    // drop the ones that went out of view
+    m_downloads.update();
+
+    if (_view.changedOnLastUpdate) {
+        // Let the workers re-sort their queues by the new task priorities
+        m_workers.updatePriorities();
+    }
+
     // Make m_tiles an unique list of tiles for rendering sorted from
     // high to low zoom-levels.
     std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b){
@@ -141,13 +237,113 @@ void TileManager::updateTileSets(const ViewState& _view,
     m_tiles.erase(std::unique(m_tiles.begin(), m_tiles.end()), m_tiles.end());
 }
 
+const std::vector<TileID>& TileManager::mappedPrefetchTiles(const TileSet& _tileSet,
+                                                           const VisibleTiles& _prefetchTiles) {
+
+    // The prefetch tiles may be at a different zoom than the view
+    if (_prefetchTiles.empty() || m_prefetchBudget == 0) {
+        return _prefetchTiles.tiles();
+    }
+
+    mapToSourceZoom(_prefetchTiles.tiles(), _tileSet.source->maxZoom(), m_mappedPrefetchTiles);
+    return m_mappedPrefetchTiles;
+}
+
+void TileManager::updateVisibleTile(TileSet& _tileSet, const TileID& _tileID, TileEntry& _entry,
+                                    const ViewState& _view, bool _newTiles) {
+
+    auto generation = _tileSet.source->generation();
+
+    _entry.setVisible(true);
+
+    if (_entry.m_prefetch) {
+        _entry.m_prefetch = false;
+        m_prefetchStats.hits++;
+    }
+
+    if (_entry.isReady()) {
+        m_tiles.push_back(_entry.tile);
+
+        if (!_entry.isLoading() &&
+            (_entry.tile->sourceGeneration() < generation)) {
+            // Tile needs update - enqueue for loading
+            enqueueTask(_tileSet, _tileID, _view);
+        }
+    } else {
+
+        if (_entry.isLoading() && _entry.rastersPending() == 0) {
+            if (_newTiles) {
+                // check again for proxies
+                updateProxyTiles(_tileSet, _tileID, _entry);
+            }
+            m_tilesInProgress++;
+        } else if (!bool(_entry.task) ||
+                   (_entry.rastersPending() > 0 && !_entry.isCanceled()) ||
+                   (_entry.isCanceled() && (_entry.task->sourceGeneration() < generation))) {
+            // Start loading when:
+            // no task is set,
+            // one of the raster for this task has not been loaded yet
+            // or the task stems from an older tile source generation.
+
+            // Not yet available - enqueue for loading
+            enqueueTask(_tileSet, _tileID, _view);
+
+            m_tilesInProgress++;
+        }
+    }
+}
+
+void TileManager::addVisibleTile(TileSet& _tileSet, const TileID& _tileID,
+                                 const ViewState& _view, bool _newTiles) {
+
+    if (auto* added = _tileSet.tiles.find(_tileID)) {
+        // A proxy or prefetched tile, or added as proxy for another visible tile
+        updateVisibleTile(_tileSet, _tileID, added->value, _view, _newTiles);
+
+    } else if (!addTile(_tileSet, _tileID)) {
+        // Not in cache - enqueue for loading
+        enqueueTask(_tileSet, _tileID, _view);
+        m_tilesInProgress++;
+    }
+}
+
+void TileManager::updateHiddenTile(const TileID& _tileID, TileEntry& _entry, int _maxZoom,
+                                   const std::vector<TileID>& _prefetchTiles,
+                                   std::vector<TileID>& _removeTiles) {
+
+    if (_entry.getProxyCounter() > 0) {
+        if (_entry.isReady()) {
+            m_tiles.push_back(_entry.tile);
+        } else if (_tileID.z < _maxZoom) {
+            // Cancel loading
+            _removeTiles.push_back(_tileID);
+        }
+    } else if (_entry.m_prefetch &&
+               std::binary_search(_prefetchTiles.begin(), _prefetchTiles.end(), _tileID)) {
+        // Still expected to become visible
+    } else {
+        _removeTiles.push_back(_tileID);
+    }
+    _entry.setVisible(false);
+}
+
 void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
-                                const std::set<TileID>& _visibleTiles) {
+                                const VisibleTiles& _visibleTiles,
+                                const VisibleTiles& _prefetchTiles) {
 
     bool newTiles = false;
 
     if (_tileSet.sourceGeneration != _tileSet.source->generation()) {
         _tileSet.sourceGeneration = _tileSet.source->generation();
+
+        // Tasks of an older source generation would load outdated data.
+        // Cancel them, the tiles are enqueued again below.
+        for (auto& it : _tileSet.tiles) {
+            auto& entry = it.value;
+            if (entry.isLoading() && entry.task->sourceGeneration() < _tileSet.sourceGeneration) {
+                entry.task->cancel();
+            }
+        }
     }
 
     // Tile load request above this zoom-level will be canceled in order to
@@ -155,14 +351,17 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
     // the current view.
     int maxZoom = _view.zoom + 2;
 
+    _tileSet.maxZoom = maxZoom;
+    _tileSet.loading = false;
+
     std::vector<TileID> removeTiles;
     auto& tiles = _tileSet.tiles;
 
     // Check for ready tasks, move Tile to active TileSet and unset Proxies.
     for (auto& it : tiles) {
-        auto& entry = it.second;
+        auto& entry = it.value;
         if (entry.newData()) {
-            clearProxyTiles(_tileSet, it.first, entry, removeTiles);
+            clearProxyTiles(_tileSet, it.id, entry, removeTiles);
             entry.task->complete();
 
             entry.tile = std::move(entry.task->tile());
@@ -173,80 +372,35 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
         }
     }
 
-    const auto* visibleTiles = &_visibleTiles;
+    const auto* visibleTiles = &_visibleTiles.tiles();
 
-    std::set<TileID> mappedTiles;
     if (_view.zoom > _tileSet.source->maxZoom()) {
-        for (const auto& id : _visibleTiles) {
-            auto tile = id.withMaxSourceZoom(_tileSet.source->maxZoom());
-            // Replace tile with same coordinates and lower source zoom
-            auto other = std::find_if(mappedTiles.begin(), mappedTiles.end(),
-                             [&](auto& t) { return tile.x == t.x &&
-                                            tile.y == t.y &&
-                                            tile.z == t.z &&
-                                            tile.wrap == t.wrap; });
-            if (other == mappedTiles.end()) {
-                mappedTiles.insert(tile);
-            } else if (other->s < tile.s) {
-                mappedTiles.erase(other);
-                mappedTiles.insert(tile);
-            }
-        }
-        visibleTiles = &mappedTiles;
+        mapToSourceZoom(_visibleTiles.tiles(), _tileSet.source->maxZoom(), m_mappedTiles);
+        visibleTiles = &m_mappedTiles;
     }
 
-    // Loop over visibleTiles and add any needed tiles to tileSet
-    auto curTilesIt = tiles.begin();
-    auto visTilesIt = visibleTiles->begin();
+    const auto& prefetch = mappedPrefetchTiles(_tileSet, _prefetchTiles);
 
-    auto generation = _tileSet.source->generation();
+    // Loop over visibleTiles and add any needed tiles to tileSet. Tiles
+    // that are added during the loop are not part of currentTiles.
+    auto& currentTiles = tiles.sorted();
+    auto curTilesIt = currentTiles.begin();
+    auto visTilesIt = visibleTiles->begin();
 
-    while (visTilesIt != visibleTiles->end() || curTilesIt != tiles.end()) {
+    while (visTilesIt != visibleTiles->end() || curTilesIt != currentTiles.end()) {
 
         auto& visTileId = visTilesIt == visibleTiles->end()
             ? NOT_A_TILE : *visTilesIt;
 
-        auto& curTileId = curTilesIt == tiles.end()
-            ? NOT_A_TILE : curTilesIt->first;
+        auto& curTileId = curTilesIt == currentTiles.end()
+            ? NOT_A_TILE : (*curTilesIt)->id;
 
         if (visTileId == curTileId) {
             // tiles in both sets match
             assert(visTilesIt != visibleTiles->end() &&
-                   curTilesIt != tiles.end());
-
-            auto& entry = curTilesIt->second;
-            entry.setVisible(true);
+                   curTilesIt != currentTiles.end());
 
-            if (entry.isReady()) {
-                m_tiles.push_back(entry.tile);
-
-                if (!entry.isLoading() &&
-                    (entry.tile->sourceGeneration() < generation)) {
-                    // Tile needs update - enqueue for loading
-                    enqueueTask(_tileSet, visTileId, _view);
-                }
-            } else {
-
-                if (entry.isLoading() && entry.rastersPending() == 0) {
-                    if (newTiles) {
-                        // check again for proxies
-                        updateProxyTiles(_tileSet, visTileId, entry);
-                    }
-                    m_tilesInProgress++;
-                } else if (!bool(entry.task) ||
-                           (entry.rastersPending() > 0 && !entry.isCanceled()) ||
-                           (entry.isCanceled() && (entry.task->sourceGeneration() < generation))) {
-                    // Start loading when:
-                    // no task is set,
-                    // one of the raster for this task has not been loaded yet
-                    // or the task stems from an older tile source generation.
-
-                    // Not yet available - enqueue for loading
-                    enqueueTask(_tileSet, visTileId, _view);
-
-                    m_tilesInProgress++;
-                }
-            }
+            updateVisibleTile(_tileSet, visTileId, (*curTilesIt)->value, _view, newTiles);
 
             ++curTilesIt;
             ++visTilesIt;
@@ -258,52 +412,95 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             //     NOT_A_TILE. (for the current implementation of > operator)
             assert(visTilesIt != visibleTiles->end());
 
-            if (!addTile(_tileSet, visTileId)) {
-                // Not in cache - enqueue for loading
-                enqueueTask(_tileSet, visTileId, _view);
-                m_tilesInProgress++;
-            }
+            addVisibleTile(_tileSet, visTileId, _view, newTiles);
 
             ++visTilesIt;
 
         } else {
             // tileSet has a tile not present in visibleTiles
-            assert(curTilesIt != tiles.end());
+            assert(curTilesIt != currentTiles.end());
 
-            auto& entry = curTilesIt->second;
+            updateHiddenTile(curTileId, (*curTilesIt)->value, maxZoom, prefetch, removeTiles);
 
-            if (entry.getProxyCounter() > 0) {
-                if (entry.isReady()) {
-                    m_tiles.push_back(entry.tile);
-                } else if (curTileId.z < maxZoom) {
-                    // Cancel loading
-                    removeTiles.push_back(curTileId);
-                }
-            } else {
-                removeTiles.push_back(curTileId);
-            }
-            entry.setVisible(false);
             ++curTilesIt;
         }
     }
 
-    while (!removeTiles.empty()) {
-        auto it = tiles.find(removeTiles.back());
-        removeTiles.pop_back();
+    updateTileStates(_tileSet, _view, removeTiles);
+
+    if (m_prefetchBudget > 0) {
+        prefetchTiles(_tileSet, _view, prefetch);
+    }
+}
+
+void TileManager::updateTileSetDeltas(TileSet& _tileSet, const ViewState& _view,
+                                      const VisibleTiles& _visibleTiles,
+                                      const VisibleTiles& _prefetchTiles) {
+
+    // Nothing is loading. Visible tiles whose task was canceled, e.g. after a
+    // failed download, may still be drawn by proxies.
+    _tileSet.loading = false;
+
+    std::vector<TileID> removeTiles;
+    auto& tiles = _tileSet.tiles;
+    const auto& added = _visibleTiles.added();
+    const auto& prefetch = mappedPrefetchTiles(_tileSet, _prefetchTiles);
+
+    // Added tiles first, so that their proxies are kept when they go out of view
+    for (const auto& id : added) {
+        addVisibleTile(_tileSet, id, _view, false);
+    }
+
+    for (const auto& id : _visibleTiles.removed()) {
+        if (auto* entry = tiles.find(id)) {
+            updateHiddenTile(id, entry->value, _tileSet.maxZoom, prefetch, removeTiles);
+        }
+    }
+
+    // Tiles that stayed in view and proxies are still ready for rendering,
+    // as in updateVisibleTile() and updateHiddenTile()
+    for (auto& it : tiles) {
+        auto& entry = it.value;
+        if (!entry.isReady()) { continue; }
+
+        if (entry.isVisible()) {
+            if (!std::binary_search(added.begin(), added.end(), it.id)) {
+                m_tiles.push_back(entry.tile);
+            }
+        } else if (entry.getProxyCounter() > 0) {
+            m_tiles.push_back(entry.tile);
+        }
+    }
+
+    updateTileStates(_tileSet, _view, removeTiles);
+
+    if (m_prefetchBudget > 0) {
+        prefetchTiles(_tileSet, _view, prefetch);
+    }
+}
+
+void TileManager::updateTileStates(TileSet& _tileSet, const ViewState& _view,
+                                   std::vector<TileID>& _removeTiles) {
+
+    auto& tiles = _tileSet.tiles;
 
-        if ((it != tiles.end()) &&
-            (!it->second.isVisible()) &&
-            (it->second.getProxyCounter() <= 0  ||
-             it->first.z >= maxZoom)) {
+    while (!_removeTiles.empty()) {
+        auto* it = tiles.find(_removeTiles.back());
+        _removeTiles.pop_back();
 
-            clearProxyTiles(_tileSet, it->first, it->second, removeTiles);
+        if (it &&
+            (!it->value.isVisible()) &&
+            (it->value.getProxyCounter() <= 0  ||
+             it->id.z >= _tileSet.maxZoom)) {
 
-            removeTile(_tileSet, it);
+            clearProxyTiles(_tileSet, it->id, it->value, _removeTiles);
+
+            removeTile(_tileSet, *it);
         }
     }
 
     for (auto& it : tiles) {
-        auto& entry = it.second;
+        auto& entry = it.value;
 
         size_t rasterLoading = 0;
         size_t rasterDone = 0;
@@ -316,7 +513,7 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
         }
 
         DBG("> %s - ready:%d proxy:%d/%d loading:%d rDone:%d rLoading:%d rPending:%d canceled:%d",
-             it.first.toString().c_str(),
+             it.id.toString().c_str(),
              entry.isReady(),
              entry.getProxyCounter(),
              entry.m_proxies,
@@ -327,24 +524,25 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
              entry.task && entry.task->isCanceled());
 
         if (entry.isLoading()) {
-            auto& id = it.first;
+            _tileSet.loading = true;
+
             auto& task = entry.task;
 
-            // Update tile distance to map center for load priority.
-            auto tileCenter = _view.mapProjection->TileCenter(id);
-            double scaleDiv = exp2(id.z - _view.zoom);
-            if (scaleDiv < 1) { scaleDiv = 0.1/scaleDiv; } // prefer parent tiles
-            task->setPriority(glm::length2(tileCenter - _view.center) * scaleDiv);
-            task->setProxyState(entry.getProxyCounter() > 0);
-
-            // Count tiles that are currently being downloaded to
-            // limit download requests.
-            if (!task->hasData()) {
-                m_loadPending++;
+            if (entry.m_prefetch) {
+                m_prefetchLoading++;
+
+                task->setPriority(PREFETCH_PRIORITY_SCALE * loadPriority(_view, it.id));
+                task->setProxyState(true);
+            } else {
+                // Update tile distance to map center for load priority.
+                task->setPriority(loadPriority(_view, it.id));
+                task->setProxyState(entry.getProxyCounter() > 0);
             }
 
+            // Raster downloads are ranked with their tile
             for (auto& subTask : task->subTasks()) {
-                if (!subTask->hasData()) { m_loadPending++; }
+                subTask->setPriority(task->getPriority());
+                subTask->setProxyState(task->isProxy());
             }
         }
 
@@ -355,19 +553,44 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
     }
 }
 
+void TileManager::prefetchTiles(TileSet& _tileSet, const ViewState& _view,
+                                const std::vector<TileID>& _prefetchTiles) {
+
+    for (const auto& id : _prefetchTiles) {
+        if (m_prefetchLoading >= m_prefetchBudget) { break; }
+
+        if (_tileSet.tiles.find(id)) { continue; }
+
+        // Already available, it will be taken from the cache when visible
+        auto cached = m_tileCache->contains(_tileSet.source->id(), id);
+        if (cached && cached->sourceGeneration() == _tileSet.source->generation()) {
+            continue;
+        }
+
+        auto entry = _tileSet.tiles.emplace(id);
+        entry.first->value.m_prefetch = true;
+
+        enqueueTask(_tileSet, id, _view);
+
+        m_prefetchLoading++;
+        m_prefetchStats.requested++;
+    }
+}
+
 void TileManager::enqueueTask(TileSet& _tileSet, const TileID& _tileID,
                               const ViewState& _view) {
 
-    // Keep the items sorted by distance
-    auto tileCenter = _view.mapProjection->TileCenter(_tileID);
-    double distance = glm::length2(tileCenter - _view.center);
+    // Keep the items sorted by priority
+    double priority = loadPriority(_view, _tileID);
 
-    auto it = std::upper_bound(m_loadTasks.begin(), m_loadTasks.end(), distance,
-                               [](auto& distance, auto& other){
-                                   return distance < std::get<0>(other);
+    auto it = std::upper_bound(m_loadTasks.begin(), m_loadTasks.end(), priority,
+                               [](auto& priority, auto& other){
+                                   return priority < std::get<0>(other);
                                });
 
-    m_loadTasks.insert(it, std::make_tuple(distance, &_tileSet, _tileID));
+    m_loadTasks.insert(it, std::make_tuple(priority, &_tileSet, _tileID));
+
+    _tileSet.loading = true;
 }
 
 // create and download raster references store these
@@ -394,26 +617,19 @@ void TileManager::loadSubTasks(std::vector<std::shared_ptr<DataSource>>& _subSou
             subTileID = subTileID.withMaxSourceZoom(subSource->maxZoom());
         }
         auto subTask = subSource->createTask(subTileID, index);
+        subTasks.insert(it, subTask);
+
         if (subTask->isReady()) {
-            subTasks.insert(it, subTask);
             requestRender();
 
         } else if (subTask->hasData()) {
-            subTasks.insert(it, subTask);
             m_dataCallback.func(std::move(subTask));
 
-        } else if (m_loadPending < MAX_DOWNLOADS) {
-            subTasks.insert(it, subTask);
-
-            if (subSource->loadTileData(std::move(subTask), m_dataCallback)) {
-                m_loadPending++;
+        } else {
+            subTask->setPriority(tileTask->getPriority());
+            subTask->setProxyState(tileTask->isProxy());
 
-            } else {
-                // dependent raster's loading failed..
-                // this subTask's rasterReady must have been set with black texture
-                assert(subTask->isReady());
-                requestRender();
-            }
+            m_downloads.enqueue(std::move(subTask), m_dataCallback);
         }
     }
 }
@@ -424,8 +640,10 @@ void TileManager::loadTiles() {
 
         auto tileId = std::get<2>(loadTask);
         auto& tileSet = *std::get<1>(loadTask);
-        auto tileIt = tileSet.tiles.find(tileId);
-        auto& entry = tileIt->second;
+        auto* tileIt = tileSet.tiles.find(tileId);
+        if (!tileIt) { continue; }
+
+        auto& entry = tileIt->value;
 
         if (entry.task && entry.rastersPending() > 0 && !entry.isCanceled()) {
             // just load the rasters and continue,
@@ -435,29 +653,31 @@ void TileManager::loadTiles() {
         }
 
         auto task = tileSet.source->createTask(tileId);
+        task->setPriority(std::get<0>(loadTask));
+
+        if (entry.m_prefetch) {
+            task->setPriority(PREFETCH_PRIORITY_SCALE * std::get<0>(loadTask));
+            task->setProxyState(true);
+        }
+
+        // Note: Set implicit 'loading' state
+        entry.task = task;
 
         if (task->hasData()) {
-            // Note: Set implicit 'loading' state
-            entry.task = task;
             loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
             m_dataCallback.func(std::move(task));
 
-        } else if (m_loadPending < MAX_DOWNLOADS) {
-            entry.task = task;
-            if (tileSet.source->loadTileData(std::move(task), m_dataCallback)) {
-                m_loadPending++;
-                loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
-            } else {
-                // Set canceled state, so that tile will not be tried
-                // for reloading until sourceGeneration increased.
-                entry.task->cancel();
-                continue;
-            }
+        } else {
+            // When the download can not be started the task is canceled, so
+            // that the tile will not be tried for reloading until
+            // sourceGeneration increased.
+            m_downloads.enqueue(std::move(task), m_dataCallback);
+            loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
         }
     }
 
-    DBG("loading:%d pending:%d cache: %fMB",
-        m_loadTasks.size(), m_loadPending,
+    DBG("loading:%d downloads:%d/%d cache: %fMB",
+        m_loadTasks.size(), m_downloads.active(), m_downloads.pending(),
         (double(m_tileCache->getMemoryUsage()) / (1024 * 1024)));
 
     m_loadTasks.clear();
@@ -488,18 +708,21 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
 
     if (!tile) {
         // Add Proxy if corresponding proxy MapTile ready
-        updateProxyTiles(_tileSet, _tileID, entry.first->second);
+        updateProxyTiles(_tileSet, _tileID, entry.first->value);
     }
-    entry.first->second.setVisible(true);
+    entry.first->value.setVisible(true);
 
     return bool(tile);
 }
 
-void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIt) {
+void TileManager::removeTile(TileSet& _tileSet, TileMap<TileEntry>::Entry& _tile) {
 
-    auto& id = _tileIt->first;
-    auto& entry = _tileIt->second;
+    auto id = _tile.id;
+    auto& entry = _tile.value;
 
+    if (entry.m_prefetch) {
+        m_prefetchStats.misses++;
+    }
 
     if (entry.isLoading()) {
         entry.clearTask();
@@ -517,7 +740,7 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
     }
 
     //remove tile from set
-    _tileIt = _tileSet.tiles.erase(_tileIt);
+    _tileSet.tiles.erase(id);
     // Remove rasters from this DataSource
     _tileSet.source->clearRaster(id);
 }
@@ -532,9 +755,9 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     // check if the proxy exists in the visible tile set
     {
-        const auto& it = tiles.find(_proxyTileId);
-        if (it != tiles.end()) {
-            auto& entry = it->second;
+        auto* it = tiles.find(_proxyTileId);
+        if (it) {
+            auto& entry = it->value;
 
             if (!entry.isCanceled() && _tile.setProxy(_proxyId)) {
                 entry.incProxyCounter();
@@ -556,7 +779,7 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
         if (proxyTile && _tile.setProxy(_proxyId)) {
 
             auto result = tiles.emplace(_proxyTileId, proxyTile);
-            auto& entry = result.first->second;
+            auto& entry = result.first->value;
             entry.incProxyCounter();
 
             m_tiles.push_back(proxyTile);
@@ -599,9 +822,9 @@ void TileManager::clearProxyTiles(TileSet& _tileSet, const TileID& _tileID, Tile
     auto& tiles = _tileSet.tiles;
 
     auto removeProxy = [&tiles,&_removes](TileID id) {
-        auto it = tiles.find(id);
-        if (it != tiles.end()) {
-            auto& entry = it->second;
+        auto* it = tiles.find(id);
+        if (it) {
+            auto& entry = it->value;
             entry.decProxyCounter();
             if (entry.getProxyCounter() <= 0 && !entry.isVisible()) {
                 _removes.push_back(id);
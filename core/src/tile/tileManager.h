@@ -1,18 +1,19 @@
 #pragma once
 
 #include "data/tileData.h"
+#include "tile/downloadScheduler.h"
 #include "tile/tileWorker.h"
 #include "tile/tile.h"
 #include "tile/tileID.h"
+#include "tile/tileMap.h"
+#include "tile/visibleTiles.h"
 #include "tileTask.h"
 #include "util/fastmap.h"
 
-#include <map>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <tuple>
-#include <set>
 #include <data/dataSource.h>
 
 namespace Tangram {
@@ -29,7 +30,8 @@ struct ViewState;
 class TileManager {
 
     const static size_t DEFAULT_CACHE_SIZE = 32*1024*1024; // 32 MB
-    const static int MAX_DOWNLOADS = 4;
+
+    const static size_t DEFAULT_PREFETCH_BUDGET = 8;
 
 public:
 
@@ -40,8 +42,15 @@ public:
     /* Sets the tile DataSources */
     void setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources);
 
-    /* Updates visible tile set and load missing tiles */
-    void updateTileSets(const ViewState& _view, const std::set<TileID>& _visibleTiles);
+    /* Updates visible tile set and load missing tiles
+     *
+     * @_prefetchTiles: Tiles that are expected to become visible soon, e.g.
+     * at the destination of a camera ease. Missing ones are loaded ahead with
+     * a lower priority than the visible tiles and their proxies, at most
+     * setPrefetchBudget() at a time.
+     */
+    void updateTileSets(const ViewState& _view, const VisibleTiles& _visibleTiles,
+                        const VisibleTiles& _prefetchTiles = VisibleTiles());
 
     void clearTileSets();
 
@@ -67,6 +76,26 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* Maximum number of tiles loading ahead at a time, 0 disables prefetching */
+    void setPrefetchBudget(size_t _maxTiles) { m_prefetchBudget = _maxTiles; }
+
+    struct PrefetchStats {
+        // Tiles that started loading ahead of becoming visible
+        uint64_t requested = 0;
+        // Prefetched tiles that became visible
+        uint64_t hits = 0;
+        // Prefetched tiles that were dropped before becoming visible
+        uint64_t misses = 0;
+
+        float hitRate() const {
+            return hits + misses == 0 ? 0.f : float(hits) / (hits + misses);
+        }
+    };
+
+    const PrefetchStats& prefetchStats() const { return m_prefetchStats; }
+
+    void resetPrefetchStats() { m_prefetchStats = {}; }
+
 private:
 
     enum class ProxyID : uint8_t {
@@ -95,6 +124,9 @@ private:
         /* The set of proxy tiles referenced by this tile */
         uint8_t m_proxies = 0;
 
+        /* Loaded ahead for the prefetch tiles and not yet visible */
+        bool m_prefetch = false;
+
         bool isReady() { return bool(tile); }
         bool isLoading() { return bool(task) && !task->isCanceled(); }
         size_t rastersPending() {
@@ -177,12 +209,64 @@ private:
             : source(_source), clientDataSource(_clientDataSource) {}
 
         std::shared_ptr<DataSource> source;
-        std::map<TileID, TileEntry> tiles;
+        TileMap<TileEntry> tiles;
         int64_t sourceGeneration = 0;
         bool clientDataSource;
+
+        /* State of the last full update: While the visible tiles, the source
+         * generation and the zoom-level are unchanged and no tile is loading
+         * the TileSet can not change and its tiles for rendering are reused */
+        int64_t visibleVersion = -1;
+        int64_t prefetchVersion = -1;
+        int maxZoom = -1;
+        bool loading = false;
+        std::vector<std::shared_ptr<Tile>> renderTiles;
+
+        void invalidate() {
+            visibleVersion = -1;
+            renderTiles.clear();
+        }
     };
 
-    void updateTileSet(TileSet& tileSet, const ViewState& _view, const std::set<TileID>& _visibleTiles);
+    /* Merges the visible tiles with the tiles of _tileSet */
+    void updateTileSet(TileSet& tileSet, const ViewState& _view, const VisibleTiles& _visibleTiles,
+                       const VisibleTiles& _prefetchTiles);
+
+    /* Applies the visibility changes of the added and removed tiles of
+     * _visibleTiles. The render list and tile states are still collected
+     * from all tiles of _tileSet. */
+    void updateTileSetDeltas(TileSet& tileSet, const ViewState& _view, const VisibleTiles& _visibleTiles,
+                             const VisibleTiles& _prefetchTiles);
+
+    /* Whether the result of the last updateTileSet() for _tileSet is still current */
+    bool isUpToDate(const TileSet& _tileSet, const ViewState& _view,
+                    const VisibleTiles& _visibleTiles, const VisibleTiles& _prefetchTiles) const;
+
+    /* Whether _tileSet was last updated for the previous version of _visibleTiles
+     * and nothing else changed since, so that updateTileSetDeltas() can be used */
+    bool canApplyDeltas(const TileSet& _tileSet, const ViewState& _view,
+                        const VisibleTiles& _visibleTiles, const VisibleTiles& _prefetchTiles) const;
+
+    void updateVisibleTile(TileSet& _tileSet, const TileID& _tileID, TileEntry& _entry,
+                           const ViewState& _view, bool _newTiles);
+
+    /* Adds a visible tile that has no entry in the current tiles of _tileSet */
+    void addVisibleTile(TileSet& _tileSet, const TileID& _tileID, const ViewState& _view, bool _newTiles);
+
+    /* Keeps a tile that went out of view as proxy or prefetched tile, otherwise
+     * adds it to _removeTiles */
+    void updateHiddenTile(const TileID& _tileID, TileEntry& _entry, int _maxZoom,
+                          const std::vector<TileID>& _prefetchTiles, std::vector<TileID>& _removeTiles);
+
+    /* Removes _removeTiles and their unused proxies, updates the load priorities */
+    void updateTileStates(TileSet& _tileSet, const ViewState& _view, std::vector<TileID>& _removeTiles);
+
+    /* _prefetchTiles mapped to the max zoom of the source of _tileSet */
+    const std::vector<TileID>& mappedPrefetchTiles(const TileSet& _tileSet, const VisibleTiles& _prefetchTiles);
+
+    /* Starts loading the tiles of _prefetchTiles that are missing in _tileSet,
+     * while less than m_prefetchBudget tiles are loading ahead */
+    void prefetchTiles(TileSet& _tileSet, const ViewState& _view, const std::vector<TileID>& _prefetchTiles);
 
     void enqueueTask(TileSet& _tileSet, const TileID& _tileID, const ViewState& _view);
 
@@ -200,7 +284,7 @@ private:
     /*
      * Removes a tile from m_tileSet
      */
-    void removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIter);
+    void removeTile(TileSet& _tileSet, TileMap<TileEntry>::Entry& _tile);
 
     /*
      * Checks and updates m_tileSet with proxy tiles for every new visible tile
@@ -215,7 +299,6 @@ private:
      */
     void clearProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile, std::vector<TileID>& _removes);
 
-    int32_t m_loadPending = 0;
     int32_t m_tilesInProgress = 0;
 
     std::vector<TileSet> m_tileSets;
@@ -227,6 +310,9 @@ private:
 
     TileTaskQueue& m_workers;
 
+    /* Queue of tile and raster downloads, ranked by task priority */
+    DownloadScheduler m_downloads;
+
     bool m_tileSetChanged = false;
 
     /* Callback for DataSource:
@@ -234,7 +320,18 @@ private:
      */
     TileTaskCb m_dataCallback;
 
-    /* Temporary list of tiles that need to be loaded */
+    /* Temporary list of visible tiles mapped to the max zoom of a source */
+    std::vector<TileID> m_mappedTiles;
+    std::vector<TileID> m_mappedPrefetchTiles;
+
+    size_t m_prefetchBudget = DEFAULT_PREFETCH_BUDGET;
+
+    /* Number of prefetched tiles that are loading */
+    size_t m_prefetchLoading = 0;
+
+    PrefetchStats m_prefetchStats;
+
+    /* Temporary list of tiles that need to be loaded, sorted by load priority */
     std::vector<std::tuple<double, TileSet*, TileID>> m_loadTasks;
 
 
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "tile/tileID.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Tangram {
+
+/* Packs a TileID into 64 bits, packed keys are ordered like their TileIDs.
+ * Exact for zoom levels up to 21 and wraps in [-512, 512). */
+inline uint64_t packTileID(const TileID& _id) {
+    return (uint64_t(63 - _id.s) << 58) |
+        (uint64_t(63 - _id.z) << 52) |
+        (uint64_t(uint32_t(_id.x) & 0x1fffff) << 31) |
+        (uint64_t(uint32_t(_id.y) & 0x1fffff) << 10) |
+        (uint64_t(_id.wrap + 512) & 0x3ff);
+}
+
+/* TileMap
+ *
+ * Map from TileID to T as an open-addressing hash table (linear probing) of
+ * indices into a slab of entries. Entries never move: pointers to them stay
+ * valid while other entries are added or erased, and erased slots are reused.
+ *
+ * A vector of packed keys and entries keeps the TileID order for iteration.
+ * Unlike std::map, entries must not be added or erased while iterating;
+ * sorted() provides a snapshot of the order for that.
+ */
+template<typename T>
+class TileMap {
+
+public:
+
+    struct Entry {
+        Entry(const TileID& _id) : id(_id) {}
+
+        template<typename... Args>
+        Entry(const TileID& _id, Args&&... _args) : id(_id), value(std::forward<Args>(_args)...) {}
+
+        const TileID id;
+        T value;
+    };
+
+private:
+
+    struct Slot {
+        bool used = false;
+        typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type storage;
+
+        Entry& entry() { return *reinterpret_cast<Entry*>(&storage); }
+    };
+
+    using Order = std::vector<std::pair<uint64_t, Entry*>>;
+
+public:
+
+    class iterator {
+    public:
+        iterator(typename Order::const_iterator _it) : m_it(_it) {}
+
+        Entry& operator*() const { return *m_it->second; }
+        Entry* operator->() const { return m_it->second; }
+
+        iterator& operator++() { ++m_it; return *this; }
+
+        bool operator!=(const iterator& _other) const { return m_it != _other.m_it; }
+        bool operator==(const iterator& _other) const { return m_it == _other.m_it; }
+
+    private:
+        typename Order::const_iterator m_it;
+    };
+
+    TileMap() = default;
+
+    TileMap(const TileMap&) = delete;
+    TileMap& operator=(const TileMap&) = delete;
+
+    TileMap(TileMap&& _other) noexcept { swap(_other); }
+
+    TileMap& operator=(TileMap&& _other) noexcept {
+        clear();
+        swap(_other);
+        return *this;
+    }
+
+    ~TileMap() { clear(); }
+
+    /* Returns the entry for _id or nullptr */
+    Entry* find(const TileID& _id) {
+        if (m_table.empty()) { return nullptr; }
+
+        for (size_t pos = bucket(packTileID(_id)); m_table[pos] != 0; pos = (pos + 1) & mask()) {
+            auto& slot = m_slots[m_table[pos] - 1];
+            if (slot.entry().id == _id) { return &slot.entry(); }
+        }
+        return nullptr;
+    }
+
+    /* Adds an entry for _id with T constructed from _args, unless one
+     * exists already. Returns the entry and whether it was added. */
+    template<typename... Args>
+    std::pair<Entry*, bool> emplace(const TileID& _id, Args&&... _args) {
+
+        if (auto* entry = find(_id)) { return { entry, false }; }
+
+        // Entries must be ordered correctly by their packed key
+        assert(_id.z >= 0 && _id.z <= 21 && _id.s >= 0 && _id.s < 64);
+        assert(_id.wrap >= -512 && _id.wrap < 512);
+
+        if ((size() + 1) * 2 > m_table.size()) { rehash(std::max<size_t>(16, m_table.size() * 2)); }
+
+        uint32_t index;
+        if (m_free.empty()) {
+            index = m_slots.size();
+            m_slots.emplace_back();
+        } else {
+            index = m_free.back();
+            m_free.pop_back();
+        }
+
+        auto& slot = m_slots[index];
+        new (&slot.storage) Entry(_id, std::forward<Args>(_args)...);
+        slot.used = true;
+
+        uint64_t key = packTileID(_id);
+
+        size_t pos = bucket(key);
+        while (m_table[pos] != 0) { pos = (pos + 1) & mask(); }
+        m_table[pos] = index + 1;
+
+        auto it = std::lower_bound(m_order.begin(), m_order.end(), key,
+                                   [](auto& a, auto& b) { return a.first < b; });
+        m_order.insert(it, { key, &slot.entry() });
+
+        return { &slot.entry(), true };
+    }
+
+    /* Removes the entry for _id, returns whether it existed */
+    bool erase(const TileID& _id) {
+        if (m_table.empty()) { return false; }
+
+        uint64_t key = packTileID(_id);
+
+        size_t pos = bucket(key);
+        for (; m_table[pos] != 0; pos = (pos + 1) & mask()) {
+            if (m_slots[m_table[pos] - 1].entry().id == _id) { break; }
+        }
+        if (m_table[pos] == 0) { return false; }
+
+        uint32_t index = m_table[pos] - 1;
+        auto& slot = m_slots[index];
+
+        auto it = std::lower_bound(m_order.begin(), m_order.end(), key,
+                                   [](auto& a, auto& b) { return a.first < b; });
+        m_order.erase(it);
+
+        slot.entry().~Entry();
+        slot.used = false;
+        m_free.push_back(index);
+
+        // Shift following entries of the probe sequence back into the gap
+        size_t gap = pos;
+        for (size_t next = (pos + 1) & mask(); m_table[next] != 0; next = (next + 1) & mask()) {
+            size_t home = bucket(packTileID(m_slots[m_table[next] - 1].entry().id));
+            if (((next - home) & mask()) >= ((next - gap) & mask())) {
+                m_table[gap] = m_table[next];
+                gap = next;
+            }
+        }
+        m_table[gap] = 0;
+
+        return true;
+    }
+
+    void clear() {
+        for (auto& slot : m_slots) {
+            if (slot.used) { slot.entry().~Entry(); }
+        }
+        m_slots.clear();
+        m_free.clear();
+        m_order.clear();
+        std::fill(m_table.begin(), m_table.end(), 0);
+    }
+
+    size_t size() const { return m_order.size(); }
+    bool empty() const { return m_order.empty(); }
+
+    /* Snapshot of the entries in TileID order. Valid until the next call or
+     * until the entries are erased. */
+    const std::vector<Entry*>& sorted() {
+        m_sorted.clear();
+        for (auto& it : m_order) { m_sorted.push_back(it.second); }
+        return m_sorted;
+    }
+
+    /* Iteration in TileID order */
+    iterator begin() const { return iterator(m_order.begin()); }
+    iterator end() const { return iterator(m_order.end()); }
+
+private:
+
+    size_t mask() const { return m_table.size() - 1; }
+
+    size_t bucket(uint64_t _key) const {
+        // Fibonacci hashing, spreads neighbouring tiles over the table
+        return size_t((_key * 0x9E3779B97F4A7C15ull) >> 32) & mask();
+    }
+
+    void rehash(size_t _capacity) {
+        m_table.assign(_capacity, 0);
+
+        for (uint32_t index = 0; index < m_slots.size(); index++) {
+            if (!m_slots[index].used) { continue; }
+
+            size_t pos = bucket(packTileID(m_slots[index].entry().id));
+            while (m_table[pos] != 0) { pos = (pos + 1) & mask(); }
+            m_table[pos] = index + 1;
+        }
+    }
+
+    void swap(TileMap& _other) {
+        std::swap(m_slots, _other.m_slots);
+        std::swap(m_free, _other.m_free);
+        std::swap(m_table, _other.m_table);
+        std::swap(m_order, _other.m_order);
+    }
+
+    // Stable storage of the entries
+    std::deque<Slot> m_slots;
+
+    // Unused slots
+    std::vector<uint32_t> m_free;
+
+    // Slot index + 1 per bucket, 0 for empty buckets
+    std::vector<uint32_t> m_table;
+
+    // Packed key and entry, sorted by key
+    Order m_order;
+
+    std::vector<Entry*> m_sorted;
+};
+
+}
@@ -16,9 +16,13 @@ TileTask::TileTask(TileID& _tileId, std::shared_ptr<DataSource> _source, int _su
 
 void TileTask::process(TileBuilder& _tileBuilder) {
 
-    auto tileData = m_source->parse(*this, *_tileBuilder.scene().mapProjection());
+    auto selection = _tileBuilder.selection(*m_source);
+
+    auto tileData = m_source->parseSelected(*this, *_tileBuilder.scene().mapProjection(), selection);
 
     if (tileData) {
+        _tileBuilder.simplify(m_tileId, *tileData, *m_source);
+
         m_tile = _tileBuilder.build(m_tileId, *tileData, *m_source);
     } else {
         cancel();
@@ -84,7 +84,7 @@ protected:
     // Tile result, set when tile was  sucessfully created
     std::shared_ptr<Tile> m_tile;
 
-    bool m_canceled = false;
+    std::atomic<bool> m_canceled{false};
 
     std::atomic<float> m_priority;
     bool m_proxyState = false;
@@ -104,6 +104,9 @@ public:
 
 struct TileTaskQueue {
     virtual void enqueue(std::shared_ptr<TileTask>&& task) = 0;
+
+    // Called after the priorities of enqueued tasks have changed
+    virtual void updatePriorities() {}
 };
 
 struct TileTaskCb {
@@ -2,6 +2,7 @@
 
 #include "platform.h"
 #include "data/dataSource.h"
+#include "scene/scene.h"
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
 #include "tile/tileBuilder.h"
@@ -19,9 +20,14 @@ TileWorker::TileWorker(int _num_worker) {
 
     for (int i = 0; i < _num_worker; i++) {
         auto worker = std::make_unique<Worker>();
-        worker->thread = std::thread(&TileWorker::run, this, worker.get());
+        worker->id = i;
         m_workers.push_back(std::move(worker));
     }
+
+    // Start threads once all queues exist, workers may steal from each other
+    for (auto& worker : m_workers) {
+        worker->thread = std::thread(&TileWorker::run, this, worker.get());
+    }
 }
 
 TileWorker::~TileWorker(){
@@ -38,53 +44,49 @@ void TileWorker::run(Worker* instance) {
 
     while (true) {
 
-        std::shared_ptr<TileTask> task;
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-
-            m_condition.wait(lock, [&, this]{
-                    return !m_running || !m_queue.empty();
-                });
-
-            if (instance->tileBuilder) {
-                builder = std::move(instance->tileBuilder);
-                LOG("Passed new TileBuilder to TileWorker");
+        if (instance->hasNewScene) {
+            std::shared_ptr<Scene> scene;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                scene = std::move(instance->scene);
+                instance->hasNewScene = false;
             }
+            // Set up the TileBuilder on this thread, not in setScene(), and
+            // keep the Duktape heap of the previous one
+            auto styleContext = builder ? builder->releaseStyleContext() : nullptr;
+            builder = std::make_unique<TileBuilder>(scene, std::move(styleContext));
+            builder->setExecutor(this);
+            LOG("Passed new TileBuilder to TileWorker");
+        }
 
-            // Check if thread should stop
-            if (!m_running) {
-                break;
-            }
+        // Check if thread should stop
+        if (!m_running) {
+            break;
+        }
 
-            if (!builder) {
+        // Help with split tiles first, their TileTask is already running
+        if (builder) {
+            if (auto splitJob = takeSplitJob(*builder, true)) {
+                (*splitJob->job)(*builder);
+                finishSplitJob(*splitJob);
                 continue;
             }
+        }
 
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
+        std::shared_ptr<TileTask> task;
 
-            m_queue.erase(removes, m_queue.end());
+        if (builder) {
+            task = nextTask(*instance);
+        }
 
-            if (m_queue.empty()) {
-                continue;
-            }
+        if (!task) {
+            std::unique_lock<std::mutex> lock(m_mutex);
 
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->source().id() == b->source().id() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
+            m_condition.wait(lock, [&, this]{
+                    return !m_running || instance->hasNewScene ||
+                        (builder && (m_pending > 0 || takeSplitJob(*builder, false)));
                 });
-
-            task = std::move(*it);
-            m_queue.erase(it);
+            continue;
         }
 
         if (task->isCanceled()) {
@@ -93,7 +95,18 @@ void TileWorker::run(Worker* instance) {
 
         // const clock_t begin = clock();
 
-        task->process(*builder);
+        {
+            Arena::Scope scope(instance->arena);
+            task->process(*builder);
+        }
+
+        // Reuse the Arena when the TileData was released, otherwise
+        // the TileData releases it
+        if (instance->arena.use_count() == 1) {
+            instance->arena->reset();
+        } else {
+            instance->arena = std::make_shared<Arena>();
+        }
 
         // float loadTime = (float(clock() - begin) / CLOCKS_PER_SEC) * 1000;
         // LOG("loadTime %s - %f", task->tileID.toString().c_str(), loadTime);
@@ -102,23 +115,201 @@ void TileWorker::run(Worker* instance) {
     }
 }
 
+std::shared_ptr<TileTask> TileWorker::nextTask(Worker& _worker) {
+
+    {
+        std::lock_guard<std::mutex> lock(_worker.mutex);
+        if (auto task = popTask(_worker)) { return task; }
+    }
+
+    // Own queue is empty: steal the head of another queue. The first round
+    // skips queues that are locked by their owner or another thief, the
+    // second one waits for their locks. Otherwise an idle worker would spin
+    // in run() while m_pending counts tasks it could not reach.
+    size_t numWorkers = m_workers.size();
+
+    for (int round = 0; round < 2 && m_pending > 0; round++) {
+        for (size_t i = 1; i < numWorkers && m_pending > 0; i++) {
+            auto& worker = *m_workers[(_worker.id + i) % numWorkers];
+
+            std::unique_lock<std::mutex> lock(worker.mutex, std::defer_lock);
+            if (round == 0) {
+                if (!lock.try_lock()) { continue; }
+            } else {
+                lock.lock();
+            }
+
+            if (auto task = popTask(worker)) { return task; }
+        }
+    }
+    return nullptr;
+}
+
+void TileWorker::updateQueue(Worker& _worker) {
+
+    uint32_t generation = m_priorityGeneration;
+
+    if (_worker.generation == generation) { return; }
+
+    _worker.generation = generation;
+
+    auto& queue = _worker.queue;
+
+    // Remove all canceled tasks and re-key the others
+    auto removes = std::remove_if(queue.begin(), queue.end(),
+                                  [](const auto& a) { return a.task->isCanceled(); });
+
+    m_pending -= std::distance(removes, queue.end());
+    queue.erase(removes, queue.end());
+
+    for (auto& entry : queue) {
+        entry.proxy = entry.task->isProxy();
+        entry.priority = entry.task->getPriority();
+    }
+    std::make_heap(queue.begin(), queue.end());
+}
+
+std::shared_ptr<TileTask> TileWorker::popTask(Worker& _worker) {
+
+    updateQueue(_worker);
+
+    auto& queue = _worker.queue;
+
+    while (!queue.empty()) {
+        // Pop highest priority tile from queue
+        std::pop_heap(queue.begin(), queue.end());
+        auto task = std::move(queue.back().task);
+        queue.pop_back();
+        m_pending--;
+
+        if (task->isCanceled()) { continue; }
+
+        return task;
+    }
+    return nullptr;
+}
+
 void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
-    for (auto& worker : m_workers) {
-        worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (auto& worker : m_workers) {
+            worker->scene = _scene;
+            worker->hasNewScene = true;
+        }
     }
+    m_condition.notify_all();
 }
 
 void TileWorker::enqueue(std::shared_ptr<TileTask>&& task) {
+
+    if (!m_running) {
+        return;
+    }
+
+    auto& worker = *m_workers[m_nextWorker++ % m_workers.size()];
     {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        worker.queue.push_back({ task->isProxy(), task->getPriority(), std::move(task) });
+        std::push_heap(worker.queue.begin(), worker.queue.end());
+        m_pending++;
+    }
+
+    {
+        // Ensure a worker that is about to wait sees the new task
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) {
-            return;
-        }
-        m_queue.push_back(std::move(task));
     }
     m_condition.notify_one();
 }
 
+size_t TileWorker::splitCount(size_t _features) const {
+
+    size_t threshold = m_splitThreshold;
+
+    if (threshold == 0 || _features < threshold) { return 1; }
+
+    return m_workers.size();
+}
+
+void TileWorker::execute(TileBuilder& _builder, std::vector<Job>& _jobs) {
+
+    std::vector<std::shared_ptr<SplitJob>> parts;
+    {
+        std::lock_guard<std::mutex> lock(m_splitMutex);
+
+        for (size_t i = 1; i < _jobs.size(); i++) {
+            auto part = std::make_shared<SplitJob>();
+            part->sceneId = _builder.scene().id;
+            part->job = &_jobs[i];
+
+            parts.push_back(part);
+            m_splitJobs.push_back(part);
+        }
+    }
+
+    {
+        // Ensure a worker that is about to wait sees the new parts
+        std::unique_lock<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_all();
+
+    if (!_jobs.empty()) {
+        _jobs[0](_builder);
+    }
+
+    // Build the parts that no other worker has picked up
+    for (auto& part : parts) {
+        bool taken = false;
+        {
+            std::lock_guard<std::mutex> lock(m_splitMutex);
+
+            auto it = std::find(m_splitJobs.begin(), m_splitJobs.end(), part);
+            if (it != m_splitJobs.end()) {
+                m_splitJobs.erase(it);
+                taken = true;
+            }
+        }
+        if (taken) {
+            (*part->job)(_builder);
+            finishSplitJob(*part);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_splitMutex);
+    m_splitCondition.wait(lock, [&]{
+            return std::all_of(parts.begin(), parts.end(),
+                               [](const auto& part) { return part->done; });
+        });
+}
+
+std::shared_ptr<TileWorker::SplitJob> TileWorker::takeSplitJob(const TileBuilder& _builder, bool _remove) {
+
+    std::lock_guard<std::mutex> lock(m_splitMutex);
+
+    // Only TileBuilders of the same Scene create identical meshes
+    auto it = std::find_if(m_splitJobs.begin(), m_splitJobs.end(),
+                           [&](const auto& job) { return job->sceneId == _builder.scene().id; });
+
+    if (it == m_splitJobs.end()) { return nullptr; }
+
+    auto job = *it;
+    if (_remove) { m_splitJobs.erase(it); }
+
+    return job;
+}
+
+void TileWorker::finishSplitJob(SplitJob& _job) {
+    {
+        std::lock_guard<std::mutex> lock(m_splitMutex);
+        _job.done = true;
+    }
+    m_splitCondition.notify_all();
+}
+
+void TileWorker::updatePriorities() {
+    m_priorityGeneration++;
+}
+
 void TileWorker::stop() {
     {
         std::unique_lock<std::mutex> lock(m_mutex);
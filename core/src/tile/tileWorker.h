@@ -1,10 +1,13 @@
 #pragma once
 
+#include "tile/tileBuilder.h"
 #include "tile/tileTask.h"
+#include "util/arena.h"
 #include "util/jobQueue.h"
 
 #include <memory>
 #include <vector>
+#include <deque>
 #include <condition_variable>
 #include <thread>
 #include <mutex>
@@ -14,9 +17,24 @@ namespace Tangram {
 
 class JobQueue;
 class Scene;
-class TileBuilder;
 
-class TileWorker : public TileTaskQueue {
+/* TileWorker
+ *
+ * Each worker thread owns a priority queue (binary heap) of TileTasks.
+ * Enqueued tasks are distributed round-robin over the workers, so that
+ * the queues hold tasks of similar priorities. A worker takes the most
+ * urgent task of its own queue. When that is empty it steals the most
+ * urgent task of another queue that is not locked at the moment. The
+ * shared mutex is only taken when a worker goes idle.
+ *
+ * Tasks of an older generation of their DataSource are canceled when they
+ * are dequeued: TileManager enqueues the tile again for the current one.
+ *
+ * Tiles with at least 'splitThreshold' features are built in parts (see
+ * TileBuilder::build()). Idle workers pick up the parts before starting
+ * on their next task.
+ */
+class TileWorker : public TileTaskQueue, public TileBuildExecutor {
 
 public:
 
@@ -26,29 +44,112 @@ public:
 
     virtual void enqueue(std::shared_ptr<TileTask>&& task) override;
 
+    /* Re-sort queued tasks on next access (TileTask priorities changed) */
+    virtual void updatePriorities() override;
+
     void stop();
 
     bool isRunning() const { return m_running; }
 
+    /* Returns immediately, each worker sets up its TileBuilder for _scene
+     * before taking the next task and keeps its StyleContext */
     void setScene(std::shared_ptr<Scene>& _scene);
 
+    /* Number of tasks waiting to be processed */
+    int pendingTasks() const { return m_pending; }
+
+    /* Build tiles with at least _features features on several workers, 0 to disable */
+    void setSplitThreshold(size_t _features) { m_splitThreshold = _features; }
+
+    size_t splitCount(size_t _features) const override;
+
+    void execute(TileBuilder& _builder, std::vector<Job>& _jobs) override;
+
 private:
 
+    struct QueueEntry {
+        // Snapshot of the task priority, so that heap order does not
+        // change while TileManager updates the task priorities.
+        bool proxy;
+        double priority;
+        std::shared_ptr<TileTask> task;
+
+        // Heap order: the greatest entry is processed first
+        bool operator<(const QueueEntry& _other) const {
+            if (proxy != _other.proxy) { return proxy; }
+            return priority > _other.priority;
+        }
+    };
+
     struct Worker {
+        size_t id;
         std::thread thread;
-        std::unique_ptr<TileBuilder> tileBuilder;
+
+        // Set by setScene() - guarded by TileWorker::m_mutex. The worker
+        // creates its TileBuilder for the Scene.
+        std::shared_ptr<Scene> scene;
+        std::atomic<bool> hasNewScene{false};
+
+        // Guards 'queue' and 'generation'
+        std::mutex mutex;
+        std::vector<QueueEntry> queue;
+        uint32_t generation = 0;
+
+        // Memory for the TileData of the currently processed task,
+        // shared with the TileData
+        std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+    };
+
+    // A part of a split tile build
+    struct SplitJob {
+        // Scene::id of the TileBuilder that split the tile. A new Scene may
+        // be allocated at the address of a released one.
+        int32_t sceneId;
+        Job* job;
+        // Guarded by m_splitMutex
+        bool done = false;
     };
 
     void run(Worker* instance);
 
-    bool m_running;
+    /* Take a queued part of a split tile with the same Scene as _builder */
+    std::shared_ptr<SplitJob> takeSplitJob(const TileBuilder& _builder, bool _remove);
+
+    void finishSplitJob(SplitJob& _job);
+
+    /* Pop the most urgent task of the own queue of _worker or steal one */
+    std::shared_ptr<TileTask> nextTask(Worker& _worker);
+
+    /* Re-key the queue of _worker when task priorities changed - requires
+     * _worker.mutex */
+    void updateQueue(Worker& _worker);
+
+    /* Pop the most urgent task of _worker - requires _worker.mutex */
+    std::shared_ptr<TileTask> popTask(Worker& _worker);
+
+    std::atomic<bool> m_running;
 
     std::vector<std::unique_ptr<Worker>> m_workers;
 
-    std::condition_variable m_condition;
+    // Round-robin distribution of new tasks
+    std::atomic<uint32_t> m_nextWorker{0};
 
+    // Number of tasks in all worker queues
+    std::atomic<int> m_pending{0};
+
+    // Incremented when task priorities changed
+    std::atomic<uint32_t> m_priorityGeneration{0};
+
+    // Used to put idle workers to sleep
+    std::condition_variable m_condition;
     std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+
+    std::atomic<size_t> m_splitThreshold{0};
+
+    // Parts of split tiles waiting for a worker
+    std::deque<std::shared_ptr<SplitJob>> m_splitJobs;
+    std::condition_variable m_splitCondition;
+    std::mutex m_splitMutex;
 };
 
 }
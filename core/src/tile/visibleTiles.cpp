@@ -0,0 +1,40 @@
+#include "tile/visibleTiles.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace Tangram {
+
+static std::atomic<uint64_t> s_version(0);
+
+VisibleTiles::VisibleTiles(std::vector<TileID> _tiles) {
+    update(_tiles);
+}
+
+void VisibleTiles::update(std::vector<TileID>& _tiles) {
+
+    std::sort(_tiles.begin(), _tiles.end());
+    _tiles.erase(std::unique(_tiles.begin(), _tiles.end()), _tiles.end());
+
+    m_added.clear();
+    m_removed.clear();
+    m_previousVersion = m_version;
+
+    if (_tiles == m_tiles && m_version != 0) { return; }
+
+    std::set_difference(_tiles.begin(), _tiles.end(), m_tiles.begin(), m_tiles.end(),
+                        std::back_inserter(m_added));
+    std::set_difference(m_tiles.begin(), m_tiles.end(), _tiles.begin(), _tiles.end(),
+                        std::back_inserter(m_removed));
+
+    std::swap(m_tiles, _tiles);
+    m_version = ++s_version;
+}
+
+void VisibleTiles::clear() {
+    std::vector<TileID> none;
+    update(none);
+}
+
+}
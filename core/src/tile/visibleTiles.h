@@ -0,0 +1,72 @@
+#pragma once
+
+#include "tile/tileID.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+/* VisibleTiles
+ *
+ * The set of tiles covered by the view, kept as a sorted vector of TileIDs
+ * together with the tiles that were added and removed by the last update().
+ *
+ * This is not an incremental computation: the View still rasterizes the
+ * whole frustum into a new vector on every change, update() swaps it in and
+ * derives added() and removed() as the difference of the two sorted vectors.
+ * What consumers save is the comparison with their own tile containers.
+ *
+ * Each update() that changes the set gets a new version. Versions are unique
+ * across all VisibleTiles instances, so that a consumer can tell from the
+ * version alone whether the tiles changed since it last looked at them.
+ * A consumer that has seen previousVersion() can apply added() and removed()
+ * instead of comparing all tiles.
+ */
+class VisibleTiles {
+
+public:
+
+    VisibleTiles() = default;
+
+    explicit VisibleTiles(std::vector<TileID> _tiles);
+
+    /* Replace the visible tiles by _tiles, which may be unsorted and contain
+     * duplicates. _tiles is swapped with the previous tiles to reuse their
+     * memory, its content is unspecified afterwards. */
+    void update(std::vector<TileID>& _tiles);
+
+    void clear();
+
+    /* Sorted by TileID order, without duplicates */
+    const std::vector<TileID>& tiles() const { return m_tiles; }
+
+    /* Tiles that became visible with the last update() */
+    const std::vector<TileID>& added() const { return m_added; }
+
+    /* Tiles that are no longer visible since the last update() */
+    const std::vector<TileID>& removed() const { return m_removed; }
+
+    uint64_t version() const { return m_version; }
+
+    /* Version to which added() and removed() were applied, equal to version()
+     * when the last update() did not change the tiles */
+    uint64_t previousVersion() const { return m_previousVersion; }
+
+    bool empty() const { return m_tiles.empty(); }
+    size_t size() const { return m_tiles.size(); }
+
+    auto begin() const { return m_tiles.begin(); }
+    auto end() const { return m_tiles.end(); }
+
+private:
+
+    std::vector<TileID> m_tiles;
+    std::vector<TileID> m_added;
+    std::vector<TileID> m_removed;
+
+    uint64_t m_version = 0;
+    uint64_t m_previousVersion = 0;
+};
+
+}
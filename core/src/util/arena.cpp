@@ -0,0 +1,86 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace Tangram {
+
+static thread_local Arena* s_currentArena = nullptr;
+static thread_local std::shared_ptr<Arena> s_currentOwner;
+
+Arena::~Arena() {
+    // A container still using the Arena would point into released memory
+    assert(m_live == 0);
+}
+
+Arena* Arena::current() {
+    return s_currentArena;
+}
+
+std::shared_ptr<Arena> Arena::currentOwner() {
+    return s_currentOwner;
+}
+
+Arena::Scope::Scope(Arena& _arena) : previous(s_currentArena), previousOwner(std::move(s_currentOwner)) {
+    s_currentArena = &_arena;
+    s_currentOwner.reset();
+}
+
+Arena::Scope::Scope(std::shared_ptr<Arena> _arena) : previous(s_currentArena), previousOwner(std::move(s_currentOwner)) {
+    s_currentArena = _arena.get();
+    s_currentOwner = std::move(_arena);
+}
+
+Arena::Scope::~Scope() {
+    s_currentArena = previous;
+    s_currentOwner = std::move(previousOwner);
+}
+
+uintptr_t Arena::addChunk(size_t _minBytes) {
+
+    size_t size = std::max(_minBytes, m_chunkSize);
+
+    m_chunks.push_back({ std::unique_ptr<char[]>(new char[size]), size });
+
+    auto& chunk = m_chunks.back();
+    m_pos = reinterpret_cast<uintptr_t>(chunk.data.get());
+    m_end = m_pos + size;
+
+    return m_pos;
+}
+
+void Arena::reset() {
+
+    // A container still using the Arena would point into released memory
+    assert(m_live == 0);
+
+    m_allocations = 0;
+    m_live = 0;
+
+    std::fill(std::begin(m_free), std::end(m_free), nullptr);
+
+    if (m_chunks.empty()) { return; }
+
+    // Keep one chunk of default size, large chunks were likely
+    // needed for an exceptional tile.
+    if (m_chunks.front().size != m_chunkSize) {
+        m_chunks.clear();
+        m_pos = m_end = 0;
+        return;
+    }
+
+    m_chunks.resize(1);
+
+    auto& chunk = m_chunks.front();
+    m_pos = reinterpret_cast<uintptr_t>(chunk.data.get());
+    m_end = m_pos + chunk.size;
+}
+
+size_t Arena::capacity() const {
+    size_t sum = 0;
+    for (auto& chunk : m_chunks) { sum += chunk.size; }
+    return sum;
+}
+
+}
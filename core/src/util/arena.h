@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Tangram {
+
+/* Arena
+ *
+ * Bump allocator for short-lived data, e.g. the TileData of one tile.
+ * Memory is taken from large chunks and only returned to the heap as a
+ * whole. Each TileWorker thread makes an Arena current while a tile is
+ * parsed and built (see Arena::Scope); the TileData created in that scope
+ * shares ownership of the Arena, so the memory lives as long as the
+ * TileData. The worker reuses the Arena for the next tile only when the
+ * TileData was released, otherwise it starts a new one.
+ *
+ * Deallocated blocks are kept in free lists by size, so that the old
+ * buffers of growing vectors are reused for later allocations.
+ *
+ * Containers that should outlive their TileData must be copied, copies
+ * use the heap. All containers using the Arena must be destroyed before
+ * reset() or the destruction of the Arena; debug builds assert this.
+ */
+class Arena {
+
+public:
+
+    static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+    Arena(size_t _chunkSize = CHUNK_SIZE) : m_chunkSize(_chunkSize) {}
+
+    ~Arena();
+
+    // No copies
+    Arena(const Arena& _other) = delete;
+    Arena& operator=(const Arena& _other) = delete;
+
+    void* allocate(size_t _bytes, size_t _align) {
+        m_allocations++;
+        m_live++;
+
+        // Reuse a deallocated block of at least _bytes
+        size_t sizeClass = ceilLog2(_bytes);
+        if (sizeClass < SIZE_CLASSES && m_free[sizeClass]) {
+            void* block = m_free[sizeClass];
+            if ((reinterpret_cast<uintptr_t>(block) & (_align - 1)) == 0) {
+                std::memcpy(&m_free[sizeClass], block, sizeof(void*));
+                return block;
+            }
+        }
+
+        uintptr_t pos = (m_pos + _align - 1) & ~uintptr_t(_align - 1);
+
+        if (pos + _bytes > m_end) {
+            pos = addChunk(_bytes + _align);
+            pos = (pos + _align - 1) & ~uintptr_t(_align - 1);
+        }
+
+        m_pos = pos + _bytes;
+
+        return reinterpret_cast<void*>(pos);
+    }
+
+    /* The most recent allocation is given back to the chunk, other blocks
+     * are kept for reuse by allocate() until reset(). */
+    void deallocate(void* _ptr, size_t _bytes) {
+        m_live--;
+
+        uintptr_t pos = reinterpret_cast<uintptr_t>(_ptr);
+        if (pos + _bytes == m_pos) {
+            m_pos = pos;
+            return;
+        }
+
+        // Blocks of [2^n, 2^(n+1)) bytes are kept in class n
+        if (_bytes < sizeof(void*)) { return; }
+        size_t sizeClass = ceilLog2(_bytes + 1) - 1;
+        if (sizeClass < SIZE_CLASSES) {
+            std::memcpy(_ptr, &m_free[sizeClass], sizeof(void*));
+            m_free[sizeClass] = _ptr;
+        }
+    }
+
+    /* Release all allocations. Keeps the first chunk for reuse. */
+    void reset();
+
+    /* Number of allocations since last reset */
+    size_t allocations() const { return m_allocations; }
+
+    /* Number of allocations that were not deallocated yet */
+    size_t liveAllocations() const { return m_live; }
+
+    /* Bytes reserved from the heap */
+    size_t capacity() const;
+
+    /* Arena used by ArenaAllocators created on the current thread */
+    static Arena* current();
+
+    /* Shared owner of the current Arena, when it was made current with one */
+    static std::shared_ptr<Arena> currentOwner();
+
+    /* Makes an Arena current for the calling thread during its lifetime */
+    struct Scope {
+        Scope(Arena& _arena);
+        Scope(std::shared_ptr<Arena> _arena);
+        ~Scope();
+        Arena* previous;
+        std::shared_ptr<Arena> previousOwner;
+    };
+
+private:
+
+    static constexpr size_t SIZE_CLASSES = 32;
+
+    static size_t ceilLog2(size_t _bytes) {
+        size_t n = 0;
+        while ((size_t(1) << n) < _bytes) { n++; }
+        return n;
+    }
+
+    uintptr_t addChunk(size_t _minBytes);
+
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Chunk> m_chunks;
+    size_t m_chunkSize;
+
+    uintptr_t m_pos = 0;
+    uintptr_t m_end = 0;
+
+    // Heads of the lists of deallocated blocks, the next pointer
+    // is stored in the block
+    void* m_free[SIZE_CLASSES] = {};
+
+    size_t m_allocations = 0;
+    size_t m_live = 0;
+};
+
+/* STL allocator that takes memory from the Arena which was current on
+ * construction, or from the heap when no Arena was set. Copied containers
+ * always use the heap, moved containers keep their Arena.
+ */
+template<typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    // Containers moved into each other keep their storage
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    Arena* arena;
+
+    ArenaAllocator() : arena(Arena::current()) {}
+    ArenaAllocator(Arena* _arena) : arena(_arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& _other) : arena(_other.arena) {}
+
+    // Copies use the heap - they may outlive the Arena, e.g. data copied
+    // out of a TileData into a Tile or a cache.
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator(nullptr);
+    }
+
+    T* allocate(size_t _n) {
+        if (arena) {
+            return static_cast<T*>(arena->allocate(_n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(_n * sizeof(T)));
+    }
+
+    void deallocate(T* _ptr, size_t _n) {
+        if (arena) {
+            arena->deallocate(_ptr, _n * sizeof(T));
+        } else {
+            ::operator delete(_ptr);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& _other) const { return arena == _other.arena; }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& _other) const { return arena != _other.arena; }
+};
+
+}
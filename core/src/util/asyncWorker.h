@@ -1,6 +1,10 @@
-#include <thread>
-#include <mutex>
+#pragma once
+
+#include <condition_variable>
 #include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace Tangram {
 
@@ -1,19 +1,9 @@
 #include "builders.h"
 
 #include "geom.h"
-#include "glm/gtx/rotate_vector.hpp"
-#include "glm/gtx/norm.hpp"
-
-namespace mapbox { namespace util {
-template <>
-struct nth<0, Tangram::Point> {
-    inline static float get(const Tangram::Point &t) { return t.x; };
-};
-template <>
-struct nth<1, Tangram::Point> {
-    inline static float get(const Tangram::Point &t) { return t.y; };
-};
-}}
+#include "simd.h"
+
+#include <cstring>
 
 namespace Tangram {
 
@@ -29,433 +19,119 @@ JoinTypes JoinTypeFromString(const std::string& str) {
     return JoinTypes::miter;
 }
 
-void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
-
-    glm::vec2 min, max;
-    if (_ctx.useTexCoords) {
-        min = glm::vec2(std::numeric_limits<float>::max());
-        max = glm::vec2(std::numeric_limits<float>::min());
-
-        for (auto& p : _polygon[0]) {
-            min.x = std::min(min.x, p.x);
-            min.y = std::min(min.y, p.y);
-            max.x = std::max(max.x, p.x);
-            max.y = std::max(max.y, p.y);
-        }
-    }
-
-    // Run earcut, triangles are stored in _ctx.earcut.indices
-    _ctx.earcut(_polygon);
-
-    size_t sumPoints = 0;
-    for (auto& line : _polygon) {
-        sumPoints += line.size();
-    }
-
-    // Mark the points that are referenced by indices as used.
-    size_t sumVertices = 0;
-    _ctx.used.assign(sumPoints, 0);
-    for (auto i : _ctx.earcut.indices) {
-        if (_ctx.used[i] == 0) {
-            _ctx.used[i] = 1;
-            sumVertices++;
-        }
-    }
-
-    uint16_t vertexDataOffset = _ctx.numVertices;
-    _ctx.numVertices += sumVertices;
+void Builders::segmentNormals(const Line& _line, std::vector<glm::vec2>& _normals) {
 
-    size_t ring = 0;
-    size_t offset = 0;
+    size_t n = _line.size();
+    _normals.resize(n);
 
-    // Go through all points of the polyon.
-    for (size_t src = 0, dst = 0; src < sumPoints; src++) {
-        // The points of the polygon rings are indexed linearly.
-        // This maps the indices back to the original ring and point.
-        if (src - offset >= _polygon[ring].size()) {
-            offset += _polygon[ring].size();
-            ring += 1;
-        }
-
-        // Add vertex only when the point is used.
-        if (_ctx.used[src] == 0) { continue; }
+    size_t i = 0;
 
-        // Keep track of skipped points to update indices
-        _ctx.used[src] = dst++;
+    // Same operations as glm::normalize(perp2d(a, b))
+    for (; i + 4 < n; i += 4) {
+        const Point* p = &_line[i];
+        auto ax = simd::set(p[0].x, p[1].x, p[2].x, p[3].x);
+        auto ay = simd::set(p[0].y, p[1].y, p[2].y, p[3].y);
+        auto bx = simd::set(p[1].x, p[2].x, p[3].x, p[4].x);
+        auto by = simd::set(p[1].y, p[2].y, p[3].y, p[4].y);
 
-        auto& p = _polygon[ring][src - offset];
-        glm::vec3 coord(p.x, p.y, _height);
+        auto px = by - ay;
+        auto py = ax - bx;
+        auto invLength = simd::splat(1.f) / simd::sqrt(px * px + py * py);
 
-        if (_ctx.useTexCoords) {
-            glm::vec2 uv(mapValue(coord.x, min.x, max.x, 0., 1.),
-                         mapValue(coord.y, min.y, max.y, 1., 0.));
+        float x[4], y[4];
+        simd::store(x, px * invLength);
+        simd::store(y, py * invLength);
 
-            _ctx.addVertex(coord, glm::vec3(0.0, 0.0, 1.0), uv);
-        } else {
-            _ctx.addVertex(coord, glm::vec3(0.0, 0.0, 1.0), glm::vec2(0));
+        for (int j = 0; j < 4; j++) {
+            _normals[i + j] = { x[j], y[j] };
         }
     }
 
-    for (auto i : _ctx.earcut.indices) {
-        _ctx.indices.push_back(vertexDataOffset + _ctx.used[i]);
+    for (; i < n; i++) {
+        _normals[i] = glm::normalize(perp2d(_line[i], _line[(i + 1) % n]));
     }
 }
 
-void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
-
-    auto vertexDataOffset = _ctx.numVertices;
-
-    static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
-    glm::vec3 normalVector;
-
-    for (auto& line : _polygon) {
-
-        size_t lineSize = line.size();
+void Builders::miterScales(const std::vector<glm::vec2>& _normals, std::vector<float>& _scales) {
 
-        for (size_t i = 0; i < lineSize - 1; i++) {
+    size_t n = _normals.size();
+    _scales.resize(n);
 
-            glm::vec3 a(line[i]);
-            glm::vec3 b(line[i+1]);
+    if (n == 0) { return; }
 
-            normalVector = glm::cross(upVector, b - a);
-            normalVector = glm::normalize(normalVector);
+    _scales[0] = 2.f / glm::dot(_normals[n - 1] + _normals[0], _normals[n - 1] + _normals[0]);
 
-            if (std::isnan(normalVector.x)
-             || std::isnan(normalVector.y)
-             || std::isnan(normalVector.z)) {
-                continue;
-            }
+    size_t i = 1;
 
-            // 1st vertex top
-            a.z = _maxHeight;
-            _ctx.addVertex(a, normalVector, glm::vec2(1.,1.));
+    // Same operations as 2.f / glm::dot(m, m)
+    for (; i + 4 <= n; i += 4) {
+        const glm::vec2* a = &_normals[i - 1];
+        auto mx = simd::set(a[0].x + a[1].x, a[1].x + a[2].x, a[2].x + a[3].x, a[3].x + a[4].x);
+        auto my = simd::set(a[0].y + a[1].y, a[1].y + a[2].y, a[2].y + a[3].y, a[3].y + a[4].y);
 
-            // 2nd vertex top
-            b.z = _maxHeight;
-            _ctx.addVertex(b, normalVector, glm::vec2(0.,1.));
-
-            // 1st vertex bottom
-            a.z = _minHeight;
-            _ctx.addVertex(a, normalVector, glm::vec2(1.,0.));
-
-            // 2nd vertex bottom
-            b.z = _minHeight;
-            _ctx.addVertex(b, normalVector, glm::vec2(0.,0.));
-
-            // Start the index from the previous state of the vertex Data
-            _ctx.indices.push_back(vertexDataOffset);
-            _ctx.indices.push_back(vertexDataOffset + 1);
-            _ctx.indices.push_back(vertexDataOffset + 2);
-
-            _ctx.indices.push_back(vertexDataOffset + 1);
-            _ctx.indices.push_back(vertexDataOffset + 3);
-            _ctx.indices.push_back(vertexDataOffset + 2);
-
-            vertexDataOffset += 4;
-        }
-
-        _ctx.numVertices = vertexDataOffset;
-    }
-}
-
-// Get 2D perpendicular of two points
-glm::vec2 perp2d(const glm::vec3& _v1, const glm::vec3& _v2 ){
-    return glm::vec2(_v2.y - _v1.y, _v1.x - _v2.x);
-}
-
-// Helper function for polyline tesselation
-inline void addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv, PolyLineBuilder& _ctx) {
-    _ctx.numVertices++;
-    _ctx.addVertex(_coord, _normal, _uv);
-}
-
-// Helper function for polyline tesselation; adds indices for pairs of vertices arranged like a line strip
-void indexPairs( int _nPairs, int _nVertices, std::vector<uint16_t>& _indicesOut) {
-    for (int i = 0; i < _nPairs; i++) {
-        _indicesOut.push_back(_nVertices - 2*i - 4);
-        _indicesOut.push_back(_nVertices - 2*i - 2);
-        _indicesOut.push_back(_nVertices - 2*i - 3);
-
-        _indicesOut.push_back(_nVertices - 2*i - 3);
-        _indicesOut.push_back(_nVertices - 2*i - 2);
-        _indicesOut.push_back(_nVertices - 2*i - 1);
+        simd::store(&_scales[i], simd::splat(2.f) / (mx * mx + my * my));
     }
-}
-
-//  Tessalate a fan geometry between points A       B
-//  using their normals from a center        \ . . /
-//  and interpolating their UVs               \ p /
-//                                             \./
-//                                              C
-void addFan(const glm::vec3& _pC,
-            const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
-            const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
-            int _numTriangles, PolyLineBuilder& _ctx) {
-
-    // Find angle difference
-    float cross = _nA.x * _nB.y - _nA.y * _nB.x; // z component of cross(_CA, _CB)
-    float angle = atan2f(cross, glm::dot(_nA, _nB));
-
-    int startIndex = _ctx.numVertices;
-
-    // Add center vertex
-    addPolyLineVertex(_pC, _nC, _uC, _ctx);
-
-    // Add vertex for point A
-    addPolyLineVertex(_pC, _nA, _uA, _ctx);
-
-    // Add radial vertices
-    glm::vec2 radial = _nA;
-    for (int i = 0; i < _numTriangles; i++) {
-        float frac = (i + 1)/(float)_numTriangles;
-        radial = glm::rotate(_nA, angle * frac);
-
-        glm::vec2 uv(0.0);
-        if (_ctx.useTexCoords) {
-            uv = (1.f - frac) * _uA + frac * _uB;
-        }
-
-        addPolyLineVertex(_pC, radial, uv, _ctx);
-
-        // Add indices
-        _ctx.indices.push_back(startIndex); // center vertex
-        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 1 : 2));
-        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 2 : 1));
-    }
-
-}
-
-// Function to add the vertices for line caps
-void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning, PolyLineBuilder& _ctx) {
-
-    float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
-
-    if (_numCorners < 1) {
-        // "Butt" cap needs no extra vertices
-        return;
-    } else if (_numCorners == 2) {
-        // "Square" cap needs two extra vertices
-        glm::vec2 tangent(-_normal.y, _normal.x);
-        addPolyLineVertex(_coord, _normal + tangent, {0.f, v}, _ctx);
-        addPolyLineVertex(_coord, -_normal + tangent, {0.f, v}, _ctx);
-        if (!_isBeginning) { // At the beginning of a line we can't form triangles with previous vertices
-            indexPairs(1, _ctx.numVertices, _ctx.indices);
-        }
-        return;
-    }
-
-    // "Round" cap type needs a fan of vertices
-    glm::vec2 nA(_normal), nB(-_normal), nC(0.f, 0.f), uA(1.f, v), uB(0.f, v), uC(0.5f, v);
-    if (_isBeginning) {
-        nA *= -1.f; // To flip the direction of the fan, we negate the normal vectors
-        nB *= -1.f;
-        uA.x = 0.f; // To keep tex coords consistent, we must reverse these too
-        uB.x = 1.f;
-    }
-    addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
-}
 
-// Tests if a line segment (from point A to B) is outside the edge of a tile
-bool isOutsideTile(const glm::vec3& _a, const glm::vec3& _b) {
-
-    // tweak this adjust if catching too few/many line segments near tile edges
-    // TODO: make tolerance configurable by source if necessary
-    float tolerance = 0.0005;
-    float tile_min = 0.0 + tolerance;
-    float tile_max = 1.0 - tolerance;
-
-    if ( (_a.x < tile_min && _b.x < tile_min) ||
-         (_a.x > tile_max && _b.x > tile_max) ||
-         (_a.y < tile_min && _b.y < tile_min) ||
-         (_a.y > tile_max && _b.y > tile_max) ) {
-        return true;
+    for (; i < n; i++) {
+        glm::vec2 m = _normals[i - 1] + _normals[i];
+        _scales[i] = 2.f / glm::dot(m, m);
     }
-
-    return false;
 }
 
-void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _startIndex,
-                          size_t _endIndex, bool endCap = true) {
-
-    float distance = 0; // Cumulative distance along the polyline.
-
-    size_t origLineSize = _line.size();
-
-    // endIndex/startIndex could be wrapped values, calculate lineSize accordingly
-    int lineSize = (int)((_endIndex > _startIndex) ?
-                   (_endIndex - _startIndex) :
-                   (origLineSize - _startIndex + _endIndex));
-    if (lineSize < 2) { return; }
-
-    glm::vec3 coordCurr(_line[_startIndex]);
-    // get the Point using wrapped index in the original line geometry
-    glm::vec3 coordNext(_line[(_startIndex + 1) % origLineSize]);
-    glm::vec2 normPrev, normNext, miterVec;
-
-    int cornersOnCap = (int)_ctx.cap;
-    int trianglesOnJoin = (int)_ctx.join;
-
-    // Process first point in line with an end cap
-    normNext = glm::normalize(perp2d(coordCurr, coordNext));
-
-    if (endCap) {
-        addCap(coordCurr, normNext, cornersOnCap, true, _ctx);
-    }
-    addPolyLineVertex(coordCurr, normNext, {1.0f, 0.0f}, _ctx); // right corner
-    addPolyLineVertex(coordCurr, -normNext, {0.0f, 0.0f}, _ctx); // left corner
-
+void Builders::packPolyLineVertices(const PolyLineVertexData* _vertices, size_t _count,
+                                    const PolyLinePackFormat& _format, char* _out) {
 
-    // Process intermediate points
-    for (int i = 1; i < lineSize - 1; i++) {
-        // get the Point using wrapped index in the original line geometry
-        int nextIndex = (i + _startIndex + 1) % origLineSize;
+    static_assert(sizeof(PolyLineVertexData) == 6 * sizeof(float), "Unexpected PolyLineVertexData padding");
 
-        distance += glm::distance(coordCurr, coordNext);
+    // Position and extrusion of a vertex are the first four floats
+    auto scale = simd::set(_format.positionScale, _format.positionScale,
+                           _format.extrusionScale, _format.extrusionScale);
+    auto uvScale = simd::splat(_format.texcoordScale);
 
-        coordCurr = coordNext;
-        coordNext = _line[nextIndex];
+    int16_t packed[4];
 
-        if (coordCurr == coordNext) {
-            continue;
-        }
-
-        normPrev = normNext;
-        normNext = glm::normalize(perp2d(coordCurr, coordNext));
+    size_t i = 0;
 
-        // Compute "normal" for miter joint
-        miterVec = normPrev + normNext;
+    for (; i + 2 <= _count; i += 2) {
+        char* out = _out + i * _format.stride;
 
-        float scale = 1.f;
+        for (size_t j = 0; j < 2; j++) {
+            auto v = simd::load(&_vertices[i + j].coord.x) * scale;
+            simd::store16(packed, simd::truncate(simd::lowHigh(simd::round(v), v)));
 
-        // normPrev and normNext are in the opposite direction
-        // in order to prevent NaN values, we use the perp
-        // vector of those two vectors
-        if (miterVec == glm::zero<glm::vec2>()) {
-            miterVec = perp2d(glm::vec3(normNext, 0.f), glm::vec3(normPrev, 0.f));
-        } else {
-            scale = 2.f / glm::dot(miterVec, miterVec);
+            std::memcpy(out + _format.position, &packed[0], 2 * sizeof(int16_t));
+            std::memcpy(out + _format.extrusion, &packed[2], 2 * sizeof(int16_t));
+            out += _format.stride;
         }
 
-        miterVec *= scale;
+        if (_format.hasTexcoord) {
+            const auto& a = _vertices[i].uv;
+            const auto& b = _vertices[i + 1].uv;
+            auto uv = simd::set(a.x, a.y, b.x, b.y) * uvScale;
+            simd::store16(packed, simd::truncateUnsigned(uv));
 
-        if (glm::length2(miterVec) > glm::length2(_ctx.miterLimit)) {
-            trianglesOnJoin = 1;
-            miterVec *= _ctx.miterLimit / glm::length(miterVec);
+            out = _out + i * _format.stride;
+            std::memcpy(out + _format.texcoord, &packed[0], 2 * sizeof(int16_t));
+            std::memcpy(out + _format.stride + _format.texcoord, &packed[2], 2 * sizeof(int16_t));
         }
-
-        float v = distance;
-
-        if (trianglesOnJoin == 0) {
-            // Join type is a simple miter
-
-            addPolyLineVertex(coordCurr, miterVec, {1.0, v}, _ctx); // right corner
-            addPolyLineVertex(coordCurr, -miterVec, {0.0, v}, _ctx); // left corner
-            indexPairs(1, _ctx.numVertices, _ctx.indices);
-
-        } else {
-
-            // Join type is a fan of triangles
-
-            bool isRightTurn = (normNext.x * normPrev.y - normNext.y * normPrev.x) > 0; // z component of cross(normNext, normPrev)
-
-            if (isRightTurn) {
-
-                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
-                addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx); // left (outer) corner
-                indexPairs(1, _ctx.numVertices, _ctx.indices);
-
-                addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
-
-                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
-                addPolyLineVertex(coordCurr, -normNext, {0.0f, v}, _ctx); // left (outer) corner
-
-            } else {
-
-                addPolyLineVertex(coordCurr, normPrev, {1.0f, v}, _ctx); // right (outer) corner
-                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
-                indexPairs(1, _ctx.numVertices, _ctx.indices);
-
-                addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
-
-                addPolyLineVertex(coordCurr, normNext, {1.0f, v}, _ctx); // right (outer) corner
-                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
-            }
-        }
-    }
-
-    distance += glm::distance(coordCurr, coordNext);
-
-    // Process last point in line with a cap
-    addPolyLineVertex(coordNext, normNext, {1.f, distance}, _ctx); // right corner
-    addPolyLineVertex(coordNext, -normNext, {0.f, distance}, _ctx); // left corner
-    indexPairs(1, _ctx.numVertices, _ctx.indices);
-    if (endCap) {
-        addCap(coordNext, normNext, cornersOnCap, false, _ctx);
     }
 
-}
-
-void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
-
-    size_t lineSize = _line.size();
-
-    if (_ctx.keepTileEdges) {
+    for (; i < _count; i++) {
+        char* out = _out + i * _format.stride;
+        const auto& vertex = _vertices[i];
 
-        buildPolyLineSegment(_line, _ctx, 0, lineSize);
+        auto v = simd::set(vertex.coord.x, vertex.coord.y, vertex.enormal.x, vertex.enormal.y) * scale;
+        simd::store16(packed, simd::truncate(simd::lowHigh(simd::round(v), v)));
 
-    } else {
+        std::memcpy(out + _format.position, &packed[0], 2 * sizeof(int16_t));
+        std::memcpy(out + _format.extrusion, &packed[2], 2 * sizeof(int16_t));
 
-        int cut = 0;
-        int firstCutEnd = 0;
-
-        // Determine cuts
-        for (size_t i = 0; i < lineSize - 1; i++) {
-            const glm::vec3& coordCurr = _line[i];
-            const glm::vec3& coordNext = _line[i+1];
-            if (isOutsideTile(coordCurr, coordNext)) {
-                if (cut == 0) {
-                    firstCutEnd = i + 1;
-                }
-                buildPolyLineSegment(_line, _ctx, cut, i + 1);
-                cut = i + 1;
-            }
-        }
-
-        if (_ctx.closedPolygon) {
-            if (cut == 0) {
-                // no tile edge cuts!
-                // loop and close the polygon with no endcaps
-                buildPolyLineSegment(_line, _ctx, 0, lineSize+2, false);
-            } else {
-                // merge first and last cut line-segments together
-                buildPolyLineSegment(_line, _ctx, cut, firstCutEnd);
-            }
-        } else {
-            buildPolyLineSegment(_line, _ctx, cut, lineSize);
+        if (_format.hasTexcoord) {
+            auto uv = simd::set(vertex.uv.x, vertex.uv.y, 0.f, 0.f) * uvScale;
+            simd::store16(packed, simd::truncateUnsigned(uv));
+            std::memcpy(out + _format.texcoord, &packed[0], 2 * sizeof(int16_t));
         }
-
     }
-
-}
-
-void Builders::buildQuadAtPoint(const glm::vec2& _screenPosition, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder& _ctx) {
-    float halfWidth = _size.x * .5f;
-    float halfHeight = _size.y * .5f;
-
-    _ctx.addVertex(glm::vec2(-halfWidth, -halfHeight), _screenPosition, {_uvBL.x, _uvBL.y});
-    _ctx.addVertex(glm::vec2(-halfWidth, halfHeight), _screenPosition, {_uvBL.x, _uvTR.y});
-    _ctx.addVertex(glm::vec2(halfWidth, -halfHeight), _screenPosition, {_uvTR.x, _uvBL.y});
-    _ctx.addVertex(glm::vec2(halfWidth, halfHeight), _screenPosition, {_uvTR.x, _uvTR.y});
-
-    _ctx.indices.push_back(_ctx.numVerts + 2);
-    _ctx.indices.push_back(_ctx.numVerts + 0);
-    _ctx.indices.push_back(_ctx.numVerts + 1);
-    _ctx.indices.push_back(_ctx.numVerts + 1);
-    _ctx.indices.push_back(_ctx.numVerts + 3);
-    _ctx.indices.push_back(_ctx.numVerts + 2);
-
-    _ctx.numVerts += 4;
-
 }
 
 }
@@ -1,12 +1,30 @@
 #pragma once
 
 #include "data/tileData.h"
+#include "util/geom.h"
+#include "glm/vec2.hpp"
+#include "glm/gtx/rotate_vector.hpp"
+#include "glm/gtx/norm.hpp"
 
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 #include "earcut.hpp/include/earcut.hpp"
 
+namespace mapbox { namespace util {
+template <>
+struct nth<0, Tangram::Point> {
+    inline static float get(const Tangram::Point &t) { return t.x; };
+};
+template <>
+struct nth<1, Tangram::Point> {
+    inline static float get(const Tangram::Point &t) { return t.y; };
+};
+}}
+
 namespace Tangram {
 
 enum class CapTypes {
@@ -25,7 +43,29 @@ enum class JoinTypes {
 
 JoinTypes JoinTypeFromString(const std::string& str);
 
-/* Callback function for PolygonBuilder:
+/* The builders are templates over their vertex sink, any callable with the
+ * signature below. A sink type that is known at compile time is inlined into
+ * the builder loops, a std::function sink (see the typedefs) is type-erased.
+ */
+
+/* Vertex sink that discards all vertices */
+struct NoVertexFn {
+    template<class... Args>
+    void operator()(const Args&...) {}
+};
+
+/* Default vertex sink of the builders: A no-op for sinks that can wrap one,
+ * such as the std::function sinks, which would be empty otherwise. Other
+ * sinks are value-initialized and set up before building. */
+template<class VertexFn>
+std::enable_if_t<std::is_constructible<VertexFn, NoVertexFn>::value, VertexFn>
+defaultVertexFn() { return VertexFn(NoVertexFn()); }
+
+template<class VertexFn>
+std::enable_if_t<!std::is_constructible<VertexFn, NoVertexFn>::value, VertexFn>
+defaultVertexFn() { return VertexFn(); }
+
+/* Vertex sink for PolygonBuilder:
  *
  * @coord  tesselated output coordinate
  * @normal triangle plane normal
@@ -36,18 +76,18 @@ typedef std::function<void(const glm::vec3& coord, const glm::vec3& normal, cons
 /* PolygonBuilder context,
  * see Builders::buildPolygon() and Builders::buildPolygonExtrusion()
  */
+template<class VertexFn = PolygonVertexFn>
 struct PolygonBuilder {
     std::vector<uint16_t> indices; // indices for drawing the polyon as triangles are added to this vector
     std::vector<int> used;
 
-    PolygonVertexFn addVertex;
+    VertexFn addVertex;
     size_t numVertices = 0;
     bool useTexCoords;
 
     mapbox::detail::Earcut<uint16_t> earcut;
 
-    PolygonBuilder(PolygonVertexFn _addVertex = [](auto&,auto&,auto&){},
-                   bool _useTexCoords = true)
+    PolygonBuilder(VertexFn _addVertex = defaultVertexFn<VertexFn>(), bool _useTexCoords = true)
         : addVertex(_addVertex), useTexCoords(_useTexCoords){}
 
     void clear() {
@@ -57,7 +97,7 @@ struct PolygonBuilder {
 };
 
 
-/* Callback function for PolyLineBuilder:
+/* Vertex sink for PolyLineBuilder:
  *
  * @coord   tesselated output coordinate
  * @enormal extrusion vector of the output coordinate
@@ -65,12 +105,34 @@ struct PolygonBuilder {
  */
 typedef std::function<void(const glm::vec3& coord, const glm::vec2& enormal, const glm::vec2& uv)> PolyLineVertexFn;
 
+/* Output of a PolyLineBuilder sink that stages its vertices for
+ * Builders::packPolyLineVertices() */
+struct PolyLineVertexData {
+    glm::vec2 coord;
+    glm::vec2 enormal;
+    glm::vec2 uv;
+};
+
+/* Layout of an interleaved vertex buffer for Builders::packPolyLineVertices():
+ * byte offsets of the int16 pairs in a vertex of _stride bytes */
+struct PolyLinePackFormat {
+    float positionScale;
+    float extrusionScale;
+    float texcoordScale;
+    size_t stride;
+    size_t position;
+    size_t extrusion;
+    bool hasTexcoord = false;
+    size_t texcoord = 0;
+};
+
 /* PolyLineBuilder context,
  * see Builders::buildPolyLine()
  */
+template<class VertexFn = PolyLineVertexFn>
 struct PolyLineBuilder {
     std::vector<uint16_t> indices; // indices for drawing the polyline as triangles are added to this vector
-    PolyLineVertexFn addVertex;
+    VertexFn addVertex;
     size_t numVertices = 0;
     float miterLimit = 3.f;
     CapTypes cap;
@@ -79,7 +141,11 @@ struct PolyLineBuilder {
     bool closedPolygon;
     bool useTexCoords = false;
 
-    PolyLineBuilder(PolyLineVertexFn _addVertex = [](auto&,auto&,auto&){},
+    // Per segment of the current line, see Builders::segmentNormals()
+    std::vector<glm::vec2> normals;
+    std::vector<float> miterScales;
+
+    PolyLineBuilder(VertexFn _addVertex = defaultVertexFn<VertexFn>(),
                     CapTypes _cap = CapTypes::butt,
                     JoinTypes _join = JoinTypes::bevel,
                     bool _kte = true, bool _closedPoly = false)
@@ -91,7 +157,7 @@ struct PolyLineBuilder {
     }
 };
 
-/* Callback function for SpriteBuilder
+/* Vertex sink for SpriteBuilder
  * @coord tesselated coordinates of the sprite quad in screen space
  * @screenPos the screen position
  * @uv texture coordinate of the ouptput coordinate
@@ -100,12 +166,13 @@ typedef std::function<void(const glm::vec2& coord, const glm::vec2& screenPos, c
 
 /* SpriteBuidler context
  */
+template<class VertexFn = SpriteBuilderFn>
 struct SpriteBuilder {
     std::vector<uint16_t> indices;
-    SpriteBuilderFn addVertex;
+    VertexFn addVertex;
     size_t numVerts = 0;
 
-    SpriteBuilder(SpriteBuilderFn _addVertex) : addVertex(_addVertex) {}
+    SpriteBuilder(VertexFn _addVertex) : addVertex(_addVertex) {}
 };
 
 class Builders {
@@ -116,21 +183,48 @@ public:
      * @_polygon input coordinates describing the polygon
      * @_ctx output vectors, see <PolygonBuilder>
      */
-    static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx);
+    template<class VertexFn>
+    static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder<VertexFn>& _ctx);
 
     /* Build extruded 'walls' from a polygon
      * @_polygon input coordinates describing the polygon
      * @_minHeight the extrusion will extend from this z coordinate to the z of the polygon points
      * @_ctx output vectors, see <PolygonBuilder>
      */
-    static void buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx);
+    template<class VertexFn>
+    static void buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder<VertexFn>& _ctx);
 
     /* Build a tesselated polygon line of fixed width from line coordinates
      * @_line input coordinates describing the line
      * @_options parameters for polyline construction
      * @_ctx output vectors, see <PolyLineBuilder>
      */
-    static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx);
+    template<class VertexFn>
+    static void buildPolyLine(const Line& _line, PolyLineBuilder<VertexFn>& _ctx);
+
+    /* Normalized perpendiculars of the segments from each point of _line to
+     * the next, wrapping around at the end: _normals[i] is the normal of the
+     * segment from _line[i] to _line[i+1].
+     *
+     * This function, miterScales() and packPolyLineVertices() are the batched
+     * parts of the polyline extrusion. They process four values at a time and
+     * give bit-identical results to the scalar expressions, see meshTests.
+     */
+    static void segmentNormals(const Line& _line, std::vector<glm::vec2>& _normals);
+
+    /* Miter scale factors of the joins between consecutive _normals:
+     * _scales[i] = 2 / dot(m, m) with m = _normals[i-1] + _normals[i], and
+     * _normals[n-1] preceding _normals[0]. Infinite when m is zero.
+     */
+    static void miterScales(const std::vector<glm::vec2>& _normals, std::vector<float>& _scales);
+
+    /* Writes _count staged polyline vertices into the interleaved vertex buffer
+     * at _out, as the int16 pairs round(coord * positionScale) and
+     * enormal * extrusionScale, and the uint16 pair uv * texcoordScale, each
+     * converted toward zero. Other vertex attributes are left unchanged.
+     */
+    static void packPolyLineVertices(const PolyLineVertexData* _vertices, size_t _count,
+                                     const PolyLinePackFormat& _format, char* _out);
 
     /* Build a tesselated quad centered on _screenOrigin
      * @_screenOrigin the sprite origin in screen space
@@ -139,8 +233,482 @@ public:
      * @_uvTR the top right UV coordinate of the quad
      * @_ctx output vectors, see <SpriteBuilder>
      */
-    static void buildQuadAtPoint(const glm::vec2& _screenOrigin, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder& _ctx);
+    template<class VertexFn>
+    static void buildQuadAtPoint(const glm::vec2& _screenOrigin, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder<VertexFn>& _ctx);
 
+private:
+
+    // Get 2D perpendicular of two points
+    static glm::vec2 perp2d(const glm::vec3& _v1, const glm::vec3& _v2) {
+        return glm::vec2(_v2.y - _v1.y, _v1.x - _v2.x);
+    }
+
+    // Adds indices for pairs of vertices arranged like a line strip
+    static void indexPairs(int _nPairs, int _nVertices, std::vector<uint16_t>& _indicesOut);
+
+    // Tests if a line segment (from point A to B) is outside the edge of a tile
+    static bool isOutsideTile(const glm::vec3& _a, const glm::vec3& _b);
+
+    template<class VertexFn>
+    static void addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv,
+                                  PolyLineBuilder<VertexFn>& _ctx);
+
+    template<class VertexFn>
+    static void addFan(const glm::vec3& _pC,
+                       const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
+                       const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
+                       int _numTriangles, PolyLineBuilder<VertexFn>& _ctx);
+
+    template<class VertexFn>
+    static void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning,
+                       PolyLineBuilder<VertexFn>& _ctx);
+
+    template<class VertexFn>
+    static void buildPolyLineSegment(const Line& _line, PolyLineBuilder<VertexFn>& _ctx, size_t _startIndex,
+                                     size_t _endIndex, bool endCap = true);
 };
 
+template<class VertexFn>
+void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder<VertexFn>& _ctx) {
+
+    glm::vec2 min, max;
+    if (_ctx.useTexCoords) {
+        min = glm::vec2(std::numeric_limits<float>::max());
+        max = glm::vec2(std::numeric_limits<float>::min());
+
+        for (auto& p : _polygon[0]) {
+            min.x = std::min(min.x, p.x);
+            min.y = std::min(min.y, p.y);
+            max.x = std::max(max.x, p.x);
+            max.y = std::max(max.y, p.y);
+        }
+    }
+
+    // Run earcut, triangles are stored in _ctx.earcut.indices
+    _ctx.earcut(_polygon);
+
+    size_t sumPoints = 0;
+    for (auto& line : _polygon) {
+        sumPoints += line.size();
+    }
+
+    // Mark the points that are referenced by indices as used.
+    size_t sumVertices = 0;
+    _ctx.used.assign(sumPoints, 0);
+    for (auto i : _ctx.earcut.indices) {
+        if (_ctx.used[i] == 0) {
+            _ctx.used[i] = 1;
+            sumVertices++;
+        }
+    }
+
+    uint16_t vertexDataOffset = _ctx.numVertices;
+    _ctx.numVertices += sumVertices;
+
+    size_t ring = 0;
+    size_t offset = 0;
+
+    // Go through all points of the polyon.
+    for (size_t src = 0, dst = 0; src < sumPoints; src++) {
+        // The points of the polygon rings are indexed linearly.
+        // This maps the indices back to the original ring and point.
+        if (src - offset >= _polygon[ring].size()) {
+            offset += _polygon[ring].size();
+            ring += 1;
+        }
+
+        // Add vertex only when the point is used.
+        if (_ctx.used[src] == 0) { continue; }
+
+        // Keep track of skipped points to update indices
+        _ctx.used[src] = dst++;
+
+        auto& p = _polygon[ring][src - offset];
+        glm::vec3 coord(p.x, p.y, _height);
+
+        if (_ctx.useTexCoords) {
+            glm::vec2 uv(mapValue(coord.x, min.x, max.x, 0., 1.),
+                         mapValue(coord.y, min.y, max.y, 1., 0.));
+
+            _ctx.addVertex(coord, glm::vec3(0.0, 0.0, 1.0), uv);
+        } else {
+            _ctx.addVertex(coord, glm::vec3(0.0, 0.0, 1.0), glm::vec2(0));
+        }
+    }
+
+    for (auto i : _ctx.earcut.indices) {
+        _ctx.indices.push_back(vertexDataOffset + _ctx.used[i]);
+    }
+}
+
+template<class VertexFn>
+void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder<VertexFn>& _ctx) {
+
+    auto vertexDataOffset = _ctx.numVertices;
+
+    static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
+    glm::vec3 normalVector;
+
+    for (auto& line : _polygon) {
+
+        size_t lineSize = line.size();
+
+        for (size_t i = 0; i < lineSize - 1; i++) {
+
+            glm::vec3 a(line[i]);
+            glm::vec3 b(line[i+1]);
+
+            normalVector = glm::cross(upVector, b - a);
+            normalVector = glm::normalize(normalVector);
+
+            if (std::isnan(normalVector.x)
+             || std::isnan(normalVector.y)
+             || std::isnan(normalVector.z)) {
+                continue;
+            }
+
+            // 1st vertex top
+            a.z = _maxHeight;
+            _ctx.addVertex(a, normalVector, glm::vec2(1.,1.));
+
+            // 2nd vertex top
+            b.z = _maxHeight;
+            _ctx.addVertex(b, normalVector, glm::vec2(0.,1.));
+
+            // 1st vertex bottom
+            a.z = _minHeight;
+            _ctx.addVertex(a, normalVector, glm::vec2(1.,0.));
+
+            // 2nd vertex bottom
+            b.z = _minHeight;
+            _ctx.addVertex(b, normalVector, glm::vec2(0.,0.));
+
+            // Start the index from the previous state of the vertex Data
+            _ctx.indices.push_back(vertexDataOffset);
+            _ctx.indices.push_back(vertexDataOffset + 1);
+            _ctx.indices.push_back(vertexDataOffset + 2);
+
+            _ctx.indices.push_back(vertexDataOffset + 1);
+            _ctx.indices.push_back(vertexDataOffset + 3);
+            _ctx.indices.push_back(vertexDataOffset + 2);
+
+            vertexDataOffset += 4;
+        }
+
+        _ctx.numVertices = vertexDataOffset;
+    }
+}
+
+inline void Builders::indexPairs(int _nPairs, int _nVertices, std::vector<uint16_t>& _indicesOut) {
+    for (int i = 0; i < _nPairs; i++) {
+        _indicesOut.push_back(_nVertices - 2*i - 4);
+        _indicesOut.push_back(_nVertices - 2*i - 2);
+        _indicesOut.push_back(_nVertices - 2*i - 3);
+
+        _indicesOut.push_back(_nVertices - 2*i - 3);
+        _indicesOut.push_back(_nVertices - 2*i - 2);
+        _indicesOut.push_back(_nVertices - 2*i - 1);
+    }
+}
+
+inline bool Builders::isOutsideTile(const glm::vec3& _a, const glm::vec3& _b) {
+
+    // tweak this adjust if catching too few/many line segments near tile edges
+    // TODO: make tolerance configurable by source if necessary
+    float tolerance = 0.0005;
+    float tile_min = 0.0 + tolerance;
+    float tile_max = 1.0 - tolerance;
+
+    if ( (_a.x < tile_min && _b.x < tile_min) ||
+         (_a.x > tile_max && _b.x > tile_max) ||
+         (_a.y < tile_min && _b.y < tile_min) ||
+         (_a.y > tile_max && _b.y > tile_max) ) {
+        return true;
+    }
+
+    return false;
+}
+
+// Helper function for polyline tesselation
+template<class VertexFn>
+inline void Builders::addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv,
+                                        PolyLineBuilder<VertexFn>& _ctx) {
+    _ctx.numVertices++;
+    _ctx.addVertex(_coord, _normal, _uv);
+}
+
+//  Tessalate a fan geometry between points A       B
+//  using their normals from a center        \ . . /
+//  and interpolating their UVs               \ p /
+//                                             \./
+//                                              C
+template<class VertexFn>
+void Builders::addFan(const glm::vec3& _pC,
+                      const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
+                      const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
+                      int _numTriangles, PolyLineBuilder<VertexFn>& _ctx) {
+
+    // Find angle difference
+    float cross = _nA.x * _nB.y - _nA.y * _nB.x; // z component of cross(_CA, _CB)
+    float angle = atan2f(cross, glm::dot(_nA, _nB));
+
+    int startIndex = _ctx.numVertices;
+
+    // Add center vertex
+    addPolyLineVertex(_pC, _nC, _uC, _ctx);
+
+    // Add vertex for point A
+    addPolyLineVertex(_pC, _nA, _uA, _ctx);
+
+    // Add radial vertices
+    glm::vec2 radial = _nA;
+    for (int i = 0; i < _numTriangles; i++) {
+        float frac = (i + 1)/(float)_numTriangles;
+        radial = glm::rotate(_nA, angle * frac);
+
+        glm::vec2 uv(0.0);
+        if (_ctx.useTexCoords) {
+            uv = (1.f - frac) * _uA + frac * _uB;
+        }
+
+        addPolyLineVertex(_pC, radial, uv, _ctx);
+
+        // Add indices
+        _ctx.indices.push_back(startIndex); // center vertex
+        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 1 : 2));
+        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 2 : 1));
+    }
+
+}
+
+// Function to add the vertices for line caps
+template<class VertexFn>
+void Builders::addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning,
+                      PolyLineBuilder<VertexFn>& _ctx) {
+
+    float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
+
+    if (_numCorners < 1) {
+        // "Butt" cap needs no extra vertices
+        return;
+    } else if (_numCorners == 2) {
+        // "Square" cap needs two extra vertices
+        glm::vec2 tangent(-_normal.y, _normal.x);
+        addPolyLineVertex(_coord, _normal + tangent, {0.f, v}, _ctx);
+        addPolyLineVertex(_coord, -_normal + tangent, {0.f, v}, _ctx);
+        if (!_isBeginning) { // At the beginning of a line we can't form triangles with previous vertices
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+        }
+        return;
+    }
+
+    // "Round" cap type needs a fan of vertices
+    glm::vec2 nA(_normal), nB(-_normal), nC(0.f, 0.f), uA(1.f, v), uB(0.f, v), uC(0.5f, v);
+    if (_isBeginning) {
+        nA *= -1.f; // To flip the direction of the fan, we negate the normal vectors
+        nB *= -1.f;
+        uA.x = 0.f; // To keep tex coords consistent, we must reverse these too
+        uB.x = 1.f;
+    }
+    addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
+}
+
+template<class VertexFn>
+void Builders::buildPolyLineSegment(const Line& _line, PolyLineBuilder<VertexFn>& _ctx, size_t _startIndex,
+                                    size_t _endIndex, bool endCap) {
+
+    float distance = 0; // Cumulative distance along the polyline.
+
+    size_t origLineSize = _line.size();
+
+    // endIndex/startIndex could be wrapped values, calculate lineSize accordingly
+    int lineSize = (int)((_endIndex > _startIndex) ?
+                   (_endIndex - _startIndex) :
+                   (origLineSize - _startIndex + _endIndex));
+    if (lineSize < 2) { return; }
+
+    glm::vec3 coordCurr(_line[_startIndex]);
+    // get the Point using wrapped index in the original line geometry
+    glm::vec3 coordNext(_line[(_startIndex + 1) % origLineSize]);
+    glm::vec2 normPrev, normNext, miterVec;
+
+    int cornersOnCap = (int)_ctx.cap;
+    int trianglesOnJoin = (int)_ctx.join;
+
+    // Process first point in line with an end cap
+    normNext = _ctx.normals[_startIndex];
+    size_t normIndex = _startIndex;
+
+    if (endCap) {
+        addCap(coordCurr, normNext, cornersOnCap, true, _ctx);
+    }
+    addPolyLineVertex(coordCurr, normNext, {1.0f, 0.0f}, _ctx); // right corner
+    addPolyLineVertex(coordCurr, -normNext, {0.0f, 0.0f}, _ctx); // left corner
+
+
+    // Process intermediate points
+    for (int i = 1; i < lineSize - 1; i++) {
+        // get the Point using wrapped index in the original line geometry
+        int nextIndex = (i + _startIndex + 1) % origLineSize;
+
+        distance += glm::distance(coordCurr, coordNext);
+
+        coordCurr = coordNext;
+        coordNext = _line[nextIndex];
+
+        if (coordCurr == coordNext) {
+            continue;
+        }
+
+        size_t currIndex = (i + _startIndex) % origLineSize;
+        bool adjacent = (normIndex + 1) % origLineSize == currIndex;
+        normIndex = currIndex;
+
+        normPrev = normNext;
+        normNext = _ctx.normals[currIndex];
+
+        // Compute "normal" for miter joint
+        miterVec = normPrev + normNext;
+
+        float scale = 1.f;
+
+        // normPrev and normNext are in the opposite direction
+        // in order to prevent NaN values, we use the perp
+        // vector of those two vectors
+        if (miterVec == glm::zero<glm::vec2>()) {
+            miterVec = perp2d(glm::vec3(normNext, 0.f), glm::vec3(normPrev, 0.f));
+        } else if (adjacent) {
+            scale = _ctx.miterScales[currIndex];
+        } else {
+            // Duplicate points were skipped
+            scale = 2.f / glm::dot(miterVec, miterVec);
+        }
+
+        miterVec *= scale;
+
+        if (glm::length2(miterVec) > glm::length2(_ctx.miterLimit)) {
+            trianglesOnJoin = 1;
+            miterVec *= _ctx.miterLimit / glm::length(miterVec);
+        }
+
+        float v = distance;
+
+        if (trianglesOnJoin == 0) {
+            // Join type is a simple miter
+
+            addPolyLineVertex(coordCurr, miterVec, {1.0, v}, _ctx); // right corner
+            addPolyLineVertex(coordCurr, -miterVec, {0.0, v}, _ctx); // left corner
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+        } else {
+
+            // Join type is a fan of triangles
+
+            bool isRightTurn = (normNext.x * normPrev.y - normNext.y * normPrev.x) > 0; // z component of cross(normNext, normPrev)
+
+            if (isRightTurn) {
+
+                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
+                addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx); // left (outer) corner
+                indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+                addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
+
+                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
+                addPolyLineVertex(coordCurr, -normNext, {0.0f, v}, _ctx); // left (outer) corner
+
+            } else {
+
+                addPolyLineVertex(coordCurr, normPrev, {1.0f, v}, _ctx); // right (outer) corner
+                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
+                indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+                addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
+
+                addPolyLineVertex(coordCurr, normNext, {1.0f, v}, _ctx); // right (outer) corner
+                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
+            }
+        }
+    }
+
+    distance += glm::distance(coordCurr, coordNext);
+
+    // Process last point in line with a cap
+    addPolyLineVertex(coordNext, normNext, {1.f, distance}, _ctx); // right corner
+    addPolyLineVertex(coordNext, -normNext, {0.f, distance}, _ctx); // left corner
+    indexPairs(1, _ctx.numVertices, _ctx.indices);
+    if (endCap) {
+        addCap(coordNext, normNext, cornersOnCap, false, _ctx);
+    }
+
+}
+
+template<class VertexFn>
+void Builders::buildPolyLine(const Line& _line, PolyLineBuilder<VertexFn>& _ctx) {
+
+    size_t lineSize = _line.size();
+
+    segmentNormals(_line, _ctx.normals);
+    miterScales(_ctx.normals, _ctx.miterScales);
+
+    if (_ctx.keepTileEdges) {
+
+        buildPolyLineSegment(_line, _ctx, 0, lineSize);
+
+    } else {
+
+        int cut = 0;
+        int firstCutEnd = 0;
+
+        // Determine cuts
+        for (size_t i = 0; i < lineSize - 1; i++) {
+            const glm::vec3& coordCurr = _line[i];
+            const glm::vec3& coordNext = _line[i+1];
+            if (isOutsideTile(coordCurr, coordNext)) {
+                if (cut == 0) {
+                    firstCutEnd = i + 1;
+                }
+                buildPolyLineSegment(_line, _ctx, cut, i + 1);
+                cut = i + 1;
+            }
+        }
+
+        if (_ctx.closedPolygon) {
+            if (cut == 0) {
+                // no tile edge cuts!
+                // loop and close the polygon with no endcaps
+                buildPolyLineSegment(_line, _ctx, 0, lineSize+2, false);
+            } else {
+                // merge first and last cut line-segments together
+                buildPolyLineSegment(_line, _ctx, cut, firstCutEnd);
+            }
+        } else {
+            buildPolyLineSegment(_line, _ctx, cut, lineSize);
+        }
+
+    }
+
+}
+
+template<class VertexFn>
+void Builders::buildQuadAtPoint(const glm::vec2& _screenPosition, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder<VertexFn>& _ctx) {
+    float halfWidth = _size.x * .5f;
+    float halfHeight = _size.y * .5f;
+
+    _ctx.addVertex(glm::vec2(-halfWidth, -halfHeight), _screenPosition, {_uvBL.x, _uvBL.y});
+    _ctx.addVertex(glm::vec2(-halfWidth, halfHeight), _screenPosition, {_uvBL.x, _uvTR.y});
+    _ctx.addVertex(glm::vec2(halfWidth, -halfHeight), _screenPosition, {_uvTR.x, _uvBL.y});
+    _ctx.addVertex(glm::vec2(halfWidth, halfHeight), _screenPosition, {_uvTR.x, _uvTR.y});
+
+    _ctx.indices.push_back(_ctx.numVerts + 2);
+    _ctx.indices.push_back(_ctx.numVerts + 0);
+    _ctx.indices.push_back(_ctx.numVerts + 1);
+    _ctx.indices.push_back(_ctx.numVerts + 1);
+    _ctx.indices.push_back(_ctx.numVerts + 3);
+    _ctx.indices.push_back(_ctx.numVerts + 2);
+
+    _ctx.numVerts += 4;
+
+}
+
 }
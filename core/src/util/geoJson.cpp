@@ -51,19 +51,27 @@ Polygon GeoJson::getPolygon(const JsonValue& _in, const Transform& _proj) {
 
 }
 
-Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
+Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId,
+                                  Properties::KeyCache& _keys) {
 
     std::vector<PropertyItem> items;
     items.reserve(_in.MemberCount());
 
+    // Members whose key has no id, set once the items are sorted
+    std::vector<JsonValue::ConstMemberIterator> unindexed;
+
     for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
 
-        const auto& name = it->name.GetString();
         const auto& value = it->value;
-        if (value.IsNumber()) {
-            items.emplace_back(name, value.GetDouble());
-        } else if (it->value.IsString()) {
-            items.emplace_back(name, value.GetString());
+        if (!value.IsNumber() && !value.IsString()) { continue; }
+
+        uint32_t keyId = _keys.keyId(it->name.GetString());
+        if (keyId == Properties::NO_KEY_ID) {
+            unindexed.push_back(it);
+        } else if (value.IsNumber()) {
+            items.emplace_back(keyId, value.GetDouble());
+        } else {
+            items.emplace_back(keyId, value.GetString());
         }
 
     }
@@ -73,18 +81,27 @@ Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
     properties.setSorted(std::move(items));
     properties.sort();
 
+    for (auto& it : unindexed) {
+        if (it->value.IsNumber()) {
+            properties.set(it->name.GetString(), it->value.GetDouble());
+        } else {
+            properties.set(it->name.GetString(), it->value.GetString());
+        }
+    }
+
     return properties;
 
 }
 
-Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId) {
+Feature GeoJson::getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId,
+                            Properties::KeyCache& _keys) {
 
     Feature feature;
 
     // Copy properties into tile data
     auto properties = _in.FindMember("properties");
     if (properties != _in.MemberEnd()) {
-        feature.props = getProperties(properties->value, _sourceId);
+        feature.props = getProperties(properties->value, _sourceId, _keys);
     }
 
     // Copy geometry into tile data
@@ -145,8 +162,10 @@ Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _s
         return layer;
     }
 
+    Properties::KeyCache keys;
+
     for (auto featureIt = features->value.Begin(); featureIt != features->value.End(); ++featureIt) {
-        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId));
+        layer.features.push_back(getFeature(*featureIt, _proj, _sourceId, keys));
     }
 
     return layer;
@@ -19,9 +19,10 @@ Line getLine(const JsonValue& _in, const Transform& _proj);
 
 Polygon getPolygon(const JsonValue& _in, const Transform& _proj);
 
-Properties getProperties(const JsonValue& _in, int32_t _sourceId);
+Properties getProperties(const JsonValue& _in, int32_t _sourceId, Properties::KeyCache& _keys);
 
-Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
+Feature getFeature(const JsonValue& _in, const Transform& _proj, int32_t _sourceId,
+                   Properties::KeyCache& _keys);
 
 Layer getLayer(const JsonValue& _in, const Transform& _proj, int32_t _sourceId);
 
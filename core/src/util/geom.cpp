@@ -101,27 +101,6 @@ glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosit
     return clipToScreenSpace(clipCoords, _screenSize);
 }
 
-glm::vec2 centroid(const std::vector<std::vector<glm::vec3>>& _polygon) {
-    glm::vec2 centroid;
-    int n = 0;
-
-    for (auto& l : _polygon) {
-        for (auto& p : l) {
-            centroid.x += p.x;
-            centroid.y += p.y;
-            n++;
-        }
-    }
-
-    if (n == 0) {
-        return centroid;
-    }
-
-    centroid /= n;
-
-    return centroid;
-}
-
 // square distance from a point <_p> to a segment <_p1,_p2>
 // http://stackoverflow.com/questions/849211/shortest-distance-between-a-point-and-a-line-segment
 //
@@ -107,7 +107,27 @@ glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosit
 glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosition, const glm::vec2& _screenSize, bool& _clipped);
 
 /* Computes the geometric center of the two dimentionnal region defined by the polygon */
-glm::vec2 centroid(const std::vector<std::vector<glm::vec3>>& _polygon);
+template<class Polygon>
+glm::vec2 centroid(const Polygon& _polygon) {
+    glm::vec2 centroid;
+    int n = 0;
+
+    for (auto& l : _polygon) {
+        for (auto& p : l) {
+            centroid.x += p.x;
+            centroid.y += p.y;
+            n++;
+        }
+    }
+
+    if (n == 0) {
+        return centroid;
+    }
+
+    centroid /= n;
+
+    return centroid;
+}
 
 inline glm::vec2 rotateBy(const glm::vec2& _in, const glm::vec2& _normal) {
     return {
@@ -27,14 +27,17 @@ namespace Tangram {
 
 InputHandler::InputHandler(View& _view) : m_view(_view) {}
 
-void InputHandler::update(float _dt) {
+bool InputHandler::isFlinging() const {
 
     auto velocityPanPixels = m_view.pixelsPerMeter() / m_view.pixelScale() * m_velocityPan;
 
-    bool isFlinging = glm::length(velocityPanPixels) > THRESHOLD_STOP_PAN ||
-                      std::abs(m_velocityZoom) > THRESHOLD_STOP_ZOOM;
+    return glm::length(velocityPanPixels) > THRESHOLD_STOP_PAN ||
+           std::abs(m_velocityZoom) > THRESHOLD_STOP_ZOOM;
+}
 
-    if (isFlinging) {
+void InputHandler::update(float _dt) {
+
+    if (isFlinging()) {
 
         m_velocityPan -= _dt * DAMPING_PAN * m_velocityPan;
         m_view.translate(_dt * m_velocityPan.x, _dt * m_velocityPan.y);
@@ -46,6 +49,18 @@ void InputHandler::update(float _dt) {
     }
 }
 
+bool InputHandler::predictFling(float _seconds, glm::vec2& _translation, float& _zoom) const {
+
+    if (!isFlinging()) { return false; }
+
+    // The velocities decay exponentially, v(t) = v * exp(-damping * t),
+    // integrate them over the next _seconds
+    _translation = m_velocityPan * (1.f - std::exp(-DAMPING_PAN * _seconds)) / DAMPING_PAN;
+    _zoom = m_velocityZoom * (1.f - std::exp(-DAMPING_ZOOM * _seconds)) / DAMPING_ZOOM;
+
+    return true;
+}
+
 void InputHandler::handleTapGesture(float _posX, float _posY) {
 
     onGesture();
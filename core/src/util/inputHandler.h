@@ -23,6 +23,10 @@ public:
 
     void cancelFling();
 
+    /* Translation (in projection units) and zoom change that the current
+     * fling adds within the next _seconds, returns false when not flinging */
+    bool predictFling(float _seconds, glm::vec2& _translation, float& _zoom) const;
+
     void setView(View& _view) { m_view = _view; }
 
 private:
@@ -31,6 +35,8 @@ private:
 
     void onGesture();
 
+    bool isFlinging() const;
+
     View& m_view;
 
     // fling deltas on zoom and translation
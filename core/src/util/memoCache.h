@@ -0,0 +1,56 @@
+#pragma once
+
+#include "util/hash.h"
+#include "util/variant.h"
+
+#include <cstdint>
+
+namespace Tangram {
+
+/* Helpers of the memo caches of StyleContext (JS function results) and
+ * DrawRuleMergeSet (matched layer rules). Both key their results by a hash
+ * of the Values the function or filter reads. */
+
+/* Combines the type and the value of _value into _seed */
+inline void hashValue(size_t& _seed, const Value& _value) {
+    if (_value.is<double>()) {
+        hash_combine(_seed, 1);
+        hash_combine(_seed, _value.get<double>());
+    } else if (_value.is<std::string>()) {
+        hash_combine(_seed, 2);
+        hash_combine(_seed, _value.get<std::string>());
+    } else {
+        hash_combine(_seed, 0);
+    }
+}
+
+/* Counts the hits of a memo cache over a window of lookups. Memoising does
+ * not pay off when less than 1/8 of them hit, e.g. when features rarely
+ * share the values that are read, like 'name' or 'id'. */
+struct MemoWindow {
+    static const uint32_t SIZE = 256;
+
+    uint32_t lookups = 0;
+    uint32_t hits = 0;
+
+    /* Counts a lookup, returns false when the last window had too few hits */
+    bool lookup() {
+        if (lookups == SIZE) {
+            if (hits < SIZE / 8) { return false; }
+            lookups = 0;
+            hits = 0;
+        }
+        lookups++;
+        return true;
+    }
+
+    void hit() { hits++; }
+};
+
+/* Clears _results when it holds _maxResults, before adding another one */
+template<typename Map>
+inline void limitMemoResults(Map& _results, size_t _maxResults) {
+    if (_results.size() >= _maxResults) { _results.clear(); }
+}
+
+}
@@ -84,13 +84,12 @@ PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::messag
     return geometry;
 }
 
-Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
-
-    Feature feature(_ctx.sourceId);
+bool PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn, Feature& feature) {
 
     _ctx.featureTags.clear();
     _ctx.featureTags.assign(_ctx.keys.size(), -1);
 
+    protobuf::message geometryMsg;
 
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
@@ -107,19 +106,19 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
 
                     if(_ctx.keys.size() <= tagKey) {
                         LOGE("accessing out of bound key");
-                        return feature;
+                        return true;
                     }
 
                     if(!tagsMsg) {
                         LOGE("uneven number of feature tag ids");
-                        return feature;
+                        return true;
                     }
 
                     auto valueKey = tagsMsg.varint();
 
                     if( _ctx.values.size() <= valueKey ) {
                         LOGE("accessing out of bound values");
-                        return feature;
+                        return true;
                     }
 
                     _ctx.featureTags[tagKey] = valueKey;
@@ -129,9 +128,9 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
             case FEATURE_TYPE:
                 feature.geometryType = (GeometryType)_featureIn.varint();
                 break;
-            // Actual geometry data
+            // Actual geometry data - decoded once the feature is selected
             case FEATURE_GEOM:
-                _ctx.geometry = getGeometry(_ctx, _featureIn.getMessage());
+                geometryMsg = _featureIn.getMessage();
                 break;
 
             default:
@@ -143,14 +142,35 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
     std::vector<Properties::Item> properties;
     properties.reserve(_ctx.featureTags.size());
 
-    for (int tagKey : _ctx.orderedKeys) {
-        int tagValue = _ctx.featureTags[tagKey];
+    // Keys without id are ordered last
+    auto tagKey = _ctx.orderedKeys.begin();
+    for (; tagKey != _ctx.orderedKeys.end() && _ctx.keyIds[*tagKey] != Properties::NO_KEY_ID; ++tagKey) {
+        int tagValue = _ctx.featureTags[*tagKey];
         if (tagValue >= 0) {
-            properties.emplace_back(_ctx.keys[tagKey], _ctx.values[tagValue]);
+            properties.emplace_back(_ctx.keyIds[*tagKey], _ctx.values[tagValue]);
         }
     }
     feature.props.setSorted(std::move(properties));
 
+    for (; tagKey != _ctx.orderedKeys.end(); ++tagKey) {
+        int tagValue = _ctx.featureTags[*tagKey];
+        if (tagValue >= 0) {
+            feature.props.setValue(_ctx.keys[*tagKey], _ctx.values[tagValue]);
+        }
+    }
+
+    size_t geometryBytes = geometryMsg.getEnd() - geometryMsg.getData();
+
+    if (_ctx.selection) {
+        if (!_ctx.selection->selectFeature(*_ctx.layerName, feature)) {
+            _ctx.selection->bytesSkipped += geometryBytes;
+            return false;
+        }
+        _ctx.selection->bytesDecoded += geometryBytes;
+    }
+
+    _ctx.geometry = getGeometry(_ctx, geometryMsg);
+
     switch(feature.geometryType) {
         case GeometryType::points:
             feature.points.insert(feature.points.begin(),
@@ -161,6 +181,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
         case GeometryType::lines:
         {
             auto pos = _ctx.geometry.coordinates.begin();
+            feature.lines.reserve(_ctx.geometry.sizes.size());
             for (int length : _ctx.geometry.sizes) {
                 if (length == 0) { continue; }
                 Line line;
@@ -175,6 +196,9 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
         {
             auto pos = _ctx.geometry.coordinates.begin();
             auto rpos = _ctx.geometry.coordinates.rend();
+            // Each ring may start a polygon, reserve the upper bound
+            // instead of growing through the Arena free lists.
+            feature.polygons.reserve(_ctx.geometry.sizes.size());
             for (int length : _ctx.geometry.sizes) {
                 if (length == 0) { continue; }
                 float area = signedArea(pos, pos + length);
@@ -211,7 +235,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
             break;
     }
 
-    return feature;
+    return true;
 }
 
 Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
@@ -297,27 +321,49 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
     //// Assign ordering to keys for faster sorting
     _ctx.orderedKeys.clear();
     _ctx.orderedKeys.reserve(_ctx.keys.size());
+    _ctx.keyIds.clear();
+    _ctx.keyIds.reserve(_ctx.keys.size());
     // assign key ids
     for (int i = 0, n = _ctx.keys.size(); i < n; i++) {
         _ctx.orderedKeys.push_back(i);
+        _ctx.keyIds.push_back(Properties::dataKeyId(_ctx.keys[i]));
     }
     // sort by Property key ordering
     std::sort(_ctx.orderedKeys.begin(), _ctx.orderedKeys.end(),
               [&](int a, int b) {
-                  return Properties::keyComparator(_ctx.keys[a], _ctx.keys[b]);
+                  return _ctx.keyIds[a] < _ctx.keyIds[b];
               });
 
+    _ctx.layerName = &layer.name;
+
     layer.features.reserve(numFeatures);
     for (auto& featureItr : _ctx.featureMsgs) {
         do {
             auto featureMsg = featureItr.getMessage();
 
-            layer.features.push_back(getFeature(_ctx, featureMsg));
+            layer.features.emplace_back(_ctx.sourceId);
+
+            if (!getFeature(_ctx, featureMsg, layer.features.back())) {
+                layer.features.pop_back();
+            }
 
         } while (featureItr.next() && featureItr.tag == LAYER_FEATURE);
     }
 
+    _ctx.layerName = nullptr;
+
     return layer;
 }
 
+std::string PbfParser::getLayerName(protobuf::message _layerIn) {
+
+    while(_layerIn.next()) {
+        if (_layerIn.tag == LAYER_NAME) {
+            return _layerIn.string();
+        }
+        _layerIn.skip();
+    }
+    return "";
+}
+
 }
@@ -23,6 +23,8 @@ namespace PbfParser {
 
         int32_t sourceId;
         std::vector<std::string> keys;
+        // Interned ids of 'keys', see Properties::keyId
+        std::vector<uint32_t> keyIds;
         std::vector<Value> values;
         std::vector<protobuf::message> featureMsgs;
         Geometry geometry;
@@ -33,14 +35,23 @@ namespace PbfParser {
 
         int tileExtent = 0;
         int winding = 0;
+
+        // Optional: Skip features that are not used by the scene
+        TileDataSelection* selection = nullptr;
+        const std::string* layerName = nullptr;
     };
 
     Geometry getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
 
-    Feature getFeature(ParserContext& _ctx, protobuf::message _featureIn);
+    /* Decodes the feature message into @_feature. Returns false when the
+     * feature was not selected, its geometry is not decoded in that case. */
+    bool getFeature(ParserContext& _ctx, protobuf::message _featureIn, Feature& _feature);
 
     Layer getLayer(ParserContext& _ctx, protobuf::message _layerIn);
 
+    /* Reads only the name field of a layer message */
+    std::string getLayerName(protobuf::message _layerIn);
+
     enum pbfGeomCmd {
         moveTo = 1,
         lineTo = 2,
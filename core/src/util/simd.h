@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TANGRAM_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// ARMv7 NEON lacks vector sqrt, division and rounding, it uses the scalar fallback
+#define TANGRAM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Tangram {
+namespace simd {
+
+/* Minimal portable 4-wide vectors for batched geometry
+ * kernels: SSE2, AArch64 NEON or a scalar fallback.
+ *
+ * All float operations are IEEE-exact per lane (no reciprocal estimates,
+ * no fused multiply-add), so a kernel gives bit-identical results to the
+ * same sequence of scalar float operations. Conversions to integers match
+ * the scalar casts for values in range of the target type.
+ */
+
+#if defined(TANGRAM_SIMD_SSE2)
+
+struct float4 { __m128 v; };
+struct int4 { __m128i v; };
+
+inline void store(float* _p, float4 _a) { _mm_storeu_ps(_p, _a.v); }
+inline float4 load(const float* _p) { return { _mm_loadu_ps(_p) }; }
+
+inline float4 set(float _a, float _b, float _c, float _d) { return { _mm_setr_ps(_a, _b, _c, _d) }; }
+inline float4 splat(float _a) { return { _mm_set1_ps(_a) }; }
+
+inline float4 operator+(float4 _a, float4 _b) { return { _mm_add_ps(_a.v, _b.v) }; }
+inline float4 operator-(float4 _a, float4 _b) { return { _mm_sub_ps(_a.v, _b.v) }; }
+inline float4 operator*(float4 _a, float4 _b) { return { _mm_mul_ps(_a.v, _b.v) }; }
+inline float4 operator/(float4 _a, float4 _b) { return { _mm_div_ps(_a.v, _b.v) }; }
+
+inline float4 sqrt(float4 _a) { return { _mm_sqrt_ps(_a.v) }; }
+
+// Lanes 0 and 1 of _a, lanes 2 and 3 of _b
+inline float4 lowHigh(float4 _a, float4 _b) {
+    return { _mm_shuffle_ps(_a.v, _b.v, _MM_SHUFFLE(3, 2, 1, 0)) };
+}
+
+// Like std::round: halfway cases away from zero
+inline float4 round(float4 _a) {
+    const __m128 signMask = _mm_set1_ps(-0.f);
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(_a.v));
+    __m128 fraction = _mm_andnot_ps(signMask, _mm_sub_ps(_a.v, truncated));
+    __m128 step = _mm_or_ps(_mm_set1_ps(1.f), _mm_and_ps(signMask, _a.v));
+    __m128 up = _mm_cmpge_ps(fraction, _mm_set1_ps(0.5f));
+    return { _mm_add_ps(truncated, _mm_and_ps(up, step)) };
+}
+
+// Conversion toward zero, as static_cast<int16_t> and static_cast<uint16_t>
+inline int4 truncate(float4 _a) { return { _mm_cvttps_epi32(_a.v) }; }
+inline int4 truncateUnsigned(float4 _a) { return { _mm_cvttps_epi32(_a.v) }; }
+
+// Stores the low 16 bits of each lane
+inline void store16(int16_t* _p, int4 _a) {
+    __m128i v = _mm_shufflelo_epi16(_a.v, _MM_SHUFFLE(3, 3, 2, 0));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 2, 0));
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 2, 0));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(_p), v);
+}
+
+#elif defined(TANGRAM_SIMD_NEON)
+
+struct float4 { float32x4_t v; };
+struct int4 { int32x4_t v; };
+
+inline void store(float* _p, float4 _a) { vst1q_f32(_p, _a.v); }
+inline float4 load(const float* _p) { return { vld1q_f32(_p) }; }
+
+inline float4 set(float _a, float _b, float _c, float _d) {
+    float v[4] = { _a, _b, _c, _d };
+    return { vld1q_f32(v) };
+}
+inline float4 splat(float _a) { return { vdupq_n_f32(_a) }; }
+
+inline float4 operator+(float4 _a, float4 _b) { return { vaddq_f32(_a.v, _b.v) }; }
+inline float4 operator-(float4 _a, float4 _b) { return { vsubq_f32(_a.v, _b.v) }; }
+inline float4 operator*(float4 _a, float4 _b) { return { vmulq_f32(_a.v, _b.v) }; }
+inline float4 operator/(float4 _a, float4 _b) { return { vdivq_f32(_a.v, _b.v) }; }
+
+inline float4 sqrt(float4 _a) { return { vsqrtq_f32(_a.v) }; }
+
+inline float4 lowHigh(float4 _a, float4 _b) {
+    return { vcombine_f32(vget_low_f32(_a.v), vget_high_f32(_b.v)) };
+}
+
+inline float4 round(float4 _a) { return { vrndaq_f32(_a.v) }; }
+
+inline int4 truncate(float4 _a) { return { vcvtq_s32_f32(_a.v) }; }
+inline int4 truncateUnsigned(float4 _a) { return { vreinterpretq_s32_u32(vcvtq_u32_f32(_a.v)) }; }
+
+inline void store16(int16_t* _p, int4 _a) { vst1_s16(_p, vmovn_s32(_a.v)); }
+
+#else
+
+struct float4 { float v[4]; };
+
+// Keeps the floats, so that the conversions are the scalar casts
+struct int4 { float v[4]; bool isUnsigned; };
+
+inline void store(float* _p, float4 _a) { for (int i = 0; i < 4; i++) { _p[i] = _a.v[i]; } }
+inline float4 load(const float* _p) { return { { _p[0], _p[1], _p[2], _p[3] } }; }
+
+inline float4 set(float _a, float _b, float _c, float _d) { return { { _a, _b, _c, _d } }; }
+inline float4 splat(float _a) { return { { _a, _a, _a, _a } }; }
+
+#define TANGRAM_SIMD_OP(op) \
+    inline float4 operator op(float4 _a, float4 _b) { \
+        return { { _a.v[0] op _b.v[0], _a.v[1] op _b.v[1], _a.v[2] op _b.v[2], _a.v[3] op _b.v[3] } }; \
+    }
+TANGRAM_SIMD_OP(+)
+TANGRAM_SIMD_OP(-)
+TANGRAM_SIMD_OP(*)
+TANGRAM_SIMD_OP(/)
+#undef TANGRAM_SIMD_OP
+
+inline float4 sqrt(float4 _a) {
+    return { { std::sqrt(_a.v[0]), std::sqrt(_a.v[1]), std::sqrt(_a.v[2]), std::sqrt(_a.v[3]) } };
+}
+
+inline float4 lowHigh(float4 _a, float4 _b) { return { { _a.v[0], _a.v[1], _b.v[2], _b.v[3] } }; }
+
+inline float4 round(float4 _a) {
+    return { { std::round(_a.v[0]), std::round(_a.v[1]), std::round(_a.v[2]), std::round(_a.v[3]) } };
+}
+
+inline int4 truncate(float4 _a) { return { { _a.v[0], _a.v[1], _a.v[2], _a.v[3] }, false }; }
+inline int4 truncateUnsigned(float4 _a) { return { { _a.v[0], _a.v[1], _a.v[2], _a.v[3] }, true }; }
+
+inline void store16(int16_t* _p, int4 _a) {
+    for (int i = 0; i < 4; i++) {
+        _p[i] = _a.isUnsigned ? int16_t(static_cast<uint16_t>(_a.v[i])) : static_cast<int16_t>(_a.v[i]);
+    }
+}
+
+#endif
+
+}
+}
@@ -0,0 +1,146 @@
+#include "util/simplify.h"
+
+#include "glm/vec2.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace Tangram {
+
+// Squared distance of points to the segment _a, _b
+struct SegmentDistance {
+
+    SegmentDistance(const Point& _a, const Point& _b)
+        : a(_a), b(_b), d(_b.x - _a.x, _b.y - _a.y) {
+        float length2 = d.x * d.x + d.y * d.y;
+        invLength2 = length2 > 0 ? 1.f / length2 : 0.f;
+    }
+
+    float operator()(const Point& _p) const {
+        glm::vec2 p(_p.x - a.x, _p.y - a.y);
+        float t = (p.x * d.x + p.y * d.y) * invLength2;
+
+        if (t > 1) {
+            p = glm::vec2(_p.x - b.x, _p.y - b.y);
+        } else if (t > 0) {
+            p -= d * t;
+        }
+        return p.x * p.x + p.y * p.y;
+    }
+
+    const Point& a;
+    const Point& b;
+    glm::vec2 d;
+    float invLength2;
+};
+
+// Marks the points of _line in (_first, _last) that are kept
+static void douglasPeucker(const Line& _line, size_t _first, size_t _last, float _sqTolerance,
+                           std::vector<bool>& _keep) {
+
+    // Iterative to not depend on the stack size for long lines
+    static thread_local std::vector<std::pair<size_t, size_t>> stack;
+    stack.clear();
+    stack.emplace_back(_first, _last);
+
+    while (!stack.empty()) {
+        size_t first = stack.back().first;
+        size_t last = stack.back().second;
+        stack.pop_back();
+
+        SegmentDistance segment(_line[first], _line[last]);
+        float maxDistance = _sqTolerance;
+        size_t index = 0;
+
+        for (size_t i = first + 1; i < last; i++) {
+            float distance = segment(_line[i]);
+            if (distance > maxDistance) {
+                index = i;
+                maxDistance = distance;
+            }
+        }
+
+        if (index != 0) {
+            _keep[index] = true;
+            if (index - first > 1) { stack.emplace_back(first, index); }
+            if (last - index > 1) { stack.emplace_back(index, last); }
+        }
+    }
+}
+
+// Removes the points of _line that are not marked in _keep
+static size_t compact(Line& _line, const std::vector<bool>& _keep) {
+
+    size_t n = 0;
+    for (size_t i = 0; i < _line.size(); i++) {
+        if (_keep[i]) { _line[n++] = _line[i]; }
+    }
+
+    size_t removed = _line.size() - n;
+    _line.erase(_line.begin() + n, _line.end());
+    return removed;
+}
+
+size_t simplifyLine(Line& _line, float _tolerance) {
+
+    if (_line.size() < 3 || _tolerance <= 0) { return 0; }
+
+    static thread_local std::vector<bool> keep;
+    keep.assign(_line.size(), false);
+    keep.front() = keep.back() = true;
+
+    douglasPeucker(_line, 0, _line.size() - 1, _tolerance * _tolerance, keep);
+
+    return compact(_line, keep);
+}
+
+static size_t simplifyRing(Line& _ring, float _tolerance) {
+
+    size_t last = _ring.size() - 1;
+    bool closed = _ring[0].x == _ring[last].x && _ring[0].y == _ring[last].y;
+    size_t minPoints = closed ? 4 : 3;
+
+    if (_ring.size() <= minPoints) { return 0; }
+
+    // The end points of a closed ring coincide: split it at the point
+    // farthest from the start and simplify both halves
+    size_t split = 0;
+    float maxDistance = -1;
+    for (size_t i = 1; i < last; i++) {
+        float dx = _ring[i].x - _ring[0].x;
+        float dy = _ring[i].y - _ring[0].y;
+        float distance = dx * dx + dy * dy;
+        if (distance > maxDistance) {
+            split = i;
+            maxDistance = distance;
+        }
+    }
+
+    static thread_local std::vector<bool> keep;
+    keep.assign(_ring.size(), false);
+    keep[0] = keep[split] = keep[last] = true;
+
+    float sqTolerance = _tolerance * _tolerance;
+    douglasPeucker(_ring, 0, split, sqTolerance, keep);
+    douglasPeucker(_ring, split, last, sqTolerance, keep);
+
+    size_t kept = 0;
+    for (bool k : keep) { kept += k; }
+
+    if (kept < minPoints) { return 0; }
+
+    return compact(_ring, keep);
+}
+
+size_t simplifyPolygon(Polygon& _polygon, float _tolerance) {
+
+    if (_tolerance <= 0) { return 0; }
+
+    size_t removed = 0;
+    for (auto& ring : _polygon) {
+        removed += simplifyRing(ring, _tolerance);
+    }
+    return removed;
+}
+
+}
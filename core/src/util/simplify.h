@@ -0,0 +1,20 @@
+#pragma once
+
+#include "data/tileData.h"
+
+namespace Tangram {
+
+/* Douglas-Peucker simplification of tile geometry, in place
+ *
+ * Points are removed when they are closer than _tolerance (in tile units) to
+ * the simplified line, only x and y are considered. The end points of lines
+ * are kept. Rings of polygons keep at least three distinct points, rings that
+ * would collapse are left unchanged.
+ *
+ * Return the number of removed points.
+ */
+size_t simplifyLine(Line& _line, float _tolerance);
+
+size_t simplifyPolygon(Polygon& _polygon, float _tolerance);
+
+}
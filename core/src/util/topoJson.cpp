@@ -147,7 +147,8 @@ Polygon getPolygon(const JsonValue& _arcSets, const Topology& _topology) {
 
 }
 
-Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source) {
+Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _source,
+                   Properties::KeyCache& _keys) {
 
     static const JsonValue keyProperties("properties");
     static const JsonValue keyType("type");
@@ -158,7 +159,7 @@ Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_
 
     auto propertiesIt = _geometry.FindMember(keyProperties);
     if (propertiesIt != _geometry.MemberEnd() && propertiesIt->value.IsObject()) {
-        feature.props = GeoJson::getProperties(propertiesIt->value, _source);
+        feature.props = GeoJson::getProperties(propertiesIt->value, _source, _keys);
     }
 
     std::string type;
@@ -231,8 +232,9 @@ Layer getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology,
     if (type != object.MemberEnd() && strcmp("GeometryCollection", type->value.GetString()) == 0) {
         auto geometries = object.FindMember("geometries");
         if (geometries != object.MemberEnd() && geometries->value.IsArray()) {
+            Properties::KeyCache keys;
             for (auto it = geometries->value.Begin(); it != geometries->value.End(); ++it) {
-                layer.features.push_back(getFeature(*it, _topology, _source));
+                layer.features.push_back(getFeature(*it, _topology, _source, keys));
             }
         }
     }
@@ -26,7 +26,8 @@ Line getLine(const JsonValue& _arcs, const Topology& _topology);
 
 Polygon getPolygon(const JsonValue& _arcs, const Topology& _topology);
 
-Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId);
+Feature getFeature(const JsonValue& _geometry, const Topology& _topology, int32_t _sourceId,
+                   Properties::KeyCache& _keys);
 
 Layer getLayer(JsonValue::MemberIterator& _object, const Topology& _topology, int32_t _sourceId);
 
@@ -431,7 +431,7 @@ glm::vec2 View::lonLatToScreenPosition(double lon, double lat, bool& clipped) {
 
 void View::updateTiles() {
 
-    m_visibleTiles.clear();
+    m_scanTiles.clear();
 
     int zoom = int(m_zoom);
     int maxTileIndex = 1 << zoom;
@@ -449,6 +449,7 @@ void View::updateTiles() {
 
     // if all of our raycasts have a negative intersection distance, we have no area to cover
     if (t0 < .0 && t1 < 0. && t2 < 0. && t3 < 0.) {
+        m_visibleTiles.clear();
         return;
     }
 
@@ -473,10 +474,10 @@ void View::updateTiles() {
     // Scan options - avoid heap allocation for std::function
     // [1] http://www.drdobbs.com/cpp/efficient-use-of-lambda-expressions-and/232500059?pgno=2
     struct ScanParams {
-        ScanParams(std::set<TileID>& _tiles, int _zoom)
+        ScanParams(std::vector<TileID>& _tiles, int _zoom)
             : tiles(_tiles), zoom(_zoom) {}
 
-        std::set<TileID>& tiles;
+        std::vector<TileID>& tiles;
         int zoom;
         int maxZoom = int(s_maxZoom);
 
@@ -491,7 +492,7 @@ void View::updateTiles() {
         glm::ivec4 last = glm::ivec4{-1};
     };
 
-    ScanParams opt{ m_visibleTiles, zoom };
+    ScanParams opt{ m_scanTiles, zoom };
 
     if (m_type == CameraType::perspective) {
 
@@ -530,7 +531,7 @@ void View::updateTiles() {
         tile.w = (x - tile.x) >> opt.zoom; // wrap
 
         if (tile != opt.last) {
-            opt.tiles.emplace(tile.x, tile.y, tile.z, tile.z, tile.w);
+            opt.tiles.emplace_back(tile.x, tile.y, tile.z, tile.z, tile.w);
             opt.last = tile;
         }
     };
@@ -544,6 +545,10 @@ void View::updateTiles() {
     // (which should remain visible, even though the base of the tile is not).
     Rasterize::scanTriangle(a, b, e, 0, maxTileIndex, s);
 
+    // Swap in the sorted scan, the added and removed tiles are the
+    // difference to the previous scan
+    m_visibleTiles.update(m_scanTiles);
+
     m_dirtyTiles = false;
 
 }
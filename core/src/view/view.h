@@ -5,11 +5,12 @@
 #include "glm/vec3.hpp"
 
 #include "tile/tileID.h"
+#include "tile/visibleTiles.h"
 #include "util/mapProjection.h"
 #include "view/viewConstraint.h"
 
-#include <set>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 
@@ -45,6 +46,7 @@ public:
     View(int _width = 800, int _height = 600, ProjectionType _projType = ProjectionType::mercator);
 
     View(const View& _view) = default;
+    View& operator=(const View& _view) = default;
 
     /* Sets a new map projection with default tileSize */
     void setMapProjection(ProjectionType _projType);
@@ -178,8 +180,9 @@ public:
     /* Gets the screen position from a latitude/longitude */
     glm::vec2 lonLatToScreenPosition(double lon, double lat, bool& clipped);
 
-    /* Returns the set of all tiles visible at the current position and zoom */
-    const std::set<TileID>& getVisibleTiles() { return m_visibleTiles; }
+    /* Returns the set of all tiles visible at the current position and zoom,
+     * with the tiles added and removed since the previous update */
+    const VisibleTiles& getVisibleTiles() { return m_visibleTiles; }
 
     /* Returns true if the view properties have changed since the last call to update() */
     bool changedOnLastUpdate() const { return m_changed; }
@@ -205,7 +208,10 @@ protected:
     std::shared_ptr<MapProjection> m_projection;
     std::shared_ptr<Stops> m_fovStops;
     std::shared_ptr<Stops> m_maxPitchStops;
-    std::set<TileID> m_visibleTiles;
+    VisibleTiles m_visibleTiles;
+
+    // Scratch buffer for the tiles covered by the view trapezoid
+    std::vector<TileID> m_scanTiles;
 
     ViewConstraint m_constraint;
 
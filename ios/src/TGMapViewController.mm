@@ -105,7 +105,7 @@
     NSMutableDictionary* dictionary = [[NSMutableDictionary alloc] init];
 
     for (const auto& item : properties->items()) {
-        NSString* key = [NSString stringWithUTF8String:item.key.c_str()];
+        NSString* key = [NSString stringWithUTF8String:item.name().c_str()];
         NSString* value = [NSString stringWithUTF8String:properties->asString(item.value).c_str()];
         dictionary[key] = value;
     }
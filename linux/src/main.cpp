@@ -356,8 +356,6 @@ int main(int argc, char* argv[]) {
         double delta = currentTime - lastTime;
         lastTime = currentTime;
 
-        processNetworkQueue();
-
         // Render
         map->update(delta);
         map->render();
@@ -4,9 +4,8 @@
 #include <fstream>
 #include <functional>
 #include <string>
-#include <list>
 
-#include "urlWorker.h"
+#include "urlClient.h"
 #include "platform_linux.h"
 #include "gl/hardware.h"
 
@@ -19,13 +18,8 @@
 
 #include <GLFW/glfw3.h>
 
-#define NUM_WORKERS 3
-
 static bool s_isContinuousRendering = false;
 
-static UrlWorker s_Workers[NUM_WORKERS];
-static std::list<std::unique_ptr<UrlTask>> s_urlTaskQueue;
-
 void logMsg(const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
@@ -33,20 +27,6 @@ void logMsg(const char* fmt, ...) {
     va_end(args);
 }
 
-void processNetworkQueue() {
-    // attach workers to NetWorkerData
-    auto taskItr = s_urlTaskQueue.begin();
-    for(auto& worker : s_Workers) {
-        if(taskItr == s_urlTaskQueue.end()) {
-            break;
-        }
-        if(worker.isAvailable()) {
-            worker.perform(std::move(*taskItr));
-            taskItr = s_urlTaskQueue.erase(taskItr);
-        }
-    }
-}
-
 void requestRender() {
 
     glfwPostEmptyEvent();
@@ -110,38 +90,27 @@ std::string systemFontFallbackPath(int _importance, int _weightHint) {
     return "";
 }
 
+static UrlClient& urlClient() {
+    static UrlClient s_urlClient;
+    return s_urlClient;
+}
+
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
-    std::unique_ptr<UrlTask> task(new UrlTask(_url, _callback));
-    for(auto& worker : s_Workers) {
-        if(worker.isAvailable()) {
-            worker.perform(std::move(task));
-            return true;
-        }
-    }
-    s_urlTaskQueue.push_back(std::move(task));
-    return true;
+    return urlClient().addRequest(_url, _callback);
 
 }
 
 void cancelUrlRequest(const std::string& _url) {
 
-    // Only clear this request if a worker has not started operating on it!!
-    // otherwise it gets too convoluted with curl!
-    auto itr = s_urlTaskQueue.begin();
-    while(itr != s_urlTaskQueue.end()) {
-        if((*itr)->url == _url) {
-            itr = s_urlTaskQueue.erase(itr);
-        } else {
-            itr++;
-        }
-    }
+    urlClient().cancelRequest(_url);
+
 }
 
 void finishUrlRequests() {
-    for(auto& worker : s_Workers) {
-        worker.join();
-    }
+
+    urlClient().stop();
+
 }
 
 void setCurrentThreadPriority(int priority){
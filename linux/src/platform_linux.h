@@ -2,7 +2,5 @@
 
 #include "platform.h"
 
-void processNetworkQueue();
-
 void finishUrlRequests();
 
@@ -0,0 +1,338 @@
+#include "urlClient.h"
+#include "log.h"
+
+#include <algorithm>
+
+// curl_multi_poll() and curl_multi_wakeup() are available since 7.68.0
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define HAVE_MULTI_WAKEUP
+#else
+// Without wakeup, new and canceled requests are noticed after this interval
+#define WAIT_TIMEOUT_MS 10
+#endif
+
+// Upper limit for buffers reserved from Content-Length
+#define MAX_BUFFER_RESERVE (16 << 20)
+
+UrlClient::UrlClient(Options _options) : m_options(_options) {
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    m_multi = curl_multi_init();
+
+    // Multiplex requests to the same host over one HTTP/2 connection
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, m_options.maxConnections);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, m_options.maxHostConnections);
+
+    m_thread = std::thread(&UrlClient::run, this);
+}
+
+UrlClient::~UrlClient() {
+    stop();
+
+    for (auto* handle : m_handles) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(m_multi);
+
+    curl_global_cleanup();
+}
+
+bool UrlClient::addRequest(const std::string& _url, UrlCallback _callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_running) { return false; }
+
+        auto& request = m_requests[_url];
+
+        if (request) {
+            // Merge with the pending or active request for this url
+            request->callbacks.push_back(std::move(_callback));
+            return true;
+        }
+
+        request = std::make_shared<Request>();
+        request->url = _url;
+        request->callbacks.push_back(std::move(_callback));
+        m_stats.pending++;
+
+        m_queue.push_back(request);
+    }
+
+    m_condition.notify_one();
+    wakeup();
+
+    return true;
+}
+
+void UrlClient::cancelRequest(const std::string& _url) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it == m_requests.end()) { return; }
+
+        auto request = std::move(it->second);
+        m_requests.erase(it);
+
+        request->canceled = true;
+        request->callbacks.clear();
+        m_stats.canceled++;
+
+        if (!request->started) {
+            // Still queued, skipped when it comes up
+            m_stats.pending--;
+            return;
+        }
+        m_canceled.push_back(std::move(request));
+    }
+
+    wakeup();
+}
+
+void UrlClient::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_running) { return; }
+        m_running = false;
+
+        m_requests.clear();
+        m_queue.clear();
+        m_stats.pending = 0;
+    }
+
+    m_condition.notify_one();
+    wakeup();
+
+    if (m_thread.joinable()) { m_thread.join(); }
+}
+
+UrlClient::Stats UrlClient::stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats = m_stats;
+    stats.active = m_active.size();
+    return stats;
+}
+
+void UrlClient::wakeup() {
+#ifdef HAVE_MULTI_WAKEUP
+    curl_multi_wakeup(m_multi);
+#endif
+}
+
+size_t UrlClient::writeData(char* _data, size_t _size, size_t _count, void* _request) {
+
+    auto& request = *static_cast<Request*>(_request);
+    auto& content = request.content;
+    size_t size = _size * _count;
+
+    if (content.capacity() == 0) {
+        // First chunk of the body: headers are complete, so reserve the whole
+        // body at once instead of growing the buffer chunk by chunk
+        size_t reserve = 0;
+#if LIBCURL_VERSION_NUM >= 0x073700
+        curl_off_t length = -1;
+        curl_easy_getinfo(request.handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+#else
+        double length = -1;
+        curl_easy_getinfo(request.handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length);
+#endif
+        if (length > 0) {
+            reserve = std::min(size_t(length), size_t(MAX_BUFFER_RESERVE));
+        }
+        // With content encoding the length is that of the compressed body
+        content.reserve(std::max({ reserve, size, request.reserve }));
+    }
+
+    content.insert(content.end(), _data, _data + size);
+
+    return size;
+}
+
+CURL* UrlClient::acquireHandle() {
+
+    CURL* handle;
+    if (m_handles.empty()) {
+        handle = curl_easy_init();
+    } else {
+        handle = m_handles.back();
+        m_handles.pop_back();
+    }
+
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &UrlClient::writeData);
+    curl_easy_setopt(handle, CURLOPT_HEADER, 0L);
+    curl_easy_setopt(handle, CURLOPT_VERBOSE, 0L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip");
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, m_options.connectTimeoutMs);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, m_options.timeoutMs);
+    // Rather wait for a connection that can be multiplexed than open a new one
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
+    if (!m_options.proxyAddress.empty()) {
+        curl_easy_setopt(handle, CURLOPT_PROXY, m_options.proxyAddress.c_str());
+    }
+
+    return handle;
+}
+
+void UrlClient::releaseHandle(CURL* _handle) {
+
+    curl_multi_remove_handle(m_multi, _handle);
+
+    if (m_handles.size() < m_options.maxActiveTransfers) {
+        curl_easy_reset(_handle);
+        m_handles.push_back(_handle);
+    } else {
+        curl_easy_cleanup(_handle);
+    }
+}
+
+void UrlClient::startTransfers() {
+
+    while (m_active.size() < m_options.maxActiveTransfers && !m_queue.empty()) {
+
+        auto request = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        if (request->canceled) { continue; }
+
+        LOGD("Fetching URL: %s", request->url.c_str());
+
+        request->started = true;
+        request->handle = acquireHandle();
+        request->reserve = m_options.bufferReserve;
+
+        curl_easy_setopt(request->handle, CURLOPT_URL, request->url.c_str());
+        curl_easy_setopt(request->handle, CURLOPT_WRITEDATA, request.get());
+        curl_easy_setopt(request->handle, CURLOPT_PRIVATE, request.get());
+
+        curl_multi_add_handle(m_multi, request->handle);
+
+        m_stats.pending--;
+        m_active.push_back(std::move(request));
+    }
+}
+
+void UrlClient::removeCanceled() {
+
+    for (auto& request : m_canceled) {
+        // Skip requests that finished before they could be removed
+        if (!request->handle) { continue; }
+
+        releaseHandle(request->handle);
+        request->handle = nullptr;
+
+        m_active.erase(std::find(m_active.begin(), m_active.end(), request));
+    }
+    m_canceled.clear();
+}
+
+void UrlClient::finishTransfer(CURL* _handle, CURLcode _result) {
+
+    Request* ptr = nullptr;
+    curl_easy_getinfo(_handle, CURLINFO_PRIVATE, &ptr);
+
+    long httpStatusCode = 0;
+    curl_easy_getinfo(_handle, CURLINFO_RESPONSE_CODE, &httpStatusCode);
+
+    std::vector<UrlCallback> callbacks;
+    std::vector<char> content;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = std::find_if(m_active.begin(), m_active.end(),
+                               [&](auto& r) { return r.get() == ptr; });
+
+        // Already removed and its handle released by removeCanceled()
+        if (it == m_active.end()) { return; }
+
+        auto request = std::move(*it);
+        m_active.erase(it);
+
+        releaseHandle(request->handle);
+        request->handle = nullptr;
+
+        if (request->canceled) { return; }
+
+        // A new request for the same url may have been added after cancelling this one
+        auto entry = m_requests.find(request->url);
+        if (entry != m_requests.end() && entry->second == request) {
+            m_requests.erase(entry);
+        }
+
+        if (_result == CURLE_OK && httpStatusCode == 200) {
+            content = std::move(request->content);
+            m_stats.completed++;
+            m_stats.bytes += content.size();
+        } else {
+            LOGE("Fetching URL failed: %s - %s - %d", request->url.c_str(),
+                 curl_easy_strerror(_result), httpStatusCode);
+            m_stats.failed++;
+        }
+
+        callbacks = std::move(request->callbacks);
+    }
+
+    for (size_t i = 0; i < callbacks.size(); i++) {
+        if (i + 1 < callbacks.size()) {
+            auto copy = content;
+            callbacks[i](std::move(copy));
+        } else {
+            callbacks[i](std::move(content));
+        }
+    }
+
+    requestRender();
+}
+
+void UrlClient::run() {
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [&]{
+                return !m_running || !m_queue.empty() || !m_active.empty();
+            });
+
+            if (!m_running) { break; }
+
+            removeCanceled();
+            startTransfers();
+
+            if (m_active.empty()) { continue; }
+        }
+
+        int running = 0;
+        curl_multi_perform(m_multi, &running);
+
+        int remaining = 0;
+        while (CURLMsg* msg = curl_multi_info_read(m_multi, &remaining)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finishTransfer(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        if (running == 0) { continue; }
+
+#ifdef HAVE_MULTI_WAKEUP
+        curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+#else
+        curl_multi_wait(m_multi, nullptr, 0, WAIT_TIMEOUT_MS, nullptr);
+#endif
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& request : m_active) {
+        releaseHandle(request->handle);
+        request->handle = nullptr;
+    }
+    m_active.clear();
+    m_canceled.clear();
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "platform.h"
+
+#include <curl/curl.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* UrlClient
+ *
+ * Performs url requests on a single network thread using a curl multi handle.
+ * Connections are kept alive and shared by all requests, requests to HTTP/2
+ * hosts are multiplexed over one connection.
+ *
+ * Requests wait in a FIFO queue until a transfer slot is free. Requests for
+ * the same url are merged and can be cancelled with one hash lookup. Tile
+ * downloads are ordered by the DownloadScheduler, which starts fewer
+ * downloads at once than there are transfer slots.
+ * Response bodies are written into a buffer that is reserved up front from
+ * the Content-Length of the response and then moved into the callback.
+ *
+ * Callbacks are called on the network thread.
+ */
+class UrlClient {
+
+public:
+
+    struct Options {
+        // Number of transfers performed at the same time
+        size_t maxActiveTransfers = 16;
+        long maxConnections = 8;
+        long maxHostConnections = 6;
+        long connectTimeoutMs = 3000;
+        long timeoutMs = 30000;
+        // Reserved for responses without Content-Length
+        size_t bufferReserve = 16 * 1024;
+        std::string proxyAddress;
+    };
+
+    struct Stats {
+        size_t pending = 0;
+        size_t active = 0;
+        uint64_t completed = 0;
+        uint64_t failed = 0;
+        uint64_t canceled = 0;
+        uint64_t bytes = 0;
+    };
+
+    UrlClient() : UrlClient(Options()) {}
+    explicit UrlClient(Options _options);
+
+    ~UrlClient();
+
+    UrlClient(const UrlClient&) = delete;
+    UrlClient& operator=(const UrlClient&) = delete;
+
+    // Requests start in the order they were added. Returns false when the
+    // client is stopped.
+    bool addRequest(const std::string& _url, UrlCallback _callback);
+
+    // Drop all requests for _url. Their callbacks will not be called.
+    void cancelRequest(const std::string& _url);
+
+    // Cancel all requests and join the network thread
+    void stop();
+
+    Stats stats();
+
+private:
+
+    struct Request {
+        std::string url;
+        std::vector<UrlCallback> callbacks;
+        CURL* handle = nullptr;
+        std::vector<char> content;
+        size_t reserve = 0;
+        bool started = false;
+        bool canceled = false;
+    };
+
+    static size_t writeData(char* _data, size_t _size, size_t _count, void* _request);
+
+    void run();
+    void wakeup();
+
+    // Must be called with m_mutex held
+    void startTransfers();
+    void removeCanceled();
+    void finishTransfer(CURL* _handle, CURLcode _result);
+
+    CURL* acquireHandle();
+    void releaseHandle(CURL* _handle);
+
+    Options m_options;
+
+    CURLM* m_multi = nullptr;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = true;
+
+    // Pending and active requests by url
+    std::unordered_map<std::string, std::shared_ptr<Request>> m_requests;
+
+    // Canceled requests stay in the queue and are skipped when they come up
+    std::deque<std::shared_ptr<Request>> m_queue;
+
+    std::vector<std::shared_ptr<Request>> m_active;
+
+    // Active requests that were canceled, to be removed from m_multi
+    std::vector<std::shared_ptr<Request>> m_canceled;
+
+    std::vector<CURL*> m_handles;
+
+    Stats m_stats;
+
+    std::thread m_thread;
+};
@@ -56,14 +56,14 @@ int main(int argc, char **argv){
     while (bUpdate) {
         updateGL();
 
-        processNetworkQueue();
-
         if (getRenderRequest()) {
             setRenderRequest(false);
             newFrame();
         }
     }
 
+    finishUrlRequests();
+
     if (map) {
         delete map;
         map = nullptr;
@@ -1,7 +1,7 @@
 #include "platform.h"
 #include "gl.h"
 #include "context.h"
-#include "urlWorker.h"
+#include "urlClient.h"
 
 #include <libgen.h>
 #include <stdio.h>
@@ -9,17 +9,11 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <list>
 
 #include <regex>
 
-#define NUM_WORKERS 3
-
 static bool s_isContinuousRendering = false;
 
-static UrlWorker s_Workers[NUM_WORKERS];
-static std::list<std::unique_ptr<UrlTask>> s_urlTaskQueue;
-
 void logMsg(const char* fmt, ...) {
     va_list args;
     va_start(args, fmt);
@@ -27,20 +21,6 @@ void logMsg(const char* fmt, ...) {
     va_end(args);
 }
 
-void processNetworkQueue() {
-    // attach workers to NetWorkerData
-    auto taskItr = s_urlTaskQueue.begin();
-    for(auto& worker : s_Workers) {
-        if(taskItr == s_urlTaskQueue.end()) {
-            break;
-        }
-        if(worker.isAvailable()) {
-            worker.perform(std::move(*taskItr));
-            taskItr = s_urlTaskQueue.erase(taskItr);
-        }
-    }
-}
-
 void requestRender() {
     setRenderRequest(true);
 }
@@ -97,32 +77,27 @@ std::string systemFontFallbackPath(int _importance, int _weightHint) {
     return "";
 }
 
+static UrlClient& urlClient() {
+    static UrlClient s_urlClient;
+    return s_urlClient;
+}
+
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
-    std::unique_ptr<UrlTask> task(new UrlTask(_url, _callback));
-    for(auto& worker : s_Workers) {
-        if(worker.isAvailable()) {
-            worker.perform(std::move(task));
-            return true;
-        }
-    }
-    s_urlTaskQueue.push_back(std::move(task));
-    return true;
+    return urlClient().addRequest(_url, _callback);
 
 }
 
 void cancelUrlRequest(const std::string& _url) {
 
-    // Only clear this request if a worker has not started operating on it!
-    // otherwise it gets too convoluted with curl!
-    auto itr = s_urlTaskQueue.begin();
-    while(itr != s_urlTaskQueue.end()) {
-        if((*itr)->url == _url) {
-            itr = s_urlTaskQueue.erase(itr);
-        } else {
-            itr++;
-        }
-    }
+    urlClient().cancelRequest(_url);
+
+}
+
+void finishUrlRequests() {
+
+    urlClient().stop();
+
 }
 
 void setCurrentThreadPriority(int priority) {}
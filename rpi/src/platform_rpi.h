@@ -8,4 +8,4 @@
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 
-void processNetworkQueue();
+void finishUrlRequests();
@@ -1,7 +1,14 @@
 #include "gl.h"
+#include "gl_mock.h"
 
 namespace Tangram {
 
+static std::vector<char> s_bufferUploads;
+
+std::vector<char>& GLMock::bufferUploads() {
+    return s_bufferUploads;
+}
+
 GLenum GL::getError() {
     return 0;
 }
@@ -48,6 +55,11 @@ void GL::frontFace(GLenum mode) {
 void GL::clearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {
 }
 void GL::getIntegerv(GLenum pname, GLint *params ) {
+    switch (pname) {
+    case GL_MAX_TEXTURE_SIZE: *params = 4096; break;
+    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *params = 16; break;
+    default: *params = 0;
+    }
 }
 
 // Program
@@ -57,11 +69,14 @@ void GL::deleteProgram(GLuint program) {
 }
 void GL::deleteShader(GLuint shader) {
 }
+// Hand out names, so that code paths for valid objects are run
+static GLuint s_nextName = 1;
+
 GLuint GL::createShader(GLenum type) {
-    return 0;
+    return s_nextName++;
 }
 GLuint GL::createProgram() {
-    return 0;
+    return s_nextName++;
 }
 
 void GL::compileShader(GLuint shader) {
@@ -84,8 +99,10 @@ GLint GL::getAttribLocation(GLuint program, const GLchar *name) {
     return 0;
 }
 void GL::getProgramiv(GLuint program, GLenum pname, GLint *params) {
+    *params = (pname == GL_LINK_STATUS) ? GL_TRUE : 0;
 }
 void GL::getShaderiv(GLuint shader, GLenum pname, GLint *params) {
+    *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
 }
 
 // Buffers
@@ -94,10 +111,17 @@ void GL::bindBuffer(GLenum target, GLuint buffer) {
 void GL::deleteBuffers(GLsizei n, const GLuint *buffers) {
 }
 void GL::genBuffers(GLsizei n, GLuint *buffers) {
+    for (GLsizei i = 0; i < n; i++) { buffers[i] = s_nextName++; }
 }
 void GL::bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    if (data) {
+        s_bufferUploads.insert(s_bufferUploads.end(), (const char*)data, (const char*)data + size);
+    }
 }
 void GL::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+    if (data) {
+        s_bufferUploads.insert(s_bufferUploads.end(), (const char*)data, (const char*)data + size);
+    }
 }
 void GL::readPixels(GLint x, GLint y, GLsizei width, GLsizei height,
                     GLenum format, GLenum type, GLvoid* pixels) {
@@ -109,6 +133,7 @@ void GL::bindTexture(GLenum target, GLuint texture ) {
 void GL::activeTexture(GLenum texture) {
 }
 void GL::genTextures(GLsizei n, GLuint *textures ) {
+    for (GLsizei i = 0; i < n; i++) { textures[i] = s_nextName++; }
 }
 void GL::deleteTextures(GLsizei n, const GLuint *textures) {
 }
@@ -195,6 +220,7 @@ void GL::bindVertexArray(GLuint array) {
 void GL::deleteVertexArrays(GLsizei n, const GLuint *arrays) {
 }
 void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
+    for (GLsizei i = 0; i < n; i++) { arrays[i] = s_nextName++; }
 }
 
 
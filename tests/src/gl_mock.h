@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+namespace Tangram {
+
+namespace GLMock {
+
+/* Data passed to GL::bufferData and GL::bufferSubData, in call order */
+std::vector<char>& bufferUploads();
+
+}
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Tangram {
+
+/* HttpServer
+ *
+ * Minimal HTTP/1.1 server on the loopback interface, as a stand-in for a tile
+ * server in tests and benchmarks. Connections are kept alive, each one is
+ * served on its own thread. Responses are controlled by the query string:
+ *
+ *   /any/path?size=<bytes>&delay=<ms>&status=<code>
+ *
+ * 'size' bytes of body (default 1024) are returned after waiting 'delay'
+ * milliseconds, with status 'status' (default 200). Connections are closed
+ * when the server is destroyed.
+ */
+class HttpServer {
+
+public:
+
+    HttpServer() {
+        m_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+        int reuse = 1;
+        setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+
+        bind(m_socket, (sockaddr*)&addr, sizeof(addr));
+        listen(m_socket, 64);
+
+        socklen_t length = sizeof(addr);
+        getsockname(m_socket, (sockaddr*)&addr, &length);
+        m_port = ntohs(addr.sin_port);
+
+        m_thread = std::thread([this]() { accept(); });
+    }
+
+    ~HttpServer() {
+        m_running = false;
+        shutdown(m_socket, SHUT_RDWR);
+        close(m_socket);
+        m_thread.join();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int connection : m_connections) { shutdown(connection, SHUT_RDWR); }
+        for (auto& thread : m_threads) { thread.join(); }
+        for (int connection : m_connections) { close(connection); }
+    }
+
+    // Base url, e.g. "http://127.0.0.1:12345"
+    std::string url() const {
+        return "http://127.0.0.1:" + std::to_string(m_port);
+    }
+
+    // Number of accepted connections
+    size_t connections() const { return m_connectionCount; }
+
+    // Number of answered requests
+    size_t requests() const { return m_requestCount; }
+
+private:
+
+    void accept() {
+        while (m_running) {
+            int connection = ::accept(m_socket, nullptr, nullptr);
+            if (connection < 0) { break; }
+
+            m_connectionCount++;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_connections.push_back(connection);
+            m_threads.emplace_back([this, connection]() { serve(connection); });
+        }
+    }
+
+    static size_t param(const std::string& _target, const char* _name, size_t _default) {
+        std::string key = std::string(_name) + "=";
+        size_t query = _target.find('?');
+        if (query == std::string::npos) { return _default; }
+
+        size_t pos = _target.find(key, query);
+        if (pos == std::string::npos) { return _default; }
+
+        return std::strtoul(_target.c_str() + pos + key.size(), nullptr, 10);
+    }
+
+    void serve(int _connection) {
+        std::string buffer;
+        char chunk[4096];
+
+        while (true) {
+            size_t end;
+            while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(_connection, chunk, sizeof(chunk), 0);
+                if (n <= 0) { return; }
+                buffer.append(chunk, n);
+            }
+
+            // "GET <target> HTTP/1.1"
+            size_t start = buffer.find(' ') + 1;
+            std::string target = buffer.substr(start, buffer.find(' ', start) - start);
+            buffer.erase(0, end + 4);
+
+            size_t size = param(target, "size", 1024);
+            size_t delay = param(target, "delay", 0);
+            size_t status = param(target, "status", 200);
+
+            if (delay) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            }
+
+            std::string response = "HTTP/1.1 " + std::to_string(status) + " X\r\n"
+                "Content-Length: " + std::to_string(size) + "\r\n"
+                "Content-Type: application/octet-stream\r\n\r\n";
+            response.append(size, 'x');
+
+            const char* data = response.data();
+            size_t left = response.size();
+            while (left > 0) {
+                ssize_t n = send(_connection, data, left, MSG_NOSIGNAL);
+                if (n <= 0) { return; }
+                data += n;
+                left -= n;
+            }
+            m_requestCount++;
+        }
+    }
+
+    int m_socket;
+    int m_port;
+
+    std::atomic<bool> m_running{true};
+    std::atomic<size_t> m_connectionCount{0};
+    std::atomic<size_t> m_requestCount{0};
+
+    std::mutex m_mutex;
+    std::vector<int> m_connections;
+    std::vector<std::thread> m_threads;
+
+    std::thread m_thread;
+};
+
+}
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include <libgen.h>
 //#include <sys/resource.h>
@@ -72,6 +73,22 @@ std::string systemFontFallbackPath(int _importance, int _weightHint) {
 }
 
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
+
+    // Serve file:// URLs from the local file system, e.g. for file-backed
+    // tile sources in benchmarks. The callback runs immediately.
+    const std::string scheme = "file://";
+    if (_url.compare(0, scheme.size(), scheme) != 0) { return true; }
+
+    std::string path = _url.substr(scheme.size());
+    path = path.substr(0, path.find('?'));
+
+    size_t size = 0;
+    unsigned char* bytes = bytesFromFile(path.c_str(), size);
+
+    std::vector<char> data(bytes, bytes + size);
+    free(bytes);
+
+    _callback(std::move(data));
     return true;
 }
 
@@ -0,0 +1,121 @@
+#include "catch.hpp"
+
+#include "data/tileData.h"
+#include "util/arena.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+using ArenaVector = std::vector<int, ArenaAllocator<int>>;
+
+TEST_CASE("Containers allocate from the current Arena", "[Arena]") {
+    Arena arena;
+    {
+        Arena::Scope scope(arena);
+        ArenaVector values = { 1, 2, 3 };
+
+        REQUIRE(values.get_allocator().arena == &arena);
+        REQUIRE(arena.allocations() > 0);
+    }
+    ArenaVector values = { 1, 2, 3 };
+    REQUIRE(values.get_allocator().arena == nullptr);
+}
+
+TEST_CASE("Copies of Arena containers use the heap", "[Arena]") {
+    Arena arena;
+    ArenaVector copy;
+    {
+        Arena::Scope scope(arena);
+        ArenaVector values = { 1, 2, 3 };
+
+        copy = ArenaVector(values);
+        REQUIRE(copy.get_allocator().arena == nullptr);
+    }
+    arena.reset();
+
+    REQUIRE(copy.size() == 3);
+    REQUIRE(copy[2] == 3);
+}
+
+TEST_CASE("Arena counts the allocations of live containers", "[Arena]") {
+    Arena arena;
+    ArenaVector moved;
+    {
+        Arena::Scope scope(arena);
+        ArenaVector values;
+        for (int i = 0; i < 100; i++) { values.push_back(i); }
+
+        REQUIRE(arena.liveAllocations() == 1);
+
+        // Moved containers keep their Arena storage
+        moved = std::move(values);
+        REQUIRE(moved.get_allocator().arena == &arena);
+    }
+    REQUIRE(arena.liveAllocations() == 1);
+
+    moved = ArenaVector();
+    REQUIRE(arena.liveAllocations() == 0);
+
+    arena.reset();
+    REQUIRE(arena.allocations() == 0);
+}
+
+TEST_CASE("Arena reuses deallocated blocks", "[Arena]") {
+    Arena arena;
+
+    void* a = arena.allocate(64, 8);
+    void* b = arena.allocate(64, 8);
+
+    // Not the most recent allocation: kept in a free list
+    arena.deallocate(a, 64);
+    REQUIRE(arena.allocate(48, 8) == a);
+
+    // The most recent allocation is given back to the chunk
+    arena.deallocate(b, 64);
+    REQUIRE(arena.allocate(64, 8) == b);
+
+    arena.deallocate(a, 48);
+    arena.deallocate(b, 64);
+    arena.reset();
+
+    // The second vector grows into the old buffers of the first one,
+    // without them it would not fit into the chunk
+    Arena small(10000);
+    {
+        Arena::Scope scope(small);
+        ArenaVector first, second;
+        for (int i = 0; i < 1000; i++) { first.push_back(i); }
+        REQUIRE(small.capacity() == 10000);
+
+        for (int i = 0; i < 500; i++) { second.push_back(i); }
+        REQUIRE(small.capacity() == 10000);
+        REQUIRE(first[999] == 999);
+        REQUIRE(second[499] == 499);
+    }
+}
+
+TEST_CASE("TileData keeps its Arena alive", "[Arena]") {
+    auto arena = std::make_shared<Arena>();
+    std::shared_ptr<TileData> data;
+    {
+        Arena::Scope scope(arena);
+        REQUIRE(Arena::currentOwner() == arena);
+
+        data = std::make_shared<TileData>();
+        data->layers.emplace_back("layer");
+        data->layers.back().features.emplace_back();
+        data->layers.back().features.back().points.push_back({ 1.f, 2.f, 0.f });
+    }
+    REQUIRE(Arena::currentOwner() == nullptr);
+    REQUIRE(data->arena == arena);
+
+    // Released by the TileData, as a worker does when the TileData is kept
+    std::weak_ptr<Arena> weak = arena;
+    arena.reset();
+    REQUIRE(!weak.expired());
+    REQUIRE(data->layers[0].features[0].points[0].y == 2.f);
+
+    data.reset();
+    REQUIRE(weak.expired());
+}
@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include "gl/bufferPool.h"
+#include "gl/renderState.h"
+#include "gl/vertexLayout.h"
+
+using namespace Tangram;
+
+TEST_CASE( "Buffer pool suballocates ranges from shared pages", "[Core][BufferPool]" ) {
+
+    RenderState rs;
+    BufferPool pool(GL_ARRAY_BUFFER, 1024);
+
+    auto a = pool.allocate(rs, 100);
+    auto b = pool.allocate(rs, 200);
+
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(a.buffer == b.buffer);
+    REQUIRE(a.offset == 0);
+    // Ranges are aligned to 4 bytes
+    REQUIRE(a.size == 100);
+    REQUIRE(b.offset == 100);
+
+    auto c = pool.allocate(rs, 3);
+    REQUIRE(c.size == 4);
+
+    auto stats = pool.stats();
+    REQUIRE(stats.pages == 1);
+    REQUIRE(stats.allocations == 3);
+    REQUIRE(stats.capacity == 1024);
+    REQUIRE(stats.used == 304);
+    REQUIRE(stats.fragmentation() == 0.f);
+
+    REQUIRE(!pool.allocate(rs, 0));
+}
+
+TEST_CASE( "Buffer pool reuses and merges freed ranges", "[Core][BufferPool]" ) {
+
+    RenderState rs;
+    BufferPool pool(GL_ARRAY_BUFFER, 1024);
+
+    auto a = pool.allocate(rs, 256);
+    auto b = pool.allocate(rs, 256);
+    auto c = pool.allocate(rs, 256);
+
+    pool.free(rs, a);
+    pool.free(rs, c);
+
+    // Two free blocks: [0, 256) and [512, 1024)
+    auto stats = pool.stats();
+    REQUIRE(stats.freeBlocks == 2);
+    REQUIRE(stats.largestFreeBlock == 512);
+    REQUIRE(stats.fragmentation() == Approx(1.f - 512.f / 768.f));
+
+    // First fit
+    auto d = pool.allocate(rs, 128);
+    REQUIRE(d.buffer == a.buffer);
+    REQUIRE(d.offset == 0);
+
+    pool.free(rs, d);
+    pool.free(rs, b);
+
+    stats = pool.stats();
+    REQUIRE(stats.freeBlocks == 1);
+    REQUIRE(stats.used == 0);
+    REQUIRE(stats.largestFreeBlock == 1024);
+    REQUIRE(stats.fragmentation() == 0.f);
+
+    // The empty page is kept for reuse
+    REQUIRE(stats.pages == 1);
+    REQUIRE(pool.allocate(rs, 64).buffer == a.buffer);
+}
+
+TEST_CASE( "Buffer pool creates pages on demand", "[Core][BufferPool]" ) {
+
+    RenderState rs;
+    BufferPool pool(GL_ELEMENT_ARRAY_BUFFER, 1024);
+
+    auto a = pool.allocate(rs, 800);
+    auto b = pool.allocate(rs, 800);
+    REQUIRE(a.buffer != b.buffer);
+
+    // Larger than a page
+    auto c = pool.allocate(rs, 4000);
+    REQUIRE(c.offset == 0);
+
+    auto stats = pool.stats();
+    REQUIRE(stats.pages == 3);
+    REQUIRE(stats.capacity == 2048 + 4000);
+
+    // Oversized and surplus empty pages are released
+    pool.free(rs, c);
+    pool.free(rs, b);
+    pool.free(rs, a);
+    REQUIRE(pool.stats().pages == 1);
+
+    pool.dispose(rs);
+    REQUIRE(pool.stats().pages == 0);
+}
+
+TEST_CASE( "Vertex layouts with the same stride share a buffer pool", "[Core][BufferPool]" ) {
+
+    RenderState rs;
+
+    auto layout = std::make_unique<VertexLayout>(std::vector<VertexLayout::VertexAttrib>({
+        {"a_position", 2, GL_FLOAT, false, 0}}));
+    auto& pool = rs.vertexBufferPool(*layout);
+
+    // A layout of the next scene
+    VertexLayout sameStride({{"a_extrude", 4, GL_SHORT, false, 0}});
+    VertexLayout otherStride({{"a_position", 3, GL_FLOAT, false, 0}});
+
+    layout.reset();
+
+    REQUIRE(&rs.vertexBufferPool(sameStride) == &pool);
+    REQUIRE(&rs.vertexBufferPool(otherStride) != &pool);
+}
+
+TEST_CASE( "Staging pool recycles blocks", "[Core][BufferPool]" ) {
+
+    StagingPool::clear();
+    auto before = StagingPool::stats();
+
+    GLbyte* a = StagingPool::acquire(3000);
+    StagingPool::release(a, 3000);
+
+    REQUIRE(StagingPool::stats().pooled == StagingPool::MIN_BLOCK_SIZE);
+
+    // Same size class
+    GLbyte* b = StagingPool::acquire(100);
+    REQUIRE(b == a);
+    StagingPool::release(b, 100);
+
+    auto stats = StagingPool::stats();
+    REQUIRE(stats.hits == before.hits + 1);
+    REQUIRE(stats.misses == before.misses + 1);
+    REQUIRE(stats.live == before.live);
+
+    // Not pooled
+    GLbyte* c = StagingPool::acquire(StagingPool::MAX_BLOCK_SIZE + 1);
+    StagingPool::release(c, StagingPool::MAX_BLOCK_SIZE + 1);
+    REQUIRE(StagingPool::stats().pooled == StagingPool::MIN_BLOCK_SIZE);
+
+    StagingPool::clear();
+    REQUIRE(StagingPool::stats().pooled == 0);
+}
@@ -0,0 +1,224 @@
+#include "catch.hpp"
+
+#include "data/diskCache.h"
+#include "tile/tileID.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+
+using namespace Tangram;
+
+static const char* cachePath = "diskCacheTest.pack";
+
+TEST_CASE( "Read back tile data from DiskCache", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    DiskCache cache(cachePath, 1024 * 1024);
+    REQUIRE(cache.isOpen());
+
+    std::vector<char> data(100, 'a');
+    cache.put("osm/{z}/{x}/{y}", TileID(1, 2, 3), data);
+
+    std::vector<char> result;
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(1, 2, 3), result));
+    REQUIRE(result == data);
+
+    // Source and tile are part of the key
+    REQUIRE(!cache.get("other/{z}/{x}/{y}", TileID(1, 2, 3), result));
+    REQUIRE(!cache.get("osm/{z}/{x}/{y}", TileID(2, 2, 3), result));
+
+    cache.clear();
+    REQUIRE(!cache.get("osm/{z}/{x}/{y}", TileID(1, 2, 3), result));
+
+    unlink(cachePath);
+}
+
+TEST_CASE( "DiskCache persists and drops incomplete records", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    {
+        DiskCache cache(cachePath, 1024 * 1024);
+        cache.put("osm/{z}/{x}/{y}", TileID(1, 2, 3), std::vector<char>(100, 'a'));
+        cache.put("osm/{z}/{x}/{y}", TileID(1, 2, 3), std::vector<char>(50, 'b'));
+        cache.put("osm/{z}/{x}/{y}", TileID(2, 2, 3), std::vector<char>(100, 'c'));
+    }
+
+    // Simulate an interrupted write
+    FILE* file = fopen(cachePath, "ab");
+    REQUIRE(file);
+    fwrite("TREC", 1, 4, file);
+    fclose(file);
+
+    DiskCache cache(cachePath, 1024 * 1024);
+    REQUIRE(cache.entries() == 2);
+
+    std::vector<char> result;
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(1, 2, 3), result));
+    REQUIRE(result == std::vector<char>(50, 'b'));
+
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(2, 2, 3), result));
+    REQUIRE(result == std::vector<char>(100, 'c'));
+
+    unlink(cachePath);
+}
+
+TEST_CASE( "DiskCache evicts least recently used tiles", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    const size_t maxSize = 64 * 1024;
+    DiskCache cache(cachePath, maxSize);
+
+    std::vector<char> result;
+
+    for (int i = 0; i < 100; i++) {
+        std::vector<char> data(1000, char(i));
+
+        if (!cache.put("osm/{z}/{x}/{y}", TileID(i, 0, 10), data)) {
+            // Full: make room and retry
+            cache.compact();
+            REQUIRE(cache.put("osm/{z}/{x}/{y}", TileID(i, 0, 10), data));
+        }
+
+        // Keep the first tile in use
+        REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(0, 0, 10), result));
+    }
+
+    REQUIRE(cache.fileSize() <= maxSize);
+
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(0, 0, 10), result));
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(99, 0, 10), result));
+    REQUIRE(result[0] == char(99));
+    REQUIRE(!cache.get("osm/{z}/{x}/{y}", TileID(1, 0, 10), result));
+
+    unlink(cachePath);
+}
+
+TEST_CASE( "DiskCache serves lookups while compacting", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    const size_t maxSize = 64 * 1024;
+    DiskCache cache(cachePath, maxSize);
+
+    cache.put("osm/{z}/{x}/{y}", TileID(0, 0, 10), std::vector<char>(1000, char(0)));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> corrupt{0};
+
+    std::thread reader([&]() {
+        std::vector<char> result;
+        while (!done) {
+            for (int i = 0; i < 100; i++) {
+                if (cache.get("osm/{z}/{x}/{y}", TileID(i, 0, 10), result) &&
+                    result != std::vector<char>(1000, char(i))) {
+                    corrupt++;
+                }
+            }
+        }
+    });
+
+    for (int i = 0; i < 1000; i++) {
+        if (!cache.put("osm/{z}/{x}/{y}", TileID(i % 100, 0, 10), std::vector<char>(1000, char(i % 100)))) {
+            cache.compact();
+        }
+        if (i % 300 == 0) { cache.clear(); }
+    }
+    done = true;
+    reader.join();
+
+    REQUIRE(corrupt == 0);
+    REQUIRE(cache.fileSize() <= maxSize);
+
+    unlink(cachePath);
+}
+
+TEST_CASE( "DiskCache drops records with a torn tail", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    {
+        DiskCache cache(cachePath, 1024 * 1024);
+        cache.put("osm/{z}/{x}/{y}", TileID(1, 2, 3), std::vector<char>(100, 'a'));
+        cache.put("osm/{z}/{x}/{y}", TileID(2, 2, 3), std::vector<char>(100, 'b'));
+    }
+
+    // Simulate a crash before the data of the last record reached the disk
+    FILE* file = fopen(cachePath, "r+b");
+    REQUIRE(file);
+    fseek(file, -10, SEEK_END);
+    fwrite(std::vector<char>(10, 0).data(), 1, 10, file);
+    fclose(file);
+
+    DiskCache cache(cachePath, 1024 * 1024);
+    REQUIRE(cache.entries() == 1);
+
+    std::vector<char> result;
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(1, 2, 3), result));
+    REQUIRE(!cache.get("osm/{z}/{x}/{y}", TileID(2, 2, 3), result));
+
+    unlink(cachePath);
+}
+
+TEST_CASE( "DiskCache does not restore removed sources", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    {
+        DiskCache cache(cachePath, 1024 * 1024);
+        cache.put("osm/{z}/{x}/{y}", TileID(1, 2, 3), std::vector<char>(100, 'a'));
+        cache.put("other/{z}/{x}/{y}", TileID(1, 2, 3), std::vector<char>(100, 'b'));
+
+        cache.remove("osm/{z}/{x}/{y}");
+        REQUIRE(cache.entries() == 1);
+
+        // Records written after the removal stay
+        cache.put("osm/{z}/{x}/{y}", TileID(2, 2, 3), std::vector<char>(100, 'c'));
+    }
+
+    DiskCache cache(cachePath, 1024 * 1024);
+    REQUIRE(cache.entries() == 2);
+
+    std::vector<char> result;
+    REQUIRE(!cache.get("osm/{z}/{x}/{y}", TileID(1, 2, 3), result));
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(2, 2, 3), result));
+    REQUIRE(cache.get("other/{z}/{x}/{y}", TileID(1, 2, 3), result));
+
+    unlink(cachePath);
+}
+
+TEST_CASE( "DiskCache drops records when full until it is compacted", "[Core][DiskCache]" ) {
+
+    unlink(cachePath);
+
+    const size_t maxSize = 64 * 1024;
+    DiskCache cache(cachePath, maxSize);
+
+    int i = 0;
+    while (cache.put("osm/{z}/{x}/{y}", TileID(i, 0, 10), std::vector<char>(1000, char(i)))) { i++; }
+
+    size_t fileSize = cache.fileSize();
+    REQUIRE(fileSize <= maxSize);
+    REQUIRE(!cache.put("osm/{z}/{x}/{y}", TileID(i, 0, 10), std::vector<char>(1000, char(i))));
+    REQUIRE(cache.fileSize() == fileSize);
+
+    cache.compact();
+    REQUIRE(cache.fileSize() <= maxSize / 4 * 3);
+
+    // A second compaction has nothing to do
+    fileSize = cache.fileSize();
+    cache.compact();
+    REQUIRE(cache.fileSize() == fileSize);
+
+    REQUIRE(cache.put("osm/{z}/{x}/{y}", TileID(i, 0, 10), std::vector<char>(1000, char(i))));
+
+    std::vector<char> result;
+    REQUIRE(cache.get("osm/{z}/{x}/{y}", TileID(i, 0, 10), result));
+    REQUIRE(result == std::vector<char>(1000, char(i)));
+
+    unlink(cachePath);
+}
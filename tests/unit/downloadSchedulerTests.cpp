@@ -0,0 +1,187 @@
+#include "catch.hpp"
+
+#include "data/dataSource.h"
+#include "tile/downloadScheduler.h"
+#include "tile/tileTask.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+struct TestSource : DataSource {
+
+    struct Download {
+        std::shared_ptr<TileTask> task;
+        TileTaskCb cb;
+    };
+
+    std::vector<Download> downloads;
+    bool fail = false;
+
+    TestSource() : DataSource("", "") {}
+
+    bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override {
+        if (fail) { return false; }
+        downloads.push_back({ std::move(_task), _cb });
+        return true;
+    }
+
+    std::shared_ptr<TileData> parse(const TileTask& _task,
+                                    const MapProjection& _projection) const override {
+        return nullptr;
+    }
+
+    std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override {
+        return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+    }
+
+    // Deliver the data of the _index'th started download
+    void finish(size_t _index) {
+        auto& download = downloads[_index];
+        download.cb.func(std::move(download.task));
+    }
+};
+
+static std::shared_ptr<TileTask> addTask(DownloadScheduler& _scheduler, std::shared_ptr<TestSource> _source,
+                                         TileID _tileId, double _priority, bool _proxy = false) {
+    auto task = _source->createTask(_tileId, -1);
+    task->setPriority(_priority);
+    task->setProxyState(_proxy);
+
+    _scheduler.enqueue(task, TileTaskCb{[](std::shared_ptr<TileTask>&&) {}});
+    return task;
+}
+
+static std::vector<TileID> startedTiles(TestSource& _source) {
+    std::vector<TileID> tiles;
+    for (auto& download : _source.downloads) {
+        if (download.task) { tiles.push_back(download.task->tileId()); }
+    }
+    return tiles;
+}
+
+TEST_CASE( "DownloadScheduler starts downloads in priority order", "[Core][DownloadScheduler]" ) {
+
+    DownloadScheduler scheduler(2);
+    auto source = std::make_shared<TestSource>();
+
+    addTask(scheduler, source, TileID(0, 0, 1), 3);
+    addTask(scheduler, source, TileID(1, 0, 1), 1, true);
+    addTask(scheduler, source, TileID(0, 1, 1), 2);
+    addTask(scheduler, source, TileID(1, 1, 1), 0);
+
+    REQUIRE(source->downloads.empty());
+
+    scheduler.update();
+
+    // Proxies after all other tiles
+    REQUIRE(startedTiles(*source) == std::vector<TileID>({ TileID(1, 1, 1), TileID(0, 1, 1) }));
+    REQUIRE(scheduler.active() == 2);
+    REQUIRE(scheduler.pending() == 2);
+
+    // A finished download starts the next one
+    source->finish(0);
+    REQUIRE(source->downloads.size() == 3);
+    REQUIRE(source->downloads[2].task->tileId() == TileID(0, 0, 1));
+    REQUIRE(scheduler.active() == 2);
+}
+
+TEST_CASE( "DownloadScheduler re-ranks queued downloads", "[Core][DownloadScheduler]" ) {
+
+    DownloadScheduler scheduler(1);
+    auto source = std::make_shared<TestSource>();
+
+    addTask(scheduler, source, TileID(0, 0, 1), 0);
+    auto b = addTask(scheduler, source, TileID(1, 0, 1), 1);
+    auto c = addTask(scheduler, source, TileID(0, 1, 1), 2);
+
+    scheduler.update();
+    REQUIRE(startedTiles(*source) == std::vector<TileID>({ TileID(0, 0, 1) }));
+
+    // The view moved, c is now closest to the center
+    c->setPriority(0);
+    scheduler.update();
+
+    source->finish(0);
+    REQUIRE(source->downloads.size() == 2);
+    REQUIRE(source->downloads[1].task->tileId() == TileID(0, 1, 1));
+
+    // b went out of view
+    b->cancel();
+    scheduler.update();
+    REQUIRE(scheduler.pending() == 0);
+    REQUIRE(scheduler.active() == 1);
+}
+
+TEST_CASE( "DownloadScheduler limits downloads per source", "[Core][DownloadScheduler]" ) {
+
+    DownloadScheduler scheduler(4);
+    auto vector = std::make_shared<TestSource>();
+    auto raster = std::make_shared<TestSource>();
+    raster->setMaxDownloads(1);
+
+    addTask(scheduler, raster, TileID(0, 0, 1), 0);
+    addTask(scheduler, raster, TileID(1, 0, 1), 0);
+    addTask(scheduler, vector, TileID(0, 0, 1), 1);
+    addTask(scheduler, vector, TileID(1, 0, 1), 1);
+
+    scheduler.update();
+
+    REQUIRE(raster->downloads.size() == 1);
+    REQUIRE(vector->downloads.size() == 2);
+    REQUIRE(scheduler.pending() == 1);
+
+    raster->finish(0);
+    REQUIRE(raster->downloads.size() == 2);
+}
+
+TEST_CASE( "DownloadScheduler releases canceled and failed downloads", "[Core][DownloadScheduler]" ) {
+
+    DownloadScheduler scheduler(1);
+    auto source = std::make_shared<TestSource>();
+
+    auto a = addTask(scheduler, source, TileID(0, 0, 1), 0);
+    addTask(scheduler, source, TileID(1, 0, 1), 1);
+
+    scheduler.update();
+    REQUIRE(source->downloads.size() == 1);
+
+    // The url request of a canceled task does not call back
+    a->cancel();
+    scheduler.update();
+    REQUIRE(source->downloads.size() == 2);
+    REQUIRE(scheduler.active() == 1);
+
+    source->fail = true;
+    auto c = addTask(scheduler, source, TileID(0, 1, 1), 2);
+    source->finish(1);
+
+    REQUIRE(c->isCanceled());
+    REQUIRE(scheduler.active() == 0);
+    REQUIRE(scheduler.pending() == 0);
+}
+
+TEST_CASE( "DownloadScheduler releases a canceled download once", "[Core][DownloadScheduler]" ) {
+
+    DownloadScheduler scheduler(1);
+    auto source = std::make_shared<TestSource>();
+
+    auto a = addTask(scheduler, source, TileID(0, 0, 1), 0);
+    addTask(scheduler, source, TileID(1, 0, 1), 1);
+    addTask(scheduler, source, TileID(0, 1, 1), 2);
+
+    scheduler.update();
+    REQUIRE(source->downloads.size() == 1);
+
+    // Canceled while its data was on the way: the callback releases the slot
+    a->cancel();
+    source->finish(0);
+    REQUIRE(source->downloads.size() == 2);
+    REQUIRE(scheduler.active() == 1);
+
+    // and update() does not release it again
+    scheduler.update();
+    REQUIRE(source->downloads.size() == 2);
+    REQUIRE(scheduler.active() == 1);
+    REQUIRE(scheduler.pending() == 1);
+}
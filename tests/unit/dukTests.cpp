@@ -1,6 +1,7 @@
 #include "catch.hpp"
 
 #include "yaml-cpp/yaml.h"
+#include "scene/filterProgram.h"
 #include "scene/filters.h"
 #include "scene/sceneLoader.h"
 #include "scene/scene.h"
@@ -366,3 +367,218 @@ TEST_CASE( "Test evalFunction explicit", "[Duktape][evalFunction]") {
     }
 
 }
+
+TEST_CASE( "Test function results are memoised by the properties read", "[Duktape][evalStyleFn]") {
+    StyleContext ctx;
+    ctx.setNativeFunctions(false);
+    ctx.setKeywordZoom(10);
+
+    REQUIRE(ctx.setFunctions({
+        R"(function() { return feature.kind === 'major' ? feature.width : 1; })"}));
+
+    Feature major1, major2, minor;
+    major1.props.set("kind", "major");
+    major1.props.set("width", 4);
+    major1.props.set("name", "A");
+    major2.props.set("kind", "major");
+    major2.props.set("width", 4);
+    major2.props.set("name", "B");
+    minor.props.set("kind", "minor");
+    minor.props.set("width", 4);
+
+    StyleParam::Value value;
+
+    ctx.setFeature(minor);
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 1);
+
+    // Reads 'width' in the other branch
+    ctx.setFeature(major1);
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 4);
+
+    // Same values for 'kind' and 'width', 'name' is not read
+    ctx.setFeature(major2);
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 4);
+    REQUIRE(ctx.functionCacheStats().hits == 1);
+
+    major2.props.set("width", 6);
+    ctx.setFeature(major2);
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 6);
+
+    ctx.setFeature(minor);
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 1);
+
+    // Keywords are part of the key
+    REQUIRE(ctx.setFunctions({ R"(function() { return feature.kind === 'major' && $zoom > 10; })"}));
+
+    ctx.setFeature(major1);
+    REQUIRE(ctx.evalFilter(0) == false);
+    REQUIRE(ctx.evalFilter(0) == false);
+
+    ctx.setKeywordZoom(11);
+    REQUIRE(ctx.evalFilter(0) == true);
+
+    REQUIRE(ctx.functionCacheStats().misses == 6);
+    REQUIRE(ctx.functionCacheStats().hits == 2);
+}
+
+TEST_CASE( "Test native functions compile the simple subset of JS", "[Duktape][NativeFunction]") {
+    NativeFunction fn;
+
+    REQUIRE(fn.compile(R"(function() { return feature.kind; })"));
+    REQUIRE(fn.size() == 1);
+
+    REQUIRE(fn.compile(R"(function () { return feature.sort_key + 5 || 0 })"));
+    REQUIRE(fn.compile(R"(function() {return (feature.scalerank * .75) <= ($zoom - 4); })"));
+    REQUIRE(fn.compile(R"(function() { return feature['name:en'] || feature.name; })"));
+    REQUIRE(fn.compile(R"(function() {
+        return $zoom >= 14 ? (feature.kind === "major_road" ? 4 : 2) : 1;
+    })"));
+    REQUIRE(fn.compile(R"(function() { return $geometry === 'line' && !feature.tunnel; })"));
+
+    // Scene globals, calls, member access on values, statements and comments
+    REQUIRE(!fn.compile(R"(function() { return global.road_color; })"));
+    REQUIRE(!fn.compile(R"(function() { return Math.max(feature.a, 1); })"));
+    REQUIRE(!fn.compile(R"(function() { return feature.name.length; })"));
+    REQUIRE(!fn.compile(R"(function() { var w = feature.width; return w * 2; })"));
+    REQUIRE(!fn.compile(R"(function() { return feature.a; // comment
+    })"));
+    REQUIRE(!fn.compile(R"(function() { return
+        feature.a; })"));
+    REQUIRE(!fn.compile(R"(function() { return 010; })"));
+    REQUIRE(!fn.valid());
+}
+
+TEST_CASE( "Test functions reading the time or random numbers are found by token", "[Duktape][NativeFunction]") {
+    REQUIRE(!NativeFunction::isDeterministic(R"(function() { return Math.random() < 0.5; })"));
+    REQUIRE(!NativeFunction::isDeterministic(R"(function() { return Math['random'](); })"));
+    REQUIRE(!NativeFunction::isDeterministic(R"(function() { var d = new Date(); return d.getHours(); })"));
+    REQUIRE(!NativeFunction::isDeterministic(R"(function() { return Date.now() % 2; })"));
+
+    // Members, strings and comments
+    REQUIRE(NativeFunction::isDeterministic(R"(function() { return feature.Date; })"));
+    REQUIRE(NativeFunction::isDeterministic(R"(function() { return feature.Dates || feature.updated; })"));
+    REQUIRE(NativeFunction::isDeterministic(R"(function() { return feature.name === 'Date'; })"));
+    REQUIRE(NativeFunction::isDeterministic(R"(function() { // Math.random
+        return Math.round(feature.height); /* Date */ })"));
+}
+
+TEST_CASE( "Test native function evaluation", "[Duktape][NativeFunction]") {
+    Feature feature;
+    feature.props.set("kind", "major_road");
+    feature.props.set("sort_key", 2);
+    feature.props.set("name", "Main St");
+
+    StyleContext ctx;
+    ctx.setKeywordZoom(15);
+    ctx.setFeature(feature);
+
+    REQUIRE(ctx.setFunctions({
+        R"(function() { return feature.sort_key + 5 || 0; })",
+        R"(function() { return feature.missing + 1 || 0; })",
+        R"(function() { return $zoom >= 14 ? (feature.kind === 'major_road' ? 4 : 2) : 1; })",
+        R"(function() { return feature.name + ' (' + feature.kind + ')'; })",
+        R"(function() { return feature.kind == 'minor_road' || feature.sort_key < 3; })",
+        R"(function() { return feature.color || 'black'; })",
+        R"(function() { return feature.sort_key == '2'; })",
+    }));
+
+    StyleParam::Value value;
+
+    REQUIRE(ctx.evalStyle(0, StyleParamKey::order, value) == true);
+    REQUIRE(value.get<uint32_t>() == 7);
+
+    REQUIRE(ctx.evalStyle(1, StyleParamKey::order, value) == true);
+    REQUIRE(value.get<uint32_t>() == 0);
+
+    REQUIRE(ctx.evalStyle(2, StyleParamKey::width, value) == true);
+    REQUIRE(value.get<StyleParam::Width>().value == 4);
+
+    REQUIRE(ctx.evalStyle(3, StyleParamKey::text_source, value) == true);
+    REQUIRE(value.get<std::string>() == "Main St (major_road)");
+
+    REQUIRE(ctx.evalFilter(4) == true);
+
+    REQUIRE(ctx.evalStyle(5, StyleParamKey::color, value) == true);
+    REQUIRE(value.get<uint32_t>() == 0xff000000);
+
+    REQUIRE(ctx.functionCacheStats().native == 6);
+
+    // Comparing numbers with strings falls back to Duktape
+    REQUIRE(ctx.evalFilter(6) == true);
+    REQUIRE(ctx.functionCacheStats().native == 6);
+}
+
+TEST_CASE( "Test filters and native functions of a scene share property slots", "[Duktape][NativeFunction]") {
+    auto scene = std::make_shared<Scene>();
+    scene->functions() = { R"(function() { return feature.kind === 'park'; })" };
+
+    FilterProgram filter(Filter::MatchEquality("kind", { Value("park") }));
+    filter.linkProperties(scene->propertySlots());
+
+    StyleContext ctx;
+    ctx.initFunctions(*scene);
+
+    // Both read 'kind' through its slot in the StyleContext cache
+    REQUIRE(scene->propertySlots().slot(Properties::keyId("kind")) == 0);
+    REQUIRE(scene->propertySlots().slot(Properties::keyId("name")) == 1);
+
+    Feature park;
+    park.props.set("kind", "park");
+    Feature road;
+    road.props.set("kind", "road");
+
+    ctx.setFeature(park);
+    REQUIRE(filter.eval(park, ctx) == true);
+    REQUIRE(ctx.evalFilter(0) == true);
+
+    ctx.setFeature(road);
+    REQUIRE(filter.eval(road, ctx) == false);
+    REQUIRE(ctx.evalFilter(0) == false);
+
+    REQUIRE(ctx.functionCacheStats().native == 2);
+}
+
+TEST_CASE( "Test scene functions loaded from bytecode", "[Duktape][initFunctions]") {
+    auto scene1 = std::make_shared<Scene>();
+    scene1->config() = YAML::Load("global: { width: 3 }");
+    scene1->functions() = {
+        R"(function() { return feature.scalerank === 2; })",
+        R"(function() { return global.width * feature.scalerank; })",
+    };
+
+    Feature feature;
+    feature.props.set("scalerank", 2);
+
+    StyleContext ctx1, ctx2;
+    ctx1.setNativeFunctions(false);
+    ctx2.setNativeFunctions(false);
+
+    ctx1.initFunctions(*scene1);
+    REQUIRE(scene1->functionBytecode().compiled);
+    REQUIRE(scene1->functionBytecode().functions.size() == 2);
+
+    // Loads the bytecode compiled by ctx1
+    ctx2.initFunctions(*scene1);
+
+    for (auto* ctx : { &ctx1, &ctx2 }) {
+        ctx->setFeature(feature);
+        REQUIRE(ctx->evalFilter(0) == true);
+
+        StyleParam::Value value;
+        REQUIRE(ctx->evalStyle(1, StyleParamKey::width, value) == true);
+        REQUIRE(value.get<StyleParam::Width>().value == 6);
+    }
+
+    // Switching scenes keeps the heap but not the globals of the previous scene
+    auto scene2 = std::make_shared<Scene>();
+    scene2->functions() = { R"(function() { return typeof global === 'undefined'; })" };
+
+    ctx2.initFunctions(*scene2);
+    ctx2.setFeature(feature);
+    REQUIRE(ctx2.evalFilter(0) == true);
+}
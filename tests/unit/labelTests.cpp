@@ -5,6 +5,7 @@
 #include "style/textStyle.h"
 #include "labels/textLabel.h"
 #include "labels/textLabels.h"
+#include "labels/spriteLabel.h"
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
@@ -199,3 +200,22 @@ TEST_CASE( "Sine interpolation", "[Core][Label][Fade]" ) {
 
     REQUIRE(fadeIn.isFinished());
 }
+
+TEST_CASE( "Sprite vertices of labels far off screen are clamped", "[Core][Label]" ) {
+    glm::i16vec2 offset(40, -40);
+
+    // On screen the packed position is exact
+    glm::i16vec2 pos = SpriteVertex::packPosition(screenSize / 2.f, offset);
+    REQUIRE(pos.x == 1000 + 40);
+    REQUIRE(pos.y == 1000 - 40);
+
+    // Outside of the int16 range after scaling, i.e. more than 8192px off
+    pos = SpriteVertex::packPosition({ 9000.f, -9000.f }, offset);
+    REQUIRE(pos.x == SHRT_MAX);
+    REQUIRE(pos.y == SHRT_MIN);
+
+    // The offset must not wrap a position close to the limit
+    pos = SpriteVertex::packPosition({ 8190.f, -8190.f }, { 100, -100 });
+    REQUIRE(pos.x == SHRT_MAX);
+    REQUIRE(pos.y == SHRT_MIN);
+}
@@ -216,3 +216,55 @@ TEST_CASE("SceneLayer correctly merges rules matched from sublayer", "[SceneLaye
     REQUIRE(matches[0].findParameter(StyleParamKey::order).value.get<std::string>() == "value_c");
 
 }
+
+TEST_CASE("DrawRuleMergeSet caches matches by the filtered properties", "[SceneLayer][Filter][DrawRule]") {
+
+    Filter f = Filter::MatchEquality("kind", { Value("road") });
+
+    DrawRuleData rule = { "group1", group1, { { StyleParamKey::order, "a" } } };
+
+    SceneLayer layer = { "layer", f, { rule }, { instance_1(), instance_2() } };
+
+    Context ctx;
+    DrawRuleMergeSet ruleSet;
+
+    Feature road;
+    road.props.set("kind", "road");
+    road.props.set("one", "blah");
+    road.props.set("name", "first");
+
+    REQUIRE(ruleSet.match(road, layer, ctx));
+    REQUIRE(ruleSet.matchedRules().size() == 1);
+    REQUIRE(ruleSet.matchCacheStats().misses == 1);
+
+    // 'name' is not tested by any filter and only the existence of 'one'
+    road.props.set("name", "second");
+    road.props.set("one", "other");
+
+    REQUIRE(ruleSet.match(road, layer, ctx));
+    REQUIRE(ruleSet.matchedRules().size() == 1);
+    REQUIRE(ruleSet.matchedRules()[0].getStyleName() == "group1");
+    REQUIRE(ruleSet.matchCacheStats().hits == 1);
+
+    road.props.set("two", "blah");
+
+    REQUIRE(ruleSet.match(road, layer, ctx));
+    REQUIRE(ruleSet.matchedRules().size() == 2);
+    REQUIRE(ruleSet.matchedRules()[1].getStyleName() == "group2");
+    REQUIRE(ruleSet.matchCacheStats().misses == 2);
+
+    Feature water;
+    water.props.set("kind", "water");
+    water.props.set("one", "blah");
+
+    REQUIRE(!ruleSet.match(water, layer, ctx));
+    REQUIRE(ruleSet.matchedRules().size() == 0);
+    REQUIRE(!ruleSet.match(water, layer, ctx));
+    REQUIRE(ruleSet.matchCacheStats().hits == 2);
+
+    // The geometry type is part of the cache key
+    water.geometryType = GeometryType::lines;
+
+    REQUIRE(!ruleSet.match(water, layer, ctx));
+    REQUIRE(ruleSet.matchCacheStats().misses == 4);
+}
@@ -1,7 +1,13 @@
 #include "catch.hpp"
 
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <random>
+#include "gl/hardware.h"
 #include "gl/mesh.h"
+#include "util/builders.h"
+#include "glm/gtc/type_precision.hpp"
 
 using namespace Tangram;
 
@@ -27,6 +33,15 @@ struct TestMesh : public Mesh<Vertex> {
 
     int numVertices() const { return m_nVertices; }
     int numIndices() const { return m_nIndices; }
+
+    GLenum indexType() const { return m_indexType; }
+    const std::vector<std::pair<uint32_t, uint32_t>>& vertexOffsets() const { return m_vertexOffsets; }
+
+    // Index _i of the compiled (not yet uploaded) index data
+    uint32_t index(size_t _i) const {
+        if (m_indexType == GL_UNSIGNED_INT) { return reinterpret_cast<const GLuint*>(m_glIndexData)[_i]; }
+        return reinterpret_cast<const GLushort*>(m_glIndexData)[_i];
+    }
 };
 
 std::shared_ptr<TestMesh> newMesh(unsigned int size) {
@@ -170,3 +185,222 @@ TEST_CASE( "Check overflow", "[Core][TypedMesh]" ) {
 
     checkBounds(mesh);
 }
+
+TEST_CASE( "Polyline with a miter join", "[Core][Builders]" ) {
+    struct PolyLineVertex {
+        glm::vec3 coord;
+        glm::vec2 enormal;
+        glm::vec2 uv;
+    };
+    std::vector<PolyLineVertex> vertices;
+
+    PolyLineBuilder<> builder([&](const glm::vec3& coord, const glm::vec2& enormal, const glm::vec2& uv) {
+            vertices.push_back({ coord, enormal, uv });
+        }, CapTypes::butt, JoinTypes::miter);
+
+    Line line = { { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 1.f, 1.f, 0.f } };
+    Builders::buildPolyLine(line, builder);
+
+    // Right and left corner at each point, extruded along the normals of the
+    // segments and along the miter vector at the join
+    std::vector<PolyLineVertex> expected = {
+        { { 0.f, 0.f, 0.f }, {  0.f, -1.f }, { 1.f, 0.f } },
+        { { 0.f, 0.f, 0.f }, {  0.f,  1.f }, { 0.f, 0.f } },
+        { { 1.f, 0.f, 0.f }, {  1.f, -1.f }, { 1.f, 1.f } },
+        { { 1.f, 0.f, 0.f }, { -1.f,  1.f }, { 0.f, 1.f } },
+        { { 1.f, 1.f, 0.f }, {  1.f,  0.f }, { 1.f, 2.f } },
+        { { 1.f, 1.f, 0.f }, { -1.f,  0.f }, { 0.f, 2.f } },
+    };
+
+    REQUIRE(builder.numVertices == expected.size());
+    REQUIRE(vertices.size() == expected.size());
+    REQUIRE(builder.indices.size() == 12);
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        REQUIRE(vertices[i].coord == expected[i].coord);
+        REQUIRE(glm::length(vertices[i].enormal - expected[i].enormal) < 1e-6f);
+        REQUIRE(glm::length(vertices[i].uv - expected[i].uv) < 1e-6f);
+    }
+}
+
+// Three features of 30000 vertices each, one triangle per feature
+MeshData<Vertex> largeMeshData() {
+    MeshData<Vertex> meshData;
+    for (int f = 0; f < 3; f++) {
+        meshData.vertices.resize(meshData.vertices.size() + 30000, {0,0,0,0});
+        meshData.indices.insert(meshData.indices.end(), { 0, 1, 29999 });
+        meshData.offsets.emplace_back(3, 30000);
+    }
+    return meshData;
+}
+
+TEST_CASE( "Meshes above 65535 vertices are split into draw batches with 16 bit indices", "[Core][TypedMesh]" ) {
+    Hardware::supportsElementIndexUint = false;
+
+    TestMesh mesh(layout, GL_TRIANGLES);
+    mesh.compile(largeMeshData());
+
+    REQUIRE(mesh.indexType() == GL_UNSIGNED_SHORT);
+    REQUIRE(mesh.bufferSize() == 90000 * sizeof(Vertex) + 9 * sizeof(GLushort));
+
+    auto& batches = mesh.vertexOffsets();
+    REQUIRE(batches.size() == 2);
+    REQUIRE(batches[0] == std::make_pair(6u, 60000u));
+    REQUIRE(batches[1] == std::make_pair(3u, 30000u));
+
+    // Indices are relative to the start of their batch
+    REQUIRE(mesh.index(3) == 30000);
+    REQUIRE(mesh.index(5) == 59999);
+    REQUIRE(mesh.index(6) == 0);
+    REQUIRE(mesh.index(8) == 29999);
+}
+
+TEST_CASE( "Meshes above 65535 vertices are drawn at once with 32 bit indices", "[Core][TypedMesh]" ) {
+    Hardware::supportsElementIndexUint = true;
+
+    TestMesh mesh(layout, GL_TRIANGLES);
+    mesh.compile(largeMeshData());
+
+    REQUIRE(mesh.indexType() == GL_UNSIGNED_INT);
+    REQUIRE(mesh.bufferSize() == 90000 * sizeof(Vertex) + 9 * sizeof(GLuint));
+
+    auto& batches = mesh.vertexOffsets();
+    REQUIRE(batches.size() == 1);
+    REQUIRE(batches[0] == std::make_pair(9u, 90000u));
+
+    REQUIRE(mesh.index(3) == 30000);
+    REQUIRE(mesh.index(6) == 60000);
+    REQUIRE(mesh.index(8) == 89999);
+
+    // Small meshes keep 16 bit indices
+    TestMesh small(layout, GL_TRIANGLES);
+    MeshData<Vertex> meshData;
+    meshData.vertices.resize(3, {0,0,0,0});
+    meshData.indices = { 0, 1, 2 };
+    meshData.offsets.emplace_back(3, 3);
+    small.compile(meshData);
+
+    REQUIRE(small.indexType() == GL_UNSIGNED_SHORT);
+
+    Hardware::supportsElementIndexUint = false;
+}
+
+static bool bitEqual(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static Line randomLine(std::mt19937& _rng, size_t _size) {
+    std::uniform_real_distribution<float> coord(-0.5f, 1.5f);
+
+    Line line;
+    for (size_t i = 0; i < _size; i++) {
+        // Some repeated points, as in real tile data
+        if (i > 0 && _rng() % 8 == 0) {
+            line.push_back(line.back());
+        } else {
+            line.push_back({ coord(_rng), coord(_rng), 0.f });
+        }
+    }
+    return line;
+}
+
+TEST_CASE( "Batched polyline normals match the scalar path", "[Core][Builders]" ) {
+    std::mt19937 rng(0);
+    std::vector<glm::vec2> normals;
+
+    for (size_t size = 2; size < 40; size++) {
+        Line line = randomLine(rng, size);
+
+        Builders::segmentNormals(line, normals);
+        REQUIRE(normals.size() == size);
+
+        for (size_t i = 0; i < size; i++) {
+            const auto& a = line[i];
+            const auto& b = line[(i + 1) % size];
+            glm::vec2 expected = glm::normalize(glm::vec2(b.y - a.y, a.x - b.x));
+
+            bool equal = (bitEqual(normals[i].x, expected.x) && bitEqual(normals[i].y, expected.y)) ||
+                // NaN for repeated points
+                (a.x == b.x && a.y == b.y && std::isnan(normals[i].x) && std::isnan(expected.x));
+            REQUIRE(equal);
+        }
+    }
+}
+
+TEST_CASE( "Batched polyline miter scales match the scalar path", "[Core][Builders]" ) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+    std::vector<float> scales;
+
+    for (size_t size = 1; size < 40; size++) {
+        std::vector<glm::vec2> normals;
+        for (size_t i = 0; i < size; i++) {
+            float a = angle(rng);
+            normals.push_back({ std::cos(a), std::sin(a) });
+        }
+        // Opposite normals
+        if (size > 2) { normals[1] = -normals[0]; }
+
+        Builders::miterScales(normals, scales);
+        REQUIRE(scales.size() == size);
+
+        for (size_t i = 0; i < size; i++) {
+            glm::vec2 m = normals[(i + size - 1) % size] + normals[i];
+            REQUIRE(bitEqual(scales[i], 2.f / glm::dot(m, m)));
+        }
+    }
+}
+
+struct PackedLineVertex {
+    glm::i16vec4 pos;
+    glm::i16vec4 extrude;
+    GLuint abgr;
+    glm::u16vec2 texcoord;
+};
+
+TEST_CASE( "Batched polyline vertex packing matches the scalar path", "[Core][Builders]" ) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> coord(-1.5f, 2.f);
+    std::uniform_real_distribution<float> extrude(-3.f, 3.f);
+    std::uniform_real_distribution<float> uv(0.f, 7.99f);
+
+    PolyLinePackFormat format;
+    format.positionScale = 8192.f;
+    format.extrusionScale = 4096.f;
+    format.texcoordScale = 8192.f;
+    format.stride = sizeof(PackedLineVertex);
+    format.position = offsetof(PackedLineVertex, pos);
+    format.extrusion = offsetof(PackedLineVertex, extrude);
+    format.hasTexcoord = true;
+    format.texcoord = offsetof(PackedLineVertex, texcoord);
+
+    for (size_t size = 0; size < 40; size++) {
+        std::vector<PolyLineVertexData> vertices;
+        for (size_t i = 0; i < size; i++) {
+            glm::vec2 p = { coord(rng), coord(rng) };
+            // Halfway cases of the position rounding
+            if (i % 3 == 0) {
+                float h = (float(int(rng() % 20000) - 10000) + 0.5f) / 8192.f;
+                p = { h, -h };
+            }
+            vertices.push_back({ p, { extrude(rng), extrude(rng) }, { uv(rng), uv(rng) } });
+        }
+
+        std::vector<PackedLineVertex> packed(size, { {}, {}, 0xffffffff, {} });
+        Builders::packPolyLineVertices(vertices.data(), size, format, reinterpret_cast<char*>(packed.data()));
+
+        for (size_t i = 0; i < size; i++) {
+            const auto& v = vertices[i];
+            glm::i16vec2 pos{ glm::round(v.coord * 8192.f) };
+            glm::i16vec2 extrude{ v.enormal * 4096.f };
+            glm::u16vec2 texcoord(v.uv * 8192.f);
+
+            REQUIRE(std::memcmp(&packed[i].pos, &pos, sizeof(pos)) == 0);
+            REQUIRE(std::memcmp(&packed[i].extrude, &extrude, sizeof(extrude)) == 0);
+            REQUIRE(std::memcmp(&packed[i].texcoord, &texcoord, sizeof(texcoord)) == 0);
+            // Attributes outside of the format are left as they are
+            REQUIRE(packed[i].pos.z == 0);
+            REQUIRE(packed[i].abgr == 0xffffffff);
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE( "Property keys are interned", "[Core][Properties]" ) {
+
+    uint32_t a = Properties::keyId("kind");
+    uint32_t b = Properties::keyId("name");
+
+    REQUIRE(a != b);
+    REQUIRE(Properties::keyId("kind") == a);
+    REQUIRE(Properties::keyName(a) == "kind");
+    REQUIRE(Properties::keyName(b) == "name");
+}
+
+TEST_CASE( "Get properties by key and by key id", "[Core][Properties]" ) {
+
+    Properties props;
+    props.set("name", "Broadway");
+    props.set("kind", "major_road");
+    props.set("lanes", 4);
+    props.set("kind", "highway");
+
+    REQUIRE(props.items().size() == 3);
+
+    REQUIRE(props.getString("name") == "Broadway");
+    REQUIRE(props.getString("kind") == "highway");
+    REQUIRE(props.getNumber("lanes") == 4);
+    REQUIRE(!props.contains("oneway"));
+
+    REQUIRE(props.get(Properties::keyId("kind")).get<std::string>() == "highway");
+    REQUIRE(props.get(Properties::keyId("oneway")).is<none_type>());
+
+    for (auto& item : props.items()) {
+        REQUIRE(props.get(item.name()) == item.value);
+    }
+}
+
+TEST_CASE( "Property key ids stay unique beyond the first key chunks", "[Core][Properties]" ) {
+
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 5000; i++) {
+        ids.push_back(Properties::keyId("growKey" + std::to_string(i)));
+    }
+
+    std::set<uint32_t> unique(ids.begin(), ids.end());
+    REQUIRE(unique.size() == ids.size());
+
+    for (int i = 0; i < 5000; i++) {
+        REQUIRE(Properties::keyName(ids[i]) == "growKey" + std::to_string(i));
+    }
+}
+
+TEST_CASE( "KeyCache returns the interned key ids", "[Core][Properties]" ) {
+
+    Properties::KeyCache keys;
+
+    REQUIRE(keys.keyId("name") == Properties::keyId("name"));
+    REQUIRE(keys.keyId("name") == Properties::keyId("name"));
+    REQUIRE(keys.keyId("kind") == Properties::keyId("kind"));
+    REQUIRE(keys.ids.size() == 2);
+}
+
+TEST_CASE( "Looking up unknown keys does not intern them", "[Core][Properties]" ) {
+
+    uint32_t id;
+    REQUIRE(!Properties::findKeyId("neverInternedKey", id));
+
+    Properties props;
+    props.set("kind", "park");
+    REQUIRE(!props.contains("neverInternedKey"));
+    REQUIRE(!Properties::findKeyId("neverInternedKey", id));
+
+    REQUIRE(Properties::findKeyId("kind", id));
+    REQUIRE(id == Properties::keyId("kind"));
+}
+
+TEST_CASE( "Property keys interned concurrently get one id each", "[Core][Properties]" ) {
+
+    const int numKeys = 4000;
+    std::vector<std::vector<uint32_t>> ids(4);
+
+    std::vector<std::thread> threads;
+    for (auto& threadIds : ids) {
+        threads.emplace_back([&threadIds]() {
+            for (int i = 0; i < numKeys; i++) {
+                threadIds.push_back(Properties::keyId("concurrentKey" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (int i = 0; i < numKeys; i++) {
+        REQUIRE(ids[1][i] == ids[0][i]);
+        REQUIRE(ids[2][i] == ids[0][i]);
+        REQUIRE(ids[3][i] == ids[0][i]);
+        REQUIRE(Properties::keyName(ids[0][i]) == "concurrentKey" + std::to_string(i));
+    }
+}
+
+// Runs last: fills the key table up to Properties::MAX_DATA_KEYS
+TEST_CASE( "Data keys beyond the key table limit are kept by name", "[Core][Properties]" ) {
+
+    uint32_t id = Properties::keyId("kind");
+    for (int i = 0; id != Properties::NO_KEY_ID; i++) {
+        id = Properties::dataKeyId("fillKey" + std::to_string(i));
+    }
+
+    uint32_t lastKey = Properties::dataKeyId("tooManyKeys");
+    REQUIRE(lastKey == Properties::NO_KEY_ID);
+    REQUIRE(!Properties::findKeyId("tooManyKeys", id));
+
+    Properties props;
+    props.set("tooManyKeys", "yes");
+    props.set("kind", "park");
+    props.set("tooManyKeys", 3);
+
+    REQUIRE(props.items().size() == 1);
+    REQUIRE(props.getNumber("tooManyKeys") == 3);
+    REQUIRE(props.getString("kind") == "park");
+    REQUIRE(props.keySignature() == ~uint64_t(0));
+    REQUIRE(props.toJson() == "{ \"kind\": \"park\",\"tooManyKeys\": \"3.000000\" }");
+
+    // Scene keys are still interned and find the value by name
+    uint32_t sceneKey = Properties::keyId("tooManyKeys");
+    REQUIRE(props.get(sceneKey).get<double>() == 3);
+
+    props.clear();
+    REQUIRE(!props.contains("tooManyKeys"));
+}
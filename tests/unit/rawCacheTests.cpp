@@ -0,0 +1,110 @@
+#include "catch.hpp"
+
+#include "data/dataSource.h"
+#include "tile/tileTask.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Tangram;
+
+struct TestSource : DataSource {
+
+    TestSource() : DataSource("", "") {}
+
+    std::shared_ptr<TileData> parse(const TileTask& _task,
+                                    const MapProjection& _projection) const override {
+        return nullptr;
+    }
+
+    void put(TileID _tileId, size_t _size) {
+        cachePut(_tileId, std::make_shared<std::vector<char>>(_size, 'a'));
+    }
+
+    bool has(TileID _tileId) {
+        return createTask(_tileId)->hasData();
+    }
+};
+
+TEST_CASE( "RawCache counts hits and misses", "[Core][RawCache]" ) {
+
+    auto source = std::make_shared<TestSource>();
+    source->setCacheSize(1000);
+
+    source->put(TileID(0, 0, 1), 100);
+    source->put(TileID(1, 0, 1), 200);
+
+    REQUIRE(source->has(TileID(0, 0, 1)));
+    REQUIRE(source->has(TileID(1, 0, 1)));
+    REQUIRE(!source->has(TileID(0, 1, 1)));
+
+    auto stats = source->cacheStats();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.evictions == 0);
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.usage == 300);
+    REQUIRE(stats.maxUsage == 1000);
+
+    // Replacing an entry does not count its old data
+    source->put(TileID(0, 0, 1), 50);
+    stats = source->cacheStats();
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.usage == 250);
+
+    source->clearData();
+    stats = source->cacheStats();
+    REQUIRE(stats.entries == 0);
+    REQUIRE(stats.usage == 0);
+}
+
+TEST_CASE( "RawCache evicts to stay within its size", "[Core][RawCache]" ) {
+
+    auto source = std::make_shared<TestSource>();
+    source->setCacheSize(1000);
+
+    for (int x = 0; x < 64; x++) {
+        source->put(TileID(x, 0, 6), 100);
+
+        auto stats = source->cacheStats();
+        REQUIRE(stats.usage <= 1000);
+        REQUIRE(stats.usage == stats.entries * 100);
+    }
+
+    auto stats = source->cacheStats();
+    REQUIRE(stats.evictions == 64 - stats.entries);
+    // Shards may exceed their share while others have room
+    REQUIRE(stats.entries >= 9);
+
+    // The most recent tile is always kept
+    REQUIRE(source->has(TileID(63, 0, 6)));
+}
+
+TEST_CASE( "RawCache keeps tiles larger than a shard share", "[Core][RawCache]" ) {
+
+    auto source = std::make_shared<TestSource>();
+    source->setCacheSize(1000);
+
+    for (int x = 0; x < 4; x++) {
+        source->put(TileID(x, 0, 2), 100);
+    }
+
+    // Larger than maxUsage / number of shards: evicts only what is needed
+    source->put(TileID(0, 1, 2), 500);
+
+    auto stats = source->cacheStats();
+    REQUIRE(stats.evictions == 0);
+    REQUIRE(stats.usage == 900);
+    REQUIRE(source->has(TileID(0, 1, 2)));
+
+    source->put(TileID(1, 1, 2), 300);
+    stats = source->cacheStats();
+    REQUIRE(stats.usage <= 1000);
+    REQUIRE(stats.evictions > 0);
+    REQUIRE(source->has(TileID(1, 1, 2)));
+
+    // Tiles larger than the whole cache are not cached
+    source->put(TileID(2, 1, 2), 2000);
+    REQUIRE(!source->has(TileID(2, 1, 2)));
+    REQUIRE(source->cacheStats().usage <= 1000);
+}
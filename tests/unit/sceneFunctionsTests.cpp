@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+#include "yaml-cpp/yaml.h"
+#include "scene/nativeFunction.h"
+
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+// Collects the YAML files in _dir and its subdirectories
+static void findScenes(const std::string& _dir, std::vector<std::string>& _scenes) {
+    DIR* dir = opendir(_dir.c_str());
+    if (!dir) { return; }
+
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") { continue; }
+
+        std::string path = _dir + "/" + name;
+        if (entry->d_type == DT_DIR) {
+            findScenes(path, _scenes);
+        } else if (name.size() > 5 && name.compare(name.size() - 5, 5, ".yaml") == 0) {
+            _scenes.push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+// Collects the scalars SceneLoader would load as JS functions
+static void findFunctions(const YAML::Node& _node, std::vector<std::string>& _functions) {
+    switch (_node.Type()) {
+    case YAML::NodeType::Scalar: {
+        const std::string& val = _node.Scalar();
+        if (val.compare(0, 8, "function") == 0) {
+            _functions.push_back(val);
+        }
+        break;
+    }
+    case YAML::NodeType::Sequence:
+        for (const auto& item : _node) {
+            findFunctions(item, _functions);
+        }
+        break;
+    case YAML::NodeType::Map:
+        for (const auto& item : _node) {
+            findFunctions(item.second, _functions);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+TEST_CASE("All functions of the bundled scenes compile natively", "[Core][NativeFunction]") {
+
+    std::vector<std::string> scenes;
+    findScenes(SCENES_DIR, scenes);
+
+    REQUIRE(!scenes.empty());
+
+    size_t count = 0;
+
+    for (const auto& scene : scenes) {
+        std::vector<std::string> functions;
+        findFunctions(YAML::LoadFile(scene), functions);
+
+        for (const auto& function : functions) {
+            INFO(scene << ": " << function);
+            NativeFunction native;
+            REQUIRE(native.compile(function));
+            REQUIRE(native.valid());
+        }
+        count += functions.size();
+    }
+
+    REQUIRE(count > 0);
+}
@@ -0,0 +1,103 @@
+#include "catch.hpp"
+
+#include "util/simplify.h"
+
+#include <cmath>
+
+using namespace Tangram;
+
+TEST_CASE( "simplifyLine removes points within the tolerance", "[Core][Simplify]" ) {
+
+    Line line = {
+        {0.f, 0.f, 0.f},
+        {0.25f, 0.001f, 0.f},
+        {0.5f, -0.001f, 0.f},
+        {0.75f, 0.001f, 0.f},
+        {1.f, 0.f, 0.f},
+        {1.f, 1.f, 0.f},
+    };
+
+    SECTION( "Disabled" ) {
+        REQUIRE(simplifyLine(line, 0) == 0);
+        REQUIRE(line.size() == 6);
+    }
+
+    SECTION( "Below tolerance" ) {
+        REQUIRE(simplifyLine(line, 0.01f) == 3);
+        REQUIRE(line.size() == 3);
+        REQUIRE(line[0] == Point(0.f, 0.f, 0.f));
+        REQUIRE(line[1] == Point(1.f, 0.f, 0.f));
+        REQUIRE(line[2] == Point(1.f, 1.f, 0.f));
+    }
+
+    SECTION( "Above tolerance" ) {
+        REQUIRE(simplifyLine(line, 0.0001f) == 0);
+        REQUIRE(line.size() == 6);
+    }
+}
+
+TEST_CASE( "simplifyLine keeps the points farther than the tolerance", "[Core][Simplify]" ) {
+
+    Line line;
+    const int n = 1000;
+    for (int i = 0; i < n; i++) {
+        float x = float(i) / (n - 1);
+        line.push_back({ x, std::sin(x * 6.f) * 0.25f, float(i) });
+    }
+    Line original = line;
+
+    float tolerance = 0.002f;
+    simplifyLine(line, tolerance);
+
+    REQUIRE(line.size() < original.size() / 10);
+    REQUIRE(line.front() == original.front());
+    REQUIRE(line.back() == original.back());
+
+    // Every removed point is within the tolerance of the simplified line
+    size_t j = 0;
+    for (auto& p : original) {
+        while (j + 1 < line.size() && line[j + 1].x < p.x) { j++; }
+        if (j + 1 == line.size()) { break; }
+
+        auto& a = line[j];
+        auto& b = line[j + 1];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float distance = std::abs(dy * (p.x - a.x) - dx * (p.y - a.y)) / std::sqrt(dx * dx + dy * dy);
+        REQUIRE(distance <= tolerance * 1.001f);
+    }
+}
+
+TEST_CASE( "simplifyPolygon keeps rings closed", "[Core][Simplify]" ) {
+
+    Line ring;
+    const int n = 200;
+    for (int i = 0; i < n; i++) {
+        float a = float(i) / n * 6.2831853f;
+        ring.push_back({ std::cos(a), std::sin(a), 0.f });
+    }
+    ring.push_back(ring.front());
+
+    // A hole that collapses to less than a triangle
+    Line hole = {
+        {0.f, 0.f, 0.f},
+        {0.001f, 0.f, 0.f},
+        {0.001f, 0.001f, 0.f},
+        {0.f, 0.001f, 0.f},
+        {0.f, 0.f, 0.f},
+    };
+
+    Polygon polygon = { ring, hole };
+
+    simplifyPolygon(polygon, 0.01f);
+
+    REQUIRE(polygon.size() == 2);
+
+    auto& outer = polygon[0];
+    REQUIRE(outer.size() >= 4);
+    REQUIRE(outer.size() < ring.size());
+    REQUIRE(outer.front() == outer.back());
+    REQUIRE(outer.front() == ring.front());
+
+    REQUIRE(polygon[1].size() == 5);
+}
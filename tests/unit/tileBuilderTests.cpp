@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include "yaml-cpp/yaml.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "gl/renderState.h"
+#include "gl/shaderProgram.h"
+#include "scene/scene.h"
+#include "scene/sceneLoader.h"
+#include "style/style.h"
+#include "tile/tile.h"
+#include "tile/tileBuilder.h"
+
+#include "gl_mock.h"
+
+using namespace Tangram;
+
+// Runs the first part with the calling TileBuilder and the others with a
+// TileBuilder of another worker, like TileWorker does with idle workers
+struct TestExecutor : TileBuildExecutor {
+
+    std::shared_ptr<Scene> scene;
+    size_t parts;
+    size_t jobs = 0;
+
+    TestExecutor(std::shared_ptr<Scene> _scene, size_t _parts) : scene(_scene), parts(_parts) {}
+
+    size_t splitCount(size_t _features) const override { return parts; }
+
+    void execute(TileBuilder& _builder, std::vector<Job>& _jobs) override {
+        jobs = _jobs.size();
+        TileBuilder other(scene);
+        for (size_t i = 0; i < _jobs.size(); i++) {
+            _jobs[i](i == 0 ? _builder : other);
+        }
+    }
+};
+
+static std::shared_ptr<Scene> loadScene() {
+    auto scene = std::make_shared<Scene>();
+
+    scene->config() = YAML::Load(R"END(
+        sources:
+            src:
+                type: GeoJSON
+                url: https://example.com/{z}/{x}/{y}.json
+        layers:
+            earth:
+                data: { source: src }
+                draw:
+                    polygons: { order: 0, color: '#f00' }
+            roads:
+                data: { source: src }
+                filter: { kind: major }
+                draw:
+                    lines: { order: 1, color: white, width: 2px }
+            water:
+                data: { source: src }
+                draw:
+                    polygons: { order: 2, color: blue, extrude: true }
+                    lines: { order: 3, color: black, width: 1px }
+        )END");
+
+    SceneLoader::applyConfig(scene);
+
+    return scene;
+}
+
+static TileData createTileData() {
+    TileData data;
+
+    for (auto name : { "earth", "roads", "water" }) {
+        data.layers.emplace_back(name);
+        auto& layer = data.layers.back();
+
+        for (int i = 0; i < 20; i++) {
+            float x = 0.04f * i;
+
+            Feature line;
+            line.geometryType = GeometryType::lines;
+            line.lines.push_back({ {x, 0.1f, 0.f}, {x + 0.1f, 0.5f, 0.f}, {x, 0.9f, 0.f} });
+            line.props.set("kind", i % 2 ? "major" : "minor");
+            layer.features.push_back(std::move(line));
+
+            Feature polygon;
+            polygon.geometryType = GeometryType::polygons;
+            polygon.polygons.push_back({ { {x, 0.f, 0.f}, {x + 0.03f, 0.f, 0.f},
+                                           {x + 0.03f, 0.03f, 0.f}, {x, 0.f, 0.f} } });
+            polygon.props.set("height", 10.0 * i);
+            layer.features.push_back(std::move(polygon));
+        }
+    }
+
+    return data;
+}
+
+// Returns the vertex and index data uploaded for _mesh
+static std::vector<char> meshData(RenderState& _rs, const Style& _style, const std::unique_ptr<StyledMesh>& _mesh) {
+    GLMock::bufferUploads().clear();
+    if (_mesh) { _mesh->draw(_rs, *_style.getShaderProgram()); }
+    return GLMock::bufferUploads();
+}
+
+TEST_CASE("Tiles built in parts have the meshes of a serial build", "[Core][TileBuilder]") {
+
+    auto scene = loadScene();
+    auto source = *scene->dataSources().begin();
+    auto data = createTileData();
+    TileID tileId(0, 0, 10);
+
+    RenderState rs;
+    TileBuilder builder(scene);
+
+    auto serial = builder.build(tileId, data, *source);
+
+    // Meshes release their data once uploaded, record it only once
+    std::vector<std::vector<char>> serialData;
+    for (auto& style : scene->styles()) {
+        serialData.push_back(meshData(rs, *style, serial->getMesh(*style)));
+    }
+
+    for (size_t parts : { 2, 3, 8 }) {
+        TestExecutor executor(scene, parts);
+        builder.setExecutor(&executor);
+
+        auto split = builder.build(tileId, data, *source);
+
+        builder.setExecutor(nullptr);
+
+        size_t meshes = 0;
+
+        for (auto& style : scene->styles()) {
+            auto& a = serial->getMesh(*style);
+            auto& b = split->getMesh(*style);
+
+            REQUIRE(bool(a) == bool(b));
+            if (!a) { continue; }
+
+            meshes++;
+            REQUIRE(a->bufferSize() == b->bufferSize());
+            REQUIRE(!serialData[style->getID()].empty());
+            REQUIRE(meshData(rs, *style, b) == serialData[style->getID()]);
+        }
+
+        REQUIRE(meshes == 2);
+
+        // Only the polygons and lines styles have features
+        REQUIRE(executor.jobs == std::min<size_t>(parts, 2));
+    }
+}
@@ -115,7 +115,7 @@ TEST_CASE( "Use proxy Tile - Dont remove proxy if it is now visible", "[TileMana
     tileManager.setDataSources(sources);
 
     /// Start loading tile 0/0/0
-    std::set<TileID> visibleTiles_1 = { TileID{0,0,0} };
+    VisibleTiles visibleTiles_1({ TileID{0,0,0} });
     tileManager.updateTileSets(viewState, visibleTiles_1);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -123,7 +123,7 @@ TEST_CASE( "Use proxy Tile - Dont remove proxy if it is now visible", "[TileMana
     REQUIRE(worker.processedCount == 0);
 
     /// Start loading tile 0/0/1 - uses 0/0/0 as proxy
-    std::set<TileID> visibleTiles_2 = { TileID{0,0,1} };
+    VisibleTiles visibleTiles_2({ TileID{0,0,1} });
     tileManager.updateTileSets(viewState, visibleTiles_2);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -170,7 +170,7 @@ TEST_CASE( "Load visible Tile", "[TileManager][updateTileSets]" ) {
     std::vector<std::shared_ptr<DataSource>> sources = { source };
     tileManager.setDataSources(sources);
 
-    std::set<TileID> visibleTiles = { TileID{0,0,0} };
+    VisibleTiles visibleTiles({ TileID{0,0,0} });
     tileManager.updateTileSets(viewState, visibleTiles);
     worker.processTask();
 
@@ -196,7 +196,7 @@ TEST_CASE( "Use proxy Tile", "[TileManager][updateTileSets]" ) {
     std::vector<std::shared_ptr<DataSource>> sources = { source };
     tileManager.setDataSources(sources);
 
-    std::set<TileID> visibleTiles = { TileID{0,0,0} };
+    VisibleTiles visibleTiles({ TileID{0,0,0} });
     tileManager.updateTileSets(viewState, visibleTiles);
     worker.processTask();
 
@@ -204,7 +204,7 @@ TEST_CASE( "Use proxy Tile", "[TileManager][updateTileSets]" ) {
     REQUIRE(source->tileTaskCount == 1);
     REQUIRE(worker.processedCount == 1);
 
-    std::set<TileID> visibleTiles2 = { TileID{0,0,1} };
+    VisibleTiles visibleTiles2({ TileID{0,0,1} });
     tileManager.updateTileSets(viewState, visibleTiles2);
     worker.processTask();
 
@@ -236,7 +236,7 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     tileManager.setDataSources(sources);
 
     /// Start loading tile 0/0/0
-    std::set<TileID> visibleTiles_1 = { TileID{0,0,0} };
+    VisibleTiles visibleTiles_1({ TileID{0,0,0} });
     tileManager.updateTileSets(viewState, visibleTiles_1);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -244,7 +244,7 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(worker.processedCount == 0);
 
     /// Start loading tile 0/0/1 - add 0/0/0 as proxy
-    std::set<TileID> visibleTiles_2 = { TileID{0,0,1} };
+    VisibleTiles visibleTiles_2({ TileID{0,0,1} });
     tileManager.updateTileSets(viewState, visibleTiles_2);
 
     REQUIRE(tileManager.getVisibleTiles().size() == 0);
@@ -273,3 +273,219 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,0));
 
 }
+
+TEST_CASE( "Prefetch tiles", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TileManager tileManager(worker);
+    ViewState viewState { &s_projection, true, glm::vec2(0), 1 };
+
+    auto source = std::make_shared<TestDataSource>();
+    std::vector<std::shared_ptr<DataSource>> sources = { source };
+    tileManager.setDataSources(sources);
+
+    /// Load visible tile 0/0/1 and tile 1/0/1 ahead
+    VisibleTiles visibleTiles_1({ TileID{0,0,1} });
+    VisibleTiles prefetchTiles({ TileID{0,0,1}, TileID{1,0,1} });
+    tileManager.updateTileSets(viewState, visibleTiles_1, prefetchTiles);
+
+    REQUIRE(source->tileTaskCount == 2);
+    REQUIRE(tileManager.prefetchStats().requested == 1);
+
+    REQUIRE(worker.tasks.size() == 2);
+    // The prefetch task is ranked behind the visible tile
+    REQUIRE(worker.tasks[0]->tileId() == TileID(0,0,1));
+    REQUIRE(worker.tasks[0]->isProxy() == false);
+    REQUIRE(worker.tasks[1]->tileId() == TileID(1,0,1));
+    REQUIRE(worker.tasks[1]->isProxy() == true);
+
+    worker.processTask();
+    worker.processTask();
+    tileManager.updateTileSets(viewState, visibleTiles_1, prefetchTiles);
+
+    // Only the visible tile is drawn
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,1));
+
+    /// Move to tile 1/0/1, it is ready without loading
+    VisibleTiles visibleTiles_2({ TileID{1,0,1} });
+    tileManager.updateTileSets(viewState, visibleTiles_2, prefetchTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(1,0,1));
+    REQUIRE(source->tileTaskCount == 2);
+    REQUIRE(tileManager.prefetchStats().hits == 1);
+    REQUIRE(tileManager.prefetchStats().misses == 0);
+
+    /// Prefetch 0/1/1 and 1/1/1 with a budget of one tile, then drop the prediction
+    tileManager.setPrefetchBudget(1);
+    VisibleTiles prefetchTiles_2({ TileID{0,1,1}, TileID{1,1,1} });
+    tileManager.updateTileSets(viewState, visibleTiles_2, prefetchTiles_2);
+
+    REQUIRE(source->tileTaskCount == 3);
+    REQUIRE(tileManager.prefetchStats().requested == 2);
+
+    tileManager.updateTileSets(viewState, visibleTiles_2, VisibleTiles());
+
+    REQUIRE(worker.tasks.back()->isCanceled() == true);
+    REQUIRE(tileManager.prefetchStats().hits == 1);
+    REQUIRE(tileManager.prefetchStats().misses == 1);
+    REQUIRE(tileManager.prefetchStats().hitRate() == 0.5f);
+}
+
+TEST_CASE( "Apply changes of the visible tiles to a loaded tile set", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TileManager tileManager(worker);
+    ViewState viewState { &s_projection, true, glm::vec2(0), 1 };
+
+    auto source = std::make_shared<TestDataSource>();
+    std::vector<std::shared_ptr<DataSource>> sources = { source };
+    tileManager.setDataSources(sources);
+
+    /// Load tiles 0/0/1 and 1/0/1, and tile 1/1/1 ahead
+    std::vector<TileID> scan = { TileID{0,0,1}, TileID{1,0,1} };
+    VisibleTiles visibleTiles(scan);
+    VisibleTiles prefetchTiles({ TileID{1,1,1} });
+    tileManager.updateTileSets(viewState, visibleTiles, prefetchTiles);
+
+    while (!worker.tasks.empty()) { worker.processTask(); }
+    tileManager.updateTileSets(viewState, visibleTiles, prefetchTiles);
+
+    REQUIRE(source->tileTaskCount == 3);
+    REQUIRE(tileManager.getVisibleTiles().size() == 2);
+    REQUIRE(!tileManager.hasLoadingTiles());
+
+    /// Pan: 0/0/1 goes out of view, 0/1/1 needs loading and 1/1/1 was prefetched
+    scan = { TileID{1,0,1}, TileID{0,1,1}, TileID{1,1,1} };
+    visibleTiles.update(scan);
+    tileManager.updateTileSets(viewState, visibleTiles, prefetchTiles);
+
+    REQUIRE(source->tileTaskCount == 4);
+    REQUIRE(tileManager.hasLoadingTiles());
+    REQUIRE(tileManager.prefetchStats().hits == 1);
+    REQUIRE(tileManager.getVisibleTiles().size() == 2);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(1,0,1));
+    REQUIRE(tileManager.getVisibleTiles()[1]->getID() == TileID(1,1,1));
+
+    while (!worker.tasks.empty()) { worker.processTask(); }
+    tileManager.updateTileSets(viewState, visibleTiles, prefetchTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 3);
+
+    /// Pan back: 0/0/1 is taken from the cache
+    scan = { TileID{0,0,1}, TileID{1,0,1} };
+    visibleTiles.update(scan);
+    tileManager.updateTileSets(viewState, visibleTiles, prefetchTiles);
+
+    REQUIRE(source->tileTaskCount == 4);
+    REQUIRE(!tileManager.hasLoadingTiles());
+    REQUIRE(tileManager.getVisibleTiles().size() == 2);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,1));
+    REQUIRE(tileManager.getVisibleTiles()[1]->getID() == TileID(1,0,1));
+}
+
+TEST_CASE( "Keep drawing proxies of canceled tiles when applying changes", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TileManager tileManager(worker);
+    ViewState viewState { &s_projection, true, glm::vec2(0), 1 };
+
+    auto source = std::make_shared<TestDataSource>();
+    std::vector<std::shared_ptr<DataSource>> sources = { source };
+    tileManager.setDataSources(sources);
+
+    /// Load tile 0/0/1
+    std::vector<TileID> scan = { TileID{0,0,1} };
+    VisibleTiles visibleTiles(scan);
+    tileManager.updateTileSets(viewState, visibleTiles);
+    worker.processTask();
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+
+    /// Zoom in: 0/0/2 uses 0/0/1 as proxy, then its task fails
+    scan = { TileID{0,0,2} };
+    visibleTiles.update(scan);
+    tileManager.updateTileSets(viewState, visibleTiles);
+    worker.dropTask();
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(!tileManager.hasLoadingTiles());
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,1));
+
+    /// Pan: 0/0/2 stays in view and still needs its proxy, 2/0/2 has none
+    scan = { TileID{0,0,2}, TileID{2,0,2} };
+    visibleTiles.update(scan);
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,1));
+    REQUIRE(tileManager.getVisibleTiles()[0]->isProxy() == true);
+}
+
+TEST_CASE( "Pan by one tile while a proxy is drawn", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TileManager tileManager(worker);
+    ViewState viewState { &s_projection, true, glm::vec2(0), 1 };
+
+    auto source = std::make_shared<TestDataSource>();
+    std::vector<std::shared_ptr<DataSource>> sources = { source };
+    tileManager.setDataSources(sources);
+
+    /// Load tile 0/0/1
+    std::vector<TileID> scan = { TileID{0,0,1} };
+    VisibleTiles visibleTiles(scan);
+    tileManager.updateTileSets(viewState, visibleTiles);
+    worker.processTask();
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    /// Zoom in: 0/0/2 and 1/0/2 use 0/0/1 as proxy, then their tasks fail
+    scan = { TileID{0,0,2}, TileID{1,0,2} };
+    visibleTiles.update(scan);
+    tileManager.updateTileSets(viewState, visibleTiles);
+    while (!worker.tasks.empty()) { worker.dropTask(); }
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(!tileManager.hasLoadingTiles());
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,1));
+
+    /// Pan by one tile: 0/0/2 goes out of view, 2/0/2 comes into view
+    scan = { TileID{1,0,2}, TileID{2,0,2} };
+    visibleTiles.update(scan);
+
+    REQUIRE(visibleTiles.added() == std::vector<TileID>({ TileID{2,0,2} }));
+    REQUIRE(visibleTiles.removed() == std::vector<TileID>({ TileID{0,0,2} }));
+
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    // 1/0/2 still needs the proxy
+    REQUIRE(tileManager.hasLoadingTiles());
+    REQUIRE(tileManager.getVisibleTiles().size() == 1);
+    REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,1));
+    REQUIRE(tileManager.getVisibleTiles()[0]->isProxy() == true);
+}
+
+TEST_CASE( "Reload tiles whose task stems from an older source generation", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TileManager tileManager(worker);
+    ViewState viewState { &s_projection, true, glm::vec2(0), 1 };
+
+    auto source = std::make_shared<TestDataSource>();
+    std::vector<std::shared_ptr<DataSource>> sources = { source };
+    tileManager.setDataSources(sources);
+
+    std::vector<TileID> scan = { TileID{0,0,1} };
+    VisibleTiles visibleTiles(scan);
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(worker.tasks.size() == 1);
+
+    /// The source changes while the task is queued
+    source->clearData();
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(worker.tasks.size() == 2);
+    REQUIRE(worker.tasks[0]->isCanceled());
+    REQUIRE(!worker.tasks[1]->isCanceled());
+    REQUIRE(worker.tasks[1]->sourceGeneration() == source->generation());
+}
@@ -0,0 +1,87 @@
+#include "catch.hpp"
+
+#include "tile/tileMap.h"
+
+#include <map>
+#include <memory>
+#include <random>
+
+using namespace Tangram;
+
+TEST_CASE( "Packed TileIDs are ordered like TileIDs", "[Core][TileMap]" ) {
+
+    std::vector<TileID> ids = { TileID(0, 0, 0), TileID(1, 0, 1), TileID(0, 1, 1), TileID(1, 1, 1, 1, -1),
+                                TileID(1, 1, 1, 1, 2), TileID(5, 3, 2, 4, 0), TileID(5, 3, 2, 2, 0),
+                                TileID((1 << 20) - 1, 7, 20) };
+
+    for (auto& a : ids) {
+        for (auto& b : ids) {
+            REQUIRE((a < b) == (packTileID(a) < packTileID(b)));
+        }
+    }
+}
+
+TEST_CASE( "TileMap behaves like a std::map", "[Core][TileMap]" ) {
+
+    TileMap<int> tiles;
+    std::map<TileID, int> reference;
+
+    std::mt19937 random(1);
+
+    for (int i = 0; i < 5000; i++) {
+        int z = random() % 4;
+        TileID id(random() % (1 << z), random() % (1 << z), z);
+
+        if (random() % 3 == 0) {
+            REQUIRE(tiles.erase(id) == (reference.erase(id) == 1));
+        } else {
+            auto result = tiles.emplace(id, i);
+            auto expected = reference.emplace(id, i);
+            REQUIRE(result.second == expected.second);
+            REQUIRE(result.first->value == expected.first->second);
+        }
+        REQUIRE(tiles.size() == reference.size());
+    }
+
+    auto& sorted = tiles.sorted();
+    REQUIRE(sorted.size() == reference.size());
+
+    size_t i = 0;
+    for (auto& it : reference) {
+        REQUIRE(sorted[i]->id == it.first);
+        REQUIRE(sorted[i]->value == it.second);
+        REQUIRE(tiles.find(it.first) == sorted[i]);
+        i++;
+    }
+
+    // Iteration is in TileID order as well
+    i = 0;
+    for (auto& entry : tiles) {
+        REQUIRE(&entry == sorted[i++]);
+    }
+}
+
+TEST_CASE( "TileMap entries stay in place and are destroyed", "[Core][TileMap]" ) {
+
+    auto counter = std::make_shared<int>(0);
+
+    TileMap<std::shared_ptr<int>> tiles;
+    auto* first = tiles.emplace(TileID(0, 0, 0), counter).first;
+
+    for (int x = 0; x < 64; x++) {
+        tiles.emplace(TileID(x, 0, 6), counter);
+    }
+    REQUIRE(tiles.find(TileID(0, 0, 0)) == first);
+    REQUIRE(counter.use_count() == 66);
+
+    tiles.erase(TileID(3, 0, 6));
+    REQUIRE(counter.use_count() == 65);
+
+    TileMap<std::shared_ptr<int>> moved;
+    moved = std::move(tiles);
+    REQUIRE(moved.size() == 64);
+    REQUIRE(tiles.empty());
+
+    moved.clear();
+    REQUIRE(counter.use_count() == 1);
+}
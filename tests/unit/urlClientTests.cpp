@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include "urlClient.h"
+#include "httpServer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace Tangram;
+
+struct Responses {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::string> urls;
+    std::vector<size_t> sizes;
+
+    UrlCallback callback(const std::string& _url) {
+        return [this, _url](std::vector<char>&& _content) {
+            std::lock_guard<std::mutex> lock(mutex);
+            urls.push_back(_url);
+            sizes.push_back(_content.size());
+            condition.notify_all();
+        };
+    }
+
+    bool wait(size_t _count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(10),
+                                  [&]{ return urls.size() >= _count; });
+    }
+};
+
+TEST_CASE( "UrlClient fetches many urls over few connections", "[Platform][UrlClient]" ) {
+
+    HttpServer server;
+    Responses responses;
+
+    UrlClient::Options options;
+    options.maxHostConnections = 2;
+    UrlClient client(options);
+
+    const size_t count = 50;
+    for (size_t i = 0; i < count; i++) {
+        auto url = server.url() + "/" + std::to_string(i) + "?size=" + std::to_string(1000 + i);
+        REQUIRE(client.addRequest(url, responses.callback(url)));
+    }
+
+    REQUIRE(responses.wait(count));
+
+    for (size_t i = 0; i < count; i++) {
+        auto url = responses.urls[i];
+        REQUIRE(responses.sizes[i] == 1000 + std::stoul(url.substr(url.rfind('/') + 1)));
+    }
+
+    // Connections are reused
+    REQUIRE(server.connections() <= 2);
+
+    auto stats = client.stats();
+    REQUIRE(stats.completed == count);
+    REQUIRE(stats.pending == 0);
+}
+
+TEST_CASE( "UrlClient starts requests in the order they were added", "[Platform][UrlClient]" ) {
+
+    HttpServer server;
+    Responses responses;
+
+    UrlClient::Options options;
+    options.maxActiveTransfers = 1;
+    UrlClient client(options);
+
+    // Keep the only transfer slot busy while the other requests are queued
+    auto first = server.url() + "/first?delay=200";
+    client.addRequest(first, responses.callback(first));
+
+    auto a = server.url() + "/a";
+    auto b = server.url() + "/b";
+    auto c = server.url() + "/c";
+    client.addRequest(b, responses.callback(b));
+    client.addRequest(a, responses.callback(a));
+    client.addRequest(c, responses.callback(c));
+
+    REQUIRE(responses.wait(4));
+    REQUIRE(responses.urls == std::vector<std::string>({ first, b, a, c }));
+}
+
+TEST_CASE( "UrlClient cancels pending and active requests", "[Platform][UrlClient]" ) {
+
+    HttpServer server;
+    Responses responses;
+
+    UrlClient::Options options;
+    options.maxActiveTransfers = 1;
+    UrlClient client(options);
+
+    auto active = server.url() + "/active?delay=200";
+    auto pending = server.url() + "/pending";
+    auto last = server.url() + "/last";
+
+    client.addRequest(active, responses.callback(active));
+    client.addRequest(pending, responses.callback(pending));
+    client.addRequest(last, responses.callback(last));
+
+    client.cancelRequest(pending);
+    client.cancelRequest(active);
+
+    REQUIRE(responses.wait(1));
+    REQUIRE(responses.urls == std::vector<std::string>({ last }));
+
+    auto stats = client.stats();
+    REQUIRE(stats.canceled == 2);
+    REQUIRE(stats.completed == 1);
+}
+
+TEST_CASE( "UrlClient merges requests for the same url", "[Platform][UrlClient]" ) {
+
+    HttpServer server;
+    Responses responses;
+    UrlClient client;
+
+    auto url = server.url() + "/tile?size=4096&delay=50";
+    client.addRequest(url, responses.callback(url));
+    client.addRequest(url, responses.callback(url));
+
+    REQUIRE(responses.wait(2));
+    REQUIRE(responses.sizes == std::vector<size_t>({ 4096, 4096 }));
+    REQUIRE(server.requests() == 1);
+}
+
+TEST_CASE( "UrlClient returns empty content for failed requests", "[Platform][UrlClient]" ) {
+
+    HttpServer server;
+    Responses responses;
+    UrlClient client;
+
+    auto url = server.url() + "/missing?status=404";
+    client.addRequest(url, responses.callback(url));
+
+    REQUIRE(responses.wait(1));
+    REQUIRE(responses.sizes[0] == 0);
+    REQUIRE(client.stats().failed == 1);
+
+    client.stop();
+    REQUIRE(!client.addRequest(url, responses.callback(url)));
+}
@@ -0,0 +1,55 @@
+#include "catch.hpp"
+
+#include "tile/visibleTiles.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE( "VisibleTiles are sorted and unique", "[Core][VisibleTiles]" ) {
+
+    std::vector<TileID> scan = { TileID(1, 0, 1), TileID(0, 0, 0), TileID(0, 0, 1), TileID(1, 0, 1) };
+
+    VisibleTiles visible;
+    visible.update(scan);
+
+    REQUIRE(visible.tiles() == std::vector<TileID>({ TileID(0, 0, 1), TileID(1, 0, 1), TileID(0, 0, 0) }));
+    REQUIRE(visible.added() == visible.tiles());
+    REQUIRE(visible.removed().empty());
+}
+
+TEST_CASE( "VisibleTiles track added and removed tiles", "[Core][VisibleTiles]" ) {
+
+    VisibleTiles visible({ TileID(0, 0, 1), TileID(1, 0, 1) });
+    auto version = visible.version();
+
+    std::vector<TileID> scan = { TileID(1, 1, 1), TileID(1, 0, 1) };
+    visible.update(scan);
+
+    REQUIRE(visible.added() == std::vector<TileID>({ TileID(1, 1, 1) }));
+    REQUIRE(visible.removed() == std::vector<TileID>({ TileID(0, 0, 1) }));
+    REQUIRE(visible.version() > version);
+    REQUIRE(visible.previousVersion() == version);
+
+    // Same tiles: no changes, same version
+    version = visible.version();
+    scan = { TileID(1, 0, 1), TileID(1, 1, 1) };
+    visible.update(scan);
+
+    REQUIRE(visible.added().empty());
+    REQUIRE(visible.removed().empty());
+    REQUIRE(visible.version() == version);
+    REQUIRE(visible.previousVersion() == version);
+
+    visible.clear();
+    REQUIRE(visible.empty());
+    REQUIRE(visible.removed().size() == 2);
+}
+
+TEST_CASE( "VisibleTiles versions are unique across instances", "[Core][VisibleTiles]" ) {
+
+    VisibleTiles a({ TileID(0, 0, 0) });
+    VisibleTiles b({ TileID(0, 0, 0) });
+
+    REQUIRE(a.version() != b.version());
+}
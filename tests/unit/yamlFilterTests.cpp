@@ -5,6 +5,7 @@
 
 #include "yaml-cpp/yaml.h"
 #include "scene/filters.h"
+#include "scene/filterProgram.h"
 #include "data/tileData.h"
 #include "scene/sceneLoader.h"
 #include "scene/scene.h"
@@ -247,3 +248,67 @@ TEST_CASE("Sequences in filters implicitly create an 'any' filter", "[filters][c
     REQUIRE(filter.eval(bmw1, ctx));
     REQUIRE(!filter.eval(bike, ctx));
 }
+
+TEST_CASE("Compiled filters evaluate like the filter tree", "[filters][core][yaml]") {
+    init();
+
+    std::vector<std::string> filters = {
+        "filter: { series: !!str 3}",
+        "filter: { wheel: [ 2, 4 ] }",
+        "filter: { any: [ { brand: 'bmw' }, { drive: 'fwd' } ] }",
+        "filter: { all: [ { type: car }, { serial: { min: 1, max: 4398046511105 } } ] }",
+        "filter: { none: [ { check: true }, { wheel: 2 } ] }",
+        "filter: { check: false, $geometry: 1 }",
+        "filter: [ { brand: 'bmw' }, { type: 'car' } ]",
+        "filter: 'function() { return feature.wheel > 3; }'",
+    };
+
+    for (auto& yaml : filters) {
+        Filter filter = load(yaml);
+        FilterProgram program(filter);
+
+        for (auto* feature : { &civic, &bmw1, &bike }) {
+            REQUIRE(program.eval(*feature, ctx) == filter.eval(*feature, ctx));
+
+            // Cached property lookups
+            ctx.setFeature(*feature);
+            REQUIRE(program.eval(*feature, ctx) == filter.eval(*feature, ctx));
+        }
+        ctx.clear();
+    }
+}
+
+TEST_CASE("Compiled filters reject features without the required keys", "[filters][core][yaml]") {
+    init();
+
+    auto keyBit = [](const std::string& _key) {
+        return Properties::keyBit(Properties::keyId(_key));
+    };
+
+    REQUIRE(FilterProgram(load("filter: { brand: bmw }")).keySignature() == keyBit("brand"));
+    REQUIRE(FilterProgram(load("filter: { check: true }")).keySignature() == keyBit("check"));
+    REQUIRE(FilterProgram(load("filter: { any: [ { brand: 'bmw' }, { drive: 'fwd' } ] }")).keySignature() ==
+            (keyBit("brand") | keyBit("drive")));
+
+    auto all = FilterProgram(load("filter: { all: [ { type: car }, { serial: { min: 1, max: 4 } } ] }"));
+    REQUIRE((all.keySignature() == keyBit("type") || all.keySignature() == keyBit("serial")));
+
+    // Filters that can pass without any of the tested properties
+    REQUIRE(FilterProgram(load("filter: { check: false }")).keySignature() == 0);
+    REQUIRE(FilterProgram(load("filter: { $zoom: { min: 10 } }")).keySignature() == 0);
+    REQUIRE(FilterProgram(load("filter: { none: [ { check: true }, { wheel: 2 } ] }")).keySignature() == 0);
+    REQUIRE(FilterProgram(load("filter: { any: [ { brand: 'bmw' }, { $geometry: point } ] }")).keySignature() == 0);
+    REQUIRE(FilterProgram(load("filter: 'function() { return true; }'")).keySignature() == 0);
+    ctx.clear();
+
+    Feature empty;
+    FilterProgram program(load("filter: { brand: bmw }"));
+
+    REQUIRE(!program.mayMatch(empty.props.keySignature()));
+    REQUIRE(program.mayMatch(bmw1.props.keySignature()));
+
+    ctx.setFeature(empty);
+    REQUIRE(!program.eval(empty, ctx));
+    ctx.setFeature(bmw1);
+    REQUIRE(program.eval(bmw1, ctx));
+}